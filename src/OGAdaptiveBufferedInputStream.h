@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGBufferedInputStream.h"
+#import "OGAdaptiveBuffering.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM (ogio_adaptive_buffered_input_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioAdaptiveBufferedInputStream, ogio_adaptive_buffered_input_stream, OGIO, ADAPTIVE_BUFFERED_INPUT_STREAM, GBufferedInputStream)
+
+GInputStream* ogio_adaptive_buffered_input_stream_new(GInputStream* baseStream);
+void ogio_adaptive_buffered_input_stream_get_statistics(OGioAdaptiveBufferedInputStream* stream, OGAdaptiveBufferStatistics* statistics);
+
+G_END_DECLS
+
+/**
+ * `OGAdaptiveBufferedInputStream` is a buffered input stream that picks its
+ * buffer size from the traffic it sees.
+ *
+ * The stream looks at windows of 32 fills. If most fills came back
+ * (nearly) full or reads were too large for the buffer, the buffer is
+ * doubled, provided the shared budget of #OGAdaptiveBuffering allows it. If
+ * fills only return a small part of the buffer, as on a chatty socket, the
+ * buffer shrinks to twice the average fill. Sizes are decided between
+ * operations, so data already buffered is never lost.
+ *
+ */
+@interface OGAdaptiveBufferedInputStream : OGBufferedInputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)adaptiveBufferedInputStreamWithBaseStream:(OGInputStream*)baseStream;
+
+/**
+ * Methods
+ */
+
+- (OGioAdaptiveBufferedInputStream*)castedGObject;
+
+/**
+ * Returns the current buffer size and the sizing decisions taken so far.
+ *
+ * @return the current statistics
+ */
+- (OGAdaptiveBufferStatistics)statistics;
+
+@end
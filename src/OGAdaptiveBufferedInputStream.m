@@ -0,0 +1,243 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGAdaptiveBufferedInputStream.h"
+
+#define WINDOW_EVENTS 32
+
+struct _OGioAdaptiveBufferedInputStream {
+	GBufferedInputStream parent_instance;
+
+	gsize charged;
+
+	guint events;
+	guint largeEvents;
+	guint fills;
+	gsize filledBytes;
+
+	OGAdaptiveBufferStatistics statistics;
+};
+
+G_DEFINE_FINAL_TYPE(OGioAdaptiveBufferedInputStream, ogio_adaptive_buffered_input_stream, G_TYPE_BUFFERED_INPUT_STREAM)
+
+static void resizeBuffer(OGioAdaptiveBufferedInputStream* self, gsize size)
+{
+	GBufferedInputStream* stream = G_BUFFERED_INPUT_STREAM(self);
+	gsize current = g_buffered_input_stream_get_buffer_size(stream);
+
+	size = ogio_adaptive_buffering_round_size(size);
+	if (size == current)
+		return;
+
+	if (size > current) {
+		if (size > self->charged && !ogio_adaptive_buffering_reserve(size - self->charged, FALSE)) {
+			self->statistics.deniedGrows++;
+			return;
+		}
+
+		self->statistics.grows++;
+	} else {
+		self->statistics.shrinks++;
+	}
+
+	g_buffered_input_stream_set_buffer_size(stream, size);
+
+	/* Shrinking keeps room for the data that is still buffered. */
+	gsize actual = g_buffered_input_stream_get_buffer_size(stream);
+	if (actual > self->charged)
+		ogio_adaptive_buffering_reserve(actual - self->charged, TRUE);
+	else
+		ogio_adaptive_buffering_release(self->charged - actual);
+
+	self->charged = actual;
+}
+
+/* Called before an operation starts, never while the parent class is using its buffer. */
+static void evaluateWindow(OGioAdaptiveBufferedInputStream* self)
+{
+	if (self->events < WINDOW_EVENTS)
+		return;
+
+	gsize size = g_buffered_input_stream_get_buffer_size(G_BUFFERED_INPUT_STREAM(self));
+
+	if (self->largeEvents * 4 >= self->events * 3)
+		resizeBuffer(self, size * 2);
+	else if (self->largeEvents == 0 && self->fills > 0 && self->filledBytes / self->fills < size / 4)
+		resizeBuffer(self, 2 * (self->filledBytes / self->fills));
+
+	self->events = 0;
+	self->largeEvents = 0;
+	self->fills = 0;
+	self->filledBytes = 0;
+}
+
+static void recordFill(OGioAdaptiveBufferedInputStream* self, gssize filled)
+{
+	gsize size = g_buffered_input_stream_get_buffer_size(G_BUFFERED_INPUT_STREAM(self));
+
+	if (filled <= 0)
+		return;
+
+	self->events++;
+	self->fills++;
+	self->filledBytes += filled;
+
+	if ((gsize)filled >= size - size / 4)
+		self->largeEvents++;
+}
+
+static gssize ogio_adaptive_buffered_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioAdaptiveBufferedInputStream* self = OGIO_ADAPTIVE_BUFFERED_INPUT_STREAM(stream);
+
+	evaluateWindow(self);
+
+	/* The parent class reads requests larger than the buffer directly. */
+	if (count > g_buffered_input_stream_get_buffer_size(G_BUFFERED_INPUT_STREAM(self))) {
+		self->events++;
+		self->largeEvents++;
+	}
+
+	return G_INPUT_STREAM_CLASS(ogio_adaptive_buffered_input_stream_parent_class)->read_fn(stream, buffer, count, cancellable, error);
+}
+
+static gssize ogio_adaptive_buffered_input_stream_fill(GBufferedInputStream* stream, gssize count, GCancellable* cancellable, GError** error)
+{
+	OGioAdaptiveBufferedInputStream* self = OGIO_ADAPTIVE_BUFFERED_INPUT_STREAM(stream);
+
+	evaluateWindow(self);
+
+	gssize filled = G_BUFFERED_INPUT_STREAM_CLASS(ogio_adaptive_buffered_input_stream_parent_class)->fill(stream, count, cancellable, error);
+	recordFill(self, filled);
+
+	return filled;
+}
+
+static void ogio_adaptive_buffered_input_stream_fill_async(GBufferedInputStream* stream, gssize count, int ioPriority, GCancellable* cancellable, GAsyncReadyCallback callback, gpointer userData)
+{
+	evaluateWindow(OGIO_ADAPTIVE_BUFFERED_INPUT_STREAM(stream));
+
+	G_BUFFERED_INPUT_STREAM_CLASS(ogio_adaptive_buffered_input_stream_parent_class)->fill_async(stream, count, ioPriority, cancellable, callback, userData);
+}
+
+static gssize ogio_adaptive_buffered_input_stream_fill_finish(GBufferedInputStream* stream, GAsyncResult* result, GError** error)
+{
+	gssize filled = G_BUFFERED_INPUT_STREAM_CLASS(ogio_adaptive_buffered_input_stream_parent_class)->fill_finish(stream, result, error);
+	recordFill(OGIO_ADAPTIVE_BUFFERED_INPUT_STREAM(stream), filled);
+
+	return filled;
+}
+
+static void ogio_adaptive_buffered_input_stream_finalize(GObject* object)
+{
+	OGioAdaptiveBufferedInputStream* self = OGIO_ADAPTIVE_BUFFERED_INPUT_STREAM(object);
+
+	ogio_adaptive_buffering_release(self->charged);
+
+	G_OBJECT_CLASS(ogio_adaptive_buffered_input_stream_parent_class)->finalize(object);
+}
+
+static void ogio_adaptive_buffered_input_stream_init(OGioAdaptiveBufferedInputStream* self)
+{
+}
+
+static void ogio_adaptive_buffered_input_stream_class_init(OGioAdaptiveBufferedInputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GInputStreamClass* streamClass = G_INPUT_STREAM_CLASS(klass);
+	GBufferedInputStreamClass* bufferedClass = G_BUFFERED_INPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_adaptive_buffered_input_stream_finalize;
+
+	streamClass->read_fn = ogio_adaptive_buffered_input_stream_read;
+
+	bufferedClass->fill = ogio_adaptive_buffered_input_stream_fill;
+	bufferedClass->fill_async = ogio_adaptive_buffered_input_stream_fill_async;
+	bufferedClass->fill_finish = ogio_adaptive_buffered_input_stream_fill_finish;
+}
+
+GInputStream* ogio_adaptive_buffered_input_stream_new(GInputStream* baseStream)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(baseStream), NULL);
+
+	OGioAdaptiveBufferedInputStream* self = g_object_new(OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM, "base-stream", baseStream, "buffer-size", (guint)OG_ADAPTIVE_BUFFER_INITIAL_SIZE, NULL);
+
+	self->charged = OG_ADAPTIVE_BUFFER_INITIAL_SIZE;
+	ogio_adaptive_buffering_reserve(self->charged, TRUE);
+
+	return G_INPUT_STREAM(self);
+}
+
+void ogio_adaptive_buffered_input_stream_get_statistics(OGioAdaptiveBufferedInputStream* stream, OGAdaptiveBufferStatistics* statistics)
+{
+	g_return_if_fail(OGIO_IS_ADAPTIVE_BUFFERED_INPUT_STREAM(stream));
+	g_return_if_fail(statistics != NULL);
+
+	*statistics = stream->statistics;
+	statistics->bufferSize = g_buffered_input_stream_get_buffer_size(G_BUFFERED_INPUT_STREAM(stream));
+}
+
+@implementation OGAdaptiveBufferedInputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)adaptiveBufferedInputStreamWithBaseStream:(OGInputStream*)baseStream
+{
+	if (baseStream == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioAdaptiveBufferedInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_adaptive_buffered_input_stream_new([baseStream castedGObject]), OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM, OGioAdaptiveBufferedInputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGAdaptiveBufferedInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGAdaptiveBufferedInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioAdaptiveBufferedInputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_ADAPTIVE_BUFFERED_INPUT_STREAM, OGioAdaptiveBufferedInputStream);
+}
+
+- (OGAdaptiveBufferStatistics)statistics
+{
+	OGAdaptiveBufferStatistics statistics;
+
+	ogio_adaptive_buffered_input_stream_get_statistics((OGioAdaptiveBufferedInputStream*)[self castedGObject], &statistics);
+
+	return statistics;
+}
+
+@end
@@ -0,0 +1,62 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGBufferedOutputStream.h"
+#import "OGAdaptiveBuffering.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM (ogio_adaptive_buffered_output_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioAdaptiveBufferedOutputStream, ogio_adaptive_buffered_output_stream, OGIO, ADAPTIVE_BUFFERED_OUTPUT_STREAM, GBufferedOutputStream)
+
+GOutputStream* ogio_adaptive_buffered_output_stream_new(GOutputStream* baseStream);
+void ogio_adaptive_buffered_output_stream_get_statistics(OGioAdaptiveBufferedOutputStream* stream, OGAdaptiveBufferStatistics* statistics);
+
+G_END_DECLS
+
+/**
+ * `OGAdaptiveBufferedOutputStream` is a buffered output stream that picks
+ * its buffer size from the traffic it sees.
+ *
+ * The stream looks at windows of 64 writes. If most writes are at least half
+ * the size of the buffer, which makes the parent class cut them into
+ * buffer-sized pieces, the buffer is doubled, provided the shared budget of
+ * #OGAdaptiveBuffering allows it. If the stream is flushed explicitly after
+ * small amounts of data, as request/response protocols do, the buffer
+ * shrinks to twice the average amount flushed.
+ *
+ */
+@interface OGAdaptiveBufferedOutputStream : OGBufferedOutputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)adaptiveBufferedOutputStreamWithBaseStream:(OGOutputStream*)baseStream;
+
+/**
+ * Methods
+ */
+
+- (OGioAdaptiveBufferedOutputStream*)castedGObject;
+
+/**
+ * Returns the current buffer size and the sizing decisions taken so far.
+ *
+ * @return the current statistics
+ */
+- (OGAdaptiveBufferStatistics)statistics;
+
+@end
@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGAdaptiveBufferedOutputStream.h"
+
+#define WINDOW_WRITES 64
+
+struct _OGioAdaptiveBufferedOutputStream {
+	GBufferedOutputStream parent_instance;
+
+	gsize charged;
+
+	guint writes;
+	guint largeWrites;
+	guint flushes;
+	gsize flushedBytes;
+	gsize bytesSinceFlush;
+
+	OGAdaptiveBufferStatistics statistics;
+};
+
+G_DEFINE_FINAL_TYPE(OGioAdaptiveBufferedOutputStream, ogio_adaptive_buffered_output_stream, G_TYPE_BUFFERED_OUTPUT_STREAM)
+
+static void resizeBuffer(OGioAdaptiveBufferedOutputStream* self, gsize size)
+{
+	GBufferedOutputStream* stream = G_BUFFERED_OUTPUT_STREAM(self);
+	gsize current = g_buffered_output_stream_get_buffer_size(stream);
+
+	size = ogio_adaptive_buffering_round_size(size);
+	if (size == current)
+		return;
+
+	if (size > current) {
+		if (size > self->charged && !ogio_adaptive_buffering_reserve(size - self->charged, FALSE)) {
+			self->statistics.deniedGrows++;
+			return;
+		}
+
+		self->statistics.grows++;
+	} else {
+		self->statistics.shrinks++;
+	}
+
+	g_buffered_output_stream_set_buffer_size(stream, size);
+
+	/* Shrinking keeps room for the data that is still buffered. */
+	gsize actual = g_buffered_output_stream_get_buffer_size(stream);
+	if (actual > self->charged)
+		ogio_adaptive_buffering_reserve(actual - self->charged, TRUE);
+	else
+		ogio_adaptive_buffering_release(self->charged - actual);
+
+	self->charged = actual;
+}
+
+/* Called before a write starts, never while the parent class is using its buffer. */
+static void evaluateWindow(OGioAdaptiveBufferedOutputStream* self)
+{
+	if (self->writes < WINDOW_WRITES)
+		return;
+
+	gsize size = g_buffered_output_stream_get_buffer_size(G_BUFFERED_OUTPUT_STREAM(self));
+
+	if (self->largeWrites * 4 >= self->writes * 3)
+		resizeBuffer(self, size * 2);
+	else if (self->largeWrites == 0 && self->flushes > 0 && self->flushedBytes / self->flushes < size / 4)
+		resizeBuffer(self, 2 * (self->flushedBytes / self->flushes));
+
+	self->writes = 0;
+	self->largeWrites = 0;
+	self->flushes = 0;
+	self->flushedBytes = 0;
+}
+
+static gssize ogio_adaptive_buffered_output_stream_write(GOutputStream* stream, const void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioAdaptiveBufferedOutputStream* self = OGIO_ADAPTIVE_BUFFERED_OUTPUT_STREAM(stream);
+
+	evaluateWindow(self);
+
+	gsize size = g_buffered_output_stream_get_buffer_size(G_BUFFERED_OUTPUT_STREAM(self));
+	gssize written = G_OUTPUT_STREAM_CLASS(ogio_adaptive_buffered_output_stream_parent_class)->write_fn(stream, buffer, count, cancellable, error);
+
+	if (written > 0) {
+		self->writes++;
+		self->bytesSinceFlush += written;
+
+		if (count >= size / 2)
+			self->largeWrites++;
+	}
+
+	return written;
+}
+
+static gboolean ogio_adaptive_buffered_output_stream_flush(GOutputStream* stream, GCancellable* cancellable, GError** error)
+{
+	OGioAdaptiveBufferedOutputStream* self = OGIO_ADAPTIVE_BUFFERED_OUTPUT_STREAM(stream);
+
+	if (self->bytesSinceFlush > 0) {
+		self->flushes++;
+		self->flushedBytes += self->bytesSinceFlush;
+		self->bytesSinceFlush = 0;
+	}
+
+	return G_OUTPUT_STREAM_CLASS(ogio_adaptive_buffered_output_stream_parent_class)->flush(stream, cancellable, error);
+}
+
+static void ogio_adaptive_buffered_output_stream_finalize(GObject* object)
+{
+	OGioAdaptiveBufferedOutputStream* self = OGIO_ADAPTIVE_BUFFERED_OUTPUT_STREAM(object);
+
+	ogio_adaptive_buffering_release(self->charged);
+
+	G_OBJECT_CLASS(ogio_adaptive_buffered_output_stream_parent_class)->finalize(object);
+}
+
+static void ogio_adaptive_buffered_output_stream_init(OGioAdaptiveBufferedOutputStream* self)
+{
+}
+
+static void ogio_adaptive_buffered_output_stream_class_init(OGioAdaptiveBufferedOutputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GOutputStreamClass* streamClass = G_OUTPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_adaptive_buffered_output_stream_finalize;
+
+	streamClass->write_fn = ogio_adaptive_buffered_output_stream_write;
+	streamClass->flush = ogio_adaptive_buffered_output_stream_flush;
+}
+
+GOutputStream* ogio_adaptive_buffered_output_stream_new(GOutputStream* baseStream)
+{
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(baseStream), NULL);
+
+	OGioAdaptiveBufferedOutputStream* self = g_object_new(OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM, "base-stream", baseStream, "buffer-size", (guint)OG_ADAPTIVE_BUFFER_INITIAL_SIZE, NULL);
+
+	self->charged = OG_ADAPTIVE_BUFFER_INITIAL_SIZE;
+	ogio_adaptive_buffering_reserve(self->charged, TRUE);
+
+	return G_OUTPUT_STREAM(self);
+}
+
+void ogio_adaptive_buffered_output_stream_get_statistics(OGioAdaptiveBufferedOutputStream* stream, OGAdaptiveBufferStatistics* statistics)
+{
+	g_return_if_fail(OGIO_IS_ADAPTIVE_BUFFERED_OUTPUT_STREAM(stream));
+	g_return_if_fail(statistics != NULL);
+
+	*statistics = stream->statistics;
+	statistics->bufferSize = g_buffered_output_stream_get_buffer_size(G_BUFFERED_OUTPUT_STREAM(stream));
+}
+
+@implementation OGAdaptiveBufferedOutputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)adaptiveBufferedOutputStreamWithBaseStream:(OGOutputStream*)baseStream
+{
+	if (baseStream == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioAdaptiveBufferedOutputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_adaptive_buffered_output_stream_new([baseStream castedGObject]), OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM, OGioAdaptiveBufferedOutputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGAdaptiveBufferedOutputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGAdaptiveBufferedOutputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioAdaptiveBufferedOutputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_ADAPTIVE_BUFFERED_OUTPUT_STREAM, OGioAdaptiveBufferedOutputStream);
+}
+
+- (OGAdaptiveBufferStatistics)statistics
+{
+	OGAdaptiveBufferStatistics statistics;
+
+	ogio_adaptive_buffered_output_stream_get_statistics((OGioAdaptiveBufferedOutputStream*)[self castedGObject], &statistics);
+
+	return statistics;
+}
+
+@end
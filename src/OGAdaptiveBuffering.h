@@ -0,0 +1,89 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+#define OG_ADAPTIVE_BUFFER_MIN_SIZE 1024
+#define OG_ADAPTIVE_BUFFER_MAX_SIZE (1024 * 1024)
+#define OG_ADAPTIVE_BUFFER_INITIAL_SIZE 4096
+
+/**
+ * Sizing decisions of one adaptive buffered stream.
+ */
+typedef struct {
+	/** The current buffer size */
+	gsize bufferSize;
+	/** Number of times the buffer was grown */
+	guint64 grows;
+	/** Number of times the buffer was shrunk */
+	guint64 shrinks;
+	/** Number of times growing was refused by the memory budget */
+	guint64 deniedGrows;
+} OGAdaptiveBufferStatistics;
+
+gboolean ogio_adaptive_buffering_reserve(gsize bytes, gboolean force);
+void ogio_adaptive_buffering_release(gsize bytes);
+gsize ogio_adaptive_buffering_get_budget(void);
+void ogio_adaptive_buffering_set_budget(gsize budget);
+gsize ogio_adaptive_buffering_get_used(void);
+gsize ogio_adaptive_buffering_round_size(gsize size);
+
+G_END_DECLS
+
+/**
+ * `OGAdaptiveBuffering` holds the memory budget shared by all
+ * #OGAdaptiveBufferedInputStream and #OGAdaptiveBufferedOutputStream
+ * instances of the process.
+ *
+ * Adaptive streams start with a 4 KiB buffer and double or halve it, within
+ * 1 KiB and 1 MiB, based on the reads and writes they observe. Growing a
+ * buffer is only allowed while the sum of all adaptive buffers stays within
+ * the budget; every stream is always granted its initial buffer.
+ *
+ */
+@interface OGAdaptiveBuffering : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * The number of bytes all adaptive buffers together may grow to. Defaults
+ * to 64 MiB.
+ *
+ * @return the memory budget in bytes
+ */
++ (gsize)memoryBudget;
+
+/**
+ * Sets the memory budget. Lowering it does not shrink existing buffers, but
+ * stops them from growing until enough memory has been released.
+ *
+ * @param budget the memory budget in bytes
+ */
++ (void)setMemoryBudget:(gsize)budget;
+
+/**
+ * The number of bytes currently held by adaptive buffers.
+ *
+ * @return the memory in use in bytes
+ */
++ (gsize)memoryInUse;
+
+@end
@@ -0,0 +1,85 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGAdaptiveBuffering.h"
+
+static GMutex budgetMutex;
+static gsize budget = 64 * 1024 * 1024;
+static gsize used;
+
+gboolean ogio_adaptive_buffering_reserve(gsize bytes, gboolean force)
+{
+	gboolean reserved = FALSE;
+
+	g_mutex_lock(&budgetMutex);
+
+	if (force || (used <= budget && bytes <= budget - used)) {
+		used += bytes;
+		reserved = TRUE;
+	}
+
+	g_mutex_unlock(&budgetMutex);
+
+	return reserved;
+}
+
+void ogio_adaptive_buffering_release(gsize bytes)
+{
+	g_mutex_lock(&budgetMutex);
+	used -= MIN(bytes, used);
+	g_mutex_unlock(&budgetMutex);
+}
+
+gsize ogio_adaptive_buffering_get_budget(void)
+{
+	g_mutex_lock(&budgetMutex);
+	gsize returnValue = budget;
+	g_mutex_unlock(&budgetMutex);
+
+	return returnValue;
+}
+
+void ogio_adaptive_buffering_set_budget(gsize newBudget)
+{
+	g_mutex_lock(&budgetMutex);
+	budget = newBudget;
+	g_mutex_unlock(&budgetMutex);
+}
+
+gsize ogio_adaptive_buffering_get_used(void)
+{
+	g_mutex_lock(&budgetMutex);
+	gsize returnValue = used;
+	g_mutex_unlock(&budgetMutex);
+
+	return returnValue;
+}
+
+gsize ogio_adaptive_buffering_round_size(gsize size)
+{
+	size = CLAMP(size, OG_ADAPTIVE_BUFFER_MIN_SIZE, OG_ADAPTIVE_BUFFER_MAX_SIZE);
+
+	return (gsize)1 << g_bit_storage(size - 1);
+}
+
+@implementation OGAdaptiveBuffering
+
++ (gsize)memoryBudget
+{
+	return ogio_adaptive_buffering_get_budget();
+}
+
++ (void)setMemoryBudget:(gsize)newBudget
+{
+	ogio_adaptive_buffering_set_budget(newBudget);
+}
+
++ (gsize)memoryInUse
+{
+	return ogio_adaptive_buffering_get_used();
+}
+
+@end
@@ -0,0 +1,162 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGInputStream;
+@class OGMemoryOutputStream;
+@class OGSocket;
+
+G_BEGIN_DECLS
+
+/**
+ * Counters collected by the buffer pool.
+ */
+typedef struct {
+	/** Allocations served from a thread cache or the shared depot */
+	guint64 hits;
+	/** Allocations that had to call malloc() */
+	guint64 misses;
+	/** Allocations too large to be pooled */
+	guint64 oversized;
+	/** Bytes held by idle buffers in the thread caches and the depot */
+	gsize cachedBytes;
+	/** Bytes held by buffers currently handed out */
+	gsize outstandingBytes;
+} OGBufferPoolStatistics;
+
+gpointer ogio_buffer_pool_alloc(gsize size);
+gpointer ogio_buffer_pool_realloc(gpointer data, gsize size);
+void ogio_buffer_pool_free(gpointer data);
+gsize ogio_buffer_pool_get_capacity(gconstpointer data);
+GBytes* ogio_buffer_pool_new_bytes(gpointer data, gsize size);
+void ogio_buffer_pool_trim(void);
+void ogio_buffer_pool_get_statistics(OGBufferPoolStatistics* statistics);
+
+GBytes* ogio_buffer_pool_read_bytes(GInputStream* stream, gsize count, GCancellable* cancellable, GError** error);
+void ogio_buffer_pool_read_bytes_async(GInputStream* stream, gsize count, int ioPriority, GCancellable* cancellable, GAsyncReadyCallback callback, gpointer userData);
+GBytes* ogio_buffer_pool_read_bytes_finish(GInputStream* stream, GAsyncResult* result, GError** error);
+GBytes* ogio_buffer_pool_receive_bytes(GSocket* socket, gsize size, gint64 timeoutUs, GCancellable* cancellable, GError** error);
+GOutputStream* ogio_buffer_pool_memory_output_stream_new(void);
+
+G_END_DECLS
+
+/**
+ * `OGBufferPool` is a process-wide pool of read buffers sorted into
+ * power-of-two size classes from 256 bytes to 1 MiB.
+ *
+ * Every thread keeps a small cache of idle buffers per size class, so
+ * allocating and freeing a buffer normally takes no lock. When a thread
+ * cache overflows, for instance because buffers received on one thread are
+ * released on another, half of it is moved to a shared depot from which
+ * other threads refill. Larger requests go straight to malloc().
+ *
+ * Buffers are handed out as #GBytes that return their memory to the pool on
+ * their final unref. The class methods are drop-in replacements for
+ * -[OGInputStream readBytesWithCount:cancellable:], its asynchronous
+ * variant and -[OGSocket receiveBytesWithSize:timeoutUs:cancellable:];
+ * -pooledMemoryOutputStream returns a resizable memory output stream whose
+ * -[OGMemoryOutputStream stealAsBytes] result is pooled as well.
+ *
+ * Note that a pooled #GBytes keeps the whole size class buffer alive, so
+ * short reads into large buffers trade memory for fewer allocations.
+ *
+ */
+@interface OGBufferPool : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Returns a snapshot of the counters of the pool.
+ *
+ * @return the current statistics
+ */
++ (OGBufferPoolStatistics)statistics;
+
+/**
+ * Returns the fraction of pooled allocations that did not call malloc().
+ *
+ * @return the hit rate between 0 and 1
+ */
++ (double)hitRate;
+
+/**
+ * Moves the idle buffers cached by the calling thread to the shared depot
+ * and frees what does not fit there.
+ *
+ */
++ (void)trim;
+
+/**
+ * Like -[OGInputStream readBytesWithCount:cancellable:], but reads into a
+ * pooled buffer.
+ *
+ * @param stream the stream to read from
+ * @param count maximum number of bytes that will be read from the stream
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return a new #GBytes, empty at the end of the stream
+ */
++ (GBytes*)readBytesFromStream:(OGInputStream*)stream count:(gsize)count cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Like -[OGInputStream readBytesAsyncWithCount:ioPriority:cancellable:callback:userData:],
+ * but reads into a pooled buffer.
+ *
+ * @param stream the stream to read from
+ * @param count the number of bytes that will be read from the stream
+ * @param ioPriority the [I/O priority][io-priority] of the request
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @param callback a #GAsyncReadyCallback
+ *   to call when the request is satisfied
+ * @param userData the data to pass to callback function
+ */
++ (void)readBytesAsyncFromStream:(OGInputStream*)stream count:(gsize)count ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData;
+
+/**
+ * Finishes a read started with
+ * +readBytesAsyncFromStream:count:ioPriority:cancellable:callback:userData:.
+ *
+ * @param stream the stream the read was started on
+ * @param result a #GAsyncResult.
+ * @return the newly-allocated #GBytes
+ */
++ (GBytes*)readBytesFinishFromStream:(OGInputStream*)stream result:(GAsyncResult*)result;
+
+/**
+ * Like -[OGSocket receiveBytesWithSize:timeoutUs:cancellable:], but receives
+ * into a pooled buffer.
+ *
+ * @param socket the socket to receive from
+ * @param size the number of bytes you want to read from the socket
+ * @param timeoutUs the timeout to wait for, in microseconds, or `-1` to block
+ *   indefinitely
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return a bytes buffer containing the received bytes
+ */
++ (GBytes*)receiveBytesFromSocket:(OGSocket*)socket size:(gsize)size timeoutUs:(gint64)timeoutUs cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Creates a resizable memory output stream that grows through the pool.
+ *
+ * @return a new memory output stream
+ */
++ (OGMemoryOutputStream*)pooledMemoryOutputStream;
+
+@end
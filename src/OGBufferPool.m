@@ -0,0 +1,433 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGBufferPool.h"
+
+#import "OGCancellable.h"
+#import "OGInputStream.h"
+#import "OGMemoryOutputStream.h"
+#import "OGSocket.h"
+
+#define MIN_CLASS_SHIFT 8
+#define MAX_CLASS_SHIFT 20
+#define CLASS_COUNT (MAX_CLASS_SHIFT - MIN_CLASS_SHIFT + 1)
+#define CACHE_SLOTS 32
+#define CACHE_BYTES_PER_CLASS (512 * 1024)
+#define DEPOT_SLOTS 128
+/* Keeps the payload aligned like malloc() does. */
+#define HEADER_SIZE 16
+
+typedef union {
+	struct {
+		gsize capacity;
+		guint sizeClass;
+	} info;
+	guint8 padding[HEADER_SIZE];
+} BufferHeader;
+
+typedef struct {
+	BufferHeader* buffers[CLASS_COUNT][CACHE_SLOTS];
+	guint counts[CLASS_COUNT];
+} ThreadCache;
+
+static void threadCacheFree(gpointer data);
+
+static GPrivate threadCacheKey = G_PRIVATE_INIT(threadCacheFree);
+
+static GMutex depotMutex;
+static BufferHeader* depot[CLASS_COUNT][DEPOT_SLOTS];
+static guint depotCounts[CLASS_COUNT];
+
+static gsize hits;
+static gsize misses;
+static gsize oversized;
+static gsize cachedBytes;
+static gsize outstandingBytes;
+
+G_STATIC_ASSERT(sizeof(BufferHeader) == HEADER_SIZE);
+
+static guint classForSize(gsize size)
+{
+	if (size <= ((gsize)1 << MIN_CLASS_SHIFT))
+		return 0;
+
+	if (size > ((gsize)1 << MAX_CLASS_SHIFT))
+		return CLASS_COUNT;
+
+	return g_bit_storage(size - 1) - MIN_CLASS_SHIFT;
+}
+
+static gsize capacityOfClass(guint sizeClass)
+{
+	return (gsize)1 << (sizeClass + MIN_CLASS_SHIFT);
+}
+
+static guint cacheLimitOfClass(guint sizeClass)
+{
+	gsize limit = CACHE_BYTES_PER_CLASS / capacityOfClass(sizeClass);
+
+	return (guint)CLAMP(limit, 2, CACHE_SLOTS);
+}
+
+static BufferHeader* headerOf(gconstpointer data)
+{
+	return (BufferHeader*)((guint8*)data - HEADER_SIZE);
+}
+
+static ThreadCache* threadCache(void)
+{
+	ThreadCache* cache = g_private_get(&threadCacheKey);
+
+	if (cache == NULL) {
+		cache = g_new0(ThreadCache, 1);
+		g_private_set(&threadCacheKey, cache);
+	}
+
+	return cache;
+}
+
+/* Moves @count buffers of @cache to the depot, freeing those that do not fit. */
+static void flushToDepot(ThreadCache* cache, guint sizeClass, guint count)
+{
+	gsize capacity = capacityOfClass(sizeClass);
+	guint depotLimit = MIN(4 * cacheLimitOfClass(sizeClass), DEPOT_SLOTS);
+
+	g_mutex_lock(&depotMutex);
+
+	for (guint i = 0; i < count; i++) {
+		BufferHeader* header = cache->buffers[sizeClass][--cache->counts[sizeClass]];
+
+		if (depotCounts[sizeClass] < depotLimit) {
+			depot[sizeClass][depotCounts[sizeClass]++] = header;
+		} else {
+			g_free(header);
+			g_atomic_pointer_add(&cachedBytes, -(gssize)capacity);
+		}
+	}
+
+	g_mutex_unlock(&depotMutex);
+}
+
+/* Refills half of the thread cache from the depot and returns one more buffer. */
+static BufferHeader* takeFromDepot(ThreadCache* cache, guint sizeClass)
+{
+	BufferHeader* header = NULL;
+	guint refill = cacheLimitOfClass(sizeClass) / 2;
+
+	g_mutex_lock(&depotMutex);
+
+	if (depotCounts[sizeClass] > 0) {
+		header = depot[sizeClass][--depotCounts[sizeClass]];
+
+		while (refill-- > 0 && depotCounts[sizeClass] > 0)
+			cache->buffers[sizeClass][cache->counts[sizeClass]++] = depot[sizeClass][--depotCounts[sizeClass]];
+	}
+
+	g_mutex_unlock(&depotMutex);
+
+	return header;
+}
+
+static void threadCacheFree(gpointer data)
+{
+	ThreadCache* cache = data;
+
+	for (guint sizeClass = 0; sizeClass < CLASS_COUNT; sizeClass++)
+		if (cache->counts[sizeClass] > 0)
+			flushToDepot(cache, sizeClass, cache->counts[sizeClass]);
+
+	g_free(cache);
+}
+
+gpointer ogio_buffer_pool_alloc(gsize size)
+{
+	guint sizeClass = classForSize(size);
+	BufferHeader* header = NULL;
+	gsize capacity;
+
+	if (sizeClass < CLASS_COUNT) {
+		ThreadCache* cache = threadCache();
+		capacity = capacityOfClass(sizeClass);
+
+		if (cache->counts[sizeClass] > 0)
+			header = cache->buffers[sizeClass][--cache->counts[sizeClass]];
+		else
+			header = takeFromDepot(cache, sizeClass);
+
+		if (header != NULL) {
+			g_atomic_pointer_add(&hits, 1);
+			g_atomic_pointer_add(&cachedBytes, -(gssize)capacity);
+		} else {
+			g_atomic_pointer_add(&misses, 1);
+		}
+	} else {
+		capacity = size;
+		g_atomic_pointer_add(&oversized, 1);
+	}
+
+	if (header == NULL) {
+		header = g_malloc(HEADER_SIZE + capacity);
+		header->info.capacity = capacity;
+		header->info.sizeClass = sizeClass;
+	}
+
+	g_atomic_pointer_add(&outstandingBytes, (gssize)capacity);
+
+	return (guint8*)header + HEADER_SIZE;
+}
+
+void ogio_buffer_pool_free(gpointer data)
+{
+	if (data == NULL)
+		return;
+
+	BufferHeader* header = headerOf(data);
+	guint sizeClass = header->info.sizeClass;
+	gsize capacity = header->info.capacity;
+
+	g_atomic_pointer_add(&outstandingBytes, -(gssize)capacity);
+
+	if (sizeClass >= CLASS_COUNT) {
+		g_free(header);
+		return;
+	}
+
+	ThreadCache* cache = threadCache();
+	guint limit = cacheLimitOfClass(sizeClass);
+
+	if (cache->counts[sizeClass] >= limit)
+		flushToDepot(cache, sizeClass, limit / 2);
+
+	cache->buffers[sizeClass][cache->counts[sizeClass]++] = header;
+	g_atomic_pointer_add(&cachedBytes, (gssize)capacity);
+}
+
+gpointer ogio_buffer_pool_realloc(gpointer data, gsize size)
+{
+	if (data == NULL)
+		return (size > 0 ? ogio_buffer_pool_alloc(size) : NULL);
+
+	if (size == 0) {
+		ogio_buffer_pool_free(data);
+		return NULL;
+	}
+
+	gsize capacity = headerOf(data)->info.capacity;
+	if (size <= capacity && classForSize(size) == headerOf(data)->info.sizeClass)
+		return data;
+
+	gpointer resized = ogio_buffer_pool_alloc(size);
+	memcpy(resized, data, MIN(size, capacity));
+	ogio_buffer_pool_free(data);
+
+	return resized;
+}
+
+gsize ogio_buffer_pool_get_capacity(gconstpointer data)
+{
+	g_return_val_if_fail(data != NULL, 0);
+
+	return headerOf(data)->info.capacity;
+}
+
+GBytes* ogio_buffer_pool_new_bytes(gpointer data, gsize size)
+{
+	if (size == 0) {
+		ogio_buffer_pool_free(data);
+		return g_bytes_new(NULL, 0);
+	}
+
+	return g_bytes_new_with_free_func(data, size, ogio_buffer_pool_free, data);
+}
+
+void ogio_buffer_pool_trim(void)
+{
+	ThreadCache* cache = g_private_get(&threadCacheKey);
+
+	if (cache == NULL)
+		return;
+
+	for (guint sizeClass = 0; sizeClass < CLASS_COUNT; sizeClass++)
+		if (cache->counts[sizeClass] > 0)
+			flushToDepot(cache, sizeClass, cache->counts[sizeClass]);
+}
+
+void ogio_buffer_pool_get_statistics(OGBufferPoolStatistics* statistics)
+{
+	g_return_if_fail(statistics != NULL);
+
+	statistics->hits = (guint64)(gsize)g_atomic_pointer_get(&hits);
+	statistics->misses = (guint64)(gsize)g_atomic_pointer_get(&misses);
+	statistics->oversized = (guint64)(gsize)g_atomic_pointer_get(&oversized);
+	statistics->cachedBytes = (gsize)g_atomic_pointer_get(&cachedBytes);
+	statistics->outstandingBytes = (gsize)g_atomic_pointer_get(&outstandingBytes);
+}
+
+GBytes* ogio_buffer_pool_read_bytes(GInputStream* stream, gsize count, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(stream), NULL);
+
+	if (count == 0)
+		return g_bytes_new(NULL, 0);
+
+	gpointer buffer = ogio_buffer_pool_alloc(count);
+	gssize read = g_input_stream_read(stream, buffer, count, cancellable, error);
+
+	if (read < 0) {
+		ogio_buffer_pool_free(buffer);
+		return NULL;
+	}
+
+	return ogio_buffer_pool_new_bytes(buffer, (gsize)read);
+}
+
+static void readBytesReady(GObject* source, GAsyncResult* result, gpointer userData)
+{
+	GTask* task = userData;
+	gpointer buffer = g_task_get_task_data(task);
+	GError* error = NULL;
+
+	gssize read = g_input_stream_read_finish(G_INPUT_STREAM(source), result, &error);
+
+	if (read < 0) {
+		ogio_buffer_pool_free(buffer);
+		g_task_return_error(task, error);
+	} else {
+		g_task_return_pointer(task, ogio_buffer_pool_new_bytes(buffer, (gsize)read), (GDestroyNotify)g_bytes_unref);
+	}
+
+	g_object_unref(task);
+}
+
+void ogio_buffer_pool_read_bytes_async(GInputStream* stream, gsize count, int ioPriority, GCancellable* cancellable, GAsyncReadyCallback callback, gpointer userData)
+{
+	g_return_if_fail(G_IS_INPUT_STREAM(stream));
+
+	GTask* task = g_task_new(stream, cancellable, callback, userData);
+	g_task_set_source_tag(task, ogio_buffer_pool_read_bytes_async);
+	g_task_set_priority(task, ioPriority);
+
+	if (count == 0) {
+		g_task_return_pointer(task, g_bytes_new(NULL, 0), (GDestroyNotify)g_bytes_unref);
+		g_object_unref(task);
+		return;
+	}
+
+	gpointer buffer = ogio_buffer_pool_alloc(count);
+	g_task_set_task_data(task, buffer, NULL);
+
+	g_input_stream_read_async(stream, buffer, count, ioPriority, cancellable, readBytesReady, task);
+}
+
+GBytes* ogio_buffer_pool_read_bytes_finish(GInputStream* stream, GAsyncResult* result, GError** error)
+{
+	g_return_val_if_fail(g_task_is_valid(result, stream), NULL);
+
+	return g_task_propagate_pointer(G_TASK(result), error);
+}
+
+GBytes* ogio_buffer_pool_receive_bytes(GSocket* socket, gsize size, gint64 timeoutUs, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_SOCKET(socket), NULL);
+
+	if (timeoutUs >= 0 && !g_socket_condition_timed_wait(socket, G_IO_IN, timeoutUs, cancellable, error))
+		return NULL;
+
+	if (size == 0)
+		return g_bytes_new(NULL, 0);
+
+	gpointer buffer = ogio_buffer_pool_alloc(size);
+	gssize received = g_socket_receive(socket, buffer, size, cancellable, error);
+
+	if (received < 0) {
+		ogio_buffer_pool_free(buffer);
+		return NULL;
+	}
+
+	return ogio_buffer_pool_new_bytes(buffer, (gsize)received);
+}
+
+GOutputStream* ogio_buffer_pool_memory_output_stream_new(void)
+{
+	return g_memory_output_stream_new(NULL, 0, ogio_buffer_pool_realloc, ogio_buffer_pool_free);
+}
+
+@implementation OGBufferPool
+
++ (OGBufferPoolStatistics)statistics
+{
+	OGBufferPoolStatistics statistics;
+
+	ogio_buffer_pool_get_statistics(&statistics);
+
+	return statistics;
+}
+
++ (double)hitRate
+{
+	OGBufferPoolStatistics statistics = [self statistics];
+	guint64 total = statistics.hits + statistics.misses;
+
+	if (total == 0)
+		return 0;
+
+	return (double)statistics.hits / total;
+}
+
++ (void)trim
+{
+	ogio_buffer_pool_trim();
+}
+
++ (GBytes*)readBytesFromStream:(OGInputStream*)stream count:(gsize)count cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	GBytes* returnValue = (GBytes*)ogio_buffer_pool_read_bytes([stream castedGObject], count, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
++ (void)readBytesAsyncFromStream:(OGInputStream*)stream count:(gsize)count ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData
+{
+	ogio_buffer_pool_read_bytes_async([stream castedGObject], count, ioPriority, [cancellable castedGObject], callback, userData);
+}
+
++ (GBytes*)readBytesFinishFromStream:(OGInputStream*)stream result:(GAsyncResult*)result
+{
+	GError* err = NULL;
+
+	GBytes* returnValue = (GBytes*)ogio_buffer_pool_read_bytes_finish([stream castedGObject], result, &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
++ (GBytes*)receiveBytesFromSocket:(OGSocket*)socket size:(gsize)size timeoutUs:(gint64)timeoutUs cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	GBytes* returnValue = (GBytes*)ogio_buffer_pool_receive_bytes([socket castedGObject], size, timeoutUs, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
++ (OGMemoryOutputStream*)pooledMemoryOutputStream
+{
+	GOutputStream* gobjectValue = ogio_buffer_pool_memory_output_stream_new();
+
+	OGMemoryOutputStream* returnValue = OGWrapperClassAndObjectForGObject(gobjectValue);
+	g_object_unref(gobjectValue);
+
+	return returnValue;
+}
+
+@end
@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGTlsDatabase.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_CACHING_TLS_DATABASE (ogio_caching_tls_database_get_type())
+G_DECLARE_FINAL_TYPE(OGioCachingTlsDatabase, ogio_caching_tls_database, OGIO, CACHING_TLS_DATABASE, GTlsDatabase)
+
+/**
+ * Counters collected by an #OGioCachingTlsDatabase.
+ */
+typedef struct {
+	/** Number of chain verifications answered from the cache */
+	guint64 hits;
+	/** Number of chain verifications passed on to the base database */
+	guint64 misses;
+	/** Number of verification results dropped because of the capacity */
+	guint64 evictions;
+	/** Number of verification results dropped because they expired */
+	guint64 expirations;
+} OGCachingTlsDatabaseStatistics;
+
+GTlsDatabase* ogio_caching_tls_database_new(GTlsDatabase* baseDatabase, guint capacity, gint64 maxAge, guint maxThreads);
+GTlsDatabase* ogio_caching_tls_database_get_base_database(OGioCachingTlsDatabase* database);
+guint ogio_caching_tls_database_get_count(OGioCachingTlsDatabase* database);
+void ogio_caching_tls_database_get_statistics(OGioCachingTlsDatabase* database, OGCachingTlsDatabaseStatistics* statistics);
+void ogio_caching_tls_database_clear(OGioCachingTlsDatabase* database);
+
+G_END_DECLS
+
+/**
+ * `OGCachingTlsDatabase` is a #GTlsDatabase that wraps another database and
+ * remembers the results of certificate chain verifications.
+ *
+ * Results are keyed by the SHA-256 fingerprint of the leaf certificate, a
+ * SHA-256 hash over the whole chain, the purpose, the expected identity and
+ * the verify flags. A cached result is used until the earliest
+ * `not-valid-after` date in the chain or until it is older than the maximum
+ * age given at construction, whichever comes first. Verifications that fail
+ * with an error are never cached.
+ *
+ * Asynchronous verifications that miss the cache run on a dedicated,
+ * bounded worker pool instead of the shared #GTask thread pool, so a burst
+ * of client certificate checks cannot starve other asynchronous work.
+ *
+ * Set it on connections with -[OGTlsConnection setDatabase:] so the TLS
+ * backend's own peer verification benefits from the cache. All other
+ * lookups are passed through to the base database.
+ *
+ */
+@interface OGCachingTlsDatabase : OGTlsDatabase
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)cachingTlsDatabaseWithBaseDatabase:(OGTlsDatabase*)baseDatabase capacity:(guint)capacity maxAge:(gint64)maxAge maxThreads:(guint)maxThreads;
+
+/**
+ * Methods
+ */
+
+- (OGioCachingTlsDatabase*)castedGObject;
+
+/**
+ * Gets the database that verifications and lookups are passed on to.
+ *
+ * @return the base database
+ */
+- (OGTlsDatabase*)baseDatabase;
+
+/**
+ * Gets the number of verification results currently cached.
+ *
+ * @return the number of cached results
+ */
+- (guint)count;
+
+/**
+ * Returns a snapshot of the counters collected by the database.
+ *
+ * @return the current statistics
+ */
+- (OGCachingTlsDatabaseStatistics)statistics;
+
+/**
+ * Drops all cached verification results, e.g. after the trust anchors of
+ * the base database changed.
+ *
+ */
+- (void)clear;
+
+@end
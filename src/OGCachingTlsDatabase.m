@@ -0,0 +1,487 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGCachingTlsDatabase.h"
+
+struct _OGioCachingTlsDatabase {
+	GTlsDatabase parent_instance;
+
+	GTlsDatabase* base;
+	GThreadPool* pool;
+
+	GMutex mutex;
+	GHashTable* entries;
+	GQueue lru;
+	guint capacity;
+	gint64 maxAge;
+	OGCachingTlsDatabaseStatistics statistics;
+};
+
+typedef struct {
+	gchar* key;
+	GTlsCertificateFlags result;
+	gint64 expiresAt;
+} CacheEntry;
+
+typedef struct {
+	GTlsCertificate* chain;
+	gchar* purpose;
+	GSocketConnectable* identity;
+	GTlsInteraction* interaction;
+	GTlsDatabaseVerifyFlags flags;
+	gchar* key;
+	gint64 expiresAt;
+} VerifyData;
+
+G_DEFINE_FINAL_TYPE(OGioCachingTlsDatabase, ogio_caching_tls_database, G_TYPE_TLS_DATABASE)
+
+static void cacheEntryFree(CacheEntry* entry)
+{
+	g_free(entry->key);
+	g_free(entry);
+}
+
+static void verifyDataFree(VerifyData* data)
+{
+	g_object_unref(data->chain);
+	g_free(data->purpose);
+	g_clear_object(&data->identity);
+	g_clear_object(&data->interaction);
+	g_free(data->key);
+	g_free(data);
+}
+
+/*
+ * Builds the cache key for a verification and the wall-clock time until
+ * which its result may be reused. Returns NULL if the result must not be
+ * cached.
+ */
+static gchar* verificationKey(GTlsCertificate* chain, const gchar* purpose, GSocketConnectable* identity, GTlsDatabaseVerifyFlags flags, gint64* expiresAt)
+{
+	GChecksum* chainChecksum = g_checksum_new(G_CHECKSUM_SHA256);
+	gchar* leafFingerprint = NULL;
+	gint64 now = g_get_real_time();
+	gint64 notAfter = G_MAXINT64;
+
+	for (GTlsCertificate* certificate = chain; certificate != NULL; certificate = g_tls_certificate_get_issuer(certificate)) {
+		GByteArray* der = NULL;
+		g_object_get(certificate, "certificate", &der, NULL);
+
+		if (der == NULL) {
+			g_checksum_free(chainChecksum);
+			g_free(leafFingerprint);
+			return NULL;
+		}
+
+		if (leafFingerprint == NULL)
+			leafFingerprint = g_compute_checksum_for_data(G_CHECKSUM_SHA256, der->data, der->len);
+
+		g_checksum_update(chainChecksum, der->data, der->len);
+		g_byte_array_unref(der);
+
+		GDateTime* validFrom = g_tls_certificate_get_not_valid_before(certificate);
+		if (validFrom != NULL) {
+			gint64 from = g_date_time_to_unix(validFrom) * G_USEC_PER_SEC;
+			g_date_time_unref(validFrom);
+
+			/* The result changes once the certificate becomes valid. */
+			if (from > now)
+				notAfter = MIN(notAfter, from);
+		}
+
+		GDateTime* validUntil = g_tls_certificate_get_not_valid_after(certificate);
+		if (validUntil != NULL) {
+			notAfter = MIN(notAfter, g_date_time_to_unix(validUntil) * G_USEC_PER_SEC);
+			g_date_time_unref(validUntil);
+		}
+	}
+
+	gchar* identityString = (identity != NULL) ? g_socket_connectable_to_string(identity) : g_strdup("");
+	gchar* key = g_strdup_printf("%s/%s/%s/%u/%s", leafFingerprint, g_checksum_get_string(chainChecksum), purpose, (guint)flags, identityString);
+
+	g_free(identityString);
+	g_free(leafFingerprint);
+	g_checksum_free(chainChecksum);
+
+	*expiresAt = notAfter;
+	return key;
+}
+
+/* Must be called with the mutex held. */
+static void removeLink(OGioCachingTlsDatabase* self, GList* link)
+{
+	CacheEntry* entry = link->data;
+
+	g_hash_table_remove(self->entries, entry->key);
+	g_queue_delete_link(&self->lru, link);
+	cacheEntryFree(entry);
+}
+
+static gboolean lookupResult(OGioCachingTlsDatabase* self, const gchar* key, GTlsCertificateFlags* result)
+{
+	gboolean found = FALSE;
+
+	g_mutex_lock(&self->mutex);
+
+	GList* link = g_hash_table_lookup(self->entries, key);
+	if (link != NULL) {
+		CacheEntry* entry = link->data;
+
+		if (g_get_real_time() >= entry->expiresAt) {
+			removeLink(self, link);
+			self->statistics.expirations++;
+		} else {
+			g_queue_unlink(&self->lru, link);
+			g_queue_push_head_link(&self->lru, link);
+			*result = entry->result;
+			found = TRUE;
+		}
+	}
+
+	if (found)
+		self->statistics.hits++;
+	else
+		self->statistics.misses++;
+
+	g_mutex_unlock(&self->mutex);
+
+	return found;
+}
+
+static void storeResult(OGioCachingTlsDatabase* self, gchar* key, GTlsCertificateFlags result, gint64 expiresAt)
+{
+	gint64 now = g_get_real_time();
+
+	if (self->maxAge > 0 && expiresAt - now > self->maxAge)
+		expiresAt = now + self->maxAge;
+
+	if (expiresAt <= now) {
+		g_free(key);
+		return;
+	}
+
+	CacheEntry* entry = g_new0(CacheEntry, 1);
+	entry->key = key;
+	entry->result = result;
+	entry->expiresAt = expiresAt;
+
+	g_mutex_lock(&self->mutex);
+
+	GList* existing = g_hash_table_lookup(self->entries, key);
+	if (existing != NULL)
+		removeLink(self, existing);
+
+	g_queue_push_head(&self->lru, entry);
+	g_hash_table_insert(self->entries, entry->key, self->lru.head);
+
+	while (self->lru.length > self->capacity) {
+		removeLink(self, self->lru.tail);
+		self->statistics.evictions++;
+	}
+
+	g_mutex_unlock(&self->mutex);
+}
+
+/*
+ * Verifies with the base database after a cache miss for @key and stores
+ * the result. Takes ownership of @key, which may be NULL.
+ */
+static GTlsCertificateFlags verifyAndStore(OGioCachingTlsDatabase* self, gchar* key, gint64 expiresAt, GTlsCertificate* chain, const gchar* purpose, GSocketConnectable* identity, GTlsInteraction* interaction, GTlsDatabaseVerifyFlags flags, GCancellable* cancellable, GError** error)
+{
+	GError* localError = NULL;
+	GTlsCertificateFlags result = g_tls_database_verify_chain(self->base, chain, purpose, identity, interaction, flags, cancellable, &localError);
+
+	if (localError != NULL) {
+		g_free(key);
+		g_propagate_error(error, localError);
+		return G_TLS_CERTIFICATE_GENERIC_ERROR;
+	}
+
+	if (key != NULL)
+		storeResult(self, key, result, expiresAt);
+
+	return result;
+}
+
+static GTlsCertificateFlags ogio_caching_tls_database_verify_chain(GTlsDatabase* database, GTlsCertificate* chain, const gchar* purpose, GSocketConnectable* identity, GTlsInteraction* interaction, GTlsDatabaseVerifyFlags flags, GCancellable* cancellable, GError** error)
+{
+	OGioCachingTlsDatabase* self = OGIO_CACHING_TLS_DATABASE(database);
+	GTlsCertificateFlags result;
+	gint64 expiresAt = 0;
+	gchar* key = verificationKey(chain, purpose, identity, flags, &expiresAt);
+
+	if (key != NULL && lookupResult(self, key, &result)) {
+		g_free(key);
+		return result;
+	}
+
+	return verifyAndStore(self, key, expiresAt, chain, purpose, identity, interaction, flags, cancellable, error);
+}
+
+static void verifyWorker(gpointer item, gpointer userData)
+{
+	GTask* task = item;
+
+	if (g_task_return_error_if_cancelled(task)) {
+		g_object_unref(task);
+		return;
+	}
+
+	OGioCachingTlsDatabase* self = g_task_get_source_object(task);
+	VerifyData* data = g_task_get_task_data(task);
+	GError* error = NULL;
+
+	/* The lookup already missed before the task was queued. */
+	GTlsCertificateFlags result = verifyAndStore(self, g_steal_pointer(&data->key), data->expiresAt, data->chain, data->purpose, data->identity, data->interaction, data->flags, g_task_get_cancellable(task), &error);
+
+	if (error != NULL)
+		g_task_return_error(task, error);
+	else
+		g_task_return_int(task, result);
+
+	g_object_unref(task);
+}
+
+static void ogio_caching_tls_database_verify_chain_async(GTlsDatabase* database, GTlsCertificate* chain, const gchar* purpose, GSocketConnectable* identity, GTlsInteraction* interaction, GTlsDatabaseVerifyFlags flags, GCancellable* cancellable, GAsyncReadyCallback callback, gpointer userData)
+{
+	OGioCachingTlsDatabase* self = OGIO_CACHING_TLS_DATABASE(database);
+	GTask* task = g_task_new(database, cancellable, callback, userData);
+	g_task_set_source_tag(task, ogio_caching_tls_database_verify_chain_async);
+
+	/* Cache hits are cheap enough to answer without a worker. */
+	GTlsCertificateFlags result;
+	gint64 expiresAt = 0;
+	gchar* key = verificationKey(chain, purpose, identity, flags, &expiresAt);
+
+	if (key != NULL && lookupResult(self, key, &result)) {
+		g_free(key);
+		g_task_return_int(task, result);
+		g_object_unref(task);
+		return;
+	}
+
+	VerifyData* data = g_new0(VerifyData, 1);
+	data->chain = g_object_ref(chain);
+	data->purpose = g_strdup(purpose);
+	data->identity = (identity != NULL) ? g_object_ref(identity) : NULL;
+	data->interaction = (interaction != NULL) ? g_object_ref(interaction) : NULL;
+	data->flags = flags;
+	data->key = key;
+	data->expiresAt = expiresAt;
+	g_task_set_task_data(task, data, (GDestroyNotify)verifyDataFree);
+
+	g_thread_pool_push(self->pool, task, NULL);
+}
+
+static GTlsCertificateFlags ogio_caching_tls_database_verify_chain_finish(GTlsDatabase* database, GAsyncResult* result, GError** error)
+{
+	g_return_val_if_fail(g_task_is_valid(result, database), G_TLS_CERTIFICATE_GENERIC_ERROR);
+
+	GError* localError = NULL;
+	gssize returnValue = g_task_propagate_int(G_TASK(result), &localError);
+
+	if (localError != NULL) {
+		g_propagate_error(error, localError);
+		return G_TLS_CERTIFICATE_GENERIC_ERROR;
+	}
+
+	return (GTlsCertificateFlags)returnValue;
+}
+
+static gchar* ogio_caching_tls_database_create_certificate_handle(GTlsDatabase* database, GTlsCertificate* certificate)
+{
+	return g_tls_database_create_certificate_handle(OGIO_CACHING_TLS_DATABASE(database)->base, certificate);
+}
+
+static GTlsCertificate* ogio_caching_tls_database_lookup_certificate_for_handle(GTlsDatabase* database, const gchar* handle, GTlsInteraction* interaction, GTlsDatabaseLookupFlags flags, GCancellable* cancellable, GError** error)
+{
+	return g_tls_database_lookup_certificate_for_handle(OGIO_CACHING_TLS_DATABASE(database)->base, handle, interaction, flags, cancellable, error);
+}
+
+static GTlsCertificate* ogio_caching_tls_database_lookup_certificate_issuer(GTlsDatabase* database, GTlsCertificate* certificate, GTlsInteraction* interaction, GTlsDatabaseLookupFlags flags, GCancellable* cancellable, GError** error)
+{
+	return g_tls_database_lookup_certificate_issuer(OGIO_CACHING_TLS_DATABASE(database)->base, certificate, interaction, flags, cancellable, error);
+}
+
+static GList* ogio_caching_tls_database_lookup_certificates_issued_by(GTlsDatabase* database, GByteArray* issuerRawDn, GTlsInteraction* interaction, GTlsDatabaseLookupFlags flags, GCancellable* cancellable, GError** error)
+{
+	return g_tls_database_lookup_certificates_issued_by(OGIO_CACHING_TLS_DATABASE(database)->base, issuerRawDn, interaction, flags, cancellable, error);
+}
+
+static void ogio_caching_tls_database_finalize(GObject* object)
+{
+	OGioCachingTlsDatabase* self = OGIO_CACHING_TLS_DATABASE(object);
+
+	/* Queued tasks hold a reference, so the pool is idle by now. */
+	if (self->pool != NULL)
+		g_thread_pool_free(self->pool, TRUE, FALSE);
+
+	g_clear_object(&self->base);
+	g_hash_table_destroy(self->entries);
+	g_queue_clear_full(&self->lru, (GDestroyNotify)cacheEntryFree);
+	g_mutex_clear(&self->mutex);
+
+	G_OBJECT_CLASS(ogio_caching_tls_database_parent_class)->finalize(object);
+}
+
+static void ogio_caching_tls_database_init(OGioCachingTlsDatabase* self)
+{
+	g_mutex_init(&self->mutex);
+	g_queue_init(&self->lru);
+	self->entries = g_hash_table_new(g_str_hash, g_str_equal);
+}
+
+static void ogio_caching_tls_database_class_init(OGioCachingTlsDatabaseClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GTlsDatabaseClass* databaseClass = G_TLS_DATABASE_CLASS(klass);
+
+	objectClass->finalize = ogio_caching_tls_database_finalize;
+
+	databaseClass->verify_chain = ogio_caching_tls_database_verify_chain;
+	databaseClass->verify_chain_async = ogio_caching_tls_database_verify_chain_async;
+	databaseClass->verify_chain_finish = ogio_caching_tls_database_verify_chain_finish;
+	databaseClass->create_certificate_handle = ogio_caching_tls_database_create_certificate_handle;
+	databaseClass->lookup_certificate_for_handle = ogio_caching_tls_database_lookup_certificate_for_handle;
+	databaseClass->lookup_certificate_issuer = ogio_caching_tls_database_lookup_certificate_issuer;
+	databaseClass->lookup_certificates_issued_by = ogio_caching_tls_database_lookup_certificates_issued_by;
+}
+
+GTlsDatabase* ogio_caching_tls_database_new(GTlsDatabase* baseDatabase, guint capacity, gint64 maxAge, guint maxThreads)
+{
+	g_return_val_if_fail(G_IS_TLS_DATABASE(baseDatabase), NULL);
+	g_return_val_if_fail(capacity > 0, NULL);
+	g_return_val_if_fail(maxAge >= 0, NULL);
+	g_return_val_if_fail(maxThreads > 0, NULL);
+
+	OGioCachingTlsDatabase* self = g_object_new(OGIO_TYPE_CACHING_TLS_DATABASE, NULL);
+	self->base = g_object_ref(baseDatabase);
+	self->capacity = capacity;
+	self->maxAge = maxAge;
+	self->pool = g_thread_pool_new(verifyWorker, NULL, (gint)maxThreads, FALSE, NULL);
+
+	return G_TLS_DATABASE(self);
+}
+
+GTlsDatabase* ogio_caching_tls_database_get_base_database(OGioCachingTlsDatabase* database)
+{
+	g_return_val_if_fail(OGIO_IS_CACHING_TLS_DATABASE(database), NULL);
+
+	return database->base;
+}
+
+guint ogio_caching_tls_database_get_count(OGioCachingTlsDatabase* database)
+{
+	g_return_val_if_fail(OGIO_IS_CACHING_TLS_DATABASE(database), 0);
+
+	g_mutex_lock(&database->mutex);
+	guint count = database->lru.length;
+	g_mutex_unlock(&database->mutex);
+
+	return count;
+}
+
+void ogio_caching_tls_database_get_statistics(OGioCachingTlsDatabase* database, OGCachingTlsDatabaseStatistics* statistics)
+{
+	g_return_if_fail(OGIO_IS_CACHING_TLS_DATABASE(database));
+
+	g_mutex_lock(&database->mutex);
+	*statistics = database->statistics;
+	g_mutex_unlock(&database->mutex);
+}
+
+void ogio_caching_tls_database_clear(OGioCachingTlsDatabase* database)
+{
+	g_return_if_fail(OGIO_IS_CACHING_TLS_DATABASE(database));
+
+	g_mutex_lock(&database->mutex);
+	g_hash_table_remove_all(database->entries);
+	g_queue_clear_full(&database->lru, (GDestroyNotify)cacheEntryFree);
+	g_queue_init(&database->lru);
+	g_mutex_unlock(&database->mutex);
+}
+
+@implementation OGCachingTlsDatabase
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_CACHING_TLS_DATABASE;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_CACHING_TLS_DATABASE);
+	return gObjectClass;
+}
+
++ (instancetype)cachingTlsDatabaseWithBaseDatabase:(OGTlsDatabase*)baseDatabase capacity:(guint)capacity maxAge:(gint64)maxAge maxThreads:(guint)maxThreads
+{
+	if (baseDatabase == nil || capacity == 0 || maxAge < 0 || maxThreads == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioCachingTlsDatabase* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_caching_tls_database_new([baseDatabase castedGObject], capacity, maxAge, maxThreads), OGIO_TYPE_CACHING_TLS_DATABASE, OGioCachingTlsDatabase);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGCachingTlsDatabase* wrapperObject;
+	@try {
+		wrapperObject = [[OGCachingTlsDatabase alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioCachingTlsDatabase*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_CACHING_TLS_DATABASE, OGioCachingTlsDatabase);
+}
+
+- (OGTlsDatabase*)baseDatabase
+{
+	GTlsDatabase* gobjectValue = ogio_caching_tls_database_get_base_database((OGioCachingTlsDatabase*)[self castedGObject]);
+
+	OGTlsDatabase* returnValue = OGWrapperClassAndObjectForGObject(gobjectValue);
+	return returnValue;
+}
+
+- (guint)count
+{
+	guint returnValue = (guint)ogio_caching_tls_database_get_count((OGioCachingTlsDatabase*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (OGCachingTlsDatabaseStatistics)statistics
+{
+	OGCachingTlsDatabaseStatistics returnValue;
+
+	ogio_caching_tls_database_get_statistics((OGioCachingTlsDatabase*)[self castedGObject], &returnValue);
+
+	return returnValue;
+}
+
+- (void)clear
+{
+	ogio_caching_tls_database_clear((OGioCachingTlsDatabase*)[self castedGObject]);
+}
+
+@end
@@ -0,0 +1,168 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Creates the item for a lazily added position of an
+ * #OGioChunkedListStore from the key it was added with.
+ *
+ * Returns: (transfer full): the item, an instance of the item type of the
+ * store
+ */
+typedef GObject* (*OGioChunkedListStoreFactory)(gpointer key, gpointer userData);
+
+#define OGIO_TYPE_CHUNKED_LIST_STORE (ogio_chunked_list_store_get_type())
+G_DECLARE_FINAL_TYPE(OGioChunkedListStore, ogio_chunked_list_store, OGIO, CHUNKED_LIST_STORE, GObject)
+
+OGioChunkedListStore* ogio_chunked_list_store_new(GType itemType);
+void ogio_chunked_list_store_set_factory(OGioChunkedListStore* store, OGioChunkedListStoreFactory factory, gpointer userData, GDestroyNotify keyDestroy);
+void ogio_chunked_list_store_append(OGioChunkedListStore* store, gpointer item);
+void ogio_chunked_list_store_insert(OGioChunkedListStore* store, guint position, gpointer item);
+void ogio_chunked_list_store_remove(OGioChunkedListStore* store, guint position);
+void ogio_chunked_list_store_remove_all(OGioChunkedListStore* store);
+void ogio_chunked_list_store_splice(OGioChunkedListStore* store, guint position, guint nRemovals, gpointer* additions, guint nAdditions);
+void ogio_chunked_list_store_splice_lazy(OGioChunkedListStore* store, guint position, guint nRemovals, gpointer* keys, guint nKeys);
+gboolean ogio_chunked_list_store_is_materialized(OGioChunkedListStore* store, guint position);
+void ogio_chunked_list_store_begin_batch(OGioChunkedListStore* store);
+void ogio_chunked_list_store_end_batch(OGioChunkedListStore* store);
+
+G_END_DECLS
+
+/**
+ * `OGChunkedListStore` is a [iface@Gio.ListModel] like #OGListStore, built
+ * for very large lists.
+ *
+ * The items are kept in chunks of up to 256 positions, which form a
+ * balanced tree indexed by position. Looking up, inserting or removing an
+ * item anywhere in the list therefore takes logarithmic time, where
+ * #OGListStore moves all following items. Consecutive lookups within the
+ * same chunk, as done when a view scrolls, skip the tree.
+ *
+ * Mutations between -beginBatch and -endBatch are coalesced into a single
+ * #GListModel::items-changed emission spanning all touched positions, so
+ * filling the store one item at a time no longer emits a signal per item.
+ *
+ * Positions can also be added lazily, with a key instead of an item. The
+ * item is created by the factory set with -setFactory:userData:keyDestroy:
+ * when it is first requested, after which the key is released. The factory
+ * must never return %NULL.
+ *
+ */
+@interface OGChunkedListStore : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)chunkedListStoreWithItemType:(GType)itemType;
+
+/**
+ * Methods
+ */
+
+- (OGioChunkedListStore*)castedGObject;
+
+/**
+ * Sets the function creating the items of lazily added positions. The
+ * factory must return a new reference to an item and never %NULL.
+ *
+ * @param factory the item factory
+ * @param userData user data for @factory
+ * @param keyDestroy function to release keys once their item exists or
+ * their position is removed, or %NULL
+ */
+- (void)setFactory:(OGioChunkedListStoreFactory)factory userData:(gpointer)userData keyDestroy:(GDestroyNotify)keyDestroy;
+
+/**
+ * Appends @item to the store.
+ *
+ * @param item the new item
+ */
+- (void)appendWithItem:(gpointer)item;
+
+/**
+ * Inserts @item at @position.
+ *
+ * @param position the position at which to insert the new item
+ * @param item the new item
+ */
+- (void)insertWithPosition:(guint)position item:(gpointer)item;
+
+/**
+ * Removes the item at @position.
+ *
+ * @param position the position of the item that is to be removed
+ */
+- (void)removeWithPosition:(guint)position;
+
+/**
+ * Removes all items from the store.
+ */
+- (void)removeAll;
+
+/**
+ * Removes @nremovals items at @position and inserts @nadditions items in
+ * their place, emitting a single change.
+ *
+ * @param position the position at which to make the change
+ * @param nremovals the number of items to remove
+ * @param additions the items to add
+ * @param nadditions the number of items to add
+ */
+- (void)spliceWithPosition:(guint)position nremovals:(guint)nremovals additions:(gpointer*)additions nadditions:(guint)nadditions;
+
+/**
+ * Like -spliceWithPosition:nremovals:additions:nadditions:, but adds
+ * positions whose items are created from @keys on first access.
+ *
+ * @param position the position at which to make the change
+ * @param nremovals the number of items to remove
+ * @param keys the keys passed to the factory
+ * @param nkeys the number of positions to add
+ */
+- (void)spliceLazyWithPosition:(guint)position nremovals:(guint)nremovals keys:(gpointer*)keys nkeys:(guint)nkeys;
+
+/**
+ * Returns whether the item at @position has been created.
+ *
+ * @param position a position in the store
+ * @return whether the item exists
+ */
+- (bool)isMaterializedWithPosition:(guint)position;
+
+/**
+ * Starts collecting changes into one #GListModel::items-changed emission.
+ * Batches nest.
+ */
+- (void)beginBatch;
+
+/**
+ * Ends a batch started with -beginBatch and, if it was the outermost one,
+ * emits the collected change.
+ */
+- (void)endBatch;
+
+@end
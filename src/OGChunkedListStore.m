@@ -0,0 +1,570 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGChunkedListStore.h"
+
+#include <string.h>
+
+#define CHUNK_CAPACITY 256
+
+typedef struct {
+	GObject* item;
+	gpointer key;
+} Slot;
+
+/*
+ * The chunks form a treap ordered by position, in which every node also
+ * knows the number of items in its subtree.
+ */
+typedef struct _Chunk Chunk;
+struct _Chunk {
+	Chunk* left;
+	Chunk* right;
+	guint32 priority;
+	guint count;
+	guint total;
+	Slot slots[CHUNK_CAPACITY];
+};
+
+struct _OGioChunkedListStore {
+	GObject parent_instance;
+
+	GType itemType;
+	Chunk* root;
+	GRand* rand;
+
+	OGioChunkedListStoreFactory factory;
+	gpointer factoryData;
+	GDestroyNotify keyDestroy;
+
+	Chunk* cachedChunk;
+	guint cachedStart;
+
+	guint batchDepth;
+	gboolean batchPending;
+	guint batchStart;
+	guint batchOldEnd;
+	guint batchNewEnd;
+};
+
+static void ogio_chunked_list_store_list_model_init(GListModelInterface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioChunkedListStore, ogio_chunked_list_store, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, ogio_chunked_list_store_list_model_init))
+
+static inline guint chunkTotal(Chunk* chunk)
+{
+	return (chunk != NULL ? chunk->total : 0);
+}
+
+static void chunkUpdate(Chunk* chunk)
+{
+	chunk->total = chunkTotal(chunk->left) + chunk->count + chunkTotal(chunk->right);
+}
+
+static Chunk* chunkNew(OGioChunkedListStore* self)
+{
+	Chunk* chunk = g_malloc(sizeof(Chunk));
+
+	chunk->left = chunk->right = NULL;
+	chunk->priority = g_rand_int(self->rand);
+	chunk->count = chunk->total = 0;
+
+	return chunk;
+}
+
+static void clearSlot(OGioChunkedListStore* self, Slot* slot)
+{
+	if (slot->item != NULL)
+		g_object_unref(slot->item);
+	else if (slot->key != NULL && self->keyDestroy != NULL)
+		self->keyDestroy(slot->key);
+}
+
+static void freeTree(OGioChunkedListStore* self, Chunk* chunk)
+{
+	if (chunk == NULL)
+		return;
+
+	freeTree(self, chunk->left);
+	freeTree(self, chunk->right);
+
+	for (guint i = 0; i < chunk->count; i++)
+		clearSlot(self, &chunk->slots[i]);
+
+	g_free(chunk);
+}
+
+static Chunk* merge(Chunk* a, Chunk* b)
+{
+	if (a == NULL)
+		return b;
+
+	if (b == NULL)
+		return a;
+
+	if (a->priority > b->priority) {
+		a->right = merge(a->right, b);
+		chunkUpdate(a);
+		return a;
+	}
+
+	b->left = merge(a, b->left);
+	chunkUpdate(b);
+	return b;
+}
+
+/* Splits @tree before position @k, which must be a chunk boundary. */
+static void split(Chunk* tree, guint k, Chunk** left, Chunk** right)
+{
+	if (tree == NULL) {
+		*left = *right = NULL;
+		return;
+	}
+
+	guint leftTotal = chunkTotal(tree->left);
+
+	if (k <= leftTotal) {
+		split(tree->left, k, left, &tree->left);
+		chunkUpdate(tree);
+		*right = tree;
+	} else {
+		split(tree->right, k - leftTotal - tree->count, &tree->right, right);
+		chunkUpdate(tree);
+		*left = tree;
+	}
+}
+
+static Chunk* lookup(Chunk* tree, guint position, guint* start)
+{
+	guint base = 0;
+
+	while (tree != NULL) {
+		guint leftTotal = chunkTotal(tree->left);
+
+		if (position < leftTotal) {
+			tree = tree->left;
+		} else if (position < leftTotal + tree->count) {
+			*start = base + leftTotal;
+			return tree;
+		} else {
+			position -= leftTotal + tree->count;
+			base += leftTotal + tree->count;
+			tree = tree->right;
+		}
+	}
+
+	return NULL;
+}
+
+/* Splits the chunk containing @position so that a chunk starts there. */
+static void ensureBoundary(OGioChunkedListStore* self, guint position)
+{
+	Chunk *left, *right, *middle, *tail;
+	Chunk* chunk;
+	guint start;
+
+	if (position == 0 || position >= chunkTotal(self->root))
+		return;
+
+	chunk = lookup(self->root, position, &start);
+	if (position == start)
+		return;
+
+	split(self->root, start, &left, &right);
+	split(right, chunk->count, &middle, &right);
+
+	tail = chunkNew(self);
+	tail->count = chunk->count - (position - start);
+	memcpy(tail->slots, chunk->slots + (position - start), tail->count * sizeof(Slot));
+	chunkUpdate(tail);
+
+	chunk->count = position - start;
+	chunkUpdate(chunk);
+
+	self->root = merge(merge(left, merge(middle, tail)), right);
+}
+
+/* Joins the chunks on both sides of @position if they fit into one. */
+static void coalesceAt(OGioChunkedListStore* self, guint position)
+{
+	Chunk *left, *rest, *first, *second, *right;
+	Chunk *before, *after;
+	guint beforeStart, afterStart;
+
+	if (position == 0 || position >= chunkTotal(self->root))
+		return;
+
+	before = lookup(self->root, position - 1, &beforeStart);
+	after = lookup(self->root, position, &afterStart);
+
+	if (before == after || before->count + after->count > CHUNK_CAPACITY)
+		return;
+
+	split(self->root, beforeStart, &left, &rest);
+	split(rest, before->count, &first, &rest);
+	split(rest, after->count, &second, &right);
+
+	memcpy(first->slots + first->count, second->slots, second->count * sizeof(Slot));
+	first->count += second->count;
+	chunkUpdate(first);
+	g_free(second);
+
+	self->root = merge(merge(left, first), right);
+}
+
+static void emitChange(OGioChunkedListStore* self, guint position, guint removed, guint added)
+{
+	if (removed == 0 && added == 0)
+		return;
+
+	if (self->batchDepth > 0) {
+		if (!self->batchPending) {
+			self->batchPending = TRUE;
+			self->batchStart = position;
+			self->batchOldEnd = position + removed;
+			self->batchNewEnd = position + added;
+			return;
+		}
+
+		/* Grow the dirty range to cover this change; everything after it
+		 * maps one-to-one onto the list before the batch. */
+		guint end = MAX(self->batchNewEnd, position + removed);
+
+		self->batchOldEnd += end - self->batchNewEnd;
+		self->batchNewEnd = end - removed + added;
+		self->batchStart = MIN(self->batchStart, position);
+		return;
+	}
+
+	g_list_model_items_changed(G_LIST_MODEL(self), position, removed, added);
+}
+
+static void spliceSlots(OGioChunkedListStore* self, guint position, guint nRemovals, const Slot* additions, guint nAdditions)
+{
+	Chunk *left, *middle, *right;
+	Chunk* inserted = NULL;
+
+	ensureBoundary(self, position);
+	ensureBoundary(self, position + nRemovals);
+
+	split(self->root, position, &left, &right);
+	split(right, nRemovals, &middle, &right);
+	freeTree(self, middle);
+
+	for (guint i = 0; i < nAdditions; i += CHUNK_CAPACITY) {
+		Chunk* chunk = chunkNew(self);
+
+		chunk->count = MIN(CHUNK_CAPACITY, nAdditions - i);
+		memcpy(chunk->slots, additions + i, chunk->count * sizeof(Slot));
+		chunkUpdate(chunk);
+
+		inserted = merge(inserted, chunk);
+	}
+
+	self->root = merge(merge(left, inserted), right);
+
+	coalesceAt(self, position + nAdditions);
+	coalesceAt(self, position);
+
+	self->cachedChunk = NULL;
+
+	emitChange(self, position, nRemovals, nAdditions);
+}
+
+static GType ogio_chunked_list_store_get_item_type(GListModel* model)
+{
+	return OGIO_CHUNKED_LIST_STORE(model)->itemType;
+}
+
+static guint ogio_chunked_list_store_get_n_items(GListModel* model)
+{
+	return chunkTotal(OGIO_CHUNKED_LIST_STORE(model)->root);
+}
+
+static gpointer ogio_chunked_list_store_get_item(GListModel* model, guint position)
+{
+	OGioChunkedListStore* self = OGIO_CHUNKED_LIST_STORE(model);
+	Chunk* chunk = self->cachedChunk;
+	guint start = self->cachedStart;
+	Slot* slot;
+
+	if (position >= chunkTotal(self->root))
+		return NULL;
+
+	if (chunk == NULL || position < start || position >= start + chunk->count) {
+		chunk = lookup(self->root, position, &start);
+		self->cachedChunk = chunk;
+		self->cachedStart = start;
+	}
+
+	slot = &chunk->slots[position - start];
+
+	if (slot->item == NULL) {
+		slot->item = self->factory(slot->key, self->factoryData);
+
+		/* A position below the item count must have an item. */
+		g_return_val_if_fail(slot->item != NULL, NULL);
+
+		if (slot->key != NULL && self->keyDestroy != NULL)
+			self->keyDestroy(slot->key);
+
+		slot->key = NULL;
+	}
+
+	return g_object_ref(slot->item);
+}
+
+static void ogio_chunked_list_store_list_model_init(GListModelInterface* iface)
+{
+	iface->get_item_type = ogio_chunked_list_store_get_item_type;
+	iface->get_n_items = ogio_chunked_list_store_get_n_items;
+	iface->get_item = ogio_chunked_list_store_get_item;
+}
+
+static void ogio_chunked_list_store_init(OGioChunkedListStore* self)
+{
+	self->rand = g_rand_new();
+}
+
+static void ogio_chunked_list_store_finalize(GObject* object)
+{
+	OGioChunkedListStore* self = OGIO_CHUNKED_LIST_STORE(object);
+
+	freeTree(self, self->root);
+	g_rand_free(self->rand);
+
+	G_OBJECT_CLASS(ogio_chunked_list_store_parent_class)->finalize(object);
+}
+
+static void ogio_chunked_list_store_class_init(OGioChunkedListStoreClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_chunked_list_store_finalize;
+}
+
+OGioChunkedListStore* ogio_chunked_list_store_new(GType itemType)
+{
+	g_return_val_if_fail(g_type_is_a(itemType, G_TYPE_OBJECT), NULL);
+
+	OGioChunkedListStore* self = g_object_new(OGIO_TYPE_CHUNKED_LIST_STORE, NULL);
+
+	self->itemType = itemType;
+
+	return self;
+}
+
+void ogio_chunked_list_store_set_factory(OGioChunkedListStore* store, OGioChunkedListStoreFactory factory, gpointer userData, GDestroyNotify keyDestroy)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+
+	store->factory = factory;
+	store->factoryData = userData;
+	store->keyDestroy = keyDestroy;
+}
+
+void ogio_chunked_list_store_splice(OGioChunkedListStore* store, guint position, guint nRemovals, gpointer* additions, guint nAdditions)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+	g_return_if_fail(position <= chunkTotal(store->root) && nRemovals <= chunkTotal(store->root) - position);
+	g_return_if_fail(additions != NULL || nAdditions == 0);
+
+	for (guint i = 0; i < nAdditions; i++)
+		g_return_if_fail(g_type_is_a(G_OBJECT_TYPE(additions[i]), store->itemType));
+
+	Slot* slots = g_new(Slot, nAdditions);
+
+	for (guint i = 0; i < nAdditions; i++) {
+		slots[i].item = g_object_ref(additions[i]);
+		slots[i].key = NULL;
+	}
+
+	spliceSlots(store, position, nRemovals, slots, nAdditions);
+
+	g_free(slots);
+}
+
+void ogio_chunked_list_store_splice_lazy(OGioChunkedListStore* store, guint position, guint nRemovals, gpointer* keys, guint nKeys)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+	g_return_if_fail(store->factory != NULL);
+	g_return_if_fail(position <= chunkTotal(store->root) && nRemovals <= chunkTotal(store->root) - position);
+	g_return_if_fail(keys != NULL || nKeys == 0);
+
+	Slot* slots = g_new(Slot, nKeys);
+
+	for (guint i = 0; i < nKeys; i++) {
+		slots[i].item = NULL;
+		slots[i].key = keys[i];
+	}
+
+	spliceSlots(store, position, nRemovals, slots, nKeys);
+
+	g_free(slots);
+}
+
+void ogio_chunked_list_store_append(OGioChunkedListStore* store, gpointer item)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+
+	ogio_chunked_list_store_splice(store, chunkTotal(store->root), 0, &item, 1);
+}
+
+void ogio_chunked_list_store_insert(OGioChunkedListStore* store, guint position, gpointer item)
+{
+	ogio_chunked_list_store_splice(store, position, 0, &item, 1);
+}
+
+void ogio_chunked_list_store_remove(OGioChunkedListStore* store, guint position)
+{
+	ogio_chunked_list_store_splice(store, position, 1, NULL, 0);
+}
+
+void ogio_chunked_list_store_remove_all(OGioChunkedListStore* store)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+
+	guint n = chunkTotal(store->root);
+
+	freeTree(store, store->root);
+	store->root = NULL;
+	store->cachedChunk = NULL;
+
+	emitChange(store, 0, n, 0);
+}
+
+gboolean ogio_chunked_list_store_is_materialized(OGioChunkedListStore* store, guint position)
+{
+	g_return_val_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store), FALSE);
+	g_return_val_if_fail(position < chunkTotal(store->root), FALSE);
+
+	guint start;
+	Chunk* chunk = lookup(store->root, position, &start);
+
+	return (chunk->slots[position - start].item != NULL);
+}
+
+void ogio_chunked_list_store_begin_batch(OGioChunkedListStore* store)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+
+	store->batchDepth++;
+}
+
+void ogio_chunked_list_store_end_batch(OGioChunkedListStore* store)
+{
+	g_return_if_fail(OGIO_IS_CHUNKED_LIST_STORE(store));
+	g_return_if_fail(store->batchDepth > 0);
+
+	if (--store->batchDepth > 0 || !store->batchPending)
+		return;
+
+	store->batchPending = FALSE;
+	emitChange(store, store->batchStart, store->batchOldEnd - store->batchStart, store->batchNewEnd - store->batchStart);
+}
+
+@implementation OGChunkedListStore
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_CHUNKED_LIST_STORE;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_CHUNKED_LIST_STORE);
+	return gObjectClass;
+}
+
++ (instancetype)chunkedListStoreWithItemType:(GType)itemType
+{
+	OGioChunkedListStore* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_chunked_list_store_new(itemType), OGIO_TYPE_CHUNKED_LIST_STORE, OGioChunkedListStore);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGChunkedListStore* wrapperObject;
+	@try {
+		wrapperObject = [[OGChunkedListStore alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioChunkedListStore*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_CHUNKED_LIST_STORE, OGioChunkedListStore);
+}
+
+- (void)setFactory:(OGioChunkedListStoreFactory)factory userData:(gpointer)userData keyDestroy:(GDestroyNotify)keyDestroy
+{
+	ogio_chunked_list_store_set_factory((OGioChunkedListStore*)[self castedGObject], factory, userData, keyDestroy);
+}
+
+- (void)appendWithItem:(gpointer)item
+{
+	ogio_chunked_list_store_append((OGioChunkedListStore*)[self castedGObject], item);
+}
+
+- (void)insertWithPosition:(guint)position item:(gpointer)item
+{
+	ogio_chunked_list_store_insert((OGioChunkedListStore*)[self castedGObject], position, item);
+}
+
+- (void)removeWithPosition:(guint)position
+{
+	ogio_chunked_list_store_remove((OGioChunkedListStore*)[self castedGObject], position);
+}
+
+- (void)removeAll
+{
+	ogio_chunked_list_store_remove_all((OGioChunkedListStore*)[self castedGObject]);
+}
+
+- (void)spliceWithPosition:(guint)position nremovals:(guint)nremovals additions:(gpointer*)additions nadditions:(guint)nadditions
+{
+	ogio_chunked_list_store_splice((OGioChunkedListStore*)[self castedGObject], position, nremovals, additions, nadditions);
+}
+
+- (void)spliceLazyWithPosition:(guint)position nremovals:(guint)nremovals keys:(gpointer*)keys nkeys:(guint)nkeys
+{
+	ogio_chunked_list_store_splice_lazy((OGioChunkedListStore*)[self castedGObject], position, nremovals, keys, nkeys);
+}
+
+- (bool)isMaterializedWithPosition:(guint)position
+{
+	bool returnValue = (bool)ogio_chunked_list_store_is_materialized((OGioChunkedListStore*)[self castedGObject], position);
+
+	return returnValue;
+}
+
+- (void)beginBatch
+{
+	ogio_chunked_list_store_begin_batch((OGioChunkedListStore*)[self castedGObject]);
+}
+
+- (void)endBatch
+{
+	ogio_chunked_list_store_end_batch((OGioChunkedListStore*)[self castedGObject]);
+}
+
+@end
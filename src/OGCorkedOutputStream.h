@@ -0,0 +1,138 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterOutputStream.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_CORKED_OUTPUT_STREAM (ogio_corked_output_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioCorkedOutputStream, ogio_corked_output_stream, OGIO, CORKED_OUTPUT_STREAM, GFilterOutputStream)
+
+/**
+ * Counters collected by an #OGioCorkedOutputStream.
+ */
+typedef struct {
+	/** Number of writes accepted by the stream */
+	guint64 writes;
+	/** Number of writev() calls issued to the base stream */
+	guint64 flushes;
+	/** Number of bytes passed on to the base stream */
+	guint64 bytesFlushed;
+} OGCorkedOutputStreamStatistics;
+
+GOutputStream* ogio_corked_output_stream_new(GOutputStream* baseStream, gsize flushThreshold, guint flushDelay);
+gboolean ogio_corked_output_stream_append_bytes(OGioCorkedOutputStream* stream, GBytes* bytes, GCancellable* cancellable, GError** error);
+gsize ogio_corked_output_stream_get_pending_size(OGioCorkedOutputStream* stream);
+gsize ogio_corked_output_stream_get_flush_threshold(OGioCorkedOutputStream* stream);
+void ogio_corked_output_stream_set_flush_threshold(OGioCorkedOutputStream* stream, gsize flushThreshold);
+guint ogio_corked_output_stream_get_flush_delay(OGioCorkedOutputStream* stream);
+void ogio_corked_output_stream_set_flush_delay(OGioCorkedOutputStream* stream, guint flushDelay);
+void ogio_corked_output_stream_get_statistics(OGioCorkedOutputStream* stream, OGCorkedOutputStreamStatistics* statistics);
+
+G_END_DECLS
+
+/**
+ * `OGCorkedOutputStream` is a filter output stream that collects many small
+ * writes and hands them to its base stream as a single
+ * g_output_stream_writev_all() call.
+ *
+ * Writes smaller than a few hundred bytes are copied into shared chunks so
+ * that adjacent fields end up in one vector; larger writes are referenced
+ * in place and flush the stream before the write returns, so they are
+ * never copied. #GBytes added with -appendBytes: are kept by reference until
+ * they are written. Pending data is written once it reaches the flush
+ * threshold, when the flush delay expires, on -[OGOutputStream flushWithCancellable:]
+ * and on close.
+ *
+ * Stacking an #OGDataOutputStream on top of a corked stream turns a
+ * message made of many `put` calls into one system call.
+ *
+ * The flush delay is handled by a timeout in the thread-default main
+ * context that was current when the stream was created. Errors from a
+ * delayed flush are reported by the next operation on the stream.
+ *
+ */
+@interface OGCorkedOutputStream : OGFilterOutputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)corkedOutputStreamWithBaseStream:(OGOutputStream*)baseStream flushThreshold:(gsize)flushThreshold flushDelay:(guint)flushDelay;
+
+/**
+ * Methods
+ */
+
+- (OGioCorkedOutputStream*)castedGObject;
+
+/**
+ * Queues @bytes for writing without copying them. A reference on @bytes is
+ * held until it has been written to the base stream.
+ *
+ * @param bytes the data to write
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE on success
+ */
+- (bool)appendBytes:(GBytes*)bytes cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Gets the number of bytes waiting to be written to the base stream.
+ *
+ * @return the number of pending bytes
+ */
+- (gsize)pendingSize;
+
+/**
+ * Gets the number of pending bytes at which the stream writes to its base
+ * stream.
+ *
+ * @return the flush threshold in bytes
+ */
+- (gsize)flushThreshold;
+
+/**
+ * Sets the number of pending bytes at which the stream writes to its base
+ * stream.
+ *
+ * @param flushThreshold the flush threshold in bytes, must not be 0
+ */
+- (void)setFlushThreshold:(gsize)flushThreshold;
+
+/**
+ * Gets the time after which pending data is written even if the flush
+ * threshold has not been reached.
+ *
+ * @return the flush delay in milliseconds, or 0 if there is none
+ */
+- (guint)flushDelay;
+
+/**
+ * Sets the time after which pending data is written even if the flush
+ * threshold has not been reached.
+ *
+ * @param flushDelay the flush delay in milliseconds, or 0 to only write on
+ *     the threshold or explicit flushes
+ */
+- (void)setFlushDelay:(guint)flushDelay;
+
+/**
+ * Returns a snapshot of the counters collected by the stream.
+ *
+ * @return the current statistics
+ */
+- (OGCorkedOutputStreamStatistics)statistics;
+
+@end
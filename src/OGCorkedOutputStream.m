@@ -0,0 +1,513 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGCorkedOutputStream.h"
+
+#import "OGCancellable.h"
+
+#define CHUNK_SIZE (16 * 1024)
+#define COPY_THRESHOLD 512
+
+struct _OGioCorkedOutputStream {
+	GFilterOutputStream parent_instance;
+
+	GMutex mutex;
+	GArray* vectors;
+	GPtrArray* bytes;
+	GPtrArray* chunks;
+	guint8* chunk;
+	gsize chunkUsed;
+	gsize pending;
+
+	gsize flushThreshold;
+	guint flushDelay;
+	GMainContext* context;
+	GSource* timer;
+	GError* deferredError;
+
+	OGCorkedOutputStreamStatistics statistics;
+};
+
+G_DEFINE_FINAL_TYPE(OGioCorkedOutputStream, ogio_corked_output_stream, G_TYPE_FILTER_OUTPUT_STREAM)
+
+static gboolean flushLocked(OGioCorkedOutputStream* self, GCancellable* cancellable, GError** error);
+
+static void appendVector(OGioCorkedOutputStream* self, const void* buffer, gsize size)
+{
+	if (self->vectors->len > 0) {
+		GOutputVector* last = &g_array_index(self->vectors, GOutputVector, self->vectors->len - 1);
+
+		if ((const guint8*)last->buffer + last->size == (const guint8*)buffer) {
+			last->size += size;
+			self->pending += size;
+			return;
+		}
+	}
+
+	GOutputVector vector = { buffer, size };
+	g_array_append_val(self->vectors, vector);
+	self->pending += size;
+}
+
+static void appendCopy(OGioCorkedOutputStream* self, const void* buffer, gsize size)
+{
+	if (self->chunk == NULL || CHUNK_SIZE - self->chunkUsed < size) {
+		self->chunk = g_malloc(CHUNK_SIZE);
+		self->chunkUsed = 0;
+		g_ptr_array_add(self->chunks, self->chunk);
+	}
+
+	guint8* destination = self->chunk + self->chunkUsed;
+	memcpy(destination, buffer, size);
+	self->chunkUsed += size;
+
+	appendVector(self, destination, size);
+}
+
+static gboolean flushTimeout(gpointer userData)
+{
+	OGioCorkedOutputStream* self = userData;
+
+	g_mutex_lock(&self->mutex);
+
+	g_clear_pointer(&self->timer, g_source_unref);
+
+	if (self->deferredError == NULL && !g_output_stream_is_closed(G_OUTPUT_STREAM(self)))
+		flushLocked(self, NULL, &self->deferredError);
+
+	g_mutex_unlock(&self->mutex);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void armTimer(OGioCorkedOutputStream* self)
+{
+	if (self->flushDelay == 0 || self->timer != NULL)
+		return;
+
+	self->timer = g_timeout_source_new(self->flushDelay);
+	g_source_set_callback(self->timer, flushTimeout, g_object_ref(self), g_object_unref);
+	g_source_attach(self->timer, self->context);
+}
+
+static void disarmTimer(OGioCorkedOutputStream* self)
+{
+	if (self->timer == NULL)
+		return;
+
+	g_source_destroy(self->timer);
+	g_clear_pointer(&self->timer, g_source_unref);
+}
+
+static void releasePending(OGioCorkedOutputStream* self)
+{
+	g_array_set_size(self->vectors, 0);
+	g_ptr_array_set_size(self->bytes, 0);
+	g_ptr_array_set_size(self->chunks, 0);
+	self->chunk = NULL;
+	self->chunkUsed = 0;
+	self->pending = 0;
+}
+
+static gboolean takeDeferredError(OGioCorkedOutputStream* self, GError** error)
+{
+	if (self->deferredError == NULL)
+		return FALSE;
+
+	g_propagate_error(error, g_steal_pointer(&self->deferredError));
+	return TRUE;
+}
+
+static gboolean flushLocked(OGioCorkedOutputStream* self, GCancellable* cancellable, GError** error)
+{
+	disarmTimer(self);
+
+	if (self->vectors->len == 0)
+		return TRUE;
+
+	GOutputStream* base = g_filter_output_stream_get_base_stream(G_FILTER_OUTPUT_STREAM(self));
+	gsize written = 0;
+
+	gboolean returnValue = g_output_stream_writev_all(base, (GOutputVector*)self->vectors->data, self->vectors->len, &written, cancellable, error);
+
+	self->statistics.flushes++;
+	self->statistics.bytesFlushed += written;
+
+	releasePending(self);
+
+	return returnValue;
+}
+
+/*
+ * Queues @buffer, copying it if it is small. Buffers that are referenced in
+ * place belong to the caller, so they have to be written before returning.
+ */
+static gboolean queueLocked(OGioCorkedOutputStream* self, const void* buffer, gsize size)
+{
+	if (size < COPY_THRESHOLD) {
+		appendCopy(self, buffer, size);
+		return FALSE;
+	}
+
+	appendVector(self, buffer, size);
+	return TRUE;
+}
+
+static gboolean finishQueueLocked(OGioCorkedOutputStream* self, gboolean mustFlush, GCancellable* cancellable, GError** error)
+{
+	if (mustFlush || self->pending >= self->flushThreshold)
+		return flushLocked(self, cancellable, error);
+
+	armTimer(self);
+	return TRUE;
+}
+
+static gssize ogio_corked_output_stream_write(GOutputStream* stream, const void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioCorkedOutputStream* self = OGIO_CORKED_OUTPUT_STREAM(stream);
+	gssize returnValue = -1;
+
+	g_mutex_lock(&self->mutex);
+
+	if (!takeDeferredError(self, error)) {
+		self->statistics.writes++;
+
+		gboolean mustFlush = queueLocked(self, buffer, count);
+
+		if (finishQueueLocked(self, mustFlush, cancellable, error))
+			returnValue = (gssize)count;
+	}
+
+	g_mutex_unlock(&self->mutex);
+
+	return returnValue;
+}
+
+static gboolean ogio_corked_output_stream_writev(GOutputStream* stream, const GOutputVector* vectors, gsize nvectors, gsize* bytesWritten, GCancellable* cancellable, GError** error)
+{
+	OGioCorkedOutputStream* self = OGIO_CORKED_OUTPUT_STREAM(stream);
+	gboolean returnValue = FALSE;
+	gboolean mustFlush = FALSE;
+	gsize total = 0;
+
+	if (bytesWritten != NULL)
+		*bytesWritten = 0;
+
+	g_mutex_lock(&self->mutex);
+
+	if (!takeDeferredError(self, error)) {
+		self->statistics.writes++;
+
+		for (gsize i = 0; i < nvectors; i++) {
+			if (vectors[i].size == 0)
+				continue;
+
+			mustFlush |= queueLocked(self, vectors[i].buffer, vectors[i].size);
+			total += vectors[i].size;
+		}
+
+		returnValue = finishQueueLocked(self, mustFlush, cancellable, error);
+	}
+
+	g_mutex_unlock(&self->mutex);
+
+	if (returnValue && bytesWritten != NULL)
+		*bytesWritten = total;
+
+	return returnValue;
+}
+
+static gboolean ogio_corked_output_stream_flush(GOutputStream* stream, GCancellable* cancellable, GError** error)
+{
+	OGioCorkedOutputStream* self = OGIO_CORKED_OUTPUT_STREAM(stream);
+
+	/* The timer writes to the base stream under the mutex as well, so keep
+	 * holding it until the base stream is flushed. */
+	g_mutex_lock(&self->mutex);
+	gboolean returnValue = !takeDeferredError(self, error) && flushLocked(self, cancellable, error) && g_output_stream_flush(g_filter_output_stream_get_base_stream(G_FILTER_OUTPUT_STREAM(stream)), cancellable, error);
+	g_mutex_unlock(&self->mutex);
+
+	return returnValue;
+}
+
+static gboolean ogio_corked_output_stream_close(GOutputStream* stream, GCancellable* cancellable, GError** error)
+{
+	OGioCorkedOutputStream* self = OGIO_CORKED_OUTPUT_STREAM(stream);
+	GError* localError = NULL;
+
+	g_mutex_lock(&self->mutex);
+	if (!takeDeferredError(self, &localError))
+		flushLocked(self, cancellable, &localError);
+	releasePending(self);
+	g_mutex_unlock(&self->mutex);
+
+	/* Always let the parent close the base stream, but report our error. */
+	gboolean returnValue = G_OUTPUT_STREAM_CLASS(ogio_corked_output_stream_parent_class)->close_fn(stream, cancellable, (localError == NULL) ? error : NULL);
+
+	if (localError != NULL) {
+		g_propagate_error(error, localError);
+		return FALSE;
+	}
+
+	return returnValue;
+}
+
+static void ogio_corked_output_stream_finalize(GObject* object)
+{
+	OGioCorkedOutputStream* self = OGIO_CORKED_OUTPUT_STREAM(object);
+
+	/* A pending timer holds a reference, so there is none left here. */
+	g_array_unref(self->vectors);
+	g_ptr_array_unref(self->bytes);
+	g_ptr_array_unref(self->chunks);
+	g_main_context_unref(self->context);
+	g_clear_error(&self->deferredError);
+	g_mutex_clear(&self->mutex);
+
+	G_OBJECT_CLASS(ogio_corked_output_stream_parent_class)->finalize(object);
+}
+
+static void ogio_corked_output_stream_init(OGioCorkedOutputStream* self)
+{
+	g_mutex_init(&self->mutex);
+	self->vectors = g_array_new(FALSE, FALSE, sizeof(GOutputVector));
+	self->bytes = g_ptr_array_new_with_free_func((GDestroyNotify)g_bytes_unref);
+	self->chunks = g_ptr_array_new_with_free_func(g_free);
+	self->context = g_main_context_ref_thread_default();
+}
+
+static void ogio_corked_output_stream_class_init(OGioCorkedOutputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GOutputStreamClass* streamClass = G_OUTPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_corked_output_stream_finalize;
+
+	streamClass->write_fn = ogio_corked_output_stream_write;
+	streamClass->writev_fn = ogio_corked_output_stream_writev;
+	streamClass->flush = ogio_corked_output_stream_flush;
+	streamClass->close_fn = ogio_corked_output_stream_close;
+}
+
+GOutputStream* ogio_corked_output_stream_new(GOutputStream* baseStream, gsize flushThreshold, guint flushDelay)
+{
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(baseStream), NULL);
+	g_return_val_if_fail(flushThreshold > 0, NULL);
+
+	OGioCorkedOutputStream* self = g_object_new(OGIO_TYPE_CORKED_OUTPUT_STREAM, "base-stream", baseStream, NULL);
+	self->flushThreshold = flushThreshold;
+	self->flushDelay = flushDelay;
+
+	return G_OUTPUT_STREAM(self);
+}
+
+gboolean ogio_corked_output_stream_append_bytes(OGioCorkedOutputStream* stream, GBytes* bytes, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(bytes != NULL, FALSE);
+
+	if (g_output_stream_is_closed(G_OUTPUT_STREAM(stream))) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_CLOSED, "Stream is already closed");
+		return FALSE;
+	}
+
+	gsize size;
+	gconstpointer data = g_bytes_get_data(bytes, &size);
+	gboolean returnValue = FALSE;
+
+	g_mutex_lock(&stream->mutex);
+
+	if (!takeDeferredError(stream, error)) {
+		stream->statistics.writes++;
+
+		if (size > 0) {
+			g_ptr_array_add(stream->bytes, g_bytes_ref(bytes));
+			appendVector(stream, data, size);
+		}
+
+		returnValue = finishQueueLocked(stream, FALSE, cancellable, error);
+	}
+
+	g_mutex_unlock(&stream->mutex);
+
+	return returnValue;
+}
+
+gsize ogio_corked_output_stream_get_pending_size(OGioCorkedOutputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream), 0);
+
+	g_mutex_lock(&stream->mutex);
+	gsize returnValue = stream->pending;
+	g_mutex_unlock(&stream->mutex);
+
+	return returnValue;
+}
+
+gsize ogio_corked_output_stream_get_flush_threshold(OGioCorkedOutputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream), 0);
+
+	g_mutex_lock(&stream->mutex);
+	gsize returnValue = stream->flushThreshold;
+	g_mutex_unlock(&stream->mutex);
+
+	return returnValue;
+}
+
+void ogio_corked_output_stream_set_flush_threshold(OGioCorkedOutputStream* stream, gsize flushThreshold)
+{
+	g_return_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream));
+	g_return_if_fail(flushThreshold > 0);
+
+	g_mutex_lock(&stream->mutex);
+	stream->flushThreshold = flushThreshold;
+	g_mutex_unlock(&stream->mutex);
+}
+
+guint ogio_corked_output_stream_get_flush_delay(OGioCorkedOutputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream), 0);
+
+	g_mutex_lock(&stream->mutex);
+	guint returnValue = stream->flushDelay;
+	g_mutex_unlock(&stream->mutex);
+
+	return returnValue;
+}
+
+void ogio_corked_output_stream_set_flush_delay(OGioCorkedOutputStream* stream, guint flushDelay)
+{
+	g_return_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream));
+
+	g_mutex_lock(&stream->mutex);
+
+	stream->flushDelay = flushDelay;
+
+	/* Restart a running timer with the new delay. */
+	if (stream->timer != NULL) {
+		disarmTimer(stream);
+		armTimer(stream);
+	}
+
+	g_mutex_unlock(&stream->mutex);
+}
+
+void ogio_corked_output_stream_get_statistics(OGioCorkedOutputStream* stream, OGCorkedOutputStreamStatistics* statistics)
+{
+	g_return_if_fail(OGIO_IS_CORKED_OUTPUT_STREAM(stream));
+
+	g_mutex_lock(&stream->mutex);
+	*statistics = stream->statistics;
+	g_mutex_unlock(&stream->mutex);
+}
+
+@implementation OGCorkedOutputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_CORKED_OUTPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_CORKED_OUTPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)corkedOutputStreamWithBaseStream:(OGOutputStream*)baseStream flushThreshold:(gsize)flushThreshold flushDelay:(guint)flushDelay
+{
+	if (baseStream == nil || flushThreshold == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioCorkedOutputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_corked_output_stream_new([baseStream castedGObject], flushThreshold, flushDelay), OGIO_TYPE_CORKED_OUTPUT_STREAM, OGioCorkedOutputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGCorkedOutputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGCorkedOutputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioCorkedOutputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_CORKED_OUTPUT_STREAM, OGioCorkedOutputStream);
+}
+
+- (bool)appendBytes:(GBytes*)bytes cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)ogio_corked_output_stream_append_bytes((OGioCorkedOutputStream*)[self castedGObject], bytes, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (gsize)pendingSize
+{
+	gsize returnValue = (gsize)ogio_corked_output_stream_get_pending_size((OGioCorkedOutputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (gsize)flushThreshold
+{
+	gsize returnValue = (gsize)ogio_corked_output_stream_get_flush_threshold((OGioCorkedOutputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setFlushThreshold:(gsize)flushThreshold
+{
+	if (flushThreshold == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_corked_output_stream_set_flush_threshold((OGioCorkedOutputStream*)[self castedGObject], flushThreshold);
+}
+
+- (guint)flushDelay
+{
+	guint returnValue = (guint)ogio_corked_output_stream_get_flush_delay((OGioCorkedOutputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setFlushDelay:(guint)flushDelay
+{
+	ogio_corked_output_stream_set_flush_delay((OGioCorkedOutputStream*)[self castedGObject], flushDelay);
+}
+
+- (OGCorkedOutputStreamStatistics)statistics
+{
+	OGCorkedOutputStreamStatistics returnValue;
+
+	ogio_corked_output_stream_get_statistics((OGioCorkedOutputStream*)[self castedGObject], &returnValue);
+
+	return returnValue;
+}
+
+@end
@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGDataInputStream;
+@class OGDataOutputStream;
+@class OGDataRecordSchema;
+
+G_BEGIN_DECLS
+
+/**
+ * Fixed-width element types understood by the bulk data stream functions.
+ */
+typedef enum {
+	OG_DATA_ELEMENT_UINT8,
+	OG_DATA_ELEMENT_INT8,
+	OG_DATA_ELEMENT_UINT16,
+	OG_DATA_ELEMENT_INT16,
+	OG_DATA_ELEMENT_UINT32,
+	OG_DATA_ELEMENT_INT32,
+	OG_DATA_ELEMENT_UINT64,
+	OG_DATA_ELEMENT_INT64,
+	OG_DATA_ELEMENT_FLOAT,
+	OG_DATA_ELEMENT_DOUBLE
+} OGDataElementType;
+
+/**
+ * One field of a packed record: @count elements of @type, stored at
+ * @offset in the in-memory struct and back to back on the wire.
+ */
+typedef struct {
+	OGDataElementType type;
+	gsize offset;
+	gsize count;
+} OGDataRecordField;
+
+gsize ogio_data_element_type_get_size(OGDataElementType type);
+gsize ogio_data_record_fields_get_wire_size(const OGDataRecordField* fields, guint nFields);
+
+gboolean ogio_data_input_stream_read_array(GDataInputStream* stream, OGDataElementType type, gpointer elements, gsize count, GCancellable* cancellable, GError** error);
+gboolean ogio_data_output_stream_put_array(GDataOutputStream* stream, OGDataElementType type, gconstpointer elements, gsize count, GCancellable* cancellable, GError** error);
+gboolean ogio_data_input_stream_read_records(GDataInputStream* stream, const OGDataRecordField* fields, guint nFields, gsize recordSize, gpointer records, gsize count, GCancellable* cancellable, GError** error);
+gboolean ogio_data_output_stream_put_records(GDataOutputStream* stream, const OGDataRecordField* fields, guint nFields, gsize recordSize, gconstpointer records, gsize count, GCancellable* cancellable, GError** error);
+
+G_END_DECLS
+
+/**
+ * `OGDataArrays` reads and writes arrays of fixed-width integers and
+ * floating point numbers, and arrays of packed records, through an
+ * #OGDataInputStream or #OGDataOutputStream.
+ *
+ * Instead of one call, one error check and one byte swap per scalar, the
+ * whole array is transferred with a single read or write and converted
+ * from or to the byte order of the data stream in one pass over the
+ * buffer; the conversion loops are written so the compiler can vectorize
+ * them. The byte order is taken from the data stream, so the results are
+ * identical to calling the scalar `read` and `put` methods in a loop.
+ *
+ * Records are described by an #OGDataRecordSchema. On the wire their
+ * fields follow each other without padding; in memory they are placed at
+ * the offsets given by the schema, typically obtained with offsetof().
+ *
+ */
+@interface OGDataArrays : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Reads @count elements of @type into @elements.
+ *
+ * @param stream a given #GDataInputStream.
+ * @param type the element type
+ * @param elements a buffer for @count elements
+ * @param count the number of elements to read
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ */
++ (void)readArrayFromStream:(OGDataInputStream*)stream type:(OGDataElementType)type elements:(gpointer)elements count:(gsize)count cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Writes @count elements of @type from @elements.
+ *
+ * @param stream a #GDataOutputStream.
+ * @param type the element type
+ * @param elements the elements to write
+ * @param count the number of elements to write
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ */
++ (void)putArrayToStream:(OGDataOutputStream*)stream type:(OGDataElementType)type elements:(gconstpointer)elements count:(gsize)count cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Reads @count records described by @schema into @records.
+ *
+ * @param stream a given #GDataInputStream.
+ * @param schema the layout of the records
+ * @param records a buffer for @count records of the schema's record size
+ * @param count the number of records to read
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ */
++ (void)readRecordsFromStream:(OGDataInputStream*)stream schema:(OGDataRecordSchema*)schema records:(gpointer)records count:(gsize)count cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Writes @count records described by @schema from @records.
+ *
+ * @param stream a #GDataOutputStream.
+ * @param schema the layout of the records
+ * @param records the records to write
+ * @param count the number of records to write
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ */
++ (void)putRecordsToStream:(OGDataOutputStream*)stream schema:(OGDataRecordSchema*)schema records:(gconstpointer)records count:(gsize)count cancellable:(OGCancellable*)cancellable;
+
+@end
@@ -0,0 +1,318 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGDataArrays.h"
+
+#import "OGCancellable.h"
+#import "OGDataInputStream.h"
+#import "OGDataOutputStream.h"
+#import "OGDataRecordSchema.h"
+
+#define CHUNK_SIZE (64 * 1024)
+
+gsize ogio_data_element_type_get_size(OGDataElementType type)
+{
+	switch (type) {
+	case OG_DATA_ELEMENT_UINT8:
+	case OG_DATA_ELEMENT_INT8:
+		return 1;
+	case OG_DATA_ELEMENT_UINT16:
+	case OG_DATA_ELEMENT_INT16:
+		return 2;
+	case OG_DATA_ELEMENT_UINT32:
+	case OG_DATA_ELEMENT_INT32:
+	case OG_DATA_ELEMENT_FLOAT:
+		return 4;
+	case OG_DATA_ELEMENT_UINT64:
+	case OG_DATA_ELEMENT_INT64:
+	case OG_DATA_ELEMENT_DOUBLE:
+		return 8;
+	}
+
+	g_return_val_if_reached(0);
+}
+
+gsize ogio_data_record_fields_get_wire_size(const OGDataRecordField* fields, guint nFields)
+{
+	gsize size = 0;
+
+	for (guint i = 0; i < nFields; i++)
+		size += ogio_data_element_type_get_size(fields[i].type) * fields[i].count;
+
+	return size;
+}
+
+static gboolean needsSwap(GDataStreamByteOrder order)
+{
+	switch (order) {
+	case G_DATA_STREAM_BYTE_ORDER_BIG_ENDIAN:
+		return (G_BYTE_ORDER != G_BIG_ENDIAN);
+	case G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN:
+		return (G_BYTE_ORDER != G_LITTLE_ENDIAN);
+	default:
+		return FALSE;
+	}
+}
+
+/*
+ * Swaps @count elements of @width bytes in place. The memcpy() calls make
+ * unaligned buffers safe and compile to plain loads and stores, which lets
+ * the compiler vectorize the loops.
+ */
+static void swapElements(guint8* bytes, gsize width, gsize count)
+{
+	switch (width) {
+	case 2:
+		for (gsize i = 0; i < count; i++) {
+			guint16 value;
+
+			memcpy(&value, bytes + 2 * i, 2);
+			value = GUINT16_SWAP_LE_BE(value);
+			memcpy(bytes + 2 * i, &value, 2);
+		}
+		break;
+	case 4:
+		for (gsize i = 0; i < count; i++) {
+			guint32 value;
+
+			memcpy(&value, bytes + 4 * i, 4);
+			value = GUINT32_SWAP_LE_BE(value);
+			memcpy(bytes + 4 * i, &value, 4);
+		}
+		break;
+	case 8:
+		for (gsize i = 0; i < count; i++) {
+			guint64 value;
+
+			memcpy(&value, bytes + 8 * i, 8);
+			value = GUINT64_SWAP_LE_BE(value);
+			memcpy(bytes + 8 * i, &value, 8);
+		}
+		break;
+	default:
+		break;
+	}
+}
+
+static gboolean readExactly(GInputStream* stream, gpointer buffer, gsize size, GCancellable* cancellable, GError** error)
+{
+	gsize read = 0;
+
+	if (!g_input_stream_read_all(stream, buffer, size, &read, cancellable, error))
+		return FALSE;
+
+	if (read < size) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Unexpected early end-of-stream");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gboolean checkedSize(gsize a, gsize b, gsize* result, GError** error)
+{
+	if (!g_size_checked_mul(result, a, b)) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Array is too large");
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+gboolean ogio_data_input_stream_read_array(GDataInputStream* stream, OGDataElementType type, gpointer elements, gsize count, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_DATA_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(elements != NULL || count == 0, FALSE);
+
+	gsize width = ogio_data_element_type_get_size(type);
+	gsize size;
+
+	if (!checkedSize(width, count, &size, error))
+		return FALSE;
+
+	if (!readExactly(G_INPUT_STREAM(stream), elements, size, cancellable, error))
+		return FALSE;
+
+	if (width > 1 && needsSwap(g_data_input_stream_get_byte_order(stream)))
+		swapElements(elements, width, count);
+
+	return TRUE;
+}
+
+gboolean ogio_data_output_stream_put_array(GDataOutputStream* stream, OGDataElementType type, gconstpointer elements, gsize count, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_DATA_OUTPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(elements != NULL || count == 0, FALSE);
+
+	gsize width = ogio_data_element_type_get_size(type);
+	gsize size;
+
+	if (!checkedSize(width, count, &size, error))
+		return FALSE;
+
+	if (width == 1 || !needsSwap(g_data_output_stream_get_byte_order(stream)))
+		return g_output_stream_write_all(G_OUTPUT_STREAM(stream), elements, size, NULL, cancellable, error);
+
+	gsize scratchSize = MIN(size, CHUNK_SIZE);
+	guint8* scratch = g_malloc(MAX(scratchSize, 1));
+	const guint8* source = elements;
+	gboolean result = TRUE;
+
+	while (size > 0) {
+		gsize chunk = MIN(size, scratchSize);
+
+		memcpy(scratch, source, chunk);
+		swapElements(scratch, width, chunk / width);
+
+		if (!g_output_stream_write_all(G_OUTPUT_STREAM(stream), scratch, chunk, NULL, cancellable, error)) {
+			result = FALSE;
+			break;
+		}
+
+		source += chunk;
+		size -= chunk;
+	}
+
+	g_free(scratch);
+
+	return result;
+}
+
+gboolean ogio_data_input_stream_read_records(GDataInputStream* stream, const OGDataRecordField* fields, guint nFields, gsize recordSize, gpointer records, gsize count, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_DATA_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(fields != NULL && nFields > 0, FALSE);
+	g_return_val_if_fail(records != NULL || count == 0, FALSE);
+
+	gsize wireSize = ogio_data_record_fields_get_wire_size(fields, nFields);
+	g_return_val_if_fail(wireSize > 0, FALSE);
+
+	gsize perChunk = MAX(1, CHUNK_SIZE / wireSize);
+	gboolean swap = needsSwap(g_data_input_stream_get_byte_order(stream));
+	guint8* wire = g_malloc(MIN(perChunk, MAX(count, 1)) * wireSize);
+	guint8* record = records;
+	gboolean result = TRUE;
+
+	while (count > 0) {
+		gsize batch = MIN(count, perChunk);
+		const guint8* source = wire;
+
+		if (!readExactly(G_INPUT_STREAM(stream), wire, batch * wireSize, cancellable, error)) {
+			result = FALSE;
+			break;
+		}
+
+		for (gsize i = 0; i < batch; i++, record += recordSize) {
+			for (guint j = 0; j < nFields; j++) {
+				gsize width = ogio_data_element_type_get_size(fields[j].type);
+				gsize size = width * fields[j].count;
+
+				memcpy(record + fields[j].offset, source, size);
+				if (swap && width > 1)
+					swapElements(record + fields[j].offset, width, fields[j].count);
+
+				source += size;
+			}
+		}
+
+		count -= batch;
+	}
+
+	g_free(wire);
+
+	return result;
+}
+
+gboolean ogio_data_output_stream_put_records(GDataOutputStream* stream, const OGDataRecordField* fields, guint nFields, gsize recordSize, gconstpointer records, gsize count, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_DATA_OUTPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(fields != NULL && nFields > 0, FALSE);
+	g_return_val_if_fail(records != NULL || count == 0, FALSE);
+
+	gsize wireSize = ogio_data_record_fields_get_wire_size(fields, nFields);
+	g_return_val_if_fail(wireSize > 0, FALSE);
+
+	gsize perChunk = MAX(1, CHUNK_SIZE / wireSize);
+	gboolean swap = needsSwap(g_data_output_stream_get_byte_order(stream));
+	guint8* wire = g_malloc(MIN(perChunk, MAX(count, 1)) * wireSize);
+	const guint8* record = records;
+	gboolean result = TRUE;
+
+	while (count > 0) {
+		gsize batch = MIN(count, perChunk);
+		guint8* target = wire;
+
+		for (gsize i = 0; i < batch; i++, record += recordSize) {
+			for (guint j = 0; j < nFields; j++) {
+				gsize width = ogio_data_element_type_get_size(fields[j].type);
+				gsize size = width * fields[j].count;
+
+				memcpy(target, record + fields[j].offset, size);
+				if (swap && width > 1)
+					swapElements(target, width, fields[j].count);
+
+				target += size;
+			}
+		}
+
+		if (!g_output_stream_write_all(G_OUTPUT_STREAM(stream), wire, batch * wireSize, NULL, cancellable, error)) {
+			result = FALSE;
+			break;
+		}
+
+		count -= batch;
+	}
+
+	g_free(wire);
+
+	return result;
+}
+
+@implementation OGDataArrays
+
++ (void)readArrayFromStream:(OGDataInputStream*)stream type:(OGDataElementType)type elements:(gpointer)elements count:(gsize)count cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	ogio_data_input_stream_read_array([stream castedGObject], type, elements, count, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+}
+
++ (void)putArrayToStream:(OGDataOutputStream*)stream type:(OGDataElementType)type elements:(gconstpointer)elements count:(gsize)count cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	ogio_data_output_stream_put_array([stream castedGObject], type, elements, count, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+}
+
++ (void)readRecordsFromStream:(OGDataInputStream*)stream schema:(OGDataRecordSchema*)schema records:(gpointer)records count:(gsize)count cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	if (schema == nil || schema.fieldCount == 0 || schema.wireSize == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_data_input_stream_read_records([stream castedGObject], schema.fields, schema.fieldCount, schema.recordSize, records, count, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+}
+
++ (void)putRecordsToStream:(OGDataOutputStream*)stream schema:(OGDataRecordSchema*)schema records:(gconstpointer)records count:(gsize)count cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	if (schema == nil || schema.fieldCount == 0 || schema.wireSize == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_data_output_stream_put_records([stream castedGObject], schema.fields, schema.fieldCount, schema.recordSize, records, count, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+}
+
+@end
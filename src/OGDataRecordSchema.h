@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGDataArrays.h"
+
+/**
+ * `OGDataRecordSchema` describes a packed binary record for
+ * +[OGDataArrays readRecordsFromStream:schema:records:count:cancellable:]
+ * and +[OGDataArrays putRecordsToStream:schema:records:count:cancellable:].
+ *
+ * Fields are transferred in the order they are added. For example, a frame
+ * header `struct { guint32 id; gint64 time; float values[3]; }` is
+ * described by adding a %OG_DATA_ELEMENT_UINT32 field at
+ * `offsetof(..., id)`, a %OG_DATA_ELEMENT_INT64 field at
+ * `offsetof(..., time)` and a %OG_DATA_ELEMENT_FLOAT field with a count of 3
+ * at `offsetof(..., values)`; it occupies 24 bytes on the wire.
+ *
+ */
+@interface OGDataRecordSchema : OFObject
+{
+	GArray* _fields;
+	gsize _recordSize;
+	gsize _wireSize;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)schemaWithRecordSize:(gsize)recordSize;
+
+/**
+ * Initializes an empty schema for records occupying @recordSize bytes in
+ * memory.
+ *
+ * @param recordSize the in-memory size of one record, usually sizeof()
+ * @return an initialized schema
+ */
+- (instancetype)initWithRecordSize:(gsize)recordSize;
+
+/**
+ * Methods
+ */
+
+/**
+ * Appends a field of @count elements of @type stored at @offset.
+ *
+ * @param type the element type
+ * @param offset the offset of the field within the in-memory record
+ * @param count the number of elements, 1 for a scalar
+ */
+- (void)addFieldWithType:(OGDataElementType)type offset:(gsize)offset count:(gsize)count;
+
+/**
+ * The in-memory size of one record.
+ *
+ * @return the record size in bytes
+ */
+- (gsize)recordSize;
+
+/**
+ * The size of one record on the wire.
+ *
+ * @return the wire size in bytes
+ */
+- (gsize)wireSize;
+
+/**
+ * The number of fields.
+ *
+ * @return the number of fields
+ */
+- (guint)fieldCount;
+
+/**
+ * The fields in wire order.
+ *
+ * @return an array of -fieldCount fields, owned by the schema
+ */
+- (const OGDataRecordField*)fields;
+
+@end
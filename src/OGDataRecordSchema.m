@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGDataRecordSchema.h"
+
+@implementation OGDataRecordSchema
+
++ (instancetype)schemaWithRecordSize:(gsize)recordSize
+{
+	return [[[self alloc] initWithRecordSize:recordSize] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithRecordSize:(gsize)recordSize
+{
+	self = [super init];
+
+	@try {
+		if (recordSize == 0)
+			@throw [OFInvalidArgumentException exception];
+
+		_recordSize = recordSize;
+		_fields = g_array_new(FALSE, FALSE, sizeof(OGDataRecordField));
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_fields != NULL)
+		g_array_unref(_fields);
+
+	[super dealloc];
+}
+
+- (void)addFieldWithType:(OGDataElementType)type offset:(gsize)offset count:(gsize)count
+{
+	gsize width = ogio_data_element_type_get_size(type);
+
+	if (width == 0 || count == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	if (count > (_recordSize - MIN(offset, _recordSize)) / width)
+		@throw [OFOutOfRangeException exception];
+
+	OGDataRecordField field = { type, offset, count };
+	g_array_append_val(_fields, field);
+
+	_wireSize += width * count;
+}
+
+- (gsize)recordSize
+{
+	return _recordSize;
+}
+
+- (gsize)wireSize
+{
+	return _wireSize;
+}
+
+- (guint)fieldCount
+{
+	return _fields->len;
+}
+
+- (const OGDataRecordField*)fields
+{
+	return (const OGDataRecordField*)(void*)_fields->data;
+}
+
+@end
@@ -0,0 +1,148 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+/**
+ * What happened to a path within one coalescing window of an
+ * #OGFileMonitorHub.
+ */
+typedef enum {
+	/** The path was created or moved into a watched directory */
+	OG_FILE_CHANGE_CREATED = 1 << 0,
+	/** The contents were modified */
+	OG_FILE_CHANGE_CHANGED = 1 << 1,
+	/** A file opened for writing was closed */
+	OG_FILE_CHANGE_CHANGES_DONE = 1 << 2,
+	/** Metadata such as permissions or timestamps changed */
+	OG_FILE_CHANGE_ATTRIBUTES = 1 << 3,
+	/** The path was deleted or moved out of a watched directory */
+	OG_FILE_CHANGE_DELETED = 1 << 4
+} OGFileChangeFlags;
+
+/**
+ * The coalesced changes to one path.
+ */
+typedef struct {
+	/** The absolute path, valid during the callback */
+	const gchar* path;
+	/** The changes, combined over the window */
+	OGFileChangeFlags flags;
+	/** Whether the path is a directory */
+	bool isDirectory;
+} OGFileChange;
+
+/**
+ * Called with every batch of changes. @overflowed is set if the kernel
+ * dropped events, in which case watched trees should be rescanned.
+ */
+typedef void (*OGFileMonitorHubFunc)(const OGFileChange* changes, gsize count, bool overflowed, gpointer userData);
+
+/**
+ * `OGFileMonitorHub` watches many files and directory trees through a
+ * single inotify instance and reports their changes in batches.
+ *
+ * Unlike an #OGFileMonitor per path, which emits one signal per event, the
+ * hub coalesces all events for a path that arrive within a time window
+ * into one #OGFileChange. A burst of created, changed and changes-done
+ * events turns into a single created entry, and a file that is created
+ * and deleted again within the window is not reported at all. Whenever
+ * windows expire, all their changes are passed to one call of the hub
+ * function, on the thread-default main context of the thread that created
+ * the hub.
+ *
+ * Directories added recursively are watched together with all their
+ * subdirectories, including ones created later; the contents of a new
+ * subdirectory are reported as created. One inotify watch is used per
+ * directory, so the number of watched directories is bounded by
+ * `fs.inotify.max_user_watches`.
+ *
+ */
+@interface OGFileMonitorHub : OFObject
+{
+	int _inotifyFd;
+	int _wakeFd;
+	GThread* _thread;
+	GMutex _mutex;
+	GHashTable* _watches;
+	GHashTable* _watchPaths;
+	GHashTable* _pending;
+	GQueue _pendingOrder;
+	gint64 _windowUs;
+	bool _overflowed;
+	OGFileMonitorHubFunc _func;
+	gpointer _userData;
+	GMainContext* _context;
+	bool _stopping;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)fileMonitorHubWithWindowMsecs:(guint)windowMsecs func:(OGFileMonitorHubFunc)func userData:(gpointer)userData;
+
+/**
+ * Initializes a hub.
+ *
+ * @param windowMsecs the coalescing window in milliseconds
+ * @param func the function receiving batches of changes
+ * @param userData user data for @func, which must stay valid as long as
+ * changes may be dispatched
+ * @return an initialized hub
+ */
+- (instancetype)initWithWindowMsecs:(guint)windowMsecs func:(OGFileMonitorHubFunc)func userData:(gpointer)userData;
+
+/**
+ * Methods
+ */
+
+/**
+ * Starts watching @path, a file or a directory.
+ *
+ * @param path the path to watch
+ * @param recursive whether to watch all subdirectories of a directory
+ */
+- (void)addPath:(OFString*)path recursive:(bool)recursive;
+
+/**
+ * Stops watching @path and, if it was added recursively, its
+ * subdirectories.
+ *
+ * @param path a path passed to -addPath:recursive:
+ */
+- (void)removePath:(OFString*)path;
+
+/**
+ * The number of inotify watches in use.
+ *
+ * @return the number of watches
+ */
+- (guint)watchCount;
+
+/**
+ * The coalescing window.
+ *
+ * @return the window in milliseconds
+ */
+- (guint)windowMsecs;
+
+/**
+ * Sets the coalescing window. Changes are reported at most this long after
+ * the first event for their path.
+ *
+ * @param windowMsecs the window in milliseconds
+ */
+- (void)setWindowMsecs:(guint)windowMsecs;
+
+@end
@@ -0,0 +1,603 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFileMonitorHub.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <string.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#define DIRECTORY_MASK (IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_MOVED_FROM | IN_MOVED_TO | IN_DELETE_SELF | IN_EXCL_UNLINK | IN_ONLYDIR)
+#define FILE_MASK (IN_MODIFY | IN_CLOSE_WRITE | IN_ATTRIB | IN_DELETE_SELF | IN_MOVE_SELF)
+#define EVENT_BUFFER_SIZE (64 * 1024)
+
+typedef struct {
+	int wd;
+	gchar* path;
+	bool recursive;
+} Watch;
+
+typedef struct {
+	gchar* path;
+	OGFileChangeFlags flags;
+	bool isDirectory;
+	gint64 first;
+} PendingChange;
+
+typedef struct {
+	OGFileMonitorHubFunc func;
+	gpointer userData;
+	GArray* changes;
+	bool overflowed;
+} ChangeDelivery;
+
+static void freeWatch(gpointer data)
+{
+	Watch* watch = data;
+
+	g_free(watch->path);
+	g_free(watch);
+}
+
+static void clearChange(gpointer data)
+{
+	OGFileChange* change = data;
+
+	g_free((gchar*)change->path);
+}
+
+static OGFileChangeFlags flagsForMask(uint32_t mask)
+{
+	OGFileChangeFlags flags = 0;
+
+	if (mask & (IN_CREATE | IN_MOVED_TO))
+		return OG_FILE_CHANGE_CREATED;
+
+	if (mask & (IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF | IN_MOVE_SELF))
+		return OG_FILE_CHANGE_DELETED;
+
+	if (mask & IN_MODIFY)
+		flags |= OG_FILE_CHANGE_CHANGED;
+
+	if (mask & IN_CLOSE_WRITE)
+		flags |= OG_FILE_CHANGE_CHANGES_DONE;
+
+	if (mask & IN_ATTRIB)
+		flags |= OG_FILE_CHANGE_ATTRIBUTES;
+
+	return flags;
+}
+
+/*
+ * Folds @flags into the changes already seen for a path in the current
+ * window. A path created and deleted again cancels out, and one deleted
+ * and created again is reported as changed.
+ */
+static void mergeFlags(PendingChange* pending, OGFileChangeFlags flags)
+{
+	if (flags & OG_FILE_CHANGE_DELETED) {
+		pending->flags = ((pending->flags & OG_FILE_CHANGE_CREATED) ? 0 : OG_FILE_CHANGE_DELETED);
+		return;
+	}
+
+	if (flags & OG_FILE_CHANGE_CREATED) {
+		if (pending->flags & OG_FILE_CHANGE_DELETED)
+			pending->flags = OG_FILE_CHANGE_CHANGED;
+		else
+			pending->flags |= OG_FILE_CHANGE_CREATED;
+
+		return;
+	}
+
+	if (!(pending->flags & OG_FILE_CHANGE_DELETED))
+		pending->flags |= flags;
+}
+
+static bool hasPathPrefix(const gchar* path, const gchar* prefix, gsize prefixLength)
+{
+	return (strncmp(path, prefix, prefixLength) == 0 && (path[prefixLength] == '\0' || path[prefixLength] == '/'));
+}
+
+static gboolean deliverChanges(gpointer userData)
+{
+	ChangeDelivery* delivery = userData;
+
+	delivery->func((const OGFileChange*)(void*)delivery->changes->data, delivery->changes->len, delivery->overflowed, delivery->userData);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void freeDelivery(gpointer userData)
+{
+	ChangeDelivery* delivery = userData;
+
+	g_array_unref(delivery->changes);
+	g_free(delivery);
+}
+
+static gpointer hubThread(gpointer data);
+
+@interface OGFileMonitorHub ()
+- (void)run;
+- (void)readEvents;
+- (void)recordWatchLocked:(int)wd path:(const gchar*)path recursive:(bool)recursive;
+- (void)removeWatchesLockedWithPrefix:(const gchar*)prefix;
+- (bool)addTreeLocked:(const gchar*)root recursive:(bool)recursive reportContents:(bool)reportContents now:(gint64)now error:(GError**)error;
+- (void)queueChangeLocked:(const gchar*)path flags:(OGFileChangeFlags)flags isDirectory:(bool)isDirectory now:(gint64)now;
+- (GArray*)collectExpiredLocked:(gint64)now;
+- (int)nextTimeoutLocked:(gint64)now;
+- (void)wake;
+@end
+
+static gpointer hubThread(gpointer data)
+{
+	[(OGFileMonitorHub*)data run];
+
+	return NULL;
+}
+
+@implementation OGFileMonitorHub
+
++ (instancetype)fileMonitorHubWithWindowMsecs:(guint)windowMsecs func:(OGFileMonitorHubFunc)func userData:(gpointer)userData
+{
+	return [[[self alloc] initWithWindowMsecs:windowMsecs func:func userData:userData] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithWindowMsecs:(guint)windowMsecs func:(OGFileMonitorHubFunc)func userData:(gpointer)userData
+{
+	self = [super init];
+
+	_inotifyFd = -1;
+	_wakeFd = -1;
+	g_mutex_init(&_mutex);
+	g_queue_init(&_pendingOrder);
+
+	@try {
+		GError* err = NULL;
+
+		if (func == NULL)
+			@throw [OFInvalidArgumentException exception];
+
+		_watches = g_hash_table_new_full(g_direct_hash, g_direct_equal, NULL, freeWatch);
+		_watchPaths = g_hash_table_new(g_str_hash, g_str_equal);
+		_pending = g_hash_table_new(g_str_hash, g_str_equal);
+		_windowUs = (gint64)windowMsecs * 1000;
+		_func = func;
+		_userData = userData;
+		_context = g_main_context_ref_thread_default();
+
+		if ((_inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC)) < 0 || (_wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)) < 0) {
+			int errsv = errno;
+
+			g_set_error(&err, G_IO_ERROR, g_io_error_from_errno(errsv), "Error creating inotify instance: %s", g_strerror(errsv));
+		}
+
+		[OGErrorException throwForError:err];
+
+		_thread = g_thread_new("ogio-monitor-hub", hubThread, self);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	PendingChange* pending;
+
+	if (_thread != NULL) {
+		g_mutex_lock(&_mutex);
+		_stopping = true;
+		g_mutex_unlock(&_mutex);
+
+		[self wake];
+		g_thread_join(_thread);
+	}
+
+	while ((pending = g_queue_pop_head(&_pendingOrder)) != NULL) {
+		g_free(pending->path);
+		g_free(pending);
+	}
+
+	if (_pending != NULL)
+		g_hash_table_unref(_pending);
+
+	if (_watchPaths != NULL)
+		g_hash_table_unref(_watchPaths);
+
+	if (_watches != NULL)
+		g_hash_table_unref(_watches);
+
+	if (_wakeFd >= 0)
+		close(_wakeFd);
+
+	if (_inotifyFd >= 0)
+		close(_inotifyFd);
+
+	if (_context != NULL)
+		g_main_context_unref(_context);
+
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (void)wake
+{
+	guint64 value = 1;
+
+	while (write(_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR);
+}
+
+- (void)addPath:(OFString*)path recursive:(bool)recursive
+{
+	GError* err = NULL;
+	gchar* canonical;
+
+	if (path == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	canonical = g_canonicalize_filename([path UTF8String], NULL);
+
+	g_mutex_lock(&_mutex);
+
+	if (g_file_test(canonical, G_FILE_TEST_IS_DIR)) {
+		[self addTreeLocked:canonical recursive:recursive reportContents:false now:0 error:&err];
+	} else {
+		int wd = inotify_add_watch(_inotifyFd, canonical, FILE_MASK);
+
+		if (wd < 0) {
+			int errsv = errno;
+
+			g_set_error(&err, G_IO_ERROR, g_io_error_from_errno(errsv), "Error watching %s: %s", canonical, g_strerror(errsv));
+		} else
+			[self recordWatchLocked:wd path:canonical recursive:false];
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	g_free(canonical);
+
+	[OGErrorException throwForError:err];
+}
+
+- (void)removePath:(OFString*)path
+{
+	gchar* canonical;
+
+	if (path == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	canonical = g_canonicalize_filename([path UTF8String], NULL);
+
+	g_mutex_lock(&_mutex);
+	[self removeWatchesLockedWithPrefix:canonical];
+	g_mutex_unlock(&_mutex);
+
+	g_free(canonical);
+}
+
+- (guint)watchCount
+{
+	guint returnValue;
+
+	g_mutex_lock(&_mutex);
+	returnValue = g_hash_table_size(_watches);
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (guint)windowMsecs
+{
+	guint returnValue;
+
+	g_mutex_lock(&_mutex);
+	returnValue = (guint)(_windowUs / 1000);
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (void)setWindowMsecs:(guint)windowMsecs
+{
+	g_mutex_lock(&_mutex);
+	_windowUs = (gint64)windowMsecs * 1000;
+	g_mutex_unlock(&_mutex);
+
+	[self wake];
+}
+
+- (void)recordWatchLocked:(int)wd path:(const gchar*)path recursive:(bool)recursive
+{
+	Watch* watch = g_hash_table_lookup(_watches, GINT_TO_POINTER(wd));
+
+	/* inotify hands out the same descriptor for the same inode, so a
+	 * directory reached again under a new name replaces its record. */
+	if (watch != NULL) {
+		g_hash_table_remove(_watchPaths, watch->path);
+		g_free(watch->path);
+	} else {
+		watch = g_new0(Watch, 1);
+		watch->wd = wd;
+		g_hash_table_insert(_watches, GINT_TO_POINTER(wd), watch);
+	}
+
+	watch->path = g_strdup(path);
+	watch->recursive = recursive;
+	g_hash_table_insert(_watchPaths, watch->path, watch);
+}
+
+- (void)removeWatchesLockedWithPrefix:(const gchar*)prefix
+{
+	gsize prefixLength = strlen(prefix);
+	GHashTableIter iter;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, _watches);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		Watch* watch = value;
+
+		if (!hasPathPrefix(watch->path, prefix, prefixLength))
+			continue;
+
+		inotify_rm_watch(_inotifyFd, watch->wd);
+		g_hash_table_remove(_watchPaths, watch->path);
+		g_hash_table_iter_remove(&iter);
+	}
+}
+
+- (bool)addTreeLocked:(const gchar*)root recursive:(bool)recursive reportContents:(bool)reportContents now:(gint64)now error:(GError**)error
+{
+	GQueue directories = G_QUEUE_INIT;
+	gchar* directory;
+	bool first = true;
+	bool result = true;
+
+	g_queue_push_tail(&directories, g_strdup(root));
+
+	while ((directory = g_queue_pop_head(&directories)) != NULL) {
+		int wd = inotify_add_watch(_inotifyFd, directory, DIRECTORY_MASK);
+
+		if (wd < 0) {
+			int errsv = errno;
+
+			/* Subdirectories may vanish or be unreadable; running out of
+			 * watches is fatal though. */
+			if (first || errsv == ENOSPC || errsv == ENOMEM) {
+				g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "Error watching %s: %s", directory, g_strerror(errsv));
+				g_free(directory);
+				result = false;
+				break;
+			}
+
+			g_free(directory);
+			continue;
+		}
+
+		[self recordWatchLocked:wd path:directory recursive:recursive];
+		first = false;
+
+		if (recursive) {
+			DIR* dir = opendir(directory);
+			struct dirent* entry;
+
+			while (dir != NULL && (entry = readdir(dir)) != NULL) {
+				if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0)
+					continue;
+
+				gchar* child = g_build_filename(directory, entry->d_name, NULL);
+				bool isDirectory = (entry->d_type == DT_DIR || (entry->d_type == DT_UNKNOWN && g_file_test(child, G_FILE_TEST_IS_DIR) && !g_file_test(child, G_FILE_TEST_IS_SYMLINK)));
+
+				/* Entries of a directory created while being watched may
+				 * predate its watch, so report them as created. */
+				if (reportContents)
+					[self queueChangeLocked:child flags:OG_FILE_CHANGE_CREATED isDirectory:isDirectory now:now];
+
+				if (isDirectory)
+					g_queue_push_tail(&directories, child);
+				else
+					g_free(child);
+			}
+
+			if (dir != NULL)
+				closedir(dir);
+		}
+
+		g_free(directory);
+	}
+
+	while ((directory = g_queue_pop_head(&directories)) != NULL)
+		g_free(directory);
+
+	return result;
+}
+
+- (void)queueChangeLocked:(const gchar*)path flags:(OGFileChangeFlags)flags isDirectory:(bool)isDirectory now:(gint64)now
+{
+	PendingChange* pending = g_hash_table_lookup(_pending, path);
+
+	if (pending == NULL) {
+		pending = g_new0(PendingChange, 1);
+		pending->path = g_strdup(path);
+		pending->first = now;
+		g_hash_table_insert(_pending, pending->path, pending);
+		g_queue_push_tail(&_pendingOrder, pending);
+	}
+
+	mergeFlags(pending, flags);
+	pending->isDirectory |= isDirectory;
+}
+
+- (void)readEvents
+{
+	guint8 buffer[EVENT_BUFFER_SIZE] __attribute__((aligned(__alignof__(struct inotify_event))));
+
+	for (;;) {
+		ssize_t length = read(_inotifyFd, buffer, sizeof(buffer));
+		gint64 now = g_get_monotonic_time();
+
+		if (length < 0 && errno == EINTR)
+			continue;
+
+		if (length <= 0)
+			break;
+
+		g_mutex_lock(&_mutex);
+
+		for (guint8* p = buffer; p < buffer + length;) {
+			const struct inotify_event* event = (const struct inotify_event*)(void*)p;
+			Watch* watch;
+			gchar* path;
+			bool isDirectory = (event->mask & IN_ISDIR);
+
+			p += sizeof(struct inotify_event) + event->len;
+
+			if (event->mask & IN_Q_OVERFLOW) {
+				_overflowed = true;
+				continue;
+			}
+
+			watch = g_hash_table_lookup(_watches, GINT_TO_POINTER(event->wd));
+			if (watch == NULL)
+				continue;
+
+			if (event->mask & IN_IGNORED) {
+				g_hash_table_remove(_watchPaths, watch->path);
+				g_hash_table_remove(_watches, GINT_TO_POINTER(event->wd));
+				continue;
+			}
+
+			path = (event->len > 0 ? g_build_filename(watch->path, event->name, NULL) : g_strdup(watch->path));
+
+			if (isDirectory && watch->recursive) {
+				if (event->mask & (IN_CREATE | IN_MOVED_TO))
+					[self addTreeLocked:path recursive:true reportContents:true now:now error:NULL];
+				else if (event->mask & IN_MOVED_FROM)
+					[self removeWatchesLockedWithPrefix:path];
+			}
+
+			OGFileChangeFlags flags = flagsForMask(event->mask);
+
+			if (flags != 0)
+				[self queueChangeLocked:path flags:flags isDirectory:isDirectory now:now];
+
+			g_free(path);
+		}
+
+		g_mutex_unlock(&_mutex);
+	}
+}
+
+- (GArray*)collectExpiredLocked:(gint64)now
+{
+	GArray* changes = g_array_new(FALSE, FALSE, sizeof(OGFileChange));
+	PendingChange* pending;
+
+	g_array_set_clear_func(changes, clearChange);
+
+	while ((pending = g_queue_peek_head(&_pendingOrder)) != NULL && pending->first + _windowUs <= now) {
+		g_queue_pop_head(&_pendingOrder);
+		g_hash_table_remove(_pending, pending->path);
+
+		if (pending->flags != 0) {
+			OGFileChange change = { pending->path, pending->flags, pending->isDirectory };
+
+			g_array_append_val(changes, change);
+		} else
+			g_free(pending->path);
+
+		g_free(pending);
+	}
+
+	return changes;
+}
+
+- (int)nextTimeoutLocked:(gint64)now
+{
+	PendingChange* pending = g_queue_peek_head(&_pendingOrder);
+
+	if (pending == NULL)
+		return -1;
+
+	gint64 remaining = pending->first + _windowUs - now;
+
+	if (remaining <= 0)
+		return 0;
+
+	return (int)MIN((remaining + 999) / 1000, G_MAXINT);
+}
+
+- (void)run
+{
+	for (;;) {
+		GPollFD fds[2] = {
+			{ _inotifyFd, G_IO_IN, 0 },
+			{ _wakeFd, G_IO_IN, 0 }
+		};
+		GArray* changes;
+		bool overflowed;
+		int timeout;
+
+		g_mutex_lock(&_mutex);
+		timeout = [self nextTimeoutLocked:g_get_monotonic_time()];
+		g_mutex_unlock(&_mutex);
+
+		g_poll(fds, 2, timeout);
+
+		if (fds[1].revents & G_IO_IN) {
+			guint64 value;
+
+			while (read(_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR);
+		}
+
+		if (fds[0].revents & G_IO_IN)
+			[self readEvents];
+
+		g_mutex_lock(&_mutex);
+
+		if (_stopping) {
+			g_mutex_unlock(&_mutex);
+			break;
+		}
+
+		/* After an overflow the remaining windows are flushed right away
+		 * along with the notification. */
+		changes = [self collectExpiredLocked:(_overflowed ? G_MAXINT64 - _windowUs : g_get_monotonic_time())];
+		overflowed = _overflowed;
+		_overflowed = false;
+
+		g_mutex_unlock(&_mutex);
+
+		if (changes->len > 0 || overflowed) {
+			ChangeDelivery* delivery = g_new0(ChangeDelivery, 1);
+			GSource* source = g_idle_source_new();
+
+			delivery->func = _func;
+			delivery->userData = _userData;
+			delivery->changes = changes;
+			delivery->overflowed = overflowed;
+
+			g_source_set_priority(source, G_PRIORITY_DEFAULT);
+			g_source_set_callback(source, deliverChanges, delivery, freeDelivery);
+			g_source_attach(source, _context);
+			g_source_unref(source);
+		} else
+			g_array_unref(changes);
+	}
+}
+
+@end
@@ -0,0 +1,127 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Decides whether @item of the source model is part of an
+ * #OGioFilterListModel.
+ *
+ * Returns: %TRUE to keep @item
+ */
+typedef gboolean (*OGioFilterListModelFunc)(gpointer item, gpointer userData);
+
+#define OGIO_TYPE_FILTER_LIST_MODEL (ogio_filter_list_model_get_type())
+G_DECLARE_FINAL_TYPE(OGioFilterListModel, ogio_filter_list_model, OGIO, FILTER_LIST_MODEL, GObject)
+
+OGioFilterListModel* ogio_filter_list_model_new(GListModel* model, OGioFilterListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy);
+GListModel* ogio_filter_list_model_get_model(OGioFilterListModel* self);
+void ogio_filter_list_model_set_filter_func(OGioFilterListModel* self, OGioFilterListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy);
+void ogio_filter_list_model_refilter(OGioFilterListModel* self);
+gboolean ogio_filter_list_model_get_background(OGioFilterListModel* self);
+void ogio_filter_list_model_set_background(OGioFilterListModel* self, gboolean background);
+gboolean ogio_filter_list_model_is_pending(OGioFilterListModel* self);
+
+G_END_DECLS
+
+/**
+ * `OGFilterListModel` is a [iface@Gio.ListModel] containing the items of a
+ * source model that pass a filter function, in source order.
+ *
+ * The model keeps the source positions of the matching items and follows
+ * the #GListModel::items-changed signal of the source: only the added
+ * items are passed to the filter, the positions after the change are
+ * shifted, and a single change covering just the affected matches is
+ * emitted.
+ *
+ * When the filter criteria change, for example with every keystroke in a
+ * search entry, -refilter runs the filter over the whole source and emits
+ * one change spanning the first to the last position that differs. With
+ * -setBackground: enabled, large sources are filtered on a worker thread
+ * while the model keeps showing the previous result; the filter function
+ * must then be thread-safe. A refilter still running when the source or
+ * the criteria change again is cancelled and restarted, so only the newest
+ * result is ever applied.
+ *
+ */
+@interface OGFilterListModel : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)filterListModelWithModel:(GListModel*)model func:(OGioFilterListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+/**
+ * Methods
+ */
+
+- (OGioFilterListModel*)castedGObject;
+
+/**
+ * The source model.
+ *
+ * @return the #GListModel being filtered
+ */
+- (GListModel*)model;
+
+/**
+ * Replaces the filter function and refilters the model.
+ *
+ * @param func the new filter function
+ * @param userData user data for @func
+ * @param userDataDestroy function to release @userData, or %NULL
+ */
+- (void)setFilterFunc:(OGioFilterListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+/**
+ * Runs the filter over all items again, after the criteria it checks
+ * have changed.
+ */
+- (void)refilter;
+
+/**
+ * Whether large sources are refiltered on a worker thread.
+ *
+ * @return whether background filtering is enabled
+ */
+- (bool)background;
+
+/**
+ * Sets whether large sources are refiltered on a worker thread.
+ *
+ * @param background whether to filter in the background
+ */
+- (void)setBackground:(bool)background;
+
+/**
+ * Returns whether a background refilter is in progress, in which case the
+ * model still shows the result of the previous filter.
+ *
+ * @return whether a refilter is pending
+ */
+- (bool)isPending;
+
+@end
@@ -0,0 +1,452 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterListModel.h"
+
+/* Sources smaller than this are refiltered synchronously even in the
+ * background mode, as the thread hop would cost more than the filtering. */
+#define BACKGROUND_THRESHOLD 4096
+#define CANCEL_CHECK_INTERVAL 1024
+
+/*
+ * The filter function and its data are reference counted, since a
+ * background refilter keeps using them after they have been replaced.
+ */
+typedef struct {
+	OGioFilterListModelFunc func;
+	gpointer userData;
+	GDestroyNotify userDataDestroy;
+} Filter;
+
+typedef struct {
+	Filter* filter;
+	GPtrArray* items;
+} RefilterData;
+
+struct _OGioFilterListModel {
+	GObject parent_instance;
+
+	GListModel* model;
+	gulong itemsChangedHandler;
+
+	Filter* filter;
+	/* The source positions of the matching items, ascending. */
+	GArray* matches;
+
+	gboolean background;
+	GCancellable* pending;
+};
+
+static void ogio_filter_list_model_list_model_init(GListModelInterface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioFilterListModel, ogio_filter_list_model, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, ogio_filter_list_model_list_model_init))
+
+static void filterClear(gpointer data)
+{
+	Filter* filter = data;
+
+	if (filter->userDataDestroy != NULL)
+		filter->userDataDestroy(filter->userData);
+}
+
+static void filterRelease(Filter* filter)
+{
+	g_atomic_rc_box_release_full(filter, filterClear);
+}
+
+static void refilterDataFree(gpointer data)
+{
+	RefilterData* refilterData = data;
+
+	filterRelease(refilterData->filter);
+	g_ptr_array_unref(refilterData->items);
+	g_free(refilterData);
+}
+
+static inline gboolean accepts(Filter* filter, gpointer item)
+{
+	return filter->func(item, filter->userData);
+}
+
+static guint lowerBound(GArray* matches, guint sourcePosition)
+{
+	guint low = 0, high = matches->len;
+
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+
+		if (g_array_index(matches, guint, middle) < sourcePosition)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	return low;
+}
+
+/* Replaces the matches, emitting the range between the first and the last
+ * position that differ. */
+static void applyMatches(OGioFilterListModel* self, GArray* matches)
+{
+	GArray* old = self->matches;
+	guint oldLen = old->len, newLen = matches->len;
+	guint common = MIN(oldLen, newLen);
+	guint prefix = 0, suffix = 0;
+
+	while (prefix < common && g_array_index(old, guint, prefix) == g_array_index(matches, guint, prefix))
+		prefix++;
+
+	while (suffix < common - prefix && g_array_index(old, guint, oldLen - 1 - suffix) == g_array_index(matches, guint, newLen - 1 - suffix))
+		suffix++;
+
+	self->matches = matches;
+	g_array_unref(old);
+
+	if (oldLen - prefix - suffix > 0 || newLen - prefix - suffix > 0)
+		g_list_model_items_changed(G_LIST_MODEL(self), prefix, oldLen - prefix - suffix, newLen - prefix - suffix);
+}
+
+static void refilterThread(GTask* task, gpointer sourceObject, gpointer taskData, GCancellable* cancellable)
+{
+	RefilterData* data = taskData;
+	GArray* matches = g_array_new(FALSE, FALSE, sizeof(guint));
+
+	for (guint i = 0; i < data->items->len; i++) {
+		if (i % CANCEL_CHECK_INTERVAL == 0 && g_task_return_error_if_cancelled(task)) {
+			g_array_unref(matches);
+			return;
+		}
+
+		if (accepts(data->filter, g_ptr_array_index(data->items, i)))
+			g_array_append_val(matches, i);
+	}
+
+	g_task_return_pointer(task, matches, (GDestroyNotify)g_array_unref);
+}
+
+static void refilterDone(GObject* sourceObject, GAsyncResult* result, gpointer userData)
+{
+	OGioFilterListModel* self = OGIO_FILTER_LIST_MODEL(sourceObject);
+	GTask* task = G_TASK(result);
+
+	/* Superseded refilters were cancelled, so they return an error. */
+	GArray* matches = g_task_propagate_pointer(task, NULL);
+
+	if (matches == NULL)
+		return;
+
+	if (g_task_get_cancellable(task) != self->pending) {
+		g_array_unref(matches);
+		return;
+	}
+
+	g_clear_object(&self->pending);
+	applyMatches(self, matches);
+}
+
+static void cancelRefilter(OGioFilterListModel* self)
+{
+	if (self->pending == NULL)
+		return;
+
+	g_cancellable_cancel(self->pending);
+	g_clear_object(&self->pending);
+}
+
+static void startRefilter(OGioFilterListModel* self)
+{
+	guint count = g_list_model_get_n_items(self->model);
+
+	cancelRefilter(self);
+
+	if (!self->background || count < BACKGROUND_THRESHOLD) {
+		GArray* matches = g_array_new(FALSE, FALSE, sizeof(guint));
+
+		for (guint i = 0; i < count; i++) {
+			gpointer item = g_list_model_get_item(self->model, i);
+
+			if (accepts(self->filter, item))
+				g_array_append_val(matches, i);
+
+			g_object_unref(item);
+		}
+
+		applyMatches(self, matches);
+		return;
+	}
+
+	/* The worker gets its own references to the items, so the source may
+	 * change meanwhile; any change cancels and restarts the refilter. */
+	RefilterData* data = g_new(RefilterData, 1);
+	data->filter = g_atomic_rc_box_acquire(self->filter);
+	data->items = g_ptr_array_new_full(count, g_object_unref);
+
+	for (guint i = 0; i < count; i++)
+		g_ptr_array_add(data->items, g_list_model_get_item(self->model, i));
+
+	self->pending = g_cancellable_new();
+
+	GTask* task = g_task_new(self, self->pending, refilterDone, NULL);
+	g_task_set_source_tag(task, startRefilter);
+	g_task_set_task_data(task, data, refilterDataFree);
+	g_task_run_in_thread(task, refilterThread);
+	g_object_unref(task);
+}
+
+static void itemsChanged(GListModel* model, guint position, guint removed, guint added, gpointer userData)
+{
+	OGioFilterListModel* self = userData;
+	gboolean restart = (self->pending != NULL);
+	GArray* inserted = g_array_new(FALSE, FALSE, sizeof(guint));
+	guint first, last;
+
+	cancelRefilter(self);
+
+	first = lowerBound(self->matches, position);
+	last = lowerBound(self->matches, position + removed);
+
+	if (last > first)
+		g_array_remove_range(self->matches, first, last - first);
+
+	for (guint i = first; i < self->matches->len; i++)
+		g_array_index(self->matches, guint, i) = g_array_index(self->matches, guint, i) - removed + added;
+
+	for (guint i = position; i < position + added; i++) {
+		gpointer item = g_list_model_get_item(model, i);
+
+		if (accepts(self->filter, item))
+			g_array_append_val(inserted, i);
+
+		g_object_unref(item);
+	}
+
+	g_array_insert_vals(self->matches, first, inserted->data, inserted->len);
+
+	if (last > first || inserted->len > 0)
+		g_list_model_items_changed(G_LIST_MODEL(self), first, last - first, inserted->len);
+
+	g_array_unref(inserted);
+
+	/* A refilter in progress was working on the old source. */
+	if (restart)
+		startRefilter(self);
+}
+
+static GType ogio_filter_list_model_get_item_type(GListModel* model)
+{
+	return g_list_model_get_item_type(OGIO_FILTER_LIST_MODEL(model)->model);
+}
+
+static guint ogio_filter_list_model_get_n_items(GListModel* model)
+{
+	return OGIO_FILTER_LIST_MODEL(model)->matches->len;
+}
+
+static gpointer ogio_filter_list_model_get_item(GListModel* model, guint position)
+{
+	OGioFilterListModel* self = OGIO_FILTER_LIST_MODEL(model);
+
+	if (position >= self->matches->len)
+		return NULL;
+
+	return g_list_model_get_item(self->model, g_array_index(self->matches, guint, position));
+}
+
+static void ogio_filter_list_model_list_model_init(GListModelInterface* iface)
+{
+	iface->get_item_type = ogio_filter_list_model_get_item_type;
+	iface->get_n_items = ogio_filter_list_model_get_n_items;
+	iface->get_item = ogio_filter_list_model_get_item;
+}
+
+static void ogio_filter_list_model_init(OGioFilterListModel* self)
+{
+	self->matches = g_array_new(FALSE, FALSE, sizeof(guint));
+}
+
+static void ogio_filter_list_model_finalize(GObject* object)
+{
+	OGioFilterListModel* self = OGIO_FILTER_LIST_MODEL(object);
+
+	g_clear_signal_handler(&self->itemsChangedHandler, self->model);
+	g_clear_object(&self->model);
+	g_clear_object(&self->pending);
+
+	if (self->filter != NULL)
+		filterRelease(self->filter);
+
+	g_array_unref(self->matches);
+
+	G_OBJECT_CLASS(ogio_filter_list_model_parent_class)->finalize(object);
+}
+
+static void ogio_filter_list_model_class_init(OGioFilterListModelClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_filter_list_model_finalize;
+}
+
+OGioFilterListModel* ogio_filter_list_model_new(GListModel* model, OGioFilterListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_val_if_fail(G_IS_LIST_MODEL(model), NULL);
+	g_return_val_if_fail(func != NULL, NULL);
+
+	OGioFilterListModel* self = g_object_new(OGIO_TYPE_FILTER_LIST_MODEL, NULL);
+
+	self->model = g_object_ref(model);
+	self->itemsChangedHandler = g_signal_connect(model, "items-changed", G_CALLBACK(itemsChanged), self);
+
+	ogio_filter_list_model_set_filter_func(self, func, userData, userDataDestroy);
+
+	return self;
+}
+
+GListModel* ogio_filter_list_model_get_model(OGioFilterListModel* self)
+{
+	g_return_val_if_fail(OGIO_IS_FILTER_LIST_MODEL(self), NULL);
+
+	return self->model;
+}
+
+void ogio_filter_list_model_set_filter_func(OGioFilterListModel* self, OGioFilterListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_if_fail(OGIO_IS_FILTER_LIST_MODEL(self));
+	g_return_if_fail(func != NULL);
+
+	Filter* filter = g_atomic_rc_box_new0(Filter);
+	filter->func = func;
+	filter->userData = userData;
+	filter->userDataDestroy = userDataDestroy;
+
+	if (self->filter != NULL)
+		filterRelease(self->filter);
+
+	self->filter = filter;
+
+	startRefilter(self);
+}
+
+void ogio_filter_list_model_refilter(OGioFilterListModel* self)
+{
+	g_return_if_fail(OGIO_IS_FILTER_LIST_MODEL(self));
+
+	startRefilter(self);
+}
+
+gboolean ogio_filter_list_model_get_background(OGioFilterListModel* self)
+{
+	g_return_val_if_fail(OGIO_IS_FILTER_LIST_MODEL(self), FALSE);
+
+	return self->background;
+}
+
+void ogio_filter_list_model_set_background(OGioFilterListModel* self, gboolean background)
+{
+	g_return_if_fail(OGIO_IS_FILTER_LIST_MODEL(self));
+
+	self->background = background;
+}
+
+gboolean ogio_filter_list_model_is_pending(OGioFilterListModel* self)
+{
+	g_return_val_if_fail(OGIO_IS_FILTER_LIST_MODEL(self), FALSE);
+
+	return (self->pending != NULL);
+}
+
+@implementation OGFilterListModel
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_FILTER_LIST_MODEL;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_FILTER_LIST_MODEL);
+	return gObjectClass;
+}
+
++ (instancetype)filterListModelWithModel:(GListModel*)model func:(OGioFilterListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (!G_IS_LIST_MODEL(model) || func == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioFilterListModel* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_filter_list_model_new(model, func, userData, userDataDestroy), OGIO_TYPE_FILTER_LIST_MODEL, OGioFilterListModel);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGFilterListModel* wrapperObject;
+	@try {
+		wrapperObject = [[OGFilterListModel alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioFilterListModel*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_FILTER_LIST_MODEL, OGioFilterListModel);
+}
+
+- (GListModel*)model
+{
+	GListModel* returnValue = (GListModel*)ogio_filter_list_model_get_model((OGioFilterListModel*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setFilterFunc:(OGioFilterListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (func == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_filter_list_model_set_filter_func((OGioFilterListModel*)[self castedGObject], func, userData, userDataDestroy);
+}
+
+- (void)refilter
+{
+	ogio_filter_list_model_refilter((OGioFilterListModel*)[self castedGObject]);
+}
+
+- (bool)background
+{
+	bool returnValue = (bool)ogio_filter_list_model_get_background((OGioFilterListModel*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setBackground:(bool)background
+{
+	ogio_filter_list_model_set_background((OGioFilterListModel*)[self castedGObject], background);
+}
+
+- (bool)isPending
+{
+	bool returnValue = (bool)ogio_filter_list_model_is_pending((OGioFilterListModel*)[self castedGObject]);
+
+	return returnValue;
+}
+
+@end
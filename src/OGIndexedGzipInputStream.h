@@ -0,0 +1,130 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterInputStream.h"
+
+@class OGOutputStream;
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM (ogio_indexed_gzip_input_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioIndexedGzipInputStream, ogio_indexed_gzip_input_stream, OGIO, INDEXED_GZIP_INPUT_STREAM, GFilterInputStream)
+
+GInputStream* ogio_indexed_gzip_input_stream_new(GInputStream* baseStream, guint64 span);
+gboolean ogio_indexed_gzip_input_stream_build_index(OGioIndexedGzipInputStream* stream, GCancellable* cancellable, GError** error);
+gboolean ogio_indexed_gzip_input_stream_save_index(OGioIndexedGzipInputStream* stream, GOutputStream* indexStream, GCancellable* cancellable, GError** error);
+gboolean ogio_indexed_gzip_input_stream_load_index(OGioIndexedGzipInputStream* stream, GInputStream* indexStream, GCancellable* cancellable, GError** error);
+guint ogio_indexed_gzip_input_stream_get_checkpoint_count(OGioIndexedGzipInputStream* stream);
+gboolean ogio_indexed_gzip_input_stream_is_index_complete(OGioIndexedGzipInputStream* stream);
+
+G_END_DECLS
+
+/**
+ * `OGIndexedGzipInputStream` decompresses a gzip stream read from a seekable
+ * base stream and implements [iface@Gio.Seekable] on the
+ * uncompressed data.
+ *
+ * While data is decompressed, the stream records a checkpoint roughly every
+ * @span uncompressed bytes: the compressed offset of a deflate block
+ * boundary together with the 32 KiB of output preceding it. A seek restarts
+ * decompression at the closest checkpoint before the target, so random
+ * access costs at most one span of decompression once the region has been
+ * indexed. Seeking beyond the indexed region extends the index on the way.
+ *
+ * The index can be built up front with -buildIndexWithCancellable: and
+ * persisted with -saveIndexToStream:cancellable:, so later readers of the
+ * same file can load it instead of scanning the whole archive. Windows are
+ * kept deflated, which keeps the index at around 10 KiB per checkpoint.
+ *
+ * The compressed data has to start at offset 0 of the base stream.
+ * Multi-member gzip files are supported.
+ *
+ */
+@interface OGIndexedGzipInputStream : OGFilterInputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)indexedGzipInputStreamWithBaseStream:(OGInputStream*)baseStream span:(guint64)span;
+
+/**
+ * Methods
+ */
+
+- (OGioIndexedGzipInputStream*)castedGObject;
+
+/**
+ * Decompresses the remainder of the input to complete the index. The read
+ * position of the stream is not changed.
+ *
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE on success
+ */
+- (bool)buildIndexWithCancellable:(OGCancellable*)cancellable;
+
+/**
+ * Writes the checkpoints collected so far to @indexStream.
+ *
+ * @param indexStream the stream to write the index to
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE on success
+ */
+- (bool)saveIndexToStream:(OGOutputStream*)indexStream cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Replaces the index by one previously written with
+ * -saveIndexToStream:cancellable: for the same compressed data.
+ *
+ * @param indexStream the stream to read the index from
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE on success
+ */
+- (bool)loadIndexFromStream:(OGInputStream*)indexStream cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Returns the number of checkpoints in the index.
+ *
+ * @return the number of checkpoints
+ */
+- (guint)checkpointCount;
+
+/**
+ * Returns whether the whole input has been indexed, in which case the
+ * uncompressed size is known and seeking relative to the end is cheap.
+ *
+ * @return whether the index is complete
+ */
+- (bool)isIndexComplete;
+
+/**
+ * Tells the current uncompressed position within the stream.
+ *
+ * @return the current offset
+ */
+- (goffset)tell;
+
+/**
+ * Seeks to an uncompressed position. The decompressor is only repositioned
+ * by the next read.
+ *
+ * @param offset a #goffset
+ * @param type a #GSeekType
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE on success
+ */
+- (bool)seekToOffset:(goffset)offset type:(GSeekType)type cancellable:(OGCancellable*)cancellable;
+
+@end
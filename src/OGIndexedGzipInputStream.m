@@ -0,0 +1,747 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGIndexedGzipInputStream.h"
+
+#import "OGCancellable.h"
+#import "OGOutputStream.h"
+
+#include <zlib.h>
+
+#define WINDOW_SIZE 32768
+#define INPUT_SIZE (64 * 1024)
+#define DEFAULT_SPAN (4 * 1024 * 1024)
+#define GZIP_TRAILER_SIZE 8
+#define GZIP_WINDOW_BITS (16 + 15)
+
+static const char indexMagic[8] = { 'O', 'G', 'G', 'Z', 'I', 'D', 'X', 1 };
+
+typedef struct {
+	guint64 outOffset;
+	guint64 inOffset;
+	guint8 bits;
+	GBytes* window;
+} CheckPoint;
+
+struct _OGioIndexedGzipInputStream {
+	GFilterInputStream parent_instance;
+
+	guint64 span;
+	GPtrArray* points;
+	gboolean indexComplete;
+	guint64 length;
+
+	/* Logical read position; the decoder catches up on the next read. */
+	guint64 position;
+
+	z_stream inflater;
+	gboolean started;
+	gboolean raw;
+	gboolean memberOpen;
+	gsize skip;
+	guint8* input;
+	guint64 inPosition;
+	gboolean baseEof;
+	gboolean eof;
+
+	/* Output is inflated into a circular window that also feeds checkpoints. */
+	guint8* window;
+	gsize have;
+	gsize delivered;
+	guint64 outTotal;
+};
+
+static void ogio_indexed_gzip_input_stream_seekable_init(GSeekableIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioIndexedGzipInputStream, ogio_indexed_gzip_input_stream, G_TYPE_FILTER_INPUT_STREAM,
+	G_IMPLEMENT_INTERFACE(G_TYPE_SEEKABLE, ogio_indexed_gzip_input_stream_seekable_init))
+
+static void checkPointFree(CheckPoint* point)
+{
+	g_bytes_unref(point->window);
+	g_free(point);
+}
+
+static guint64 cursorOf(OGioIndexedGzipInputStream* self)
+{
+	return self->outTotal - (self->have - self->delivered);
+}
+
+static void addCheckPoint(OGioIndexedGzipInputStream* self)
+{
+	guint64 last = 0;
+
+	if (self->points->len > 0)
+		last = ((CheckPoint*)g_ptr_array_index(self->points, self->points->len - 1))->outOffset;
+
+	if (self->outTotal < last + self->span)
+		return;
+
+	/* The oldest bytes of the window follow the ones written last. */
+	guint8 linear[WINDOW_SIZE];
+	memcpy(linear, self->window + self->have, WINDOW_SIZE - self->have);
+	memcpy(linear + WINDOW_SIZE - self->have, self->window, self->have);
+
+	uLongf size = compressBound(WINDOW_SIZE);
+	guint8* deflated = g_malloc(size);
+
+	if (compress2(deflated, &size, linear, WINDOW_SIZE, Z_BEST_SPEED) != Z_OK) {
+		g_free(deflated);
+		return;
+	}
+
+	CheckPoint* point = g_new(CheckPoint, 1);
+	point->outOffset = self->outTotal;
+	point->inOffset = self->inPosition - self->inflater.avail_in;
+	point->bits = self->inflater.data_type & 7;
+	point->window = g_bytes_new_take(g_realloc(deflated, size), size);
+
+	g_ptr_array_add(self->points, point);
+}
+
+static gboolean fillInput(OGioIndexedGzipInputStream* self, GCancellable* cancellable, GError** error)
+{
+	GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+
+	gssize read = g_input_stream_read(base, self->input, INPUT_SIZE, cancellable, error);
+	if (read < 0)
+		return FALSE;
+
+	if (read == 0)
+		self->baseEof = TRUE;
+
+	self->inflater.next_in = self->input;
+	self->inflater.avail_in = (uInt)read;
+	self->inPosition += read;
+
+	return TRUE;
+}
+
+static gboolean restartDecoder(OGioIndexedGzipInputStream* self, CheckPoint* point, GCancellable* cancellable, GError** error)
+{
+	GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+	guint64 offset = 0;
+
+	if (point != NULL)
+		offset = point->inOffset - (point->bits > 0 ? 1 : 0);
+
+	if (!g_seekable_seek(G_SEEKABLE(base), (goffset)offset, G_SEEK_SET, cancellable, error))
+		return FALSE;
+
+	self->started = FALSE;
+	self->inPosition = offset;
+	self->inflater.avail_in = 0;
+	self->baseEof = FALSE;
+	self->eof = FALSE;
+	self->skip = 0;
+	self->have = self->delivered = 0;
+	self->inflater.next_out = self->window;
+	self->inflater.avail_out = WINDOW_SIZE;
+
+	if (point == NULL) {
+		inflateReset2(&self->inflater, GZIP_WINDOW_BITS);
+		self->raw = FALSE;
+		self->memberOpen = FALSE;
+		self->outTotal = 0;
+		self->started = TRUE;
+
+		return TRUE;
+	}
+
+	inflateReset2(&self->inflater, -15);
+	self->raw = TRUE;
+	self->memberOpen = TRUE;
+	self->outTotal = point->outOffset;
+
+	if (point->bits > 0) {
+		if (!fillInput(self, cancellable, error))
+			return FALSE;
+
+		if (self->inflater.avail_in == 0) {
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Gzip index does not match the compressed data");
+			return FALSE;
+		}
+
+		int byte = *self->inflater.next_in;
+		self->inflater.next_in++;
+		self->inflater.avail_in--;
+		inflatePrime(&self->inflater, point->bits, byte >> (8 - point->bits));
+	}
+
+	gsize deflatedSize;
+	const guint8* deflated = g_bytes_get_data(point->window, &deflatedSize);
+	guint8 dictionary[WINDOW_SIZE];
+	uLongf dictionarySize = WINDOW_SIZE;
+
+	if (uncompress(dictionary, &dictionarySize, deflated, deflatedSize) != Z_OK || dictionarySize != WINDOW_SIZE) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Corrupt gzip index checkpoint");
+		return FALSE;
+	}
+
+	inflateSetDictionary(&self->inflater, dictionary, WINDOW_SIZE);
+	self->started = TRUE;
+
+	return TRUE;
+}
+
+/* Inflates more output into the window. Must only be called once everything in the window was delivered. */
+static gboolean decodeMore(OGioIndexedGzipInputStream* self, GCancellable* cancellable, GError** error)
+{
+	z_stream* inflater = &self->inflater;
+
+	if (self->have == WINDOW_SIZE) {
+		inflater->next_out = self->window;
+		inflater->avail_out = WINDOW_SIZE;
+		self->have = self->delivered = 0;
+	}
+
+	for (;;) {
+		if (inflater->avail_in == 0 && !self->baseEof && !fillInput(self, cancellable, error))
+			return FALSE;
+
+		if (self->skip > 0) {
+			gsize skipped = MIN(self->skip, inflater->avail_in);
+
+			inflater->next_in += skipped;
+			inflater->avail_in -= (uInt)skipped;
+			self->skip -= skipped;
+
+			if (self->skip > 0) {
+				if (self->baseEof) {
+					g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated gzip trailer");
+					return FALSE;
+				}
+
+				continue;
+			}
+
+			inflateReset2(inflater, GZIP_WINDOW_BITS);
+			self->raw = FALSE;
+		}
+
+		if (inflater->avail_in == 0 && self->baseEof) {
+			if (self->memberOpen) {
+				g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated gzip member");
+				return FALSE;
+			}
+
+			self->eof = TRUE;
+
+			if (!self->indexComplete) {
+				self->indexComplete = TRUE;
+				self->length = self->outTotal;
+			}
+
+			return TRUE;
+		}
+
+		uInt before = inflater->avail_out;
+		int result = inflate(inflater, Z_BLOCK);
+
+		if (result != Z_OK && result != Z_STREAM_END && result != Z_BUF_ERROR) {
+			g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid gzip data: %s", inflater->msg != NULL ? inflater->msg : "unknown error");
+			return FALSE;
+		}
+
+		gsize produced = before - inflater->avail_out;
+		self->have += produced;
+		self->outTotal += produced;
+
+		if (result == Z_STREAM_END) {
+			self->memberOpen = FALSE;
+
+			/* A raw inflater stops in front of the gzip trailer. */
+			if (self->raw)
+				self->skip = GZIP_TRAILER_SIZE;
+			else
+				inflateReset(inflater);
+		} else {
+			if (result == Z_OK)
+				self->memberOpen = TRUE;
+
+			if ((inflater->data_type & 128) && !(inflater->data_type & 64))
+				addCheckPoint(self);
+		}
+
+		if (produced > 0)
+			return TRUE;
+	}
+}
+
+static CheckPoint* findCheckPoint(OGioIndexedGzipInputStream* self, guint64 offset)
+{
+	guint low = 0;
+	guint high = self->points->len;
+
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+
+		if (((CheckPoint*)g_ptr_array_index(self->points, middle))->outOffset <= offset)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	if (low == 0)
+		return NULL;
+
+	return g_ptr_array_index(self->points, low - 1);
+}
+
+/* Moves the decoder to the logical position, restarting from a checkpoint where that is cheaper. */
+static gboolean positionDecoder(OGioIndexedGzipInputStream* self, GCancellable* cancellable, GError** error)
+{
+	CheckPoint* point = findCheckPoint(self, self->position);
+	guint64 cursor = cursorOf(self);
+
+	if (!self->started || self->position < cursor || (point != NULL && point->outOffset > cursor)) {
+		if (!restartDecoder(self, point, cancellable, error))
+			return FALSE;
+	}
+
+	while ((cursor = cursorOf(self)) < self->position) {
+		if (self->delivered < self->have) {
+			self->delivered += (gsize)MIN(self->have - self->delivered, self->position - cursor);
+			continue;
+		}
+
+		if (self->eof)
+			break;
+
+		if (!decodeMore(self, cancellable, error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static gssize ogio_indexed_gzip_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioIndexedGzipInputStream* self = OGIO_INDEXED_GZIP_INPUT_STREAM(stream);
+
+	if (count == 0)
+		return 0;
+
+	if (!positionDecoder(self, cancellable, error))
+		return -1;
+
+	while (self->delivered == self->have && !self->eof) {
+		if (!decodeMore(self, cancellable, error))
+			return -1;
+	}
+
+	if (self->delivered == self->have)
+		return 0;
+
+	gsize chunk = MIN(count, self->have - self->delivered);
+	memcpy(buffer, self->window + self->delivered, chunk);
+	self->delivered += chunk;
+	self->position += chunk;
+
+	return (gssize)chunk;
+}
+
+static gboolean buildIndex(OGioIndexedGzipInputStream* self, GCancellable* cancellable, GError** error)
+{
+	if (self->indexComplete)
+		return TRUE;
+
+	CheckPoint* last = NULL;
+	if (self->points->len > 0)
+		last = g_ptr_array_index(self->points, self->points->len - 1);
+
+	if (!self->started || cursorOf(self) < (last != NULL ? last->outOffset : 0)) {
+		if (!restartDecoder(self, last, cancellable, error))
+			return FALSE;
+	}
+
+	while (!self->eof) {
+		self->delivered = self->have;
+
+		if (!decodeMore(self, cancellable, error))
+			return FALSE;
+	}
+
+	return TRUE;
+}
+
+static goffset ogio_indexed_gzip_input_stream_tell(GSeekable* seekable)
+{
+	return (goffset)OGIO_INDEXED_GZIP_INPUT_STREAM(seekable)->position;
+}
+
+static gboolean ogio_indexed_gzip_input_stream_can_seek(GSeekable* seekable)
+{
+	GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(seekable));
+
+	return g_seekable_can_seek(G_SEEKABLE(base));
+}
+
+static gboolean ogio_indexed_gzip_input_stream_seek(GSeekable* seekable, goffset offset, GSeekType type, GCancellable* cancellable, GError** error)
+{
+	OGioIndexedGzipInputStream* self = OGIO_INDEXED_GZIP_INPUT_STREAM(seekable);
+	GInputStream* stream = G_INPUT_STREAM(seekable);
+	goffset origin = 0;
+
+	if (!g_input_stream_set_pending(stream, error))
+		return FALSE;
+
+	switch (type) {
+	case G_SEEK_CUR:
+		origin = (goffset)self->position;
+		break;
+	case G_SEEK_END:
+		if (!buildIndex(self, cancellable, error)) {
+			g_input_stream_clear_pending(stream);
+			return FALSE;
+		}
+
+		origin = (goffset)self->length;
+		break;
+	default:
+		break;
+	}
+
+	g_input_stream_clear_pending(stream);
+
+	if (offset < -origin) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid seek request");
+		return FALSE;
+	}
+
+	self->position = (guint64)(origin + offset);
+
+	return TRUE;
+}
+
+static gboolean ogio_indexed_gzip_input_stream_can_truncate(GSeekable* seekable)
+{
+	return FALSE;
+}
+
+static gboolean ogio_indexed_gzip_input_stream_truncate(GSeekable* seekable, goffset offset, GCancellable* cancellable, GError** error)
+{
+	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Cannot truncate an input stream");
+
+	return FALSE;
+}
+
+static void ogio_indexed_gzip_input_stream_seekable_init(GSeekableIface* iface)
+{
+	iface->tell = ogio_indexed_gzip_input_stream_tell;
+	iface->can_seek = ogio_indexed_gzip_input_stream_can_seek;
+	iface->seek = ogio_indexed_gzip_input_stream_seek;
+	iface->can_truncate = ogio_indexed_gzip_input_stream_can_truncate;
+	iface->truncate_fn = ogio_indexed_gzip_input_stream_truncate;
+}
+
+static void ogio_indexed_gzip_input_stream_finalize(GObject* object)
+{
+	OGioIndexedGzipInputStream* self = OGIO_INDEXED_GZIP_INPUT_STREAM(object);
+
+	inflateEnd(&self->inflater);
+	g_ptr_array_unref(self->points);
+	g_free(self->input);
+	g_free(self->window);
+
+	G_OBJECT_CLASS(ogio_indexed_gzip_input_stream_parent_class)->finalize(object);
+}
+
+static void ogio_indexed_gzip_input_stream_init(OGioIndexedGzipInputStream* self)
+{
+	self->span = DEFAULT_SPAN;
+	self->points = g_ptr_array_new_with_free_func((GDestroyNotify)checkPointFree);
+	self->input = g_malloc(INPUT_SIZE);
+	self->window = g_malloc(WINDOW_SIZE);
+
+	inflateInit2(&self->inflater, GZIP_WINDOW_BITS);
+}
+
+static void ogio_indexed_gzip_input_stream_class_init(OGioIndexedGzipInputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GInputStreamClass* streamClass = G_INPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_indexed_gzip_input_stream_finalize;
+
+	streamClass->read_fn = ogio_indexed_gzip_input_stream_read;
+}
+
+GInputStream* ogio_indexed_gzip_input_stream_new(GInputStream* baseStream, guint64 span)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(baseStream), NULL);
+	g_return_val_if_fail(G_IS_SEEKABLE(baseStream), NULL);
+
+	OGioIndexedGzipInputStream* self = g_object_new(OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM, "base-stream", baseStream, NULL);
+
+	if (span != 0)
+		self->span = MAX(span, WINDOW_SIZE);
+
+	return G_INPUT_STREAM(self);
+}
+
+gboolean ogio_indexed_gzip_input_stream_build_index(OGioIndexedGzipInputStream* stream, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_INDEXED_GZIP_INPUT_STREAM(stream), FALSE);
+
+	if (!g_input_stream_set_pending(G_INPUT_STREAM(stream), error))
+		return FALSE;
+
+	gboolean result = buildIndex(stream, cancellable, error);
+
+	g_input_stream_clear_pending(G_INPUT_STREAM(stream));
+
+	return result;
+}
+
+gboolean ogio_indexed_gzip_input_stream_save_index(OGioIndexedGzipInputStream* stream, GOutputStream* indexStream, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_INDEXED_GZIP_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(indexStream), FALSE);
+
+	GDataOutputStream* output = g_data_output_stream_new(indexStream);
+	g_filter_output_stream_set_close_base_stream(G_FILTER_OUTPUT_STREAM(output), FALSE);
+	g_data_output_stream_set_byte_order(output, G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN);
+
+	gboolean result = (g_output_stream_write_all(G_OUTPUT_STREAM(output), indexMagic, sizeof(indexMagic), NULL, cancellable, error) && g_data_output_stream_put_uint64(output, stream->span, cancellable, error) && g_data_output_stream_put_byte(output, stream->indexComplete ? 1 : 0, cancellable, error) && g_data_output_stream_put_uint64(output, stream->length, cancellable, error) && g_data_output_stream_put_uint32(output, stream->points->len, cancellable, error));
+
+	for (guint i = 0; result && i < stream->points->len; i++) {
+		CheckPoint* point = g_ptr_array_index(stream->points, i);
+		gsize size;
+		const void* window = g_bytes_get_data(point->window, &size);
+
+		result = (g_data_output_stream_put_uint64(output, point->outOffset, cancellable, error) && g_data_output_stream_put_uint64(output, point->inOffset, cancellable, error) && g_data_output_stream_put_byte(output, point->bits, cancellable, error) && g_data_output_stream_put_uint32(output, (guint32)size, cancellable, error) && g_output_stream_write_all(G_OUTPUT_STREAM(output), window, size, NULL, cancellable, error));
+	}
+
+	if (result)
+		result = g_output_stream_flush(G_OUTPUT_STREAM(output), cancellable, error);
+
+	g_object_unref(output);
+
+	return result;
+}
+
+gboolean ogio_indexed_gzip_input_stream_load_index(OGioIndexedGzipInputStream* stream, GInputStream* indexStream, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_INDEXED_GZIP_INPUT_STREAM(stream), FALSE);
+	g_return_val_if_fail(G_IS_INPUT_STREAM(indexStream), FALSE);
+
+	GDataInputStream* input = g_data_input_stream_new(indexStream);
+	g_filter_input_stream_set_close_base_stream(G_FILTER_INPUT_STREAM(input), FALSE);
+	g_data_input_stream_set_byte_order(input, G_DATA_STREAM_BYTE_ORDER_LITTLE_ENDIAN);
+
+	GPtrArray* points = g_ptr_array_new_with_free_func((GDestroyNotify)checkPointFree);
+	GError* localError = NULL;
+	char magic[sizeof(indexMagic)];
+	gsize read = 0;
+	guint64 span = 0;
+	gboolean complete = FALSE;
+	guint64 length = 0;
+	gboolean valid = FALSE;
+
+	if (!g_input_stream_read_all(G_INPUT_STREAM(input), magic, sizeof(magic), &read, cancellable, &localError))
+		goto out;
+
+	if (read != sizeof(magic) || memcmp(magic, indexMagic, sizeof(magic)) != 0)
+		goto out;
+
+	span = g_data_input_stream_read_uint64(input, cancellable, &localError);
+	if (localError == NULL)
+		complete = g_data_input_stream_read_byte(input, cancellable, &localError) != 0;
+	if (localError == NULL)
+		length = g_data_input_stream_read_uint64(input, cancellable, &localError);
+
+	guint32 count = 0;
+	if (localError == NULL)
+		count = g_data_input_stream_read_uint32(input, cancellable, &localError);
+
+	for (guint32 i = 0; localError == NULL && i < count; i++) {
+		guint64 outOffset = g_data_input_stream_read_uint64(input, cancellable, &localError);
+		guint64 inOffset = (localError == NULL ? g_data_input_stream_read_uint64(input, cancellable, &localError) : 0);
+		guint8 bits = (localError == NULL ? g_data_input_stream_read_byte(input, cancellable, &localError) : 0);
+		guint32 size = (localError == NULL ? g_data_input_stream_read_uint32(input, cancellable, &localError) : 0);
+
+		if (localError != NULL)
+			goto out;
+
+		if (bits > 7 || size > compressBound(WINDOW_SIZE) || (bits > 0 && inOffset == 0))
+			goto out;
+
+		if (points->len > 0 && ((CheckPoint*)g_ptr_array_index(points, points->len - 1))->outOffset >= outOffset)
+			goto out;
+
+		guint8* window = g_malloc(size);
+		if (!g_input_stream_read_all(G_INPUT_STREAM(input), window, size, &read, cancellable, &localError) || read != size) {
+			g_free(window);
+			goto out;
+		}
+
+		CheckPoint* point = g_new(CheckPoint, 1);
+		point->outOffset = outOffset;
+		point->inOffset = inOffset;
+		point->bits = bits;
+		point->window = g_bytes_new_take(window, size);
+		g_ptr_array_add(points, point);
+	}
+
+	valid = (localError == NULL && span >= WINDOW_SIZE);
+
+out:
+	g_object_unref(input);
+
+	if (localError != NULL) {
+		g_propagate_error(error, localError);
+		g_ptr_array_unref(points);
+		return FALSE;
+	}
+
+	if (!valid) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid gzip index");
+		g_ptr_array_unref(points);
+		return FALSE;
+	}
+
+	g_ptr_array_unref(stream->points);
+	stream->points = points;
+	stream->span = span;
+	stream->indexComplete = complete;
+	stream->length = length;
+	stream->started = FALSE;
+
+	return TRUE;
+}
+
+guint ogio_indexed_gzip_input_stream_get_checkpoint_count(OGioIndexedGzipInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_INDEXED_GZIP_INPUT_STREAM(stream), 0);
+
+	return stream->points->len;
+}
+
+gboolean ogio_indexed_gzip_input_stream_is_index_complete(OGioIndexedGzipInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_INDEXED_GZIP_INPUT_STREAM(stream), FALSE);
+
+	return stream->indexComplete;
+}
+
+@implementation OGIndexedGzipInputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)indexedGzipInputStreamWithBaseStream:(OGInputStream*)baseStream span:(guint64)span
+{
+	if (baseStream == nil || !G_IS_SEEKABLE([baseStream castedGObject]))
+		@throw [OFInvalidArgumentException exception];
+
+	OGioIndexedGzipInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_indexed_gzip_input_stream_new([baseStream castedGObject], span), OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM, OGioIndexedGzipInputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGIndexedGzipInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGIndexedGzipInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioIndexedGzipInputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_INDEXED_GZIP_INPUT_STREAM, OGioIndexedGzipInputStream);
+}
+
+- (bool)buildIndexWithCancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)ogio_indexed_gzip_input_stream_build_index((OGioIndexedGzipInputStream*)[self castedGObject], [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (bool)saveIndexToStream:(OGOutputStream*)indexStream cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)ogio_indexed_gzip_input_stream_save_index((OGioIndexedGzipInputStream*)[self castedGObject], [indexStream castedGObject], [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (bool)loadIndexFromStream:(OGInputStream*)indexStream cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)ogio_indexed_gzip_input_stream_load_index((OGioIndexedGzipInputStream*)[self castedGObject], [indexStream castedGObject], [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (guint)checkpointCount
+{
+	guint returnValue = (guint)ogio_indexed_gzip_input_stream_get_checkpoint_count((OGioIndexedGzipInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (bool)isIndexComplete
+{
+	bool returnValue = (bool)ogio_indexed_gzip_input_stream_is_index_complete((OGioIndexedGzipInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (goffset)tell
+{
+	goffset returnValue = (goffset)g_seekable_tell(G_SEEKABLE([self castedGObject]));
+
+	return returnValue;
+}
+
+- (bool)seekToOffset:(goffset)offset type:(GSeekType)type cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)g_seekable_seek(G_SEEKABLE([self castedGObject]), offset, type, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+@end
@@ -0,0 +1,103 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGListStore;
+
+G_BEGIN_DECLS
+
+/**
+ * Extracts the sort key of @item. The key is passed to the key comparison
+ * function in place of the item.
+ *
+ * Returns: the sort key of @item
+ */
+typedef gpointer (*OGioListStoreKeyFunc)(gpointer item, gpointer userData);
+
+void ogio_list_store_sort_parallel(GListStore* store, GCompareDataFunc compareFunc, gpointer userData, guint threads);
+void ogio_list_store_sort_by_key(GListStore* store, OGioListStoreKeyFunc keyFunc, GCompareDataFunc keyCompareFunc, GDestroyNotify keyDestroy, gpointer userData, guint threads);
+gboolean ogio_list_store_find_sorted(GListStore* store, gpointer item, GCompareDataFunc compareFunc, gpointer userData, guint* position);
+
+G_END_DECLS
+
+/**
+ * `OGListStoreSorting` sorts the items of an #OGListStore with a merge sort
+ * that runs on several threads, and searches sorted stores in logarithmic
+ * time.
+ *
+ * -[OGListStore sortWithCompareFunc:userData:] sorts on the calling thread
+ * and emits the change item by item through the underlying sequence. The
+ * functions here copy the items into an array once, sort consecutive runs
+ * of it in parallel, merge the runs pairwise, again in parallel, and put
+ * the result back with a single splice. The sort is stable.
+ *
+ * Because the comparison function is called from worker threads, it must
+ * be thread-safe and must not touch the store. Passing 0 threads uses one
+ * thread per processor; small stores are always sorted on the calling
+ * thread.
+ *
+ * When comparing two items is expensive, for example because a collation
+ * key has to be computed from a file name, the key-extracted sort computes
+ * the key of every item once and compares the keys instead.
+ *
+ */
+@interface OGListStoreSorting : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Sorts the items of @store according to @compareFunc.
+ *
+ * @param store the store to sort
+ * @param compareFunc thread-safe pairwise comparison function for sorting
+ * @param userData user data for @compareFunc
+ * @param threads the number of threads to use, 0 for one per processor
+ */
++ (void)sortListStore:(OGListStore*)store compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData threads:(guint)threads;
+
+/**
+ * Sorts the items of @store by comparing the keys @keyFunc returns for
+ * them. @keyFunc is called exactly once per item, possibly from a worker
+ * thread, and every key is released with @keyDestroy after sorting.
+ *
+ * @param store the store to sort
+ * @param keyFunc thread-safe function extracting the sort key of an item
+ * @param keyCompareFunc thread-safe pairwise comparison function for keys
+ * @param keyDestroy function to free the keys, or %NULL
+ * @param userData user data for @keyFunc and @keyCompareFunc
+ * @param threads the number of threads to use, 0 for one per processor
+ */
++ (void)sortListStore:(OGListStore*)store keyFunc:(OGioListStoreKeyFunc)keyFunc keyCompareFunc:(GCompareDataFunc)keyCompareFunc keyDestroy:(GDestroyNotify)keyDestroy userData:(gpointer)userData threads:(guint)threads;
+
+/**
+ * Looks up @item in @store, which must be sorted according to
+ * @compareFunc, with a binary search. Of the items comparing equal to
+ * @item, only @item itself matches.
+ *
+ * @param store a sorted store
+ * @param item an item
+ * @param compareFunc pairwise comparison function the store is sorted by
+ * @param userData user data for @compareFunc
+ * @param position the position of @item, if it was found.
+ * @return Whether @store contains @item.
+ */
++ (bool)findInSortedListStore:(OGListStore*)store item:(gpointer)item compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData position:(guint*)position;
+
+@end
@@ -0,0 +1,315 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGListStoreSorting.h"
+
+#import "OGListStore.h"
+
+#include <string.h>
+
+/* Runs shorter than this are sorted by insertion before merging. */
+#define INSERTION_RUN 32
+/* The smallest run worth handing to a thread of its own. */
+#define MIN_THREAD_RUN 4096
+
+typedef struct {
+	gpointer key;
+	gpointer item;
+} SortEntry;
+
+typedef struct {
+	SortEntry* entries;
+	SortEntry* scratch;
+	gsize begin;
+	gsize middle;
+	gsize end;
+	OGioListStoreKeyFunc keyFunc;
+	GCompareDataFunc compareFunc;
+	gpointer userData;
+} SortTask;
+
+static void insertionSort(SortEntry* entries, gsize count, GCompareDataFunc compareFunc, gpointer userData)
+{
+	for (gsize i = 1; i < count; i++) {
+		SortEntry entry = entries[i];
+		gsize j = i;
+
+		while (j > 0 && compareFunc(entries[j - 1].key, entry.key, userData) > 0) {
+			entries[j] = entries[j - 1];
+			j--;
+		}
+
+		entries[j] = entry;
+	}
+}
+
+static void mergeInto(const SortEntry* src, gsize begin, gsize middle, gsize end, SortEntry* dst, GCompareDataFunc compareFunc, gpointer userData)
+{
+	gsize i = begin, j = middle, k = begin;
+
+	while (i < middle && j < end) {
+		/* Taking from the left run on ties keeps the sort stable. */
+		if (compareFunc(src[j].key, src[i].key, userData) < 0)
+			dst[k++] = src[j++];
+		else
+			dst[k++] = src[i++];
+	}
+
+	memcpy(dst + k, src + i, (middle - i) * sizeof(SortEntry));
+	k += middle - i;
+	memcpy(dst + k, src + j, (end - j) * sizeof(SortEntry));
+}
+
+static void sortRange(SortEntry* entries, SortEntry* scratch, gsize count, GCompareDataFunc compareFunc, gpointer userData)
+{
+	SortEntry* src = entries;
+	SortEntry* dst = scratch;
+
+	for (gsize begin = 0; begin < count; begin += INSERTION_RUN)
+		insertionSort(entries + begin, MIN(INSERTION_RUN, count - begin), compareFunc, userData);
+
+	for (gsize width = INSERTION_RUN; width < count; width *= 2) {
+		for (gsize begin = 0; begin < count; begin += 2 * width)
+			mergeInto(src, begin, MIN(begin + width, count), MIN(begin + 2 * width, count), dst, compareFunc, userData);
+
+		SortEntry* tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != entries)
+		memcpy(entries, src, count * sizeof(SortEntry));
+}
+
+static gpointer sortRunThread(gpointer data)
+{
+	SortTask* task = data;
+
+	if (task->keyFunc != NULL)
+		for (gsize i = task->begin; i < task->end; i++)
+			task->entries[i].key = task->keyFunc(task->entries[i].item, task->userData);
+
+	sortRange(task->entries + task->begin, task->scratch + task->begin, task->end - task->begin, task->compareFunc, task->userData);
+
+	return NULL;
+}
+
+static gpointer mergeRunsThread(gpointer data)
+{
+	SortTask* task = data;
+
+	mergeInto(task->entries, task->begin, task->middle, task->end, task->scratch, task->compareFunc, task->userData);
+
+	return NULL;
+}
+
+/* Runs the first task on the calling thread and the others on new threads. */
+static void runTasks(GThreadFunc func, SortTask* tasks, guint count)
+{
+	GThread** threads = g_new(GThread*, count);
+
+	for (guint i = 1; i < count; i++)
+		threads[i] = g_thread_new("ogio-list-sort", func, &tasks[i]);
+
+	func(&tasks[0]);
+
+	for (guint i = 1; i < count; i++)
+		g_thread_join(threads[i]);
+
+	g_free(threads);
+}
+
+static void sortEntries(SortEntry* entries, gsize count, OGioListStoreKeyFunc keyFunc, GCompareDataFunc compareFunc, gpointer userData, guint threads)
+{
+	SortEntry* scratch = g_new(SortEntry, count);
+	SortEntry* src = entries;
+	SortEntry* dst = scratch;
+	guint runs;
+
+	if (threads == 0)
+		threads = g_get_num_processors();
+
+	runs = (guint)MIN((gsize)threads, MAX(count / MIN_THREAD_RUN, 1));
+
+	gsize* bounds = g_new(gsize, runs + 1);
+	SortTask* tasks = g_new0(SortTask, runs);
+
+	for (guint i = 0; i <= runs; i++)
+		bounds[i] = count * i / runs;
+
+	for (guint i = 0; i < runs; i++) {
+		tasks[i].entries = entries;
+		tasks[i].scratch = scratch;
+		tasks[i].begin = bounds[i];
+		tasks[i].end = bounds[i + 1];
+		tasks[i].keyFunc = keyFunc;
+		tasks[i].compareFunc = compareFunc;
+		tasks[i].userData = userData;
+	}
+
+	runTasks(sortRunThread, tasks, runs);
+
+	while (runs > 1) {
+		guint pairs = runs / 2;
+		guint merged = (runs + 1) / 2;
+
+		for (guint i = 0; i < pairs; i++) {
+			tasks[i].entries = src;
+			tasks[i].scratch = dst;
+			tasks[i].begin = bounds[2 * i];
+			tasks[i].middle = bounds[2 * i + 1];
+			tasks[i].end = bounds[2 * i + 2];
+			tasks[i].keyFunc = NULL;
+		}
+
+		runTasks(mergeRunsThread, tasks, pairs);
+
+		if (runs % 2 != 0)
+			memcpy(dst + bounds[runs - 1], src + bounds[runs - 1], (bounds[runs] - bounds[runs - 1]) * sizeof(SortEntry));
+
+		for (guint i = 0; i < merged; i++)
+			bounds[i] = bounds[2 * i];
+
+		bounds[merged] = count;
+		runs = merged;
+
+		SortEntry* tmp = src;
+		src = dst;
+		dst = tmp;
+	}
+
+	if (src != entries)
+		memcpy(entries, src, count * sizeof(SortEntry));
+
+	g_free(tasks);
+	g_free(bounds);
+	g_free(scratch);
+}
+
+static void sortStore(GListStore* store, OGioListStoreKeyFunc keyFunc, GCompareDataFunc compareFunc, GDestroyNotify keyDestroy, gpointer userData, guint threads)
+{
+	guint count = g_list_model_get_n_items(G_LIST_MODEL(store));
+
+	if (count < 2)
+		return;
+
+	SortEntry* entries = g_new(SortEntry, count);
+	gpointer* items = g_new(gpointer, count);
+
+	/* Sequential positions are served from the store's cached iterator. */
+	for (guint i = 0; i < count; i++)
+		entries[i].key = entries[i].item = g_list_model_get_item(G_LIST_MODEL(store), i);
+
+	sortEntries(entries, count, keyFunc, compareFunc, userData, threads);
+
+	for (guint i = 0; i < count; i++) {
+		items[i] = entries[i].item;
+
+		if (keyFunc != NULL && keyDestroy != NULL)
+			keyDestroy(entries[i].key);
+	}
+
+	g_free(entries);
+
+	g_list_store_splice(store, 0, count, items, count);
+
+	for (guint i = 0; i < count; i++)
+		g_object_unref(items[i]);
+
+	g_free(items);
+}
+
+void ogio_list_store_sort_parallel(GListStore* store, GCompareDataFunc compareFunc, gpointer userData, guint threads)
+{
+	g_return_if_fail(G_IS_LIST_STORE(store));
+	g_return_if_fail(compareFunc != NULL);
+
+	sortStore(store, NULL, compareFunc, NULL, userData, threads);
+}
+
+void ogio_list_store_sort_by_key(GListStore* store, OGioListStoreKeyFunc keyFunc, GCompareDataFunc keyCompareFunc, GDestroyNotify keyDestroy, gpointer userData, guint threads)
+{
+	g_return_if_fail(G_IS_LIST_STORE(store));
+	g_return_if_fail(keyFunc != NULL);
+	g_return_if_fail(keyCompareFunc != NULL);
+
+	sortStore(store, keyFunc, keyCompareFunc, keyDestroy, userData, threads);
+}
+
+gboolean ogio_list_store_find_sorted(GListStore* store, gpointer item, GCompareDataFunc compareFunc, gpointer userData, guint* position)
+{
+	g_return_val_if_fail(G_IS_LIST_STORE(store), FALSE);
+	g_return_val_if_fail(compareFunc != NULL, FALSE);
+
+	GListModel* model = G_LIST_MODEL(store);
+	guint count = g_list_model_get_n_items(model);
+	guint low = 0, high = count;
+
+	/* Find the first item not ordered before @item. */
+	while (low < high) {
+		guint middle = low + (high - low) / 2;
+		gpointer other = g_list_model_get_item(model, middle);
+		gint result = compareFunc(other, item, userData);
+
+		g_object_unref(other);
+
+		if (result < 0)
+			low = middle + 1;
+		else
+			high = middle;
+	}
+
+	/* Walk the run of items comparing equal to @item. */
+	for (guint i = low; i < count; i++) {
+		gpointer other = g_list_model_get_item(model, i);
+		gboolean found = (other == item);
+		gboolean equal = found || compareFunc(other, item, userData) == 0;
+
+		g_object_unref(other);
+
+		if (found) {
+			if (position != NULL)
+				*position = i;
+
+			return TRUE;
+		}
+
+		if (!equal)
+			break;
+	}
+
+	return FALSE;
+}
+
+@implementation OGListStoreSorting
+
++ (void)sortListStore:(OGListStore*)store compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData threads:(guint)threads
+{
+	if (store == nil || compareFunc == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_list_store_sort_parallel([store castedGObject], compareFunc, userData, threads);
+}
+
++ (void)sortListStore:(OGListStore*)store keyFunc:(OGioListStoreKeyFunc)keyFunc keyCompareFunc:(GCompareDataFunc)keyCompareFunc keyDestroy:(GDestroyNotify)keyDestroy userData:(gpointer)userData threads:(guint)threads
+{
+	if (store == nil || keyFunc == NULL || keyCompareFunc == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_list_store_sort_by_key([store castedGObject], keyFunc, keyCompareFunc, keyDestroy, userData, threads);
+}
+
++ (bool)findInSortedListStore:(OGListStore*)store item:(gpointer)item compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData position:(guint*)position
+{
+	if (store == nil || compareFunc == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	bool returnValue = (bool)ogio_list_store_find_sorted([store castedGObject], item, compareFunc, userData, position);
+
+	return returnValue;
+}
+
+@end
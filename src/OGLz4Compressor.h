@@ -0,0 +1,73 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_LZ4_COMPRESSOR (ogio_lz4_compressor_get_type())
+G_DECLARE_FINAL_TYPE(OGioLz4Compressor, ogio_lz4_compressor, OGIO, LZ4_COMPRESSOR, GObject)
+
+OGioLz4Compressor* ogio_lz4_compressor_new(int level, GBytes* dictionary);
+int ogio_lz4_compressor_get_level(OGioLz4Compressor* compressor);
+
+G_END_DECLS
+
+/**
+ * `OGLz4Compressor` is an implementation of [iface@Gio.Converter] that
+ * compresses data into LZ4 frames.
+ *
+ * Each conversion until g_converter_reset() produces one frame with linked
+ * 64 KiB blocks and a content checksum. %G_CONVERTER_FLUSH ends the current
+ * block so that everything written so far can be decompressed by the peer.
+ *
+ * Level 0 selects the fast compressor, levels from 3 to 12 the slower high
+ * compression mode; negative levels trade ratio for even more speed. An
+ * optional dictionary improves the ratio on small, similar payloads; the
+ * decompressor has to be given the same dictionary.
+ *
+ */
+@interface OGLz4Compressor : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)lz4CompressorWithLevel:(int)level;
+
++ (instancetype)lz4CompressorWithLevel:(int)level dictionary:(GBytes*)dictionary;
+
+/**
+ * Methods
+ */
+
+- (OGioLz4Compressor*)castedGObject;
+
+/**
+ * Returns the compression level the compressor was created with.
+ *
+ * @return the compression level
+ */
+- (int)level;
+
+@end
@@ -0,0 +1,255 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGLz4Compressor.h"
+
+#include <lz4frame.h>
+#include <lz4hc.h>
+
+#define CHUNK_SIZE (64 * 1024)
+
+struct _OGioLz4Compressor {
+	GObject parent_instance;
+
+	LZ4F_cctx* context;
+	LZ4F_CDict* dictionary;
+	LZ4F_preferences_t preferences;
+	int level;
+
+	/* LZ4F needs a worst-case sized destination, so output is staged here. */
+	guint8* pending;
+	gsize pendingCapacity;
+	gsize pendingOffset;
+	gsize pendingLength;
+
+	gboolean started;
+	gboolean ended;
+};
+
+static void ogio_lz4_compressor_converter_init(GConverterIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioLz4Compressor, ogio_lz4_compressor, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, ogio_lz4_compressor_converter_init))
+
+static GConverterResult ogio_lz4_compressor_convert(GConverter* converter, const void* inbuf, gsize inbufSize, void* outbuf, gsize outbufSize, GConverterFlags flags, gsize* bytesRead, gsize* bytesWritten, GError** error)
+{
+	OGioLz4Compressor* self = OGIO_LZ4_COMPRESSOR(converter);
+	gsize read = 0;
+	gsize written = 0;
+	gboolean flushed = FALSE;
+
+	for (;;) {
+		if (self->pendingOffset < self->pendingLength) {
+			gsize chunk = MIN(self->pendingLength - self->pendingOffset, outbufSize - written);
+
+			memcpy((guint8*)outbuf + written, self->pending + self->pendingOffset, chunk);
+			self->pendingOffset += chunk;
+			written += chunk;
+
+			if (self->pendingOffset < self->pendingLength)
+				break;
+		}
+
+		self->pendingOffset = self->pendingLength = 0;
+
+		if (self->ended)
+			break;
+
+		size_t result;
+		gsize consumed = 0;
+
+		if (!self->started) {
+			if (self->dictionary != NULL)
+				result = LZ4F_compressBegin_usingCDict(self->context, self->pending, self->pendingCapacity, self->dictionary, &self->preferences);
+			else
+				result = LZ4F_compressBegin(self->context, self->pending, self->pendingCapacity, &self->preferences);
+
+			self->started = TRUE;
+		} else if (read < inbufSize) {
+			consumed = MIN(inbufSize - read, CHUNK_SIZE);
+			result = LZ4F_compressUpdate(self->context, self->pending, self->pendingCapacity, (const guint8*)inbuf + read, consumed, NULL);
+		} else if (flags & G_CONVERTER_INPUT_AT_END) {
+			result = LZ4F_compressEnd(self->context, self->pending, self->pendingCapacity, NULL);
+			self->ended = TRUE;
+		} else if ((flags & G_CONVERTER_FLUSH) && !flushed) {
+			result = LZ4F_flush(self->context, self->pending, self->pendingCapacity, NULL);
+			flushed = TRUE;
+		} else {
+			break;
+		}
+
+		if (LZ4F_isError(result)) {
+			g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "LZ4 compression failed: %s", LZ4F_getErrorName(result));
+			return G_CONVERTER_ERROR;
+		}
+
+		read += consumed;
+		self->pendingLength = result;
+	}
+
+	*bytesRead = read;
+	*bytesWritten = written;
+
+	if (self->ended && self->pendingLength == 0)
+		return G_CONVERTER_FINISHED;
+
+	if (flushed && self->pendingLength == 0)
+		return G_CONVERTER_FLUSHED;
+
+	if (read == 0 && written == 0) {
+		if (outbufSize == 0 || self->pendingLength > 0)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Not enough space in output buffer");
+		else
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Need more input");
+
+		return G_CONVERTER_ERROR;
+	}
+
+	return G_CONVERTER_CONVERTED;
+}
+
+static void ogio_lz4_compressor_reset(GConverter* converter)
+{
+	OGioLz4Compressor* self = OGIO_LZ4_COMPRESSOR(converter);
+
+	/* LZ4F_compressBegin() starts the context over for the next frame. */
+	self->pendingOffset = self->pendingLength = 0;
+	self->started = FALSE;
+	self->ended = FALSE;
+}
+
+static void ogio_lz4_compressor_converter_init(GConverterIface* iface)
+{
+	iface->convert = ogio_lz4_compressor_convert;
+	iface->reset = ogio_lz4_compressor_reset;
+}
+
+static void ogio_lz4_compressor_finalize(GObject* object)
+{
+	OGioLz4Compressor* self = OGIO_LZ4_COMPRESSOR(object);
+
+	LZ4F_freeCompressionContext(self->context);
+	LZ4F_freeCDict(self->dictionary);
+	g_free(self->pending);
+
+	G_OBJECT_CLASS(ogio_lz4_compressor_parent_class)->finalize(object);
+}
+
+static void ogio_lz4_compressor_init(OGioLz4Compressor* self)
+{
+	if (LZ4F_isError(LZ4F_createCompressionContext(&self->context, LZ4F_VERSION)))
+		self->context = NULL;
+}
+
+static void ogio_lz4_compressor_class_init(OGioLz4CompressorClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_lz4_compressor_finalize;
+}
+
+OGioLz4Compressor* ogio_lz4_compressor_new(int level, GBytes* dictionary)
+{
+	g_return_val_if_fail(level <= LZ4HC_CLEVEL_MAX, NULL);
+
+	OGioLz4Compressor* self = g_object_new(OGIO_TYPE_LZ4_COMPRESSOR, NULL);
+
+	if (self->context == NULL) {
+		g_object_unref(self);
+		return NULL;
+	}
+
+	self->level = level;
+	self->preferences.compressionLevel = level;
+	self->preferences.frameInfo.blockSizeID = LZ4F_max64KB;
+	self->preferences.frameInfo.blockMode = LZ4F_blockLinked;
+	self->preferences.frameInfo.contentChecksumFlag = LZ4F_contentChecksumEnabled;
+
+	self->pendingCapacity = LZ4F_HEADER_SIZE_MAX + LZ4F_compressBound(CHUNK_SIZE, &self->preferences);
+	self->pending = g_malloc(self->pendingCapacity);
+
+	if (dictionary != NULL) {
+		gsize size;
+		const void* data = g_bytes_get_data(dictionary, &size);
+
+		self->dictionary = LZ4F_createCDict(data, size);
+		if (self->dictionary == NULL) {
+			g_object_unref(self);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+int ogio_lz4_compressor_get_level(OGioLz4Compressor* compressor)
+{
+	g_return_val_if_fail(OGIO_IS_LZ4_COMPRESSOR(compressor), 0);
+
+	return compressor->level;
+}
+
+@implementation OGLz4Compressor
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_LZ4_COMPRESSOR;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_LZ4_COMPRESSOR);
+	return gObjectClass;
+}
+
++ (instancetype)lz4CompressorWithLevel:(int)level
+{
+	return [self lz4CompressorWithLevel:level dictionary:NULL];
+}
+
++ (instancetype)lz4CompressorWithLevel:(int)level dictionary:(GBytes*)dictionary
+{
+	OGioLz4Compressor* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_lz4_compressor_new(level, dictionary), OGIO_TYPE_LZ4_COMPRESSOR, OGioLz4Compressor);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGLz4Compressor* wrapperObject;
+	@try {
+		wrapperObject = [[OGLz4Compressor alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioLz4Compressor*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_LZ4_COMPRESSOR, OGioLz4Compressor);
+}
+
+- (int)level
+{
+	int returnValue = (int)ogio_lz4_compressor_get_level((OGioLz4Compressor*)[self castedGObject]);
+
+	return returnValue;
+}
+
+@end
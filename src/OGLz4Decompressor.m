@@ -0,0 +1,179 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGLz4Decompressor.h"
+
+#include <lz4frame.h>
+
+struct _OGioLz4Decompressor {
+	GObject parent_instance;
+
+	LZ4F_dctx* context;
+	GBytes* dictionary;
+	gboolean inFrame;
+};
+
+static void ogio_lz4_decompressor_converter_init(GConverterIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioLz4Decompressor, ogio_lz4_decompressor, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, ogio_lz4_decompressor_converter_init))
+
+static GConverterResult ogio_lz4_decompressor_convert(GConverter* converter, const void* inbuf, gsize inbufSize, void* outbuf, gsize outbufSize, GConverterFlags flags, gsize* bytesRead, gsize* bytesWritten, GError** error)
+{
+	OGioLz4Decompressor* self = OGIO_LZ4_DECOMPRESSOR(converter);
+	size_t read = inbufSize;
+	size_t written = outbufSize;
+	size_t hint;
+
+	if (self->dictionary != NULL) {
+		gsize dictionarySize;
+		const void* dictionary = g_bytes_get_data(self->dictionary, &dictionarySize);
+
+		hint = LZ4F_decompress_usingDict(self->context, outbuf, &written, inbuf, &read, dictionary, dictionarySize, NULL);
+	} else {
+		hint = LZ4F_decompress(self->context, outbuf, &written, inbuf, &read, NULL);
+	}
+
+	if (LZ4F_isError(hint)) {
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid LZ4 data: %s", LZ4F_getErrorName(hint));
+		return G_CONVERTER_ERROR;
+	}
+
+	/* A hint of 0 means the frame has been decoded and fully flushed. */
+	if (read > 0 || written > 0)
+		self->inFrame = (hint != 0);
+
+	*bytesRead = read;
+	*bytesWritten = written;
+
+	if ((flags & G_CONVERTER_INPUT_AT_END) && read == inbufSize && !self->inFrame)
+		return G_CONVERTER_FINISHED;
+
+	if (read == 0 && written == 0) {
+		if (outbufSize == 0)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Not enough space in output buffer");
+		else if (flags & G_CONVERTER_INPUT_AT_END)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated LZ4 frame");
+		else if (flags & G_CONVERTER_FLUSH)
+			return G_CONVERTER_FLUSHED;
+		else
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Need more input");
+
+		return G_CONVERTER_ERROR;
+	}
+
+	if ((flags & G_CONVERTER_FLUSH) && read == inbufSize && written < outbufSize)
+		return G_CONVERTER_FLUSHED;
+
+	return G_CONVERTER_CONVERTED;
+}
+
+static void ogio_lz4_decompressor_reset(GConverter* converter)
+{
+	OGioLz4Decompressor* self = OGIO_LZ4_DECOMPRESSOR(converter);
+
+	LZ4F_resetDecompressionContext(self->context);
+	self->inFrame = FALSE;
+}
+
+static void ogio_lz4_decompressor_converter_init(GConverterIface* iface)
+{
+	iface->convert = ogio_lz4_decompressor_convert;
+	iface->reset = ogio_lz4_decompressor_reset;
+}
+
+static void ogio_lz4_decompressor_finalize(GObject* object)
+{
+	OGioLz4Decompressor* self = OGIO_LZ4_DECOMPRESSOR(object);
+
+	LZ4F_freeDecompressionContext(self->context);
+	g_clear_pointer(&self->dictionary, g_bytes_unref);
+
+	G_OBJECT_CLASS(ogio_lz4_decompressor_parent_class)->finalize(object);
+}
+
+static void ogio_lz4_decompressor_init(OGioLz4Decompressor* self)
+{
+	if (LZ4F_isError(LZ4F_createDecompressionContext(&self->context, LZ4F_VERSION)))
+		self->context = NULL;
+}
+
+static void ogio_lz4_decompressor_class_init(OGioLz4DecompressorClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_lz4_decompressor_finalize;
+}
+
+OGioLz4Decompressor* ogio_lz4_decompressor_new(GBytes* dictionary)
+{
+	OGioLz4Decompressor* self = g_object_new(OGIO_TYPE_LZ4_DECOMPRESSOR, NULL);
+
+	if (self->context == NULL) {
+		g_object_unref(self);
+		return NULL;
+	}
+
+	if (dictionary != NULL)
+		self->dictionary = g_bytes_ref(dictionary);
+
+	return self;
+}
+
+@implementation OGLz4Decompressor
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_LZ4_DECOMPRESSOR;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_LZ4_DECOMPRESSOR);
+	return gObjectClass;
+}
+
++ (instancetype)lz4Decompressor
+{
+	return [self lz4DecompressorWithDictionary:NULL];
+}
+
++ (instancetype)lz4DecompressorWithDictionary:(GBytes*)dictionary
+{
+	OGioLz4Decompressor* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_lz4_decompressor_new(dictionary), OGIO_TYPE_LZ4_DECOMPRESSOR, OGioLz4Decompressor);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGLz4Decompressor* wrapperObject;
+	@try {
+		wrapperObject = [[OGLz4Decompressor alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioLz4Decompressor*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_LZ4_DECOMPRESSOR, OGioLz4Decompressor);
+}
+
+@end
@@ -0,0 +1,88 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+/**
+ * Maps @item of the source model to the item an #OGioMapListModel shows
+ * in its place.
+ *
+ * Returns: (transfer full): the mapped item, an instance of the item type
+ * of the map model
+ */
+typedef GObject* (*OGioMapListModelFunc)(gpointer item, gpointer userData);
+
+#define OGIO_TYPE_MAP_LIST_MODEL (ogio_map_list_model_get_type())
+G_DECLARE_FINAL_TYPE(OGioMapListModel, ogio_map_list_model, OGIO, MAP_LIST_MODEL, GObject)
+
+OGioMapListModel* ogio_map_list_model_new(GListModel* model, GType itemType, OGioMapListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy);
+GListModel* ogio_map_list_model_get_model(OGioMapListModel* self);
+void ogio_map_list_model_set_map_func(OGioMapListModel* self, OGioMapListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy);
+
+G_END_DECLS
+
+/**
+ * `OGMapListModel` is a [iface@Gio.ListModel] presenting every item of a
+ * source model through a map function, for instance to turn file infos
+ * into row objects.
+ *
+ * Items are mapped when they are first requested and then cached, so only
+ * the visible part of a long list is ever mapped. A change of the source
+ * drops the cached items of the changed range only and is forwarded with
+ * the same position and counts. Replacing the map function drops the whole
+ * cache.
+ *
+ */
+@interface OGMapListModel : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)mapListModelWithModel:(GListModel*)model itemType:(GType)itemType func:(OGioMapListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+/**
+ * Methods
+ */
+
+- (OGioMapListModel*)castedGObject;
+
+/**
+ * The source model.
+ *
+ * @return the #GListModel being mapped
+ */
+- (GListModel*)model;
+
+/**
+ * Replaces the map function, dropping all mapped items.
+ *
+ * @param func the new map function
+ * @param userData user data for @func
+ * @param userDataDestroy function to release @userData, or %NULL
+ */
+- (void)setMapFunc:(OGioMapListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+@end
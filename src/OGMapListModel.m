@@ -0,0 +1,239 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGMapListModel.h"
+
+#include <string.h>
+
+struct _OGioMapListModel {
+	GObject parent_instance;
+
+	GListModel* model;
+	gulong itemsChangedHandler;
+	GType itemType;
+
+	OGioMapListModelFunc func;
+	gpointer userData;
+	GDestroyNotify userDataDestroy;
+
+	/* One slot per source position, NULL until the item is mapped. */
+	GPtrArray* cache;
+};
+
+static void ogio_map_list_model_list_model_init(GListModelInterface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioMapListModel, ogio_map_list_model, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, ogio_map_list_model_list_model_init))
+
+static void clearItem(gpointer item)
+{
+	if (item != NULL)
+		g_object_unref(item);
+}
+
+static void itemsChanged(GListModel* model, guint position, guint removed, guint added, gpointer userData)
+{
+	OGioMapListModel* self = userData;
+	GPtrArray* cache = self->cache;
+	guint tail;
+
+	if (removed > 0)
+		g_ptr_array_remove_range(cache, position, removed);
+
+	/* Open a gap of unmapped slots for the added items. */
+	tail = cache->len - position;
+	g_ptr_array_set_size(cache, cache->len + added);
+	memmove(cache->pdata + position + added, cache->pdata + position, tail * sizeof(gpointer));
+	memset(cache->pdata + position, 0, added * sizeof(gpointer));
+
+	g_list_model_items_changed(G_LIST_MODEL(self), position, removed, added);
+}
+
+static GType ogio_map_list_model_get_item_type(GListModel* model)
+{
+	return OGIO_MAP_LIST_MODEL(model)->itemType;
+}
+
+static guint ogio_map_list_model_get_n_items(GListModel* model)
+{
+	return OGIO_MAP_LIST_MODEL(model)->cache->len;
+}
+
+static gpointer ogio_map_list_model_get_item(GListModel* model, guint position)
+{
+	OGioMapListModel* self = OGIO_MAP_LIST_MODEL(model);
+	gpointer mapped;
+
+	if (position >= self->cache->len)
+		return NULL;
+
+	mapped = g_ptr_array_index(self->cache, position);
+
+	if (mapped == NULL) {
+		gpointer item = g_list_model_get_item(self->model, position);
+
+		mapped = self->func(item, self->userData);
+		g_object_unref(item);
+
+		if (mapped == NULL)
+			return NULL;
+
+		g_ptr_array_index(self->cache, position) = mapped;
+	}
+
+	return g_object_ref(mapped);
+}
+
+static void ogio_map_list_model_list_model_init(GListModelInterface* iface)
+{
+	iface->get_item_type = ogio_map_list_model_get_item_type;
+	iface->get_n_items = ogio_map_list_model_get_n_items;
+	iface->get_item = ogio_map_list_model_get_item;
+}
+
+static void ogio_map_list_model_init(OGioMapListModel* self)
+{
+	self->cache = g_ptr_array_new_with_free_func(clearItem);
+}
+
+static void ogio_map_list_model_finalize(GObject* object)
+{
+	OGioMapListModel* self = OGIO_MAP_LIST_MODEL(object);
+
+	g_clear_signal_handler(&self->itemsChangedHandler, self->model);
+	g_clear_object(&self->model);
+	g_ptr_array_unref(self->cache);
+
+	if (self->userDataDestroy != NULL)
+		self->userDataDestroy(self->userData);
+
+	G_OBJECT_CLASS(ogio_map_list_model_parent_class)->finalize(object);
+}
+
+static void ogio_map_list_model_class_init(OGioMapListModelClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_map_list_model_finalize;
+}
+
+OGioMapListModel* ogio_map_list_model_new(GListModel* model, GType itemType, OGioMapListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_val_if_fail(G_IS_LIST_MODEL(model), NULL);
+	g_return_val_if_fail(g_type_is_a(itemType, G_TYPE_OBJECT), NULL);
+	g_return_val_if_fail(func != NULL, NULL);
+
+	OGioMapListModel* self = g_object_new(OGIO_TYPE_MAP_LIST_MODEL, NULL);
+
+	self->model = g_object_ref(model);
+	self->itemType = itemType;
+	self->func = func;
+	self->userData = userData;
+	self->userDataDestroy = userDataDestroy;
+
+	g_ptr_array_set_size(self->cache, g_list_model_get_n_items(model));
+	self->itemsChangedHandler = g_signal_connect(model, "items-changed", G_CALLBACK(itemsChanged), self);
+
+	return self;
+}
+
+GListModel* ogio_map_list_model_get_model(OGioMapListModel* self)
+{
+	g_return_val_if_fail(OGIO_IS_MAP_LIST_MODEL(self), NULL);
+
+	return self->model;
+}
+
+void ogio_map_list_model_set_map_func(OGioMapListModel* self, OGioMapListModelFunc func, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_if_fail(OGIO_IS_MAP_LIST_MODEL(self));
+	g_return_if_fail(func != NULL);
+
+	guint count = self->cache->len;
+
+	for (guint i = 0; i < count; i++) {
+		clearItem(g_ptr_array_index(self->cache, i));
+		g_ptr_array_index(self->cache, i) = NULL;
+	}
+
+	if (self->userDataDestroy != NULL)
+		self->userDataDestroy(self->userData);
+
+	self->func = func;
+	self->userData = userData;
+	self->userDataDestroy = userDataDestroy;
+
+	if (count > 0)
+		g_list_model_items_changed(G_LIST_MODEL(self), 0, count, count);
+}
+
+@implementation OGMapListModel
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_MAP_LIST_MODEL;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_MAP_LIST_MODEL);
+	return gObjectClass;
+}
+
++ (instancetype)mapListModelWithModel:(GListModel*)model itemType:(GType)itemType func:(OGioMapListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (!G_IS_LIST_MODEL(model) || func == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioMapListModel* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_map_list_model_new(model, itemType, func, userData, userDataDestroy), OGIO_TYPE_MAP_LIST_MODEL, OGioMapListModel);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGMapListModel* wrapperObject;
+	@try {
+		wrapperObject = [[OGMapListModel alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioMapListModel*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_MAP_LIST_MODEL, OGioMapListModel);
+}
+
+- (GListModel*)model
+{
+	GListModel* returnValue = (GListModel*)ogio_map_list_model_get_model((OGioMapListModel*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setMapFunc:(OGioMapListModelFunc)func userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (func == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_map_list_model_set_map_func((OGioMapListModel*)[self castedGObject], func, userData, userDataDestroy);
+}
+
+@end
@@ -0,0 +1,120 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGInputStream.h"
+
+G_BEGIN_DECLS
+
+/**
+ * Access pattern hints for the mapping of an #OGioMappedFileInputStream,
+ * passed on to madvise().
+ */
+typedef enum {
+	/** No special treatment */
+	OG_MAPPED_FILE_ADVICE_NORMAL,
+	/** Pages will be accessed in order; read ahead aggressively */
+	OG_MAPPED_FILE_ADVICE_SEQUENTIAL,
+	/** Pages will be accessed in random order; do not read ahead */
+	OG_MAPPED_FILE_ADVICE_RANDOM,
+	/** Pages will be needed soon; start reading them in now */
+	OG_MAPPED_FILE_ADVICE_WILLNEED,
+	/** Pages will not be needed soon; they may be dropped from memory */
+	OG_MAPPED_FILE_ADVICE_DONTNEED
+} OGMappedFileAdvice;
+
+#define OGIO_TYPE_MAPPED_FILE_INPUT_STREAM (ogio_mapped_file_input_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioMappedFileInputStream, ogio_mapped_file_input_stream, OGIO, MAPPED_FILE_INPUT_STREAM, GInputStream)
+
+GInputStream* ogio_mapped_file_input_stream_new(const gchar* path, GError** error);
+GInputStream* ogio_mapped_file_input_stream_new_from_fd(gint fd, GError** error);
+gsize ogio_mapped_file_input_stream_get_size(OGioMappedFileInputStream* stream);
+GBytes* ogio_mapped_file_input_stream_get_bytes(OGioMappedFileInputStream* stream, gsize offset, gsize length);
+GBytes* ogio_mapped_file_input_stream_read_bytes(OGioMappedFileInputStream* stream, gsize count, GError** error);
+gboolean ogio_mapped_file_input_stream_advise(OGioMappedFileInputStream* stream, OGMappedFileAdvice advice, gsize offset, gsize length, GError** error);
+
+G_END_DECLS
+
+/**
+ * `OGMappedFileInputStream` is an input stream reading from a read-only
+ * memory mapping of a local file.
+ *
+ * Reads are served from the mapping without a system call, and
+ * -readBytesWithCount: and -bytesAtOffset:length: hand out #GBytes that
+ * reference the mapping instead of copying it; the mapping stays alive for
+ * as long as any of them does. The stream implements [iface@Gio.Seekable],
+ * see #OGSeekable.
+ *
+ * -adviseWithAdvice:offset:length: passes access pattern hints to the kernel,
+ * for instance %OG_MAPPED_FILE_ADVICE_SEQUENTIAL before scanning a file
+ * once, or %OG_MAPPED_FILE_ADVICE_WILLNEED to prefetch a range.
+ *
+ * The file must not be truncated while it is mapped: accessing pages past
+ * the new end of the file raises SIGBUS.
+ *
+ */
+@interface OGMappedFileInputStream : OGInputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)mappedFileInputStreamWithPath:(OFString*)path;
++ (instancetype)mappedFileInputStreamWithFd:(gint)fd;
+
+/**
+ * Methods
+ */
+
+- (OGioMappedFileInputStream*)castedGObject;
+
+/**
+ * Returns the size of the mapped file.
+ *
+ * @return the size in bytes
+ */
+- (gsize)size;
+
+/**
+ * Returns a #GBytes referencing @length bytes of the mapping starting at
+ * @offset, clamped to the end of the file. The position of the stream is
+ * not changed, so this may be called from any thread.
+ *
+ * @param offset the offset of the first byte
+ * @param length the number of bytes
+ * @return a #GBytes sharing memory with the mapping
+ */
+- (GBytes*)bytesAtOffset:(gsize)offset length:(gsize)length;
+
+/**
+ * Like -[OGInputStream readBytesWithCount:cancellable:], but returns a
+ * slice of the mapping instead of a copy.
+ *
+ * @param count maximum number of bytes that will be read from the stream
+ * @return a #GBytes sharing memory with the mapping, empty at the end of
+ *     the stream
+ */
+- (GBytes*)readBytesWithCount:(gsize)count;
+
+/**
+ * Tells the kernel how a range of the mapping is going to be accessed.
+ *
+ * @param advice the expected access pattern
+ * @param offset the offset of the range
+ * @param length the length of the range, 0 for the rest of the file
+ * @return %TRUE on success
+ */
+- (bool)adviseWithAdvice:(OGMappedFileAdvice)advice offset:(gsize)offset length:(gsize)length;
+
+@end
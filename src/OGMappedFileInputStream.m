@@ -0,0 +1,352 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGMappedFileInputStream.h"
+
+#include <errno.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+struct _OGioMappedFileInputStream {
+	GInputStream parent_instance;
+
+	GMappedFile* file;
+	GBytes* bytes;
+	const guint8* data;
+	gsize size;
+	gsize position;
+};
+
+static void ogio_mapped_file_input_stream_seekable_init(GSeekableIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioMappedFileInputStream, ogio_mapped_file_input_stream, G_TYPE_INPUT_STREAM,
+	G_IMPLEMENT_INTERFACE(G_TYPE_SEEKABLE, ogio_mapped_file_input_stream_seekable_init))
+
+static gssize ogio_mapped_file_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioMappedFileInputStream* self = OGIO_MAPPED_FILE_INPUT_STREAM(stream);
+	gsize chunk = MIN(count, self->size - self->position);
+
+	memcpy(buffer, self->data + self->position, chunk);
+	self->position += chunk;
+
+	return (gssize)chunk;
+}
+
+static gssize ogio_mapped_file_input_stream_skip(GInputStream* stream, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioMappedFileInputStream* self = OGIO_MAPPED_FILE_INPUT_STREAM(stream);
+	gsize chunk = MIN(count, self->size - self->position);
+
+	self->position += chunk;
+
+	return (gssize)chunk;
+}
+
+static goffset ogio_mapped_file_input_stream_tell(GSeekable* seekable)
+{
+	return (goffset)OGIO_MAPPED_FILE_INPUT_STREAM(seekable)->position;
+}
+
+static gboolean ogio_mapped_file_input_stream_can_seek(GSeekable* seekable)
+{
+	return TRUE;
+}
+
+static gboolean ogio_mapped_file_input_stream_seek(GSeekable* seekable, goffset offset, GSeekType type, GCancellable* cancellable, GError** error)
+{
+	OGioMappedFileInputStream* self = OGIO_MAPPED_FILE_INPUT_STREAM(seekable);
+	goffset origin = 0;
+
+	switch (type) {
+	case G_SEEK_CUR:
+		origin = (goffset)self->position;
+		break;
+	case G_SEEK_END:
+		origin = (goffset)self->size;
+		break;
+	default:
+		break;
+	}
+
+	if (offset < -origin || offset > (goffset)self->size - origin) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Invalid seek request");
+		return FALSE;
+	}
+
+	self->position = (gsize)(origin + offset);
+
+	return TRUE;
+}
+
+static gboolean ogio_mapped_file_input_stream_can_truncate(GSeekable* seekable)
+{
+	return FALSE;
+}
+
+static gboolean ogio_mapped_file_input_stream_truncate(GSeekable* seekable, goffset offset, GCancellable* cancellable, GError** error)
+{
+	g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Cannot truncate a mapped file input stream");
+
+	return FALSE;
+}
+
+static void ogio_mapped_file_input_stream_seekable_init(GSeekableIface* iface)
+{
+	iface->tell = ogio_mapped_file_input_stream_tell;
+	iface->can_seek = ogio_mapped_file_input_stream_can_seek;
+	iface->seek = ogio_mapped_file_input_stream_seek;
+	iface->can_truncate = ogio_mapped_file_input_stream_can_truncate;
+	iface->truncate_fn = ogio_mapped_file_input_stream_truncate;
+}
+
+static void ogio_mapped_file_input_stream_finalize(GObject* object)
+{
+	OGioMappedFileInputStream* self = OGIO_MAPPED_FILE_INPUT_STREAM(object);
+
+	g_clear_pointer(&self->bytes, g_bytes_unref);
+	g_clear_pointer(&self->file, g_mapped_file_unref);
+
+	G_OBJECT_CLASS(ogio_mapped_file_input_stream_parent_class)->finalize(object);
+}
+
+static void ogio_mapped_file_input_stream_init(OGioMappedFileInputStream* self)
+{
+}
+
+static void ogio_mapped_file_input_stream_class_init(OGioMappedFileInputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GInputStreamClass* streamClass = G_INPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_mapped_file_input_stream_finalize;
+
+	streamClass->read_fn = ogio_mapped_file_input_stream_read;
+	streamClass->skip = ogio_mapped_file_input_stream_skip;
+}
+
+static GInputStream* streamForMappedFile(GMappedFile* file)
+{
+	OGioMappedFileInputStream* self = g_object_new(OGIO_TYPE_MAPPED_FILE_INPUT_STREAM, NULL);
+
+	self->file = file;
+	self->bytes = g_mapped_file_get_bytes(file);
+	self->data = g_bytes_get_data(self->bytes, &self->size);
+
+	return G_INPUT_STREAM(self);
+}
+
+GInputStream* ogio_mapped_file_input_stream_new(const gchar* path, GError** error)
+{
+	g_return_val_if_fail(path != NULL, NULL);
+
+	GMappedFile* file = g_mapped_file_new(path, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	return streamForMappedFile(file);
+}
+
+GInputStream* ogio_mapped_file_input_stream_new_from_fd(gint fd, GError** error)
+{
+	g_return_val_if_fail(fd >= 0, NULL);
+
+	GMappedFile* file = g_mapped_file_new_from_fd(fd, FALSE, error);
+	if (file == NULL)
+		return NULL;
+
+	return streamForMappedFile(file);
+}
+
+gsize ogio_mapped_file_input_stream_get_size(OGioMappedFileInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_MAPPED_FILE_INPUT_STREAM(stream), 0);
+
+	return stream->size;
+}
+
+GBytes* ogio_mapped_file_input_stream_get_bytes(OGioMappedFileInputStream* stream, gsize offset, gsize length)
+{
+	g_return_val_if_fail(OGIO_IS_MAPPED_FILE_INPUT_STREAM(stream), NULL);
+
+	offset = MIN(offset, stream->size);
+	length = MIN(length, stream->size - offset);
+
+	return g_bytes_new_from_bytes(stream->bytes, offset, length);
+}
+
+GBytes* ogio_mapped_file_input_stream_read_bytes(OGioMappedFileInputStream* stream, gsize count, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_MAPPED_FILE_INPUT_STREAM(stream), NULL);
+
+	if (!g_input_stream_set_pending(G_INPUT_STREAM(stream), error))
+		return NULL;
+
+	gsize chunk = MIN(count, stream->size - stream->position);
+	GBytes* bytes = g_bytes_new_from_bytes(stream->bytes, stream->position, chunk);
+	stream->position += chunk;
+
+	g_input_stream_clear_pending(G_INPUT_STREAM(stream));
+
+	return bytes;
+}
+
+gboolean ogio_mapped_file_input_stream_advise(OGioMappedFileInputStream* stream, OGMappedFileAdvice advice, gsize offset, gsize length, GError** error)
+{
+	g_return_val_if_fail(OGIO_IS_MAPPED_FILE_INPUT_STREAM(stream), FALSE);
+
+	if (offset >= stream->size)
+		return TRUE;
+
+	if (length == 0 || length > stream->size - offset)
+		length = stream->size - offset;
+
+	/* madvise() wants a page-aligned start; the mapping itself is page aligned. */
+	gsize pageSize = (gsize)sysconf(_SC_PAGESIZE);
+	gsize alignment = offset % pageSize;
+	int flag;
+
+	switch (advice) {
+	case OG_MAPPED_FILE_ADVICE_SEQUENTIAL:
+		flag = MADV_SEQUENTIAL;
+		break;
+	case OG_MAPPED_FILE_ADVICE_RANDOM:
+		flag = MADV_RANDOM;
+		break;
+	case OG_MAPPED_FILE_ADVICE_WILLNEED:
+		flag = MADV_WILLNEED;
+		break;
+	case OG_MAPPED_FILE_ADVICE_DONTNEED:
+		flag = MADV_DONTNEED;
+		break;
+	default:
+		flag = MADV_NORMAL;
+		break;
+	}
+
+	if (madvise((void*)(stream->data + offset - alignment), length + alignment, flag) != 0) {
+		int errsv = errno;
+
+		g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "Error advising mapped file: %s", g_strerror(errsv));
+		return FALSE;
+	}
+
+	return TRUE;
+}
+
+@implementation OGMappedFileInputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_MAPPED_FILE_INPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_MAPPED_FILE_INPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)mappedFileInputStreamWithPath:(OFString*)path
+{
+	GError* err = NULL;
+
+	OGioMappedFileInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_mapped_file_input_stream_new([path UTF8String], &err), OGIO_TYPE_MAPPED_FILE_INPUT_STREAM, OGioMappedFileInputStream);
+
+	if OF_UNLIKELY(!gobjectValue) {
+		[OGErrorException throwForError:err];
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+	}
+
+	OGMappedFileInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGMappedFileInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
++ (instancetype)mappedFileInputStreamWithFd:(gint)fd
+{
+	GError* err = NULL;
+
+	OGioMappedFileInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_mapped_file_input_stream_new_from_fd(fd, &err), OGIO_TYPE_MAPPED_FILE_INPUT_STREAM, OGioMappedFileInputStream);
+
+	if OF_UNLIKELY(!gobjectValue) {
+		[OGErrorException throwForError:err];
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+	}
+
+	OGMappedFileInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGMappedFileInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioMappedFileInputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_MAPPED_FILE_INPUT_STREAM, OGioMappedFileInputStream);
+}
+
+- (gsize)size
+{
+	gsize returnValue = (gsize)ogio_mapped_file_input_stream_get_size((OGioMappedFileInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (GBytes*)bytesAtOffset:(gsize)offset length:(gsize)length
+{
+	GBytes* returnValue = (GBytes*)ogio_mapped_file_input_stream_get_bytes((OGioMappedFileInputStream*)[self castedGObject], offset, length);
+
+	return returnValue;
+}
+
+- (GBytes*)readBytesWithCount:(gsize)count
+{
+	GError* err = NULL;
+
+	GBytes* returnValue = (GBytes*)ogio_mapped_file_input_stream_read_bytes((OGioMappedFileInputStream*)[self castedGObject], count, &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (bool)adviseWithAdvice:(OGMappedFileAdvice)advice offset:(gsize)offset length:(gsize)length
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)ogio_mapped_file_input_stream_advise((OGioMappedFileInputStream*)[self castedGObject], advice, offset, length, &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+@end
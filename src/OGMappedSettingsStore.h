@@ -0,0 +1,90 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsStore.h"
+
+/**
+ * `OGMappedSettingsStore` is an #OGSettingsStore keeping its values in a
+ * memory-mapped, append-only file, for use with an
+ * #OGStoreSettingsBackend where no dconf daemon is available.
+ *
+ * Every write appends a record holding the key and the serialized value,
+ * protected by a CRC-32, to the file. The records of a tree write are
+ * marked as one transaction. When the file is opened, the records are
+ * replayed into an in-memory index up to the last complete transaction;
+ * a torn or corrupted tail left by a crash is cut off. The values in the
+ * index point straight into the mapping, so a read is a hash lookup
+ * under a read lock, without copying, parsing or any IPC.
+ *
+ * Durability is batched: with a sync interval, the first write after a
+ * sync arms a timer in the thread-default main context of the thread that
+ * created the store, and a single fdatasync() covers all writes made
+ * until it fires. With an interval of 0 every write is synced before it
+ * returns. -sync, also reached through g_settings_sync(), syncs at once.
+ *
+ * Once more than half of the file consists of overwritten records, the
+ * live values are written to a new file that atomically replaces the old
+ * one.
+ *
+ * The file is locked while the store is open, so only one process can use
+ * it at a time.
+ *
+ */
+@interface OGMappedSettingsStore : OGSettingsStore
+{
+	gchar* _path;
+	int _fd;
+	GRWLock _lock;
+	GBytes* _mapping;
+	gsize _capacity;
+	gsize _dataEnd;
+	gsize _liveBytes;
+	GHashTable* _index;
+	guint _syncIntervalMsecs;
+	GMainContext* _context;
+	GMutex _syncMutex;
+	GSource* _syncSource;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)mappedSettingsStoreWithPath:(OFString*)path syncIntervalMsecs:(guint)syncIntervalMsecs;
+
+/**
+ * Opens or creates the store at @path.
+ *
+ * @param path the file to keep the values in
+ * @param syncIntervalMsecs the longest time a write stays unsynced, 0 to
+ * sync every write
+ * @return an initialized store
+ */
+- (instancetype)initWithPath:(OFString*)path syncIntervalMsecs:(guint)syncIntervalMsecs;
+
+/**
+ * Methods
+ */
+
+/**
+ * The file the values are kept in.
+ *
+ * @return the path of the file
+ */
+- (OFString*)path;
+
+/**
+ * The number of keys with a stored value.
+ *
+ * @return the number of keys
+ */
+- (guint)count;
+
+/**
+ * Rewrites the file with only the live values.
+ */
+- (void)compact;
+
+@end
@@ -0,0 +1,670 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGMappedSettingsStore.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <string.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+#define FILE_MAGIC "OGSETTS"
+#define FILE_VERSION 1
+#define BYTE_ORDER_MARK 0x01020304
+/* The file and the mapping grow in steps of this size; the unused end
+ * of the file is zero-filled and marks the end of the records. */
+#define GROWTH_STEP (256 * 1024)
+#define COMPACT_MIN_DEAD (1024 * 1024)
+
+#define RECORD_RESET (1 << 0)
+/* Set on all but the last record of a transaction. */
+#define RECORD_CONTINUED (1 << 1)
+
+#define ALIGN8(n) (((n) + 7) & ~(gsize)7)
+
+typedef struct {
+	gchar magic[8];
+	guint32 version;
+	guint32 byteOrderMark;
+} FileHeader;
+
+/*
+ * A record is this header, the NUL-terminated key and, aligned to 8 bytes,
+ * the value serialized as a "v" variant. The whole record is padded to 8
+ * bytes, and the CRC covers everything after the CRC field.
+ */
+typedef struct {
+	guint32 size;
+	guint32 crc;
+	guint32 flags;
+	guint32 keyLength;
+	guint32 valueLength;
+	guint32 reserved;
+} RecordHeader;
+
+typedef struct {
+	GVariant* value;
+	gsize size;
+} Entry;
+
+typedef struct {
+	void* address;
+	gsize length;
+} Mapping;
+
+static void entryFree(gpointer data)
+{
+	Entry* entry = data;
+
+	g_variant_unref(entry->value);
+	g_free(entry);
+}
+
+static void unmapMapping(gpointer data)
+{
+	Mapping* mapping = data;
+
+	munmap(mapping->address, mapping->length);
+	g_free(mapping);
+}
+
+static void releaseStore(gpointer data)
+{
+	[(OGMappedSettingsStore*)data release];
+}
+
+static inline gsize roundCapacity(gsize size)
+{
+	return (size + GROWTH_STEP - 1) / GROWTH_STEP * GROWTH_STEP;
+}
+
+static inline gsize valueOffset(gsize keyLength)
+{
+	return ALIGN8(sizeof(RecordHeader) + keyLength + 1);
+}
+
+static inline gsize recordSize(gsize keyLength, gsize valueLength)
+{
+	return ALIGN8(valueOffset(keyLength) + valueLength);
+}
+
+static guint32 recordCrc(const guint8* record, gsize size)
+{
+	gsize skipped = 2 * sizeof(guint32);
+
+	return (guint32)crc32(crc32(0, Z_NULL, 0), record + skipped, (uInt)(size - skipped));
+}
+
+/* Encodes a record into the zeroed @dest; @boxed is %NULL for a reset. */
+static gsize encodeRecord(guint8* dest, const gchar* key, GVariant* boxed, guint32 flags)
+{
+	RecordHeader header = { 0 };
+	gsize keyLength = strlen(key);
+
+	header.keyLength = (guint32)keyLength;
+	header.valueLength = (boxed != NULL ? (guint32)g_variant_get_size(boxed) : 0);
+	header.size = (guint32)recordSize(keyLength, header.valueLength);
+	header.flags = flags | (boxed == NULL ? RECORD_RESET : 0);
+
+	memcpy(dest + sizeof(RecordHeader), key, keyLength);
+
+	if (boxed != NULL)
+		g_variant_store(boxed, dest + valueOffset(keyLength));
+
+	memcpy(dest, &header, sizeof(header));
+	header.crc = recordCrc(dest, header.size);
+	memcpy(dest, &header, sizeof(header));
+
+	return header.size;
+}
+
+static gboolean parseRecord(const guint8* base, gsize offset, gsize limit, RecordHeader* header)
+{
+	if (limit - offset < sizeof(RecordHeader))
+		return FALSE;
+
+	memcpy(header, base + offset, sizeof(RecordHeader));
+
+	if (header->size < sizeof(RecordHeader) || header->size % 8 != 0 || header->size > limit - offset)
+		return FALSE;
+
+	if (header->keyLength == 0 || valueOffset(header->keyLength) + header->valueLength > header->size)
+		return FALSE;
+
+	if (base[offset + sizeof(RecordHeader) + header->keyLength] != '\0')
+		return FALSE;
+
+	if (!(header->flags & RECORD_RESET) && header->valueLength == 0)
+		return FALSE;
+
+	return (recordCrc(base + offset, header->size) == header->crc);
+}
+
+static gboolean writeAll(int fd, const guint8* data, gsize size, off_t offset)
+{
+	while (size > 0) {
+		ssize_t written = pwrite(fd, data, size, offset);
+
+		if (written < 0) {
+			if (errno == EINTR)
+				continue;
+
+			return FALSE;
+		}
+
+		data += written;
+		size -= (gsize)written;
+		offset += written;
+	}
+
+	return TRUE;
+}
+
+static gboolean collectTreeEntry(gpointer key, gpointer value, gpointer userData)
+{
+	GPtrArray** arrays = userData;
+
+	g_ptr_array_add(arrays[0], key);
+	g_ptr_array_add(arrays[1], value);
+
+	return FALSE;
+}
+
+static void setErrnoError(GError** error, int errsv, const gchar* what, const gchar* path)
+{
+	g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "Error %s %s: %s", what, path, g_strerror(errsv));
+}
+
+@interface OGMappedSettingsStore ()
+
+- (bool)loadWithError:(GError**)error;
+
+- (bool)mapCapacity:(gsize)capacity error:(GError**)error;
+
+- (void)indexRecordAtOffset:(gsize)offset header:(const RecordHeader*)header;
+
+- (bool)appendRecordsWithKeys:(const gchar* const*)keys values:(GVariant* const*)values count:(guint)count;
+
+- (bool)rewriteWithError:(GError**)error;
+
+- (void)scheduleSync;
+
+- (void)syncSourceFired:(GSource*)source;
+
+@end
+
+static gboolean syncExpired(gpointer userData)
+{
+	OGMappedSettingsStore* store = userData;
+
+	[store syncSourceFired:g_main_current_source()];
+
+	return G_SOURCE_REMOVE;
+}
+
+@implementation OGMappedSettingsStore
+
++ (instancetype)mappedSettingsStoreWithPath:(OFString*)path syncIntervalMsecs:(guint)syncIntervalMsecs
+{
+	return [[[self alloc] initWithPath:path syncIntervalMsecs:syncIntervalMsecs] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithPath:(OFString*)path syncIntervalMsecs:(guint)syncIntervalMsecs
+{
+	self = [super init];
+
+	_fd = -1;
+	g_rw_lock_init(&_lock);
+	g_mutex_init(&_syncMutex);
+
+	@try {
+		GError* err = NULL;
+
+		if (path == nil)
+			@throw [OFInvalidArgumentException exception];
+
+		_path = g_strdup([path UTF8String]);
+		_index = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, entryFree);
+		_syncIntervalMsecs = syncIntervalMsecs;
+		_context = g_main_context_ref_thread_default();
+
+		_fd = open(_path, O_RDWR | O_CREAT | O_CLOEXEC, 0600);
+
+		if (_fd < 0)
+			setErrnoError(&err, errno, "opening", _path);
+		else if (flock(_fd, LOCK_EX | LOCK_NB) != 0)
+			setErrnoError(&err, errno, "locking", _path);
+		else
+			[self loadWithError:&err];
+
+		[OGErrorException throwForError:err];
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	/* A pending sync holds a reference, so every write has been synced
+	 * by now. */
+	if (_mapping != NULL)
+		g_bytes_unref(_mapping);
+
+	if (_index != NULL)
+		g_hash_table_unref(_index);
+
+	if (_fd >= 0)
+		close(_fd);
+
+	if (_context != NULL)
+		g_main_context_unref(_context);
+
+	g_free(_path);
+	g_mutex_clear(&_syncMutex);
+	g_rw_lock_clear(&_lock);
+
+	[super dealloc];
+}
+
+- (bool)mapCapacity:(gsize)capacity error:(GError**)error
+{
+	void* address;
+
+	if (ftruncate(_fd, (off_t)capacity) != 0) {
+		setErrnoError(error, errno, "growing", _path);
+		return false;
+	}
+
+	address = mmap(NULL, capacity, PROT_READ, MAP_SHARED, _fd, 0);
+
+	if (address == MAP_FAILED) {
+		setErrnoError(error, errno, "mapping", _path);
+		return false;
+	}
+
+	Mapping* mapping = g_new(Mapping, 1);
+	mapping->address = address;
+	mapping->length = capacity;
+
+	/* Values handed out earlier keep their old mapping alive. */
+	if (_mapping != NULL)
+		g_bytes_unref(_mapping);
+
+	_mapping = g_bytes_new_with_free_func(address, capacity, unmapMapping, mapping);
+	_capacity = capacity;
+
+	return true;
+}
+
+- (bool)loadWithError:(GError**)error
+{
+	struct stat st;
+	const guint8* base;
+	const FileHeader* fileHeader;
+	RecordHeader header;
+	GArray* pending;
+	gsize offset, committed;
+
+	if (fstat(_fd, &st) != 0) {
+		setErrnoError(error, errno, "reading", _path);
+		return false;
+	}
+
+	if (st.st_size == 0) {
+		FileHeader newHeader = { FILE_MAGIC, FILE_VERSION, BYTE_ORDER_MARK };
+
+		if (!writeAll(_fd, (const guint8*)&newHeader, sizeof(newHeader), 0)) {
+			setErrnoError(error, errno, "writing", _path);
+			return false;
+		}
+
+		st.st_size = sizeof(newHeader);
+	}
+
+	if ((gsize)st.st_size < sizeof(FileHeader) || ![self mapCapacity:roundCapacity((gsize)st.st_size) error:error]) {
+		if (error != NULL && *error == NULL)
+			g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s is not a settings store", _path);
+
+		return false;
+	}
+
+	base = g_bytes_get_data(_mapping, NULL);
+	fileHeader = (const FileHeader*)base;
+
+	if (memcmp(fileHeader->magic, FILE_MAGIC, sizeof(fileHeader->magic)) != 0 || fileHeader->version != FILE_VERSION || fileHeader->byteOrderMark != BYTE_ORDER_MARK) {
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "%s is not a settings store", _path);
+		return false;
+	}
+
+	/* Replay the records, applying each transaction once its last record
+	 * has been read. */
+	pending = g_array_new(FALSE, FALSE, sizeof(gsize));
+	offset = committed = sizeof(FileHeader);
+
+	while (parseRecord(base, offset, _capacity, &header)) {
+		g_array_append_val(pending, offset);
+		offset += header.size;
+
+		if (header.flags & RECORD_CONTINUED)
+			continue;
+
+		for (guint i = 0; i < pending->len; i++) {
+			gsize recordOffset = g_array_index(pending, gsize, i);
+
+			memcpy(&header, base + recordOffset, sizeof(header));
+			[self indexRecordAtOffset:recordOffset header:&header];
+		}
+
+		g_array_set_size(pending, 0);
+		committed = offset;
+	}
+
+	g_array_unref(pending);
+
+	/* Cut off whatever follows the last complete transaction, so that no
+	 * stale record can follow the next append. */
+	if (ftruncate(_fd, (off_t)committed) != 0 || ftruncate(_fd, (off_t)_capacity) != 0) {
+		setErrnoError(error, errno, "truncating", _path);
+		return false;
+	}
+
+	_dataEnd = committed;
+
+	return true;
+}
+
+- (void)indexRecordAtOffset:(gsize)offset header:(const RecordHeader*)header
+{
+	const guint8* base = g_bytes_get_data(_mapping, NULL);
+	const gchar* key = (const gchar*)(base + offset + sizeof(RecordHeader));
+	Entry* old = g_hash_table_lookup(_index, key);
+
+	if (old != NULL)
+		_liveBytes -= old->size;
+
+	if (header->flags & RECORD_RESET) {
+		g_hash_table_remove(_index, key);
+		return;
+	}
+
+	/* The value points into the mapping; nothing is copied. */
+	GBytes* slice = g_bytes_new_from_bytes(_mapping, offset + valueOffset(header->keyLength), header->valueLength);
+	GVariant* boxed = g_variant_ref_sink(g_variant_new_from_bytes(G_VARIANT_TYPE_VARIANT, slice, FALSE));
+
+	Entry* entry = g_new(Entry, 1);
+	entry->value = g_variant_get_variant(boxed);
+	entry->size = header->size;
+
+	g_variant_unref(boxed);
+	g_bytes_unref(slice);
+
+	g_hash_table_replace(_index, g_strdup(key), entry);
+	_liveBytes += entry->size;
+}
+
+- (bool)appendRecordsWithKeys:(const gchar* const*)keys values:(GVariant* const*)values count:(guint)count
+{
+	GVariant** boxed = g_new0(GVariant*, count);
+	guint8* buffer;
+	gsize total = 0, position = 0;
+	bool success;
+
+	for (guint i = 0; i < count; i++) {
+		if (values[i] != NULL)
+			boxed[i] = g_variant_ref_sink(g_variant_new_variant(values[i]));
+
+		total += recordSize(strlen(keys[i]), (boxed[i] != NULL ? g_variant_get_size(boxed[i]) : 0));
+	}
+
+	buffer = g_malloc0(total);
+
+	for (guint i = 0; i < count; i++)
+		position += encodeRecord(buffer + position, keys[i], boxed[i], (i + 1 < count ? RECORD_CONTINUED : 0));
+
+	g_rw_lock_writer_lock(&_lock);
+
+	success = (_dataEnd + total <= _capacity || [self mapCapacity:roundCapacity(MAX(_capacity * 2, _dataEnd + total)) error:NULL]);
+	success = success && writeAll(_fd, buffer, total, (off_t)_dataEnd);
+
+	if (success) {
+		RecordHeader header;
+
+		for (position = 0; position < total; position += header.size) {
+			memcpy(&header, buffer + position, sizeof(header));
+			[self indexRecordAtOffset:_dataEnd + position header:&header];
+		}
+
+		_dataEnd += total;
+
+		gsize dead = _dataEnd - sizeof(FileHeader) - _liveBytes;
+
+		if (dead > COMPACT_MIN_DEAD && dead > _liveBytes)
+			[self rewriteWithError:NULL];
+	}
+
+	g_rw_lock_writer_unlock(&_lock);
+
+	for (guint i = 0; i < count; i++)
+		if (boxed[i] != NULL)
+			g_variant_unref(boxed[i]);
+
+	g_free(boxed);
+	g_free(buffer);
+
+	if (success)
+		[self scheduleSync];
+
+	return success;
+}
+
+- (bool)rewriteWithError:(GError**)error
+{
+	gchar* tmpPath = g_strconcat(_path, ".tmp", NULL);
+	gchar* directory = g_path_get_dirname(_path);
+	guint count = g_hash_table_size(_index);
+	const gchar** keys = g_new(const gchar*, count);
+	GVariant** boxed = g_new(GVariant*, count);
+	FileHeader fileHeader = { FILE_MAGIC, FILE_VERSION, BYTE_ORDER_MARK };
+	GHashTableIter iter;
+	gpointer key, value;
+	gsize total = sizeof(FileHeader), position;
+	guint8* buffer;
+	int fd, dirFd, errsv = 0;
+	guint i = 0;
+
+	g_hash_table_iter_init(&iter, _index);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		keys[i] = key;
+		boxed[i] = g_variant_ref_sink(g_variant_new_variant(((Entry*)value)->value));
+		total += recordSize(strlen(key), g_variant_get_size(boxed[i]));
+		i++;
+	}
+
+	/* All live values are written as a single transaction. */
+	buffer = g_malloc0(total);
+	memcpy(buffer, &fileHeader, sizeof(fileHeader));
+	position = sizeof(FileHeader);
+
+	for (i = 0; i < count; i++)
+		position += encodeRecord(buffer + position, keys[i], boxed[i], (i + 1 < count ? RECORD_CONTINUED : 0));
+
+	fd = open(tmpPath, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+
+	if (fd < 0 || flock(fd, LOCK_EX | LOCK_NB) != 0 || !writeAll(fd, buffer, total, 0) || fdatasync(fd) != 0 || rename(tmpPath, _path) != 0)
+		errsv = errno;
+
+	if (errsv == 0) {
+		/* Make the rename itself durable. */
+		dirFd = open(directory, O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+
+		if (dirFd >= 0) {
+			fsync(dirFd);
+			close(dirFd);
+		}
+	}
+
+	for (i = 0; i < count; i++)
+		g_variant_unref(boxed[i]);
+
+	g_free(boxed);
+	g_free(keys);
+	g_free(buffer);
+	g_free(directory);
+
+	if (errsv != 0) {
+		if (fd >= 0) {
+			close(fd);
+			unlink(tmpPath);
+		}
+
+		setErrnoError(error, errsv, "compacting", _path);
+		g_free(tmpPath);
+		return false;
+	}
+
+	g_free(tmpPath);
+
+	close(_fd);
+	_fd = fd;
+
+	g_hash_table_remove_all(_index);
+	_liveBytes = 0;
+
+	return [self loadWithError:error];
+}
+
+- (void)scheduleSync
+{
+	if (_syncIntervalMsecs == 0) {
+		[self sync];
+		return;
+	}
+
+	g_mutex_lock(&_syncMutex);
+
+	if (_syncSource == NULL) {
+		_syncSource = g_timeout_source_new(_syncIntervalMsecs);
+		g_source_set_callback(_syncSource, syncExpired, [self retain], releaseStore);
+		g_source_attach(_syncSource, _context);
+	}
+
+	g_mutex_unlock(&_syncMutex);
+}
+
+- (void)syncSourceFired:(GSource*)source
+{
+	g_mutex_lock(&_syncMutex);
+
+	if (_syncSource == source) {
+		g_source_unref(_syncSource);
+		_syncSource = NULL;
+	}
+
+	g_mutex_unlock(&_syncMutex);
+
+	[self sync];
+}
+
+- (OFString*)path
+{
+	return [OFString stringWithUTF8String:_path];
+}
+
+- (guint)count
+{
+	guint count;
+
+	g_rw_lock_reader_lock(&_lock);
+	count = g_hash_table_size(_index);
+	g_rw_lock_reader_unlock(&_lock);
+
+	return count;
+}
+
+- (GVariant*)readValueWithKey:(const gchar*)key
+{
+	Entry* entry;
+	GVariant* value = NULL;
+
+	g_rw_lock_reader_lock(&_lock);
+
+	entry = g_hash_table_lookup(_index, key);
+
+	if (entry != NULL)
+		value = g_variant_ref(entry->value);
+
+	g_rw_lock_reader_unlock(&_lock);
+
+	return value;
+}
+
+- (bool)writeValue:(GVariant*)value key:(const gchar*)key
+{
+	return [self appendRecordsWithKeys:&key values:&value count:1];
+}
+
+- (bool)writeTree:(GTree*)tree
+{
+	GPtrArray* arrays[2] = { g_ptr_array_new(), g_ptr_array_new() };
+	bool success = true;
+
+	g_tree_foreach(tree, collectTreeEntry, arrays);
+
+	if (arrays[0]->len > 0)
+		success = [self appendRecordsWithKeys:(const gchar* const*)arrays[0]->pdata values:(GVariant* const*)arrays[1]->pdata count:arrays[0]->len];
+
+	g_ptr_array_unref(arrays[0]);
+	g_ptr_array_unref(arrays[1]);
+
+	return success;
+}
+
+- (void)sync
+{
+	GSource* source;
+
+	g_mutex_lock(&_syncMutex);
+
+	source = _syncSource;
+	_syncSource = NULL;
+
+	g_mutex_unlock(&_syncMutex);
+
+	g_rw_lock_reader_lock(&_lock);
+	fdatasync(_fd);
+	g_rw_lock_reader_unlock(&_lock);
+
+	/* Destroying the source drops its reference to us, so do it last. */
+	if (source != NULL) {
+		g_source_destroy(source);
+		g_source_unref(source);
+	}
+}
+
+- (void)compact
+{
+	GError* err = NULL;
+
+	g_rw_lock_writer_lock(&_lock);
+	[self rewriteWithError:&err];
+	g_rw_lock_writer_unlock(&_lock);
+
+	[OGErrorException throwForError:err];
+}
+
+@end
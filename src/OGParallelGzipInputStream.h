@@ -0,0 +1,63 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterInputStream.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM (ogio_parallel_gzip_input_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioParallelGzipInputStream, ogio_parallel_gzip_input_stream, OGIO, PARALLEL_GZIP_INPUT_STREAM, GFilterInputStream)
+
+GInputStream* ogio_parallel_gzip_input_stream_new(GInputStream* baseStream, guint threads);
+gboolean ogio_parallel_gzip_input_stream_is_block_compressed(OGioParallelGzipInputStream* stream);
+
+G_END_DECLS
+
+/**
+ * `OGParallelGzipInputStream` decompresses a gzip stream read from its base
+ * stream, inflating BGZF blocks on a pool of worker threads.
+ *
+ * While the input consists of BGZF blocks, as written by
+ * #OGParallelGzipOutputStream, bgzip or samtools, the stream reads ahead up
+ * to twice as many blocks as there are threads and inflates them in
+ * parallel; the CRC and size of every block are verified. As soon as a gzip
+ * member without a BGZF header is found, the rest of the input is inflated
+ * sequentially on the reading thread, so any gzip file, including
+ * multi-member files and the output of #OGZlibCompressor, can be read.
+ *
+ */
+@interface OGParallelGzipInputStream : OGFilterInputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)parallelGzipInputStreamWithBaseStream:(OGInputStream*)baseStream threads:(guint)threads;
+
+/**
+ * Methods
+ */
+
+- (OGioParallelGzipInputStream*)castedGObject;
+
+/**
+ * Returns whether all gzip members read so far were BGZF blocks and have
+ * been inflated in parallel.
+ *
+ * @return whether the input is block compressed
+ */
+- (bool)isBlockCompressed;
+
+@end
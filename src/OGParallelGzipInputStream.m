@@ -0,0 +1,423 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGParallelGzipInputStream.h"
+
+#include <zlib.h>
+
+#define BGZF_HEADER_SIZE 18
+#define BGZF_FOOTER_SIZE 8
+#define BGZF_MAX_BLOCK_SIZE (64 * 1024)
+#define SEQUENTIAL_INPUT_SIZE (64 * 1024)
+
+typedef struct {
+	GBytes* input;
+	GBytes* output;
+	GError* error;
+	gboolean done;
+} Block;
+
+struct _OGioParallelGzipInputStream {
+	GFilterInputStream parent_instance;
+
+	guint maxInFlight;
+	GThreadPool* pool;
+
+	GMutex mutex;
+	GCond cond;
+	GQueue blocks;
+
+	GBytes* current;
+	gsize offset;
+	gboolean baseEof;
+
+	gboolean sequential;
+	gboolean memberOpen;
+	z_stream inflater;
+	guint8* input;
+};
+
+G_DEFINE_FINAL_TYPE(OGioParallelGzipInputStream, ogio_parallel_gzip_input_stream, G_TYPE_FILTER_INPUT_STREAM)
+
+static void blockFree(Block* block)
+{
+	g_clear_pointer(&block->input, g_bytes_unref);
+	g_clear_pointer(&block->output, g_bytes_unref);
+	g_clear_error(&block->error);
+	g_free(block);
+}
+
+static guint16 getLE16(const guint8* source)
+{
+	return (guint16)(source[0] | (source[1] << 8));
+}
+
+static guint32 getLE32(const guint8* source)
+{
+	return (guint32)source[0] | ((guint32)source[1] << 8) | ((guint32)source[2] << 16) | ((guint32)source[3] << 24);
+}
+
+static gboolean isBgzfHeader(const guint8* header)
+{
+	return (header[0] == 0x1f && header[1] == 0x8b && header[2] == Z_DEFLATED && (header[3] & 0x04) && getLE16(header + 10) == 6 && header[12] == 'B' && header[13] == 'C' && getLE16(header + 14) == 2);
+}
+
+static void inflateBlock(gpointer data, gpointer userData)
+{
+	OGioParallelGzipInputStream* self = userData;
+	Block* block = data;
+	gsize size;
+	const guint8* input = g_bytes_get_data(block->input, &size);
+	const guint8* footer = input + size - BGZF_FOOTER_SIZE;
+	guint32 expectedCrc = getLE32(footer);
+	guint32 expectedSize = getLE32(footer + 4);
+	guint8* output;
+	gboolean valid = TRUE;
+
+	/* ISIZE comes from the input; a BGZF block never inflates to more than
+	 * 64 KiB, so anything larger is corrupt and must not size the buffer. */
+	if (expectedSize > BGZF_MAX_BLOCK_SIZE) {
+		output = NULL;
+		valid = FALSE;
+	} else {
+		output = g_malloc(MAX(expectedSize, 1));
+	}
+
+	/* Inflate even empty blocks, so a corrupted ISIZE of zero cannot drop
+	 * a block's data unnoticed; the spare byte catches unexpected output. */
+	if (valid) {
+		z_stream stream = { 0 };
+
+		if (inflateInit2(&stream, -15) != Z_OK) {
+			valid = FALSE;
+		} else {
+			stream.next_in = (Bytef*)input + BGZF_HEADER_SIZE;
+			stream.avail_in = (uInt)(size - BGZF_HEADER_SIZE - BGZF_FOOTER_SIZE);
+			stream.next_out = output;
+			stream.avail_out = MAX(expectedSize, 1);
+
+			valid = (inflate(&stream, Z_FINISH) == Z_STREAM_END && stream.total_out == expectedSize && crc32(crc32(0, Z_NULL, 0), output, expectedSize) == expectedCrc);
+
+			inflateEnd(&stream);
+		}
+	}
+
+	if (valid) {
+		block->output = g_bytes_new_take(output, expectedSize);
+	} else {
+		g_free(output);
+		block->error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Corrupt BGZF block");
+	}
+
+	g_clear_pointer(&block->input, g_bytes_unref);
+
+	g_mutex_lock(&self->mutex);
+	block->done = TRUE;
+	g_cond_broadcast(&self->cond);
+	g_mutex_unlock(&self->mutex);
+}
+
+/* Hands the bytes already read to a sequential inflater for the rest of the input. */
+static gboolean startSequential(OGioParallelGzipInputStream* self, const guint8* prefix, gsize size, GError** error)
+{
+	if (inflateInit2(&self->inflater, 15 + 16) != Z_OK) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Could not initialize the decompressor");
+		return FALSE;
+	}
+
+	self->input = g_malloc(SEQUENTIAL_INPUT_SIZE);
+	memcpy(self->input, prefix, size);
+	self->inflater.next_in = self->input;
+	self->inflater.avail_in = (uInt)size;
+	self->sequential = TRUE;
+
+	return TRUE;
+}
+
+/*
+ * Reads the next BGZF block from the base stream. Returns NULL with @error
+ * unset at the end of the input or when a member that is not a BGZF block
+ * starts.
+ */
+static Block* readBlock(OGioParallelGzipInputStream* self, GCancellable* cancellable, GError** error)
+{
+	GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+	guint8 header[BGZF_HEADER_SIZE];
+	gsize read = 0;
+
+	if (!g_input_stream_read_all(base, header, sizeof(header), &read, cancellable, error))
+		return NULL;
+
+	if (read == 0) {
+		self->baseEof = TRUE;
+		return NULL;
+	}
+
+	if (read < sizeof(header) || !isBgzfHeader(header)) {
+		startSequential(self, header, read, error);
+		return NULL;
+	}
+
+	gsize blockSize = (gsize)getLE16(header + 16) + 1;
+	if (blockSize < BGZF_HEADER_SIZE + BGZF_FOOTER_SIZE) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid BGZF block size");
+		return NULL;
+	}
+
+	guint8* data = g_malloc(blockSize);
+	memcpy(data, header, sizeof(header));
+
+	if (!g_input_stream_read_all(base, data + sizeof(header), blockSize - sizeof(header), &read, cancellable, error)) {
+		g_free(data);
+		return NULL;
+	}
+
+	if (read < blockSize - sizeof(header)) {
+		g_free(data);
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated BGZF block");
+		return NULL;
+	}
+
+	Block* block = g_new0(Block, 1);
+	block->input = g_bytes_new_take(data, blockSize);
+
+	return block;
+}
+
+static gssize readSequential(OGioParallelGzipInputStream* self, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+	z_stream* inflater = &self->inflater;
+	uInt available = (uInt)MIN(count, G_MAXUINT);
+
+	inflater->next_out = buffer;
+	inflater->avail_out = available;
+
+	while (inflater->avail_out == available) {
+		if (inflater->avail_in == 0) {
+			if (self->baseEof) {
+				if (self->memberOpen) {
+					g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated gzip member");
+					return -1;
+				}
+
+				return 0;
+			}
+
+			gssize read = g_input_stream_read(base, self->input, SEQUENTIAL_INPUT_SIZE, cancellable, error);
+			if (read < 0)
+				return -1;
+
+			if (read == 0) {
+				self->baseEof = TRUE;
+				continue;
+			}
+
+			inflater->next_in = self->input;
+			inflater->avail_in = (uInt)read;
+		}
+
+		int result = inflate(inflater, Z_NO_FLUSH);
+
+		if (result == Z_STREAM_END) {
+			self->memberOpen = FALSE;
+			inflateReset(inflater);
+		} else if (result == Z_OK || (result == Z_BUF_ERROR && inflater->avail_in == 0)) {
+			self->memberOpen = TRUE;
+		} else {
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid gzip data");
+			return -1;
+		}
+	}
+
+	return (gssize)(available - inflater->avail_out);
+}
+
+static gssize ogio_parallel_gzip_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioParallelGzipInputStream* self = OGIO_PARALLEL_GZIP_INPUT_STREAM(stream);
+
+	for (;;) {
+		if (self->current != NULL) {
+			gsize size;
+			const guint8* data = g_bytes_get_data(self->current, &size);
+
+			if (self->offset < size) {
+				gsize chunk = MIN(count, size - self->offset);
+
+				memcpy(buffer, data + self->offset, chunk);
+				self->offset += chunk;
+
+				return (gssize)chunk;
+			}
+
+			g_clear_pointer(&self->current, g_bytes_unref);
+		}
+
+		if (count == 0)
+			return 0;
+
+		/* Only this thread touches the queue; workers only mark blocks done. */
+		while (!self->baseEof && !self->sequential && self->blocks.length < self->maxInFlight) {
+			GError* localError = NULL;
+			Block* block = readBlock(self, cancellable, &localError);
+
+			if (localError != NULL) {
+				g_propagate_error(error, localError);
+				return -1;
+			}
+
+			if (block == NULL)
+				break;
+
+			g_queue_push_tail(&self->blocks, block);
+			g_thread_pool_push(self->pool, block, NULL);
+		}
+
+		Block* block = g_queue_peek_head(&self->blocks);
+		if (block == NULL) {
+			if (self->sequential)
+				return readSequential(self, buffer, count, cancellable, error);
+
+			return 0;
+		}
+
+		g_mutex_lock(&self->mutex);
+		while (!block->done)
+			g_cond_wait(&self->cond, &self->mutex);
+		g_mutex_unlock(&self->mutex);
+
+		g_queue_pop_head(&self->blocks);
+
+		if (block->error != NULL) {
+			g_propagate_error(error, g_steal_pointer(&block->error));
+			blockFree(block);
+			return -1;
+		}
+
+		self->current = g_steal_pointer(&block->output);
+		self->offset = 0;
+		blockFree(block);
+	}
+}
+
+static void ogio_parallel_gzip_input_stream_finalize(GObject* object)
+{
+	OGioParallelGzipInputStream* self = OGIO_PARALLEL_GZIP_INPUT_STREAM(object);
+
+	if (self->pool != NULL)
+		g_thread_pool_free(self->pool, FALSE, TRUE);
+
+	g_queue_clear_full(&self->blocks, (GDestroyNotify)blockFree);
+	g_clear_pointer(&self->current, g_bytes_unref);
+
+	if (self->sequential)
+		inflateEnd(&self->inflater);
+
+	g_free(self->input);
+	g_cond_clear(&self->cond);
+	g_mutex_clear(&self->mutex);
+
+	G_OBJECT_CLASS(ogio_parallel_gzip_input_stream_parent_class)->finalize(object);
+}
+
+static void ogio_parallel_gzip_input_stream_init(OGioParallelGzipInputStream* self)
+{
+	g_mutex_init(&self->mutex);
+	g_cond_init(&self->cond);
+	g_queue_init(&self->blocks);
+}
+
+static void ogio_parallel_gzip_input_stream_class_init(OGioParallelGzipInputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GInputStreamClass* streamClass = G_INPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_parallel_gzip_input_stream_finalize;
+
+	streamClass->read_fn = ogio_parallel_gzip_input_stream_read;
+}
+
+GInputStream* ogio_parallel_gzip_input_stream_new(GInputStream* baseStream, guint threads)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(baseStream), NULL);
+
+	if (threads == 0)
+		threads = g_get_num_processors();
+
+	OGioParallelGzipInputStream* self = g_object_new(OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM, "base-stream", baseStream, NULL);
+	self->maxInFlight = 2 * threads;
+	self->pool = g_thread_pool_new(inflateBlock, self, (gint)threads, FALSE, NULL);
+
+	return G_INPUT_STREAM(self);
+}
+
+gboolean ogio_parallel_gzip_input_stream_is_block_compressed(OGioParallelGzipInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_PARALLEL_GZIP_INPUT_STREAM(stream), FALSE);
+
+	return !stream->sequential;
+}
+
+@implementation OGParallelGzipInputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)parallelGzipInputStreamWithBaseStream:(OGInputStream*)baseStream threads:(guint)threads
+{
+	if (baseStream == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioParallelGzipInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_parallel_gzip_input_stream_new([baseStream castedGObject], threads), OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM, OGioParallelGzipInputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGParallelGzipInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGParallelGzipInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioParallelGzipInputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_PARALLEL_GZIP_INPUT_STREAM, OGioParallelGzipInputStream);
+}
+
+- (bool)isBlockCompressed
+{
+	bool returnValue = (bool)ogio_parallel_gzip_input_stream_is_block_compressed((OGioParallelGzipInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+@end
@@ -0,0 +1,59 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterOutputStream.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM (ogio_parallel_gzip_output_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioParallelGzipOutputStream, ogio_parallel_gzip_output_stream, OGIO, PARALLEL_GZIP_OUTPUT_STREAM, GFilterOutputStream)
+
+GOutputStream* ogio_parallel_gzip_output_stream_new(GOutputStream* baseStream, int level, guint threads);
+
+G_END_DECLS
+
+/**
+ * `OGParallelGzipOutputStream` compresses everything written to it on a pool
+ * of worker threads and writes the result to its base stream in the BGZF
+ * format used by samtools and tabix.
+ *
+ * The input is cut into blocks of just under 64 KiB, and every block is
+ * compressed as an independent gzip member carrying its compressed size in a
+ * `BC` extra field. The blocks are written in order, so the output is a
+ * standard multi-member gzip file that gunzip, zcat and
+ * #OGParallelGzipInputStream can read. Closing the stream appends the BGZF
+ * end-of-file marker.
+ *
+ * Compared to an #OGZlibCompressor in an #OGConverterOutputStream, the
+ * compression ratio is slightly worse because blocks do not share their
+ * dictionary, in exchange for scaling with the number of threads. At most
+ * twice as many blocks as there are threads are kept in memory.
+ *
+ */
+@interface OGParallelGzipOutputStream : OGFilterOutputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)parallelGzipOutputStreamWithBaseStream:(OGOutputStream*)baseStream level:(int)level threads:(guint)threads;
+
+/**
+ * Methods
+ */
+
+- (OGioParallelGzipOutputStream*)castedGObject;
+
+@end
@@ -0,0 +1,339 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGParallelGzipOutputStream.h"
+
+#include <zlib.h>
+
+#define BGZF_HEADER_SIZE 18
+#define BGZF_FOOTER_SIZE 8
+#define BGZF_BLOCK_INPUT_SIZE 0xff00
+
+static const guint8 bgzfEofMarker[28] = {
+	0x1f, 0x8b, 0x08, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00, 0xff, 0x06, 0x00,
+	0x42, 0x43, 0x02, 0x00, 0x1b, 0x00, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00,
+	0x00, 0x00, 0x00, 0x00
+};
+
+typedef struct {
+	GBytes* input;
+	GBytes* output;
+	GError* error;
+	gboolean done;
+} Block;
+
+struct _OGioParallelGzipOutputStream {
+	GFilterOutputStream parent_instance;
+
+	int level;
+	guint maxInFlight;
+	GThreadPool* pool;
+
+	guint8* buffer;
+	gsize fill;
+
+	GMutex mutex;
+	GCond cond;
+	GQueue blocks;
+};
+
+G_DEFINE_FINAL_TYPE(OGioParallelGzipOutputStream, ogio_parallel_gzip_output_stream, G_TYPE_FILTER_OUTPUT_STREAM)
+
+static void blockFree(Block* block)
+{
+	g_clear_pointer(&block->input, g_bytes_unref);
+	g_clear_pointer(&block->output, g_bytes_unref);
+	g_clear_error(&block->error);
+	g_free(block);
+}
+
+static void putLE16(guint8* destination, guint16 value)
+{
+	destination[0] = value & 0xff;
+	destination[1] = value >> 8;
+}
+
+static void putLE32(guint8* destination, guint32 value)
+{
+	destination[0] = value & 0xff;
+	destination[1] = (value >> 8) & 0xff;
+	destination[2] = (value >> 16) & 0xff;
+	destination[3] = value >> 24;
+}
+
+static void compressBlock(gpointer data, gpointer userData)
+{
+	OGioParallelGzipOutputStream* self = userData;
+	Block* block = data;
+	gsize inputSize;
+	const guint8* input = g_bytes_get_data(block->input, &inputSize);
+	z_stream stream = { 0 };
+
+	if (deflateInit2(&stream, self->level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+		block->error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED, "Could not initialize the compressor");
+	} else {
+		uLong bound = deflateBound(&stream, inputSize);
+		guint8* output = g_malloc(BGZF_HEADER_SIZE + bound + BGZF_FOOTER_SIZE);
+
+		stream.next_in = (Bytef*)input;
+		stream.avail_in = (uInt)inputSize;
+		stream.next_out = output + BGZF_HEADER_SIZE;
+		stream.avail_out = (uInt)bound;
+
+		if (deflate(&stream, Z_FINISH) != Z_STREAM_END) {
+			g_free(output);
+			block->error = g_error_new_literal(G_IO_ERROR, G_IO_ERROR_FAILED, "Could not compress block");
+		} else {
+			gsize blockSize = BGZF_HEADER_SIZE + stream.total_out + BGZF_FOOTER_SIZE;
+
+			/* Gzip member with a BGZF "BC" extra field holding BSIZE - 1. */
+			output[0] = 0x1f;
+			output[1] = 0x8b;
+			output[2] = Z_DEFLATED;
+			output[3] = 0x04;
+			putLE32(output + 4, 0);
+			output[8] = 0x00;
+			output[9] = 0xff;
+			putLE16(output + 10, 6);
+			output[12] = 'B';
+			output[13] = 'C';
+			putLE16(output + 14, 2);
+			putLE16(output + 16, (guint16)(blockSize - 1));
+
+			guint8* footer = output + BGZF_HEADER_SIZE + stream.total_out;
+			putLE32(footer, (guint32)crc32(crc32(0, Z_NULL, 0), input, (uInt)inputSize));
+			putLE32(footer + 4, (guint32)inputSize);
+
+			block->output = g_bytes_new_take(output, blockSize);
+		}
+
+		deflateEnd(&stream);
+	}
+
+	g_clear_pointer(&block->input, g_bytes_unref);
+
+	g_mutex_lock(&self->mutex);
+	block->done = TRUE;
+	g_cond_broadcast(&self->cond);
+	g_mutex_unlock(&self->mutex);
+}
+
+static void submitBlock(OGioParallelGzipOutputStream* self)
+{
+	if (self->fill == 0)
+		return;
+
+	Block* block = g_new0(Block, 1);
+	block->input = g_bytes_new_take(self->buffer, self->fill);
+
+	self->buffer = g_malloc(BGZF_BLOCK_INPUT_SIZE);
+	self->fill = 0;
+
+	g_mutex_lock(&self->mutex);
+	g_queue_push_tail(&self->blocks, block);
+	g_mutex_unlock(&self->mutex);
+
+	g_thread_pool_push(self->pool, block, NULL);
+}
+
+/*
+ * Writes finished blocks to the base stream in order. Waits for unfinished
+ * blocks if @all is set or too many blocks are in flight.
+ */
+static gboolean writeBlocks(OGioParallelGzipOutputStream* self, gboolean all, GCancellable* cancellable, GError** error)
+{
+	GOutputStream* base = g_filter_output_stream_get_base_stream(G_FILTER_OUTPUT_STREAM(self));
+
+	for (;;) {
+		g_mutex_lock(&self->mutex);
+
+		Block* block = g_queue_peek_head(&self->blocks);
+		if (block == NULL || (!block->done && !all && self->blocks.length <= self->maxInFlight)) {
+			g_mutex_unlock(&self->mutex);
+			return TRUE;
+		}
+
+		while (!block->done)
+			g_cond_wait(&self->cond, &self->mutex);
+
+		g_queue_pop_head(&self->blocks);
+		g_mutex_unlock(&self->mutex);
+
+		if (block->error != NULL) {
+			g_propagate_error(error, g_steal_pointer(&block->error));
+			blockFree(block);
+			return FALSE;
+		}
+
+		gsize size;
+		gconstpointer data = g_bytes_get_data(block->output, &size);
+		gboolean written = g_output_stream_write_all(base, data, size, NULL, cancellable, error);
+		blockFree(block);
+
+		if (!written)
+			return FALSE;
+	}
+}
+
+static gssize ogio_parallel_gzip_output_stream_write(GOutputStream* stream, const void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioParallelGzipOutputStream* self = OGIO_PARALLEL_GZIP_OUTPUT_STREAM(stream);
+	gsize consumed = 0;
+
+	while (consumed < count) {
+		gsize chunk = MIN(count - consumed, BGZF_BLOCK_INPUT_SIZE - self->fill);
+
+		memcpy(self->buffer + self->fill, (const guint8*)buffer + consumed, chunk);
+		self->fill += chunk;
+		consumed += chunk;
+
+		if (self->fill == BGZF_BLOCK_INPUT_SIZE) {
+			submitBlock(self);
+
+			if (!writeBlocks(self, FALSE, cancellable, error))
+				return -1;
+		}
+	}
+
+	return (gssize)count;
+}
+
+static gboolean ogio_parallel_gzip_output_stream_flush(GOutputStream* stream, GCancellable* cancellable, GError** error)
+{
+	OGioParallelGzipOutputStream* self = OGIO_PARALLEL_GZIP_OUTPUT_STREAM(stream);
+
+	submitBlock(self);
+
+	if (!writeBlocks(self, TRUE, cancellable, error))
+		return FALSE;
+
+	return g_output_stream_flush(g_filter_output_stream_get_base_stream(G_FILTER_OUTPUT_STREAM(stream)), cancellable, error);
+}
+
+static gboolean ogio_parallel_gzip_output_stream_close(GOutputStream* stream, GCancellable* cancellable, GError** error)
+{
+	OGioParallelGzipOutputStream* self = OGIO_PARALLEL_GZIP_OUTPUT_STREAM(stream);
+	GOutputStream* base = g_filter_output_stream_get_base_stream(G_FILTER_OUTPUT_STREAM(stream));
+	GError* localError = NULL;
+
+	submitBlock(self);
+
+	if (writeBlocks(self, TRUE, cancellable, &localError))
+		g_output_stream_write_all(base, bgzfEofMarker, sizeof(bgzfEofMarker), NULL, cancellable, &localError);
+
+	gboolean returnValue = G_OUTPUT_STREAM_CLASS(ogio_parallel_gzip_output_stream_parent_class)->close_fn(stream, cancellable, (localError == NULL) ? error : NULL);
+
+	if (localError != NULL) {
+		g_propagate_error(error, localError);
+		return FALSE;
+	}
+
+	return returnValue;
+}
+
+static void ogio_parallel_gzip_output_stream_finalize(GObject* object)
+{
+	OGioParallelGzipOutputStream* self = OGIO_PARALLEL_GZIP_OUTPUT_STREAM(object);
+
+	if (self->pool != NULL)
+		g_thread_pool_free(self->pool, FALSE, TRUE);
+
+	g_queue_clear_full(&self->blocks, (GDestroyNotify)blockFree);
+	g_free(self->buffer);
+	g_cond_clear(&self->cond);
+	g_mutex_clear(&self->mutex);
+
+	G_OBJECT_CLASS(ogio_parallel_gzip_output_stream_parent_class)->finalize(object);
+}
+
+static void ogio_parallel_gzip_output_stream_init(OGioParallelGzipOutputStream* self)
+{
+	g_mutex_init(&self->mutex);
+	g_cond_init(&self->cond);
+	g_queue_init(&self->blocks);
+	self->buffer = g_malloc(BGZF_BLOCK_INPUT_SIZE);
+}
+
+static void ogio_parallel_gzip_output_stream_class_init(OGioParallelGzipOutputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GOutputStreamClass* streamClass = G_OUTPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_parallel_gzip_output_stream_finalize;
+
+	streamClass->write_fn = ogio_parallel_gzip_output_stream_write;
+	streamClass->flush = ogio_parallel_gzip_output_stream_flush;
+	streamClass->close_fn = ogio_parallel_gzip_output_stream_close;
+}
+
+GOutputStream* ogio_parallel_gzip_output_stream_new(GOutputStream* baseStream, int level, guint threads)
+{
+	g_return_val_if_fail(G_IS_OUTPUT_STREAM(baseStream), NULL);
+	g_return_val_if_fail(level >= -1 && level <= 9, NULL);
+
+	if (threads == 0)
+		threads = g_get_num_processors();
+
+	OGioParallelGzipOutputStream* self = g_object_new(OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM, "base-stream", baseStream, NULL);
+	self->level = level;
+	self->maxInFlight = 2 * threads;
+	self->pool = g_thread_pool_new(compressBlock, self, (gint)threads, FALSE, NULL);
+
+	return G_OUTPUT_STREAM(self);
+}
+
+@implementation OGParallelGzipOutputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)parallelGzipOutputStreamWithBaseStream:(OGOutputStream*)baseStream level:(int)level threads:(guint)threads
+{
+	if (baseStream == nil || level < -1 || level > 9)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioParallelGzipOutputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_parallel_gzip_output_stream_new([baseStream castedGObject], level, threads), OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM, OGioParallelGzipOutputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGParallelGzipOutputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGParallelGzipOutputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioParallelGzipOutputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_PARALLEL_GZIP_OUTPUT_STREAM, OGioParallelGzipOutputStream);
+}
+
+@end
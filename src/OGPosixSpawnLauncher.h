@@ -0,0 +1,139 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGSpawnedProcess;
+
+/**
+ * `OGPosixSpawnLauncher` starts child processes with posix_spawn(), never
+ * with fork().
+ *
+ * Forking copies the page tables of the calling process, which makes
+ * spawning from a process with a large resident set slow. posix_spawn() as
+ * implemented by glibc and musl uses clone() with CLONE_VM and CLONE_VFORK
+ * instead, so the cost of a spawn does not depend on the size of the
+ * parent. #OGSubprocessLauncher takes the same path only under conditions
+ * that are not visible to its users; this launcher supports exactly what
+ * posix_spawn() can express and nothing else, so the fast path is
+ * guaranteed. In particular there is no child setup function; use
+ * #OGSubprocessLauncher where one is needed.
+ *
+ * The supported #GSubprocessFlags are the stdin, stdout and stderr flags and
+ * %G_SUBPROCESS_FLAGS_INHERIT_FDS. Programs without a directory separator
+ * are looked up in the `PATH` of the calling process. Without
+ * %G_SUBPROCESS_FLAGS_INHERIT_FDS, descriptors above the ones passed with
+ * -takeFdWithSourceFd:targetFd: are closed in the child where the C library
+ * supports it (glibc 2.34 or newer), and are otherwise left to their
+ * close-on-exec flag. Changing the working directory needs glibc 2.29 or
+ * newer.
+ *
+ */
+@interface OGPosixSpawnLauncher : OFObject
+{
+	GSubprocessFlags _flags;
+	gchar** _environ;
+	gchar* _cwd;
+	GArray* _fdMappings;
+	bool _closed;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)posixSpawnLauncherWithFlags:(GSubprocessFlags)flags;
+
+/**
+ * Initializes a launcher.
+ *
+ * @param flags #GSubprocessFlags
+ * @return an initialized launcher
+ */
+- (instancetype)initWithFlags:(GSubprocessFlags)flags;
+
+/**
+ * Methods
+ */
+
+/**
+ * Sets the flags used for future spawns.
+ *
+ * @param flags #GSubprocessFlags
+ */
+- (void)setFlags:(GSubprocessFlags)flags;
+
+/**
+ * Replaces the environment passed to children.
+ *
+ * @param env the replacement environment
+ */
+- (void)setEnviron:(const gchar* const*)env;
+
+/**
+ * Sets an environment variable for children.
+ *
+ * @param variable the environment variable to set
+ * @param value the new value for the variable
+ * @param overwrite whether to change the variable if it already exists
+ */
+- (void)setenvWithVariable:(OFString*)variable value:(OFString*)value overwrite:(bool)overwrite;
+
+/**
+ * Removes an environment variable from the environment of children.
+ *
+ * @param variable the environment variable to unset
+ */
+- (void)unsetenvWithVariable:(OFString*)variable;
+
+/**
+ * Returns the value of an environment variable in the environment of
+ * children.
+ *
+ * @param variable the environment variable to get
+ * @return the value of the variable, or %nil if it is not set
+ */
+- (OFString*)getenvWithVariable:(OFString*)variable;
+
+/**
+ * Sets the working directory of children.
+ *
+ * @param cwd the working directory, or %nil to inherit it
+ */
+- (void)setCwd:(OFString*)cwd;
+
+/**
+ * Passes @sourceFd to children as @targetFd. The launcher takes ownership of
+ * @sourceFd and closes it in -close.
+ *
+ * @param sourceFd file descriptor in the parent process
+ * @param targetFd target descriptor for the child process
+ */
+- (void)takeFdWithSourceFd:(gint)sourceFd targetFd:(gint)targetFd;
+
+/**
+ * Closes all file descriptors passed with -takeFdWithSourceFd:targetFd:.
+ * Further spawns fail with %G_IO_ERROR_CLOSED. This is called when the
+ * launcher is deallocated.
+ */
+- (void)close;
+
+/**
+ * Spawns a child process with posix_spawn().
+ *
+ * @param argv command line arguments
+ * @return the child process
+ */
+- (OGSpawnedProcess*)spawnvWithArgv:(const gchar* const*)argv;
+
+@end
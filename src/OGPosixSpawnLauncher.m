@@ -0,0 +1,367 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGPosixSpawnLauncher.h"
+
+#import "OGSpawnedProcess.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <spawn.h>
+#include <string.h>
+#include <unistd.h>
+
+#include <glib-unix.h>
+
+#if defined(__GLIBC__) && defined(__GLIBC_PREREQ)
+# if __GLIBC_PREREQ(2, 29)
+#  define HAVE_ADDCHDIR_NP
+# endif
+# if __GLIBC_PREREQ(2, 34)
+#  define HAVE_ADDCLOSEFROM_NP
+# endif
+#endif
+
+#define SUPPORTED_FLAGS (G_SUBPROCESS_FLAGS_STDIN_PIPE | G_SUBPROCESS_FLAGS_STDIN_INHERIT | G_SUBPROCESS_FLAGS_STDOUT_PIPE | G_SUBPROCESS_FLAGS_STDOUT_SILENCE | G_SUBPROCESS_FLAGS_STDERR_PIPE | G_SUBPROCESS_FLAGS_STDERR_SILENCE | G_SUBPROCESS_FLAGS_STDERR_MERGE | G_SUBPROCESS_FLAGS_INHERIT_FDS)
+
+extern char** environ;
+
+typedef struct {
+	int source;
+	int target;
+} FdMapping;
+
+static void setSpawnError(GError** error, int errsv, const char* program)
+{
+	GSpawnError code;
+
+	switch (errsv) {
+	case ENOENT:
+	case ENOTDIR:
+		code = G_SPAWN_ERROR_NOENT;
+		break;
+	case EACCES:
+	case EPERM:
+		code = G_SPAWN_ERROR_ACCES;
+		break;
+	case ENOEXEC:
+		code = G_SPAWN_ERROR_NOEXEC;
+		break;
+	case ENOMEM:
+		code = G_SPAWN_ERROR_NOMEM;
+		break;
+	case E2BIG:
+		code = G_SPAWN_ERROR_TOO_BIG;
+		break;
+	case EINVAL:
+		code = G_SPAWN_ERROR_INVAL;
+		break;
+	default:
+		code = G_SPAWN_ERROR_FAILED;
+		break;
+	}
+
+	g_set_error(error, G_SPAWN_ERROR, code, "Failed to execute child process “%s” (%s)", program, g_strerror(errsv));
+}
+
+/*
+ * Returns a descriptor for @fd that is not below @minimum, so that the
+ * dup2() actions of the child cannot overwrite it before it is used.
+ */
+static int moveAbove(int fd, int minimum, GArray* temporaries)
+{
+	if (fd >= minimum)
+		return fd;
+
+	int moved = fcntl(fd, F_DUPFD_CLOEXEC, minimum);
+
+	if (moved >= 0)
+		g_array_append_val(temporaries, moved);
+
+	return moved;
+}
+
+static void closePipe(int fds[2])
+{
+	for (int i = 0; i < 2; i++) {
+		if (fds[i] >= 0)
+			close(fds[i]);
+
+		fds[i] = -1;
+	}
+}
+
+/*
+ * Connects descriptor @target of the child to a new pipe, to /dev/null or
+ * leaves it alone. The end of the pipe for the parent is stored in
+ * pipeFds[@target == 0 ? 1 : 0].
+ */
+static int addStdio(posix_spawn_file_actions_t* actions, int target, bool pipe, bool silence, int pipeFds[2], int minimum, GArray* temporaries)
+{
+	if (pipe) {
+		if (!g_unix_open_pipe(pipeFds, FD_CLOEXEC, NULL))
+			return errno;
+
+		int child = moveAbove(pipeFds[target == 0 ? 0 : 1], minimum, temporaries);
+
+		if (child < 0)
+			return errno;
+
+		return posix_spawn_file_actions_adddup2(actions, child, target);
+	}
+
+	if (silence)
+		return posix_spawn_file_actions_addopen(actions, target, "/dev/null", (target == 0 ? O_RDONLY : O_WRONLY), 0);
+
+	return 0;
+}
+
+static gboolean spawnChild(const gchar* const* argv, GSubprocessFlags flags, gchar** envp, const gchar* cwd, GArray* mappings, GPid* pid, int parentFds[3], GError** error)
+{
+	posix_spawn_file_actions_t actions;
+	posix_spawnattr_t attr;
+	sigset_t signals;
+	short attrFlags = POSIX_SPAWN_SETSIGMASK | POSIX_SPAWN_SETSIGDEF;
+	int pipes[3][2] = { { -1, -1 }, { -1, -1 }, { -1, -1 } };
+	GArray* temporaries = g_array_new(FALSE, FALSE, sizeof(int));
+	int minimum = 3;
+	int ret;
+
+#ifndef HAVE_ADDCHDIR_NP
+	if (cwd != NULL) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Changing the working directory with posix_spawn() is not supported");
+		g_array_unref(temporaries);
+		return FALSE;
+	}
+#endif
+
+	for (guint i = 0; i < mappings->len; i++)
+		minimum = MAX(minimum, g_array_index(mappings, FdMapping, i).target + 1);
+
+	posix_spawn_file_actions_init(&actions);
+	posix_spawnattr_init(&attr);
+
+#ifdef POSIX_SPAWN_USEVFORK
+	attrFlags |= POSIX_SPAWN_USEVFORK;
+#endif
+
+	sigemptyset(&signals);
+	posix_spawnattr_setsigmask(&attr, &signals);
+	sigaddset(&signals, SIGPIPE);
+	posix_spawnattr_setsigdefault(&attr, &signals);
+	posix_spawnattr_setflags(&attr, attrFlags);
+
+	ret = addStdio(&actions, 0, (flags & G_SUBPROCESS_FLAGS_STDIN_PIPE), !(flags & G_SUBPROCESS_FLAGS_STDIN_INHERIT), pipes[0], minimum, temporaries);
+
+	if (ret == 0)
+		ret = addStdio(&actions, 1, (flags & G_SUBPROCESS_FLAGS_STDOUT_PIPE), (flags & G_SUBPROCESS_FLAGS_STDOUT_SILENCE), pipes[1], minimum, temporaries);
+
+	if (ret == 0) {
+		if (flags & G_SUBPROCESS_FLAGS_STDERR_MERGE)
+			ret = posix_spawn_file_actions_adddup2(&actions, 1, 2);
+		else
+			ret = addStdio(&actions, 2, (flags & G_SUBPROCESS_FLAGS_STDERR_PIPE), (flags & G_SUBPROCESS_FLAGS_STDERR_SILENCE), pipes[2], minimum, temporaries);
+	}
+
+	for (guint i = 0; ret == 0 && i < mappings->len; i++) {
+		FdMapping mapping = g_array_index(mappings, FdMapping, i);
+		int source = moveAbove(mapping.source, minimum, temporaries);
+
+		ret = (source < 0 ? errno : posix_spawn_file_actions_adddup2(&actions, source, mapping.target));
+	}
+
+#ifdef HAVE_ADDCHDIR_NP
+	if (ret == 0 && cwd != NULL)
+		ret = posix_spawn_file_actions_addchdir_np(&actions, cwd);
+#endif
+
+#ifdef HAVE_ADDCLOSEFROM_NP
+	if (ret == 0 && !(flags & G_SUBPROCESS_FLAGS_INHERIT_FDS))
+		ret = posix_spawn_file_actions_addclosefrom_np(&actions, minimum);
+#endif
+
+	if (ret == 0) {
+		char* const* args = (char* const*)argv;
+
+		if (strchr(argv[0], '/') != NULL)
+			ret = posix_spawn(pid, argv[0], &actions, &attr, args, (envp != NULL ? envp : environ));
+		else
+			ret = posix_spawnp(pid, argv[0], &actions, &attr, args, (envp != NULL ? envp : environ));
+	}
+
+	posix_spawn_file_actions_destroy(&actions);
+	posix_spawnattr_destroy(&attr);
+
+	for (guint i = 0; i < temporaries->len; i++)
+		close(g_array_index(temporaries, int, i));
+
+	g_array_unref(temporaries);
+
+	if (ret != 0) {
+		for (int i = 0; i < 3; i++)
+			closePipe(pipes[i]);
+
+		setSpawnError(error, ret, argv[0]);
+		return FALSE;
+	}
+
+	/* Keep the parent ends and close the ends now owned by the child. */
+	parentFds[0] = pipes[0][1];
+	if (pipes[0][0] >= 0)
+		close(pipes[0][0]);
+
+	for (int i = 1; i < 3; i++) {
+		parentFds[i] = pipes[i][0];
+
+		if (pipes[i][1] >= 0)
+			close(pipes[i][1]);
+	}
+
+	return TRUE;
+}
+
+@implementation OGPosixSpawnLauncher
+
++ (instancetype)posixSpawnLauncherWithFlags:(GSubprocessFlags)flags
+{
+	return [[[self alloc] initWithFlags:flags] autorelease];
+}
+
+- (instancetype)init
+{
+	return [self initWithFlags:G_SUBPROCESS_FLAGS_NONE];
+}
+
+- (instancetype)initWithFlags:(GSubprocessFlags)flags
+{
+	self = [super init];
+
+	@try {
+		_fdMappings = g_array_new(FALSE, FALSE, sizeof(FdMapping));
+
+		[self setFlags:flags];
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[self close];
+
+	g_array_unref(_fdMappings);
+	g_strfreev(_environ);
+	g_free(_cwd);
+
+	[super dealloc];
+}
+
+- (void)setFlags:(GSubprocessFlags)flags
+{
+	if (flags & ~SUPPORTED_FLAGS)
+		@throw [OFInvalidArgumentException exception];
+
+	_flags = flags;
+}
+
+- (void)setEnviron:(const gchar* const*)env
+{
+	gchar** copy = g_strdupv((gchar**)env);
+
+	g_strfreev(_environ);
+	_environ = copy;
+}
+
+- (void)setenvWithVariable:(OFString*)variable value:(OFString*)value overwrite:(bool)overwrite
+{
+	if (_environ == NULL)
+		_environ = g_get_environ();
+
+	_environ = g_environ_setenv(_environ, [variable UTF8String], [value UTF8String], overwrite);
+}
+
+- (void)unsetenvWithVariable:(OFString*)variable
+{
+	if (_environ == NULL)
+		_environ = g_get_environ();
+
+	_environ = g_environ_unsetenv(_environ, [variable UTF8String]);
+}
+
+- (OFString*)getenvWithVariable:(OFString*)variable
+{
+	const gchar* gobjectValue;
+
+	if (_environ != NULL)
+		gobjectValue = g_environ_getenv(_environ, [variable UTF8String]);
+	else
+		gobjectValue = g_getenv([variable UTF8String]);
+
+	OFString* returnValue = (gobjectValue != NULL ? [OFString stringWithUTF8String:gobjectValue] : nil);
+	return returnValue;
+}
+
+- (void)setCwd:(OFString*)cwd
+{
+	gchar* copy = g_strdup([cwd UTF8String]);
+
+	g_free(_cwd);
+	_cwd = copy;
+}
+
+- (void)takeFdWithSourceFd:(gint)sourceFd targetFd:(gint)targetFd
+{
+	if (sourceFd < 0 || targetFd < 0)
+		@throw [OFInvalidArgumentException exception];
+
+	FdMapping mapping = { sourceFd, targetFd };
+	g_array_append_val(_fdMappings, mapping);
+}
+
+- (void)close
+{
+	for (guint i = 0; i < _fdMappings->len; i++)
+		close(g_array_index(_fdMappings, FdMapping, i).source);
+
+	g_array_set_size(_fdMappings, 0);
+	_closed = true;
+}
+
+- (OGSpawnedProcess*)spawnvWithArgv:(const gchar* const*)argv
+{
+	GError* err = NULL;
+	GPid pid;
+	int parentFds[3] = { -1, -1, -1 };
+
+	if (argv == NULL || argv[0] == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	if (_closed)
+		g_set_error_literal(&err, G_IO_ERROR, G_IO_ERROR_CLOSED, "Can't spawn a new child because launcher was closed");
+	else
+		spawnChild(argv, _flags, _environ, _cwd, _fdMappings, &pid, parentFds, &err);
+
+	[OGErrorException throwForError:err];
+
+	OGSpawnedProcess* returnValue;
+	@try {
+		returnValue = [[OGSpawnedProcess alloc] initWithPid:pid stdinFd:parentFds[0] stdoutFd:parentFds[1] stderrFd:parentFds[2]];
+	} @catch (id e) {
+		for (int i = 0; i < 3; i++)
+			if (parentFds[i] >= 0)
+				close(parentFds[i]);
+
+		@throw e;
+	}
+
+	return [returnValue autorelease];
+}
+
+@end
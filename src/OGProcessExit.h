@@ -0,0 +1,98 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#include <sys/resource.h>
+
+#import <OGObject/OGObject.h>
+
+/**
+ * `OGProcessExit` records the exit of a child process tracked by an
+ * #OGProcessSupervisor.
+ *
+ */
+@interface OGProcessExit : OFObject
+{
+	id _process;
+	int _status;
+	bool _hasResourceUsage;
+	struct rusage _resourceUsage;
+	bool _timedOut;
+	gint64 _runTime;
+}
+
+/**
+ * Initializes an exit record.
+ *
+ * @param process the #OGSubprocess or #OGSpawnedProcess that exited
+ * @param status the wait status of the process
+ * @param resourceUsage the resources used by the process, or %NULL
+ * @param timedOut whether the process was signalled because it ran out of
+ * time
+ * @param runTime the time in microseconds between the start of the
+ * supervision and the exit
+ * @return an initialized exit record
+ */
+- (instancetype)initWithProcess:(id)process status:(int)status resourceUsage:(const struct rusage*)resourceUsage timedOut:(bool)timedOut runTime:(gint64)runTime;
+
+/**
+ * Methods
+ */
+
+/**
+ * The process that exited.
+ *
+ * @return the #OGSubprocess or #OGSpawnedProcess
+ */
+- (id)process;
+
+/**
+ * The raw wait status of the process.
+ *
+ * @return the wait status
+ */
+- (int)status;
+
+/**
+ * Whether the process exited normally with an exit status of 0.
+ *
+ * @return %TRUE if the process was successful
+ */
+- (bool)successful;
+
+/**
+ * The resources used by the process. They are only known for processes
+ * reaped by the supervisor, that is #OGSpawnedProcess instances; an
+ * #OGSubprocess is reaped by GLib.
+ *
+ * @return the resource usage, or %NULL if it is unknown
+ */
+- (const struct rusage*)resourceUsage;
+
+/**
+ * Whether the supervisor signalled the process because its timeout
+ * expired.
+ *
+ * @return whether the process timed out
+ */
+- (bool)timedOut;
+
+/**
+ * The time in microseconds from the start of the supervision until the
+ * exit was noticed.
+ *
+ * @return the run time
+ */
+- (gint64)runTime;
+
+@end
@@ -0,0 +1,72 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGProcessExit.h"
+
+#include <sys/wait.h>
+
+@implementation OGProcessExit
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithProcess:(id)process status:(int)status resourceUsage:(const struct rusage*)resourceUsage timedOut:(bool)timedOut runTime:(gint64)runTime
+{
+	self = [super init];
+
+	_process = [process retain];
+	_status = status;
+	_timedOut = timedOut;
+	_runTime = runTime;
+
+	if (resourceUsage != NULL) {
+		_hasResourceUsage = true;
+		_resourceUsage = *resourceUsage;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[_process release];
+
+	[super dealloc];
+}
+
+- (id)process
+{
+	return _process;
+}
+
+- (int)status
+{
+	return _status;
+}
+
+- (bool)successful
+{
+	return (WIFEXITED(_status) && WEXITSTATUS(_status) == 0);
+}
+
+- (const struct rusage*)resourceUsage
+{
+	return (_hasResourceUsage ? &_resourceUsage : NULL);
+}
+
+- (bool)timedOut
+{
+	return _timedOut;
+}
+
+- (gint64)runTime
+{
+	return _runTime;
+}
+
+@end
@@ -0,0 +1,142 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGProcessExit;
+
+/**
+ * Called with all exits an #OGProcessSupervisor noticed at once, in the
+ * order they were noticed.
+ */
+typedef void (*OGProcessSupervisorExitFunc)(OFArray OF_GENERIC(OGProcessExit*)* exits, gpointer userData);
+
+/**
+ * `OGProcessSupervisor` watches any number of child processes for their exit
+ * from a single thread, instead of one child watch source per process.
+ *
+ * Every supervised #OGSubprocess or #OGSpawnedProcess is represented by a
+ * pidfd in one epoll set. All exits returned by one epoll_wait() call are
+ * reported together, either by passing them to a function on the main
+ * context that was the thread default when the supervisor was created, or
+ * by queueing them for -waitForExitsWithTimeout:. Each exit carries the
+ * wait status, the resource usage where known, and the run time of the
+ * process.
+ *
+ * A process can be given a timeout. When it expires, the process is sent a
+ * signal and, if it is still running after a grace period, killed with
+ * SIGKILL.
+ *
+ * The supervisor requires pidfd support, which Linux has offered since
+ * version 5.3. It keeps the processes alive until their exit has been
+ * reported.
+ *
+ */
+@interface OGProcessSupervisor : OFObject
+{
+	int _epollFd;
+	int _wakeFd;
+	GThread* _thread;
+	GMutex _mutex;
+	GCond _cond;
+	GHashTable* _entries;
+	guint64 _nextId;
+	guint _collecting;
+	GArray* _closingFds;
+	OFMutableArray OF_GENERIC(OGProcessExit*)* _pendingExits;
+	OGProcessSupervisorExitFunc _func;
+	gpointer _userData;
+	GMainContext* _context;
+	bool _stopping;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)processSupervisor;
+
++ (instancetype)processSupervisorWithFunc:(OGProcessSupervisorExitFunc)func userData:(gpointer)userData;
+
+/**
+ * Initializes a supervisor that queues exits for
+ * -waitForExitsWithTimeout:.
+ *
+ * @return an initialized supervisor
+ */
+- (instancetype)init;
+
+/**
+ * Initializes a supervisor that passes exits to @func on the thread-default
+ * main context of the calling thread.
+ *
+ * @param func the function receiving exits
+ * @param userData user data for @func, which must stay valid as long as
+ * exits may be dispatched
+ * @return an initialized supervisor
+ */
+- (instancetype)initWithFunc:(OGProcessSupervisorExitFunc)func userData:(gpointer)userData;
+
+/**
+ * Methods
+ */
+
+/**
+ * Starts supervising @process, without a timeout.
+ *
+ * @param process an #OGSubprocess or #OGSpawnedProcess
+ */
+- (void)addProcess:(id)process;
+
+/**
+ * Starts supervising @process. If it is still running after @timeoutUs,
+ * it is sent @signalNum, and if it is still running @graceUs after that,
+ * it is killed.
+ *
+ * @param process an #OGSubprocess or #OGSpawnedProcess
+ * @param timeoutUs the timeout in microseconds, or a negative value for
+ * none
+ * @param signalNum the signal sent when the timeout expires; SIGKILL or 0
+ * kill the process right away
+ * @param graceUs the time in microseconds between the signal and SIGKILL,
+ * or a negative value to never send SIGKILL
+ */
+- (void)addProcess:(id)process timeout:(gint64)timeoutUs signal:(int)signalNum killAfter:(gint64)graceUs;
+
+/**
+ * Stops supervising @process without reporting its exit.
+ *
+ * @param process a supervised process
+ * @return whether @process was supervised
+ */
+- (bool)removeProcess:(id)process;
+
+/**
+ * The number of processes whose exit has not been reported yet.
+ *
+ * @return the number of running processes
+ */
+- (guint)count;
+
+/**
+ * Waits until at least one exit has been noticed and returns all exits
+ * noticed since the last call. Returns right away if no process is
+ * supervised. Only valid for supervisors created without an exit function.
+ *
+ * @param timeoutUs the maximum time to wait in microseconds, or a negative
+ * value to wait indefinitely
+ * @return the exits, possibly none
+ */
+- (OFArray OF_GENERIC(OGProcessExit*)*)waitForExitsWithTimeout:(gint64)timeoutUs;
+
+@end
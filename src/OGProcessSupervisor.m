@@ -0,0 +1,580 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGProcessSupervisor.h"
+
+#import "OGProcessExit.h"
+#import "OGSpawnedProcess.h"
+#import "OGSubprocess.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <signal.h>
+#include <stdlib.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#define MAX_EVENTS 256
+
+/* Event data of the eventfd; entries are numbered from 1. */
+#define WAKE_ID 0
+
+typedef struct {
+	guint64 id;
+	id process;
+	int pidfd;
+	gint64 started;
+	gint64 deadline;
+	gint64 grace;
+	int signalNum;
+	bool timedOut;
+} SupervisedEntry;
+
+typedef struct {
+	OGProcessSupervisorExitFunc func;
+	gpointer userData;
+	OFArray* exits;
+} ExitDelivery;
+
+static void freeEntry(gpointer data)
+{
+	SupervisedEntry* entry = data;
+
+	if (entry->pidfd >= 0)
+		close(entry->pidfd);
+
+	[entry->process release];
+	g_free(entry);
+}
+
+static void throwErrno(const char* what)
+{
+	int errsv = errno;
+	GError* err = NULL;
+
+	g_set_error(&err, G_IO_ERROR, g_io_error_from_errno(errsv), "%s: %s", what, g_strerror(errsv));
+
+	[OGErrorException throwForError:err];
+}
+
+/*
+ * Returns a new pidfd for @process, or -1 with errno set to ESRCH if it has
+ * already been reaped.
+ */
+static int pidfdForProcess(id process)
+{
+	if ([process isKindOfClass:[OGSpawnedProcess class]]) {
+		int pidfd = [(OGSpawnedProcess*)process pidfd];
+
+		if (pidfd < 0) {
+			errno = ENOSYS;
+			return -1;
+		}
+
+		return fcntl(pidfd, F_DUPFD_CLOEXEC, 0);
+	}
+
+	if ([process isKindOfClass:[OGSubprocess class]]) {
+		const gchar* identifier = g_subprocess_get_identifier([(OGSubprocess*)process castedGObject]);
+
+		if (identifier == NULL) {
+			errno = ESRCH;
+			return -1;
+		}
+
+#ifdef SYS_pidfd_open
+		return (int)syscall(SYS_pidfd_open, (pid_t)atoi(identifier), 0);
+#else
+		errno = ENOSYS;
+		return -1;
+#endif
+	}
+
+	@throw [OFInvalidArgumentException exception];
+}
+
+static void signalProcess(id process, int signalNum)
+{
+	if (signalNum == SIGKILL || signalNum == 0)
+		[process forceExit];
+	else if ([process isKindOfClass:[OGSpawnedProcess class]])
+		[(OGSpawnedProcess*)process sendSignal:signalNum];
+	else
+		[(OGSubprocess*)process sendSignalWithSignalNum:signalNum];
+}
+
+static OGProcessExit* collectExit(SupervisedEntry* entry, gint64 now)
+{
+	id process = entry->process;
+	const struct rusage* resourceUsage = NULL;
+	int status = 0;
+
+	if ([process isKindOfClass:[OGSpawnedProcess class]]) {
+		OGSpawnedProcess* spawned = process;
+
+		if ([spawned hasExited]) {
+			status = [spawned status];
+			resourceUsage = [spawned resourceUsage];
+		}
+	} else {
+		GSubprocess* subprocess = [(OGSubprocess*)process castedGObject];
+		bool peeked = false;
+
+#ifdef P_PIDFD
+		siginfo_t info = { 0 };
+
+		/* Read the status without reaping, GLib's child watch still has to
+		 * reap the child to complete the GSubprocess. */
+		if (waitid(P_PIDFD, (id_t)entry->pidfd, &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid != 0) {
+			if (info.si_code == CLD_EXITED)
+				status = (info.si_status & 0xff) << 8;
+			else
+				status = (info.si_status & 0x7f) | (info.si_code == CLD_DUMPED ? 0x80 : 0);
+
+			peeked = true;
+		}
+#endif
+
+		/* Otherwise GLib has already reaped the child on its worker
+		 * thread and is about to complete the GSubprocess. */
+		if (!peeked) {
+			g_subprocess_wait(subprocess, NULL, NULL);
+			status = g_subprocess_get_status(subprocess);
+		}
+	}
+
+	return [[[OGProcessExit alloc] initWithProcess:process status:status resourceUsage:resourceUsage timedOut:entry->timedOut runTime:(now - entry->started)] autorelease];
+}
+
+static gboolean deliverExits(gpointer userData)
+{
+	ExitDelivery* delivery = userData;
+
+	delivery->func(delivery->exits, delivery->userData);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void freeDelivery(gpointer userData)
+{
+	ExitDelivery* delivery = userData;
+
+	[delivery->exits release];
+	g_free(delivery);
+}
+
+static gpointer supervisorThread(gpointer data);
+
+@interface OGProcessSupervisor ()
+- (void)run;
+- (int)nextTimeoutLocked;
+- (void)escalateExpiredLocked:(gint64)now;
+- (void)deliverEntries:(GPtrArray*)entries now:(gint64)now;
+- (void)wake;
+@end
+
+static gpointer supervisorThread(gpointer data)
+{
+	[(OGProcessSupervisor*)data run];
+
+	return NULL;
+}
+
+@implementation OGProcessSupervisor
+
++ (instancetype)processSupervisor
+{
+	return [[[self alloc] init] autorelease];
+}
+
++ (instancetype)processSupervisorWithFunc:(OGProcessSupervisorExitFunc)func userData:(gpointer)userData
+{
+	return [[[self alloc] initWithFunc:func userData:userData] autorelease];
+}
+
+- (instancetype)init
+{
+	return [self initWithFunc:NULL userData:NULL];
+}
+
+- (instancetype)initWithFunc:(OGProcessSupervisorExitFunc)func userData:(gpointer)userData
+{
+	self = [super init];
+
+	_epollFd = -1;
+	_wakeFd = -1;
+	g_mutex_init(&_mutex);
+	g_cond_init(&_cond);
+
+	@try {
+		struct epoll_event event = { .events = EPOLLIN };
+
+		_entries = g_hash_table_new_full(g_int64_hash, g_int64_equal, NULL, freeEntry);
+		_closingFds = g_array_new(FALSE, FALSE, sizeof(int));
+		_pendingExits = [[OFMutableArray alloc] init];
+		_func = func;
+		_userData = userData;
+
+		if (func != NULL)
+			_context = g_main_context_ref_thread_default();
+
+		if ((_epollFd = epoll_create1(EPOLL_CLOEXEC)) < 0)
+			throwErrno("Error creating epoll instance");
+
+		if ((_wakeFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK)) < 0)
+			throwErrno("Error creating eventfd");
+
+		event.data.u64 = WAKE_ID;
+		if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, _wakeFd, &event) < 0)
+			throwErrno("Error adding eventfd to epoll instance");
+
+		_thread = g_thread_new("ogio-supervisor", supervisorThread, self);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_thread != NULL) {
+		g_mutex_lock(&_mutex);
+		_stopping = true;
+		g_mutex_unlock(&_mutex);
+
+		[self wake];
+		g_thread_join(_thread);
+	}
+
+	if (_entries != NULL)
+		g_hash_table_unref(_entries);
+
+	if (_closingFds != NULL) {
+		for (guint i = 0; i < _closingFds->len; i++)
+			close(g_array_index(_closingFds, int, i));
+
+		g_array_unref(_closingFds);
+	}
+
+	if (_wakeFd >= 0)
+		close(_wakeFd);
+
+	if (_epollFd >= 0)
+		close(_epollFd);
+
+	if (_context != NULL)
+		g_main_context_unref(_context);
+
+	[_pendingExits release];
+	g_cond_clear(&_cond);
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (void)wake
+{
+	guint64 value = 1;
+
+	while (write(_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR);
+}
+
+- (void)addProcess:(id)process
+{
+	[self addProcess:process timeout:-1 signal:SIGTERM killAfter:-1];
+}
+
+- (void)addProcess:(id)process timeout:(gint64)timeoutUs signal:(int)signalNum killAfter:(gint64)graceUs
+{
+	if (process == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	gint64 now = g_get_monotonic_time();
+	int pidfd = pidfdForProcess(process);
+
+	if (pidfd < 0 && errno != ESRCH)
+		throwErrno("Error opening pidfd");
+
+	SupervisedEntry* entry = g_new0(SupervisedEntry, 1);
+	entry->process = [process retain];
+	entry->pidfd = pidfd;
+	entry->started = now;
+	entry->deadline = (timeoutUs >= 0 ? now + timeoutUs : 0);
+	entry->grace = graceUs;
+	entry->signalNum = signalNum;
+
+	/* The process has already been reaped, so report it right away. */
+	if (pidfd < 0) {
+		GPtrArray* entries = g_ptr_array_new();
+
+		g_ptr_array_add(entries, entry);
+
+		g_mutex_lock(&_mutex);
+		_collecting++;
+		g_mutex_unlock(&_mutex);
+
+		[self deliverEntries:entries now:now];
+		g_ptr_array_unref(entries);
+		return;
+	}
+
+	struct epoll_event event = { .events = EPOLLIN };
+
+	g_mutex_lock(&_mutex);
+
+	entry->id = ++_nextId;
+	event.data.u64 = entry->id;
+
+	if (epoll_ctl(_epollFd, EPOLL_CTL_ADD, pidfd, &event) < 0) {
+		g_mutex_unlock(&_mutex);
+		freeEntry(entry);
+		throwErrno("Error adding pidfd to epoll instance");
+	}
+
+	g_hash_table_insert(_entries, &entry->id, entry);
+
+	g_mutex_unlock(&_mutex);
+
+	if (entry->deadline != 0)
+		[self wake];
+}
+
+- (bool)removeProcess:(id)process
+{
+	GHashTableIter iter;
+	gpointer key, value;
+	bool found = false;
+
+	g_mutex_lock(&_mutex);
+
+	g_hash_table_iter_init(&iter, _entries);
+	while (g_hash_table_iter_next(&iter, &key, &value)) {
+		SupervisedEntry* entry = value;
+
+		if (entry->process == process) {
+			/* The supervisor thread may be holding an event for this
+			 * entry, so the pidfd is only closed once it looked again. */
+			epoll_ctl(_epollFd, EPOLL_CTL_DEL, entry->pidfd, NULL);
+			g_array_append_val(_closingFds, entry->pidfd);
+			entry->pidfd = -1;
+
+			g_hash_table_iter_remove(&iter);
+			found = true;
+			break;
+		}
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	if (found)
+		[self wake];
+
+	return found;
+}
+
+- (guint)count
+{
+	guint returnValue;
+
+	g_mutex_lock(&_mutex);
+	returnValue = g_hash_table_size(_entries) + _collecting;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (OFArray*)waitForExitsWithTimeout:(gint64)timeoutUs
+{
+	gint64 end = (timeoutUs >= 0 ? g_get_monotonic_time() + timeoutUs : -1);
+	OFArray* returnValue;
+
+	if (_func != NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	g_mutex_lock(&_mutex);
+
+	while (_pendingExits.count == 0 && (g_hash_table_size(_entries) > 0 || _collecting > 0)) {
+		if (end < 0)
+			g_cond_wait(&_cond, &_mutex);
+		else if (!g_cond_wait_until(&_cond, &_mutex, end))
+			break;
+	}
+
+	returnValue = [[_pendingExits copy] autorelease];
+	[_pendingExits removeAllObjects];
+
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (int)nextTimeoutLocked
+{
+	GHashTableIter iter;
+	gpointer value;
+	gint64 next = 0;
+
+	g_hash_table_iter_init(&iter, _entries);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		SupervisedEntry* entry = value;
+
+		if (entry->deadline != 0 && (next == 0 || entry->deadline < next))
+			next = entry->deadline;
+	}
+
+	if (next == 0)
+		return -1;
+
+	gint64 remaining = next - g_get_monotonic_time();
+
+	if (remaining <= 0)
+		return 0;
+
+	return (int)MIN((remaining + 999) / 1000, G_MAXINT);
+}
+
+- (void)escalateExpiredLocked:(gint64)now
+{
+	GHashTableIter iter;
+	gpointer value;
+
+	g_hash_table_iter_init(&iter, _entries);
+	while (g_hash_table_iter_next(&iter, NULL, &value)) {
+		SupervisedEntry* entry = value;
+
+		if (entry->deadline == 0 || entry->deadline > now)
+			continue;
+
+		if (!entry->timedOut) {
+			entry->timedOut = true;
+			signalProcess(entry->process, entry->signalNum);
+
+			if (entry->signalNum != SIGKILL && entry->signalNum != 0 && entry->grace >= 0)
+				entry->deadline = now + MAX(entry->grace, 1);
+			else
+				entry->deadline = 0;
+		} else {
+			signalProcess(entry->process, SIGKILL);
+			entry->deadline = 0;
+		}
+	}
+}
+
+- (void)deliverEntries:(GPtrArray*)entries now:(gint64)now
+{
+	OFMutableArray* exits = [OFMutableArray arrayWithCapacity:entries->len];
+
+	for (guint i = 0; i < entries->len; i++) {
+		SupervisedEntry* entry = g_ptr_array_index(entries, i);
+
+		[exits addObject:collectExit(entry, now)];
+		freeEntry(entry);
+	}
+
+	[exits makeImmutable];
+
+	if (_func != NULL) {
+		ExitDelivery* delivery = g_new0(ExitDelivery, 1);
+		GSource* source = g_idle_source_new();
+
+		delivery->func = _func;
+		delivery->userData = _userData;
+		delivery->exits = [exits retain];
+
+		g_source_set_priority(source, G_PRIORITY_DEFAULT);
+		g_source_set_callback(source, deliverExits, delivery, freeDelivery);
+		g_source_attach(source, _context);
+		g_source_unref(source);
+
+		g_mutex_lock(&_mutex);
+		_collecting -= entries->len;
+		g_mutex_unlock(&_mutex);
+	} else {
+		g_mutex_lock(&_mutex);
+		_collecting -= entries->len;
+		[_pendingExits addObjectsFromArray:exits];
+		g_cond_broadcast(&_cond);
+		g_mutex_unlock(&_mutex);
+	}
+}
+
+- (void)run
+{
+	struct epoll_event events[MAX_EVENTS];
+	bool stopping = false;
+
+	while (!stopping) {
+		void* pool = objc_autoreleasePoolPush();
+		GPtrArray* exited = g_ptr_array_new();
+		int timeout;
+		int n;
+
+		g_mutex_lock(&_mutex);
+		timeout = [self nextTimeoutLocked];
+		g_mutex_unlock(&_mutex);
+
+		do {
+			n = epoll_wait(_epollFd, events, MAX_EVENTS, timeout);
+		} while (n < 0 && errno == EINTR);
+
+		gint64 now = g_get_monotonic_time();
+
+		g_mutex_lock(&_mutex);
+
+		for (int i = 0; i < n; i++) {
+			guint64 id = events[i].data.u64;
+			SupervisedEntry* entry;
+
+			if (id == WAKE_ID) {
+				guint64 value;
+
+				while (read(_wakeFd, &value, sizeof(value)) < 0 && errno == EINTR);
+				continue;
+			}
+
+			/* Events of removed entries find nothing here. */
+			entry = g_hash_table_lookup(_entries, &id);
+			if (entry == NULL)
+				continue;
+
+			epoll_ctl(_epollFd, EPOLL_CTL_DEL, entry->pidfd, NULL);
+			g_hash_table_steal(_entries, &id);
+			g_ptr_array_add(exited, entry);
+			_collecting++;
+		}
+
+		/* Removals before this wait can no longer have events pending. */
+		for (guint i = 0; i < _closingFds->len; i++)
+			close(g_array_index(_closingFds, int, i));
+
+		g_array_set_size(_closingFds, 0);
+
+		[self escalateExpiredLocked:now];
+		stopping = _stopping;
+
+		/* Exits are counted until they are queued, but never queued when stopping. */
+		if (stopping)
+			_collecting -= exited->len;
+
+		g_mutex_unlock(&_mutex);
+
+		if (exited->len > 0 && !stopping)
+			[self deliverEntries:exited now:now];
+		else
+			for (guint i = 0; i < exited->len; i++)
+				freeEntry(g_ptr_array_index(exited, i));
+
+		g_ptr_array_unref(exited);
+		objc_autoreleasePoolPop(pool);
+	}
+}
+
+@end
@@ -0,0 +1,83 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGFilterInputStream.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_READ_AHEAD_INPUT_STREAM (ogio_read_ahead_input_stream_get_type())
+G_DECLARE_FINAL_TYPE(OGioReadAheadInputStream, ogio_read_ahead_input_stream, OGIO, READ_AHEAD_INPUT_STREAM, GFilterInputStream)
+
+GInputStream* ogio_read_ahead_input_stream_new(GInputStream* baseStream, guint depth, gsize bufferSize);
+guint ogio_read_ahead_input_stream_get_depth(OGioReadAheadInputStream* stream);
+void ogio_read_ahead_input_stream_set_depth(OGioReadAheadInputStream* stream, guint depth);
+gboolean ogio_read_ahead_input_stream_is_positional(OGioReadAheadInputStream* stream);
+
+G_END_DECLS
+
+/**
+ * `OGReadAheadInputStream` keeps up to @depth buffers of its base stream
+ * filled ahead of the reader, so that parsing overlaps with I/O.
+ *
+ * If the base stream is a regular file with a file descriptor, such as a
+ * local #OGFileInputStream, the buffers are read with pread() at
+ * consecutive offsets by up to @depth threads at once, which hides the
+ * latency of network file systems. Any other base stream is read by a
+ * single worker thread that stays up to @depth buffers ahead, which turns
+ * refills into double buffering.
+ *
+ * The stream works without a main loop and can be stacked under an
+ * #OGBufferedInputStream or #OGDataInputStream. The base stream must not be
+ * used directly while it is wrapped; in positional mode its own position is
+ * not advanced.
+ *
+ */
+@interface OGReadAheadInputStream : OGFilterInputStream
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)readAheadInputStreamWithBaseStream:(OGInputStream*)baseStream depth:(guint)depth bufferSize:(gsize)bufferSize;
+
+/**
+ * Methods
+ */
+
+- (OGioReadAheadInputStream*)castedGObject;
+
+/**
+ * The maximum number of buffers read ahead.
+ *
+ * @return the read-ahead depth
+ */
+- (guint)depth;
+
+/**
+ * Changes the maximum number of buffers read ahead. Buffers already in
+ * flight are not affected.
+ *
+ * @param depth the new read-ahead depth, at least 1
+ */
+- (void)setDepth:(guint)depth;
+
+/**
+ * Returns whether the base stream is read with concurrent positional reads.
+ *
+ * @return whether positional mode is used
+ */
+- (bool)isPositional;
+
+@end
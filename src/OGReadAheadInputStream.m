@@ -0,0 +1,455 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGReadAheadInputStream.h"
+#import "OGBufferPool.h"
+
+#include <errno.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#define DEFAULT_BUFFER_SIZE (256 * 1024)
+
+typedef struct {
+	guint64 offset;
+	guint8* data;
+	gsize length;
+	GError* error;
+	gboolean done;
+} Chunk;
+
+struct _OGioReadAheadInputStream {
+	GFilterInputStream parent_instance;
+
+	guint depth;
+	gsize bufferSize;
+	GThreadPool* pool;
+	GCancellable* cancellable;
+
+	/* Regular file read with pread(), or -1. */
+	int fd;
+	guint64 nextOffset;
+	guint64 fileSize;
+
+	GMutex mutex;
+	GCond cond;
+	GQueue chunks;
+	gboolean eofSeen;
+
+	Chunk* current;
+	gsize currentOffset;
+};
+
+G_DEFINE_FINAL_TYPE(OGioReadAheadInputStream, ogio_read_ahead_input_stream, G_TYPE_FILTER_INPUT_STREAM)
+
+static void chunkFree(Chunk* chunk)
+{
+	ogio_buffer_pool_free(chunk->data);
+	g_clear_error(&chunk->error);
+	g_free(chunk);
+}
+
+static gssize readFully(int fd, guint8* buffer, gsize count, guint64 offset, GError** error)
+{
+	gsize total = 0;
+
+	while (total < count) {
+		gssize result = pread(fd, buffer + total, count - total, (off_t)(offset + total));
+
+		if (result < 0) {
+			int errsv = errno;
+
+			if (errsv == EINTR)
+				continue;
+
+			g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "Error reading from file: %s", g_strerror(errsv));
+			return -1;
+		}
+
+		if (result == 0)
+			break;
+
+		total += result;
+	}
+
+	return (gssize)total;
+}
+
+static void readChunk(gpointer data, gpointer userData)
+{
+	OGioReadAheadInputStream* self = userData;
+	Chunk* chunk = data;
+	GError* error = NULL;
+	gssize read;
+
+	if (self->fd >= 0) {
+		read = (g_cancellable_set_error_if_cancelled(self->cancellable, &error) ? -1 : readFully(self->fd, chunk->data, self->bufferSize, chunk->offset, &error));
+	} else {
+		GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+
+		read = g_input_stream_read(base, chunk->data, self->bufferSize, self->cancellable, &error);
+	}
+
+	g_mutex_lock(&self->mutex);
+
+	chunk->length = (read > 0 ? (gsize)read : 0);
+	chunk->error = error;
+	chunk->done = TRUE;
+
+	if (read == 0)
+		self->eofSeen = TRUE;
+
+	g_cond_broadcast(&self->cond);
+	g_mutex_unlock(&self->mutex);
+}
+
+/* Queues reads until @depth buffers are in flight or filled. Only called from the reading thread. */
+static void scheduleReads(OGioReadAheadInputStream* self)
+{
+	g_mutex_lock(&self->mutex);
+	gboolean eofSeen = self->eofSeen;
+	g_mutex_unlock(&self->mutex);
+
+	while (!eofSeen && self->chunks.length < self->depth) {
+		if (self->fd >= 0 && self->nextOffset >= self->fileSize && self->chunks.length > 0)
+			break;
+
+		Chunk* chunk = g_new0(Chunk, 1);
+		chunk->offset = self->nextOffset;
+		chunk->data = ogio_buffer_pool_alloc(self->bufferSize);
+		self->nextOffset += self->bufferSize;
+
+		g_queue_push_tail(&self->chunks, chunk);
+		g_thread_pool_push(self->pool, chunk, NULL);
+	}
+}
+
+static void wakeReader(GCancellable* cancellable, gpointer userData)
+{
+	OGioReadAheadInputStream* self = userData;
+
+	g_mutex_lock(&self->mutex);
+	g_cond_broadcast(&self->cond);
+	g_mutex_unlock(&self->mutex);
+}
+
+/* Waits for the oldest queued chunk and makes it current. Returns FALSE at the end of the stream or on error. */
+static gboolean takeChunk(OGioReadAheadInputStream* self, GCancellable* cancellable, GError** error)
+{
+	Chunk* head = g_queue_peek_head(&self->chunks);
+	if (head == NULL)
+		return FALSE;
+
+	gulong handler = g_cancellable_connect(cancellable, G_CALLBACK(wakeReader), self, NULL);
+
+	g_mutex_lock(&self->mutex);
+	while (!head->done && !g_cancellable_is_cancelled(cancellable))
+		g_cond_wait(&self->cond, &self->mutex);
+	gboolean done = head->done;
+	g_mutex_unlock(&self->mutex);
+
+	g_cancellable_disconnect(cancellable, handler);
+
+	if (!done) {
+		g_cancellable_set_error_if_cancelled(cancellable, error);
+		return FALSE;
+	}
+
+	g_queue_pop_head(&self->chunks);
+
+	if (head->error != NULL) {
+		g_propagate_error(error, g_steal_pointer(&head->error));
+		chunkFree(head);
+		return FALSE;
+	}
+
+	if (head->length == 0) {
+		chunkFree(head);
+		return FALSE;
+	}
+
+	self->current = head;
+	self->currentOffset = 0;
+
+	return TRUE;
+}
+
+static gssize ogio_read_ahead_input_stream_read(GInputStream* stream, void* buffer, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioReadAheadInputStream* self = OGIO_READ_AHEAD_INPUT_STREAM(stream);
+
+	for (;;) {
+		if (self->current != NULL) {
+			if (self->currentOffset < self->current->length) {
+				gsize chunk = MIN(count, self->current->length - self->currentOffset);
+
+				memcpy(buffer, self->current->data + self->currentOffset, chunk);
+				self->currentOffset += chunk;
+
+				return (gssize)chunk;
+			}
+
+			g_clear_pointer(&self->current, chunkFree);
+		}
+
+		if (count == 0)
+			return 0;
+
+		scheduleReads(self);
+
+		GError* localError = NULL;
+		if (!takeChunk(self, cancellable, &localError)) {
+			if (localError == NULL)
+				return 0;
+
+			g_propagate_error(error, localError);
+			return -1;
+		}
+	}
+}
+
+static gssize ogio_read_ahead_input_stream_skip(GInputStream* stream, gsize count, GCancellable* cancellable, GError** error)
+{
+	OGioReadAheadInputStream* self = OGIO_READ_AHEAD_INPUT_STREAM(stream);
+	gsize skipped = 0;
+
+	/* Data already read ahead comes first; skipping the base stream directly
+	 * would lose it and race the worker thread. */
+	while (skipped < count) {
+		if (self->current != NULL) {
+			gsize chunk = MIN(count - skipped, self->current->length - self->currentOffset);
+
+			self->currentOffset += chunk;
+			skipped += chunk;
+
+			if (self->currentOffset == self->current->length)
+				g_clear_pointer(&self->current, chunkFree);
+
+			continue;
+		}
+
+		if (self->chunks.length == 0)
+			break;
+
+		GError* localError = NULL;
+		if (!takeChunk(self, cancellable, &localError)) {
+			if (localError == NULL)
+				return (gssize)skipped;
+
+			g_propagate_error(error, localError);
+			return -1;
+		}
+	}
+
+	if (skipped == count)
+		return (gssize)skipped;
+
+	/* Nothing is in flight any more, so the rest can be skipped without reading it. */
+	gsize remaining = count - skipped;
+	gssize result = 0;
+
+	g_mutex_lock(&self->mutex);
+
+	if (!self->eofSeen) {
+		if (self->fd >= 0) {
+			guint64 available = (self->fileSize > self->nextOffset ? self->fileSize - self->nextOffset : 0);
+
+			result = (gssize)MIN((guint64)remaining, available);
+			self->nextOffset += (guint64)result;
+		} else {
+			GInputStream* base = g_filter_input_stream_get_base_stream(G_FILTER_INPUT_STREAM(self));
+
+			result = g_input_stream_skip(base, remaining, cancellable, error);
+		}
+	}
+
+	g_mutex_unlock(&self->mutex);
+
+	if (result < 0)
+		return -1;
+
+	return (gssize)(skipped + (gsize)result);
+}
+
+static void stopReading(OGioReadAheadInputStream* self)
+{
+	if (self->pool == NULL)
+		return;
+
+	g_cancellable_cancel(self->cancellable);
+	g_thread_pool_free(self->pool, TRUE, TRUE);
+	self->pool = NULL;
+
+	g_queue_clear_full(&self->chunks, (GDestroyNotify)chunkFree);
+	g_clear_pointer(&self->current, chunkFree);
+}
+
+static gboolean ogio_read_ahead_input_stream_close(GInputStream* stream, GCancellable* cancellable, GError** error)
+{
+	stopReading(OGIO_READ_AHEAD_INPUT_STREAM(stream));
+
+	return G_INPUT_STREAM_CLASS(ogio_read_ahead_input_stream_parent_class)->close_fn(stream, cancellable, error);
+}
+
+static void ogio_read_ahead_input_stream_finalize(GObject* object)
+{
+	OGioReadAheadInputStream* self = OGIO_READ_AHEAD_INPUT_STREAM(object);
+
+	stopReading(self);
+	g_clear_object(&self->cancellable);
+	g_cond_clear(&self->cond);
+	g_mutex_clear(&self->mutex);
+
+	G_OBJECT_CLASS(ogio_read_ahead_input_stream_parent_class)->finalize(object);
+}
+
+static void ogio_read_ahead_input_stream_init(OGioReadAheadInputStream* self)
+{
+	self->fd = -1;
+	self->cancellable = g_cancellable_new();
+
+	g_mutex_init(&self->mutex);
+	g_cond_init(&self->cond);
+	g_queue_init(&self->chunks);
+}
+
+static void ogio_read_ahead_input_stream_class_init(OGioReadAheadInputStreamClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GInputStreamClass* streamClass = G_INPUT_STREAM_CLASS(klass);
+
+	objectClass->finalize = ogio_read_ahead_input_stream_finalize;
+
+	streamClass->read_fn = ogio_read_ahead_input_stream_read;
+	streamClass->skip = ogio_read_ahead_input_stream_skip;
+	streamClass->close_fn = ogio_read_ahead_input_stream_close;
+}
+
+GInputStream* ogio_read_ahead_input_stream_new(GInputStream* baseStream, guint depth, gsize bufferSize)
+{
+	g_return_val_if_fail(G_IS_INPUT_STREAM(baseStream), NULL);
+	g_return_val_if_fail(depth > 0, NULL);
+
+	OGioReadAheadInputStream* self = g_object_new(OGIO_TYPE_READ_AHEAD_INPUT_STREAM, "base-stream", baseStream, NULL);
+	self->depth = depth;
+	self->bufferSize = (bufferSize > 0 ? bufferSize : DEFAULT_BUFFER_SIZE);
+
+	if (G_IS_FILE_DESCRIPTOR_BASED(baseStream) && G_IS_SEEKABLE(baseStream)) {
+		int fd = g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(baseStream));
+		struct stat info;
+
+		if (fstat(fd, &info) == 0 && S_ISREG(info.st_mode)) {
+			self->fd = fd;
+			self->fileSize = (guint64)info.st_size;
+			self->nextOffset = (guint64)g_seekable_tell(G_SEEKABLE(baseStream));
+		}
+	}
+
+	/* A single thread keeps sequential reads of the base stream in order. */
+	self->pool = g_thread_pool_new(readChunk, self, (self->fd >= 0 ? (gint)depth : 1), FALSE, NULL);
+
+	return G_INPUT_STREAM(self);
+}
+
+guint ogio_read_ahead_input_stream_get_depth(OGioReadAheadInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_READ_AHEAD_INPUT_STREAM(stream), 0);
+
+	return stream->depth;
+}
+
+void ogio_read_ahead_input_stream_set_depth(OGioReadAheadInputStream* stream, guint depth)
+{
+	g_return_if_fail(OGIO_IS_READ_AHEAD_INPUT_STREAM(stream));
+	g_return_if_fail(depth > 0);
+
+	stream->depth = depth;
+
+	if (stream->fd >= 0 && stream->pool != NULL)
+		g_thread_pool_set_max_threads(stream->pool, (gint)depth, NULL);
+}
+
+gboolean ogio_read_ahead_input_stream_is_positional(OGioReadAheadInputStream* stream)
+{
+	g_return_val_if_fail(OGIO_IS_READ_AHEAD_INPUT_STREAM(stream), FALSE);
+
+	return (stream->fd >= 0);
+}
+
+@implementation OGReadAheadInputStream
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_READ_AHEAD_INPUT_STREAM;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_READ_AHEAD_INPUT_STREAM);
+	return gObjectClass;
+}
+
++ (instancetype)readAheadInputStreamWithBaseStream:(OGInputStream*)baseStream depth:(guint)depth bufferSize:(gsize)bufferSize
+{
+	if (baseStream == nil || depth == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioReadAheadInputStream* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_read_ahead_input_stream_new([baseStream castedGObject], depth, bufferSize), OGIO_TYPE_READ_AHEAD_INPUT_STREAM, OGioReadAheadInputStream);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGReadAheadInputStream* wrapperObject;
+	@try {
+		wrapperObject = [[OGReadAheadInputStream alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioReadAheadInputStream*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_READ_AHEAD_INPUT_STREAM, OGioReadAheadInputStream);
+}
+
+- (guint)depth
+{
+	guint returnValue = (guint)ogio_read_ahead_input_stream_get_depth((OGioReadAheadInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setDepth:(guint)depth
+{
+	if (depth == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_read_ahead_input_stream_set_depth((OGioReadAheadInputStream*)[self castedGObject], depth);
+}
+
+- (bool)isPositional
+{
+	bool returnValue = (bool)ogio_read_ahead_input_stream_is_positional((OGioReadAheadInputStream*)[self castedGObject]);
+
+	return returnValue;
+}
+
+@end
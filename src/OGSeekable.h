@@ -0,0 +1,178 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+
+/**
+ * `OGSeekable` exposes the [iface@Gio.Seekable] interface of a wrapped
+ * object, such as an #OGFileInputStream, #OGFileOutputStream,
+ * #OGFileIOStream, #OGMemoryInputStream or #OGIndexedGzipInputStream.
+ *
+ * In addition to seeking, it offers positional reads and writes with
+ * pread()/pwrite() semantics: they take an explicit offset and neither use
+ * nor move the position of the stream. When the stream is backed by a file
+ * descriptor, which is the case for local file streams, they map directly
+ * to pread() and pwrite() and are safe to call from any number of threads
+ * at once, concurrently with each other and with regular stream
+ * operations.
+ *
+ * For other streams they are emulated by seeking, transferring and seeking
+ * back. The emulation is serialized by the `OGSeekable` instance, so all
+ * concurrent users of such a stream have to go through the same instance,
+ * and it must not be mixed with regular reads and writes on other threads.
+ *
+ */
+@interface OGSeekable : OFObject
+{
+	OGObject* _object;
+	int _fd;
+	GMutex _mutex;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)seekableWithObject:(OGObject*)object;
+
+/**
+ * Initializes a seekable view of @object.
+ *
+ * @param object a wrapped object implementing #GSeekable
+ * @return an initialized seekable
+ */
+- (instancetype)initWithObject:(OGObject*)object;
+
+/**
+ * Methods
+ */
+
+/**
+ * The wrapped object.
+ *
+ * @return the object passed to the initializer
+ */
+- (OGObject*)object;
+
+/**
+ * Returns the #GSeekable interface of the wrapped object.
+ *
+ * @return the wrapped object as a #GSeekable
+ */
+- (GSeekable*)castedGObject;
+
+/**
+ * Tells the current position within the stream.
+ *
+ * @return the (positive or zero) offset from the beginning of the
+ * buffer, zero if the target is not seekable.
+ */
+- (goffset)tell;
+
+/**
+ * Tests if the stream supports the #GSeekableIface.
+ *
+ * @return %TRUE if @seekable can be seeked. %FALSE otherwise.
+ */
+- (bool)canSeek;
+
+/**
+ * Seeks in the stream by the given @offset, modified by @type.
+ *
+ * @param offset a #goffset.
+ * @param type a #GSeekType.
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE if successful.
+ */
+- (bool)seekToOffset:(goffset)offset type:(GSeekType)type cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Tests if the length of the stream can be adjusted with
+ * -truncateToOffset:cancellable:.
+ *
+ * @return %TRUE if the stream can be truncated, %FALSE otherwise.
+ */
+- (bool)canTruncate;
+
+/**
+ * Sets the length of the stream to @offset. If the stream was previously
+ * larger than @offset, the extra data is discarded. If the stream was
+ * previously shorter than @offset, it is extended with NUL ('\0') bytes.
+ *
+ * @param offset new length for @seekable, in bytes.
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return %TRUE if successful.
+ */
+- (bool)truncateToOffset:(goffset)offset cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Returns whether positional reads and writes go straight to the file
+ * descriptor of the stream and may be issued from several threads at once.
+ *
+ * @return whether the stream is backed by a file descriptor
+ */
+- (bool)supportsConcurrentPositionalIO;
+
+/**
+ * Reads up to @count bytes starting at @offset into @buffer without
+ * changing the position of the stream.
+ *
+ * @param buffer a buffer to read data into, at least @count bytes long
+ * @param count the number of bytes that will be read from the stream
+ * @param offset the offset to read from
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return the number of bytes read, 0 at the end of the stream
+ */
+- (gssize)readIntoBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Reads @count bytes starting at @offset into @buffer without changing the
+ * position of the stream, retrying short reads until @count bytes were read
+ * or the end of the stream was reached.
+ *
+ * @param buffer a buffer to read data into, at least @count bytes long
+ * @param count the number of bytes that will be read from the stream
+ * @param offset the offset to read from
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return the number of bytes read, less than @count only at the end of the
+ *     stream
+ */
+- (gsize)readAllIntoBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Writes up to @count bytes from @buffer at @offset without changing the
+ * position of the stream. Streams opened for appending write at the end
+ * regardless of @offset.
+ *
+ * @param buffer the buffer containing the data to write
+ * @param count the number of bytes to write
+ * @param offset the offset to write at
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return the number of bytes written
+ */
+- (gssize)writeBuffer:(const void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Writes all @count bytes from @buffer at @offset without changing the
+ * position of the stream.
+ *
+ * @param buffer the buffer containing the data to write
+ * @param count the number of bytes to write
+ * @param offset the offset to write at
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ */
+- (void)writeAllBuffer:(const void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable;
+
+@end
@@ -0,0 +1,271 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSeekable.h"
+
+#import "OGCancellable.h"
+
+#include <errno.h>
+#include <unistd.h>
+
+static int descriptorForObject(GObject* object)
+{
+	if (G_IS_FILE_DESCRIPTOR_BASED(object))
+		return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(object));
+
+	if (G_IS_IO_STREAM(object)) {
+		GInputStream* input = g_io_stream_get_input_stream(G_IO_STREAM(object));
+		GOutputStream* output = g_io_stream_get_output_stream(G_IO_STREAM(object));
+
+		if (G_IS_FILE_DESCRIPTOR_BASED(output))
+			return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(output));
+
+		if (G_IS_FILE_DESCRIPTOR_BASED(input))
+			return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(input));
+	}
+
+	return -1;
+}
+
+static gssize positionalTransfer(int fd, void* buffer, gsize count, goffset offset, bool write, GCancellable* cancellable, GError** error)
+{
+	gssize result;
+
+	if (g_cancellable_set_error_if_cancelled(cancellable, error))
+		return -1;
+
+	count = MIN(count, G_MAXSSIZE);
+
+	do {
+		result = (write ? pwrite(fd, buffer, count, offset) : pread(fd, buffer, count, offset));
+	} while (result < 0 && errno == EINTR);
+
+	if (result < 0) {
+		int errsv = errno;
+
+		g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "Error %s file descriptor: %s", (write ? "writing to" : "reading from"), g_strerror(errsv));
+	}
+
+	return result;
+}
+
+@interface OGSeekable ()
+- (gssize)emulatedTransferWithBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset write:(bool)write cancellable:(GCancellable*)cancellable error:(GError**)error;
+@end
+
+@implementation OGSeekable
+
++ (instancetype)seekableWithObject:(OGObject*)object
+{
+	return [[[self alloc] initWithObject:object] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithObject:(OGObject*)object
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+
+	@try {
+		if (object == nil || !G_IS_SEEKABLE([object gObject]))
+			@throw [OFInvalidArgumentException exception];
+
+		_object = [object retain];
+		_fd = descriptorForObject([object gObject]);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[_object release];
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (OGObject*)object
+{
+	return _object;
+}
+
+- (GSeekable*)castedGObject
+{
+	return G_SEEKABLE([_object gObject]);
+}
+
+- (goffset)tell
+{
+	goffset returnValue = (goffset)g_seekable_tell([self castedGObject]);
+
+	return returnValue;
+}
+
+- (bool)canSeek
+{
+	bool returnValue = (bool)g_seekable_can_seek([self castedGObject]);
+
+	return returnValue;
+}
+
+- (bool)seekToOffset:(goffset)offset type:(GSeekType)type cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)g_seekable_seek([self castedGObject], offset, type, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (bool)canTruncate
+{
+	bool returnValue = (bool)g_seekable_can_truncate([self castedGObject]);
+
+	return returnValue;
+}
+
+- (bool)truncateToOffset:(goffset)offset cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)g_seekable_truncate([self castedGObject], offset, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (bool)supportsConcurrentPositionalIO
+{
+	return (_fd >= 0);
+}
+
+- (gssize)emulatedTransferWithBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset write:(bool)write cancellable:(GCancellable*)cancellable error:(GError**)error
+{
+	GObject* object = [_object gObject];
+	GSeekable* seekable = G_SEEKABLE(object);
+	GInputStream* input = NULL;
+	GOutputStream* output = NULL;
+
+	if (G_IS_IO_STREAM(object)) {
+		input = g_io_stream_get_input_stream(G_IO_STREAM(object));
+		output = g_io_stream_get_output_stream(G_IO_STREAM(object));
+	} else if (G_IS_INPUT_STREAM(object)) {
+		input = G_INPUT_STREAM(object);
+	} else if (G_IS_OUTPUT_STREAM(object)) {
+		output = G_OUTPUT_STREAM(object);
+	}
+
+	if ((write && output == NULL) || (!write && input == NULL)) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, (write ? "Stream is not writable" : "Stream is not readable"));
+		return -1;
+	}
+
+	gssize result = -1;
+
+	g_mutex_lock(&_mutex);
+
+	goffset saved = g_seekable_tell(seekable);
+
+	if (g_seekable_seek(seekable, offset, G_SEEK_SET, cancellable, error)) {
+		if (write)
+			result = g_output_stream_write(output, buffer, count, cancellable, error);
+		else
+			result = g_input_stream_read(input, buffer, count, cancellable, error);
+
+		/* Restoring the position must not clobber the error of the transfer. */
+		if (!g_seekable_seek(seekable, saved, G_SEEK_SET, NULL, (result >= 0 ? error : NULL)))
+			result = -1;
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	return result;
+}
+
+- (gssize)readIntoBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+	gssize returnValue;
+
+	if (offset < 0)
+		@throw [OFOutOfRangeException exception];
+
+	if (_fd >= 0)
+		returnValue = positionalTransfer(_fd, buffer, count, offset, false, [cancellable castedGObject], &err);
+	else
+		returnValue = [self emulatedTransferWithBuffer:buffer count:count atOffset:offset write:false cancellable:[cancellable castedGObject] error:&err];
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (gsize)readAllIntoBuffer:(void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable
+{
+	gsize read = 0;
+
+	while (read < count) {
+		gssize chunk = [self readIntoBuffer:(guint8*)buffer + read count:count - read atOffset:offset + (goffset)read cancellable:cancellable];
+
+		if (chunk == 0)
+			break;
+
+		read += chunk;
+	}
+
+	return read;
+}
+
+- (gssize)writeBuffer:(const void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+	gssize returnValue;
+
+	if (offset < 0)
+		@throw [OFOutOfRangeException exception];
+
+	if (_fd >= 0)
+		returnValue = positionalTransfer(_fd, (void*)buffer, count, offset, true, [cancellable castedGObject], &err);
+	else
+		returnValue = [self emulatedTransferWithBuffer:(void*)buffer count:count atOffset:offset write:true cancellable:[cancellable castedGObject] error:&err];
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (void)writeAllBuffer:(const void*)buffer count:(gsize)count atOffset:(goffset)offset cancellable:(OGCancellable*)cancellable
+{
+	gsize written = 0;
+
+	while (written < count) {
+		gssize chunk = [self writeBuffer:(const guint8*)buffer + written count:count - written atOffset:offset + (goffset)written cancellable:cancellable];
+
+		/* Nothing written without an error would otherwise loop forever. */
+		if (chunk <= 0) {
+			GError* err = NULL;
+
+			g_set_error(&err, G_IO_ERROR, G_IO_ERROR_FAILED, "Short write at offset %" G_GOFFSET_FORMAT, offset + (goffset)written);
+			[OGErrorException throwForError:err];
+		}
+
+		written += chunk;
+	}
+}
+
+@end
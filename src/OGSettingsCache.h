@@ -0,0 +1,96 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+#import "OGSettingsSnapshot.h"
+
+@class OGSettings;
+
+/**
+ * `OGSettingsCache` keeps an #OGSettingsSnapshot of an #OGSettings object
+ * up to date and hands it out to any thread.
+ *
+ * The cache reads all keys when it is created and again whenever the
+ * settings emit #GSettings::change-event, which happens once per write,
+ * reset or applied batch, in the thread-default main context the settings
+ * were created in. The new snapshot replaces the old one with a single
+ * atomic exchange, so a reader sees either all of the old or all of the
+ * new values.
+ *
+ * Taking the current snapshot is lock-free: a reader increments the counter
+ * of the current generation, retries if the generation changed meanwhile,
+ * takes a reference and decrements the counter again. The refreshing thread
+ * waits only for the readers of the previous generation before dropping its
+ * reference to the old snapshot. A request handler
+ * takes a snapshot once and then reads all its settings from it.
+ *
+ */
+@interface OGSettingsCache : OFObject
+{
+	OGSettings* _settings;
+	gulong _changeEventHandler;
+	OGioSettingsSnapshot* _current;
+	guint64 _serial;
+	gint _epoch;
+	gint _readers[2];
+	GMutex _refreshMutex;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)cacheWithSettings:(OGSettings*)settings;
+
+/**
+ * Initializes a cache following @settings.
+ *
+ * @param settings the settings to cache
+ * @return an initialized cache
+ */
+- (instancetype)initWithSettings:(OGSettings*)settings;
+
+/**
+ * Methods
+ */
+
+/**
+ * The cached settings.
+ *
+ * @return the settings
+ */
+- (OGSettings*)settings;
+
+/**
+ * The current snapshot.
+ *
+ * @return the current snapshot
+ */
+- (OGSettingsSnapshot*)snapshot;
+
+/**
+ * Takes a reference to the current snapshot without allocating.
+ *
+ * @return (transfer full): the current snapshot, to be released with
+ * ogio_settings_snapshot_unref()
+ */
+- (OGioSettingsSnapshot*)acquireSnapshot;
+
+/**
+ * Reads all keys again and publishes the result, for settings changed in
+ * a way that emits no signal in this process.
+ */
+- (void)refresh;
+
+@end
@@ -0,0 +1,132 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsCache.h"
+
+#import "OGSettings.h"
+
+static gboolean changeEvent(GSettings* settings, gpointer keys, gint nKeys, gpointer userData)
+{
+	OGSettingsCache* cache = userData;
+
+	[cache refresh];
+
+	return FALSE;
+}
+
+@implementation OGSettingsCache
+
++ (instancetype)cacheWithSettings:(OGSettings*)settings
+{
+	return [[[self alloc] initWithSettings:settings] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithSettings:(OGSettings*)settings
+{
+	self = [super init];
+
+	@try {
+		if (settings == nil)
+			@throw [OFInvalidArgumentException exception];
+
+		g_mutex_init(&_refreshMutex);
+
+		_settings = [settings retain];
+		_current = ogio_settings_snapshot_new([_settings castedGObject], _serial);
+		_changeEventHandler = g_signal_connect([_settings castedGObject], "change-event", G_CALLBACK(changeEvent), self);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_changeEventHandler != 0)
+		g_signal_handler_disconnect([_settings castedGObject], _changeEventHandler);
+
+	if (_current != NULL)
+		ogio_settings_snapshot_unref(_current);
+
+	[_settings release];
+	g_mutex_clear(&_refreshMutex);
+
+	[super dealloc];
+}
+
+- (OGSettings*)settings
+{
+	return _settings;
+}
+
+- (OGioSettingsSnapshot*)acquireSnapshot
+{
+	OGioSettingsSnapshot* snapshot;
+	gint epoch;
+
+	/* Load the pointer only while counted as a reader of the current
+	 * generation, so the refreshing thread cannot drop it between the load
+	 * and the reference. If the generation changed before the counter was
+	 * raised, the refresh that flipped it may already have finished its
+	 * drain check, so count again under the new generation. */
+	for (;;) {
+		epoch = g_atomic_int_get(&_epoch);
+		g_atomic_int_inc(&_readers[epoch & 1]);
+
+		if (G_LIKELY(g_atomic_int_get(&_epoch) == epoch))
+			break;
+
+		g_atomic_int_add(&_readers[epoch & 1], -1);
+	}
+
+	snapshot = ogio_settings_snapshot_ref(g_atomic_pointer_get(&_current));
+	g_atomic_int_add(&_readers[epoch & 1], -1);
+
+	return snapshot;
+}
+
+- (OGSettingsSnapshot*)snapshot
+{
+	OGioSettingsSnapshot* snapshot = [self acquireSnapshot];
+
+	@try {
+		return [[[OGSettingsSnapshot alloc] initWithSnapshot:snapshot] autorelease];
+	} @finally {
+		ogio_settings_snapshot_unref(snapshot);
+	}
+}
+
+- (void)refresh
+{
+	OGioSettingsSnapshot* old;
+	gint epoch;
+
+	g_mutex_lock(&_refreshMutex);
+
+	old = g_atomic_pointer_exchange(&_current, ogio_settings_snapshot_new([_settings castedGObject], ++_serial));
+
+	/* Readers arriving from now on count themselves in the other
+	 * generation and load the new snapshot; wait for the ones that may
+	 * still be loading the old one. */
+	epoch = g_atomic_int_get(&_epoch) & 1;
+	g_atomic_int_inc(&_epoch);
+
+	while (g_atomic_int_get(&_readers[epoch]) != 0)
+		g_thread_yield();
+
+	ogio_settings_snapshot_unref(old);
+
+	g_mutex_unlock(&_refreshMutex);
+}
+
+@end
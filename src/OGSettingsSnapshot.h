@@ -0,0 +1,214 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGSettings;
+
+G_BEGIN_DECLS
+
+typedef struct _OGioSettingsSnapshot OGioSettingsSnapshot;
+
+OGioSettingsSnapshot* ogio_settings_snapshot_new(GSettings* settings, guint64 serial);
+OGioSettingsSnapshot* ogio_settings_snapshot_ref(OGioSettingsSnapshot* snapshot);
+void ogio_settings_snapshot_unref(OGioSettingsSnapshot* snapshot);
+guint64 ogio_settings_snapshot_get_serial(OGioSettingsSnapshot* snapshot);
+gboolean ogio_settings_snapshot_has_key(OGioSettingsSnapshot* snapshot, const gchar* key);
+GVariant* ogio_settings_snapshot_get_value(OGioSettingsSnapshot* snapshot, const gchar* key);
+gboolean ogio_settings_snapshot_get_boolean(OGioSettingsSnapshot* snapshot, const gchar* key);
+gint ogio_settings_snapshot_get_int(OGioSettingsSnapshot* snapshot, const gchar* key);
+gint64 ogio_settings_snapshot_get_int64(OGioSettingsSnapshot* snapshot, const gchar* key);
+guint ogio_settings_snapshot_get_uint(OGioSettingsSnapshot* snapshot, const gchar* key);
+guint64 ogio_settings_snapshot_get_uint64(OGioSettingsSnapshot* snapshot, const gchar* key);
+gdouble ogio_settings_snapshot_get_double(OGioSettingsSnapshot* snapshot, const gchar* key);
+gint ogio_settings_snapshot_get_enum(OGioSettingsSnapshot* snapshot, const gchar* key);
+guint ogio_settings_snapshot_get_flags(OGioSettingsSnapshot* snapshot, const gchar* key);
+const gchar* ogio_settings_snapshot_get_string(OGioSettingsSnapshot* snapshot, const gchar* key);
+const gchar* const* ogio_settings_snapshot_get_strv(OGioSettingsSnapshot* snapshot, const gchar* key);
+
+G_DEFINE_AUTOPTR_CLEANUP_FUNC(OGioSettingsSnapshot, ogio_settings_snapshot_unref)
+
+G_END_DECLS
+
+/**
+ * `OGSettingsSnapshot` holds the values of all keys of an #OGSettings
+ * object, read in one pass.
+ *
+ * Every value is unpacked once when the snapshot is taken: numbers,
+ * booleans, enums and flags are stored natively, strings and string
+ * arrays point into the stored #GVariant. Getters are a hash lookup and
+ * neither allocate nor call into GSettings, and since a snapshot never
+ * changes, it can be read from any number of threads without locking.
+ *
+ * Snapshots that follow the settings as they change are handed out by
+ * #OGSettingsCache. Reading all the values a request needs from one
+ * snapshot also guarantees they are consistent with each other.
+ *
+ * Like the getters of #OGSettings, the getters expect the key to exist
+ * and to have the matching type; otherwise a critical is logged and a
+ * zero value returned.
+ *
+ */
+@interface OGSettingsSnapshot : OFObject
+{
+	OGioSettingsSnapshot* _snapshot;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)snapshotWithSettings:(OGSettings*)settings;
+
+/**
+ * Initializes a snapshot of the current values of @settings.
+ *
+ * @param settings the settings to read
+ * @return an initialized snapshot
+ */
+- (instancetype)initWithSettings:(OGSettings*)settings;
+
+/**
+ * Initializes a wrapper for @snapshot, taking a reference on it.
+ *
+ * @param snapshot the snapshot to wrap
+ * @return an initialized snapshot
+ */
+- (instancetype)initWithSnapshot:(OGioSettingsSnapshot*)snapshot;
+
+/**
+ * Methods
+ */
+
+/**
+ * The wrapped snapshot.
+ *
+ * @return the snapshot, owned by the receiver
+ */
+- (OGioSettingsSnapshot*)snapshot;
+
+/**
+ * The serial number of the snapshot, which grows with every refresh of
+ * the #OGSettingsCache it came from.
+ *
+ * @return the serial number
+ */
+- (guint64)serial;
+
+/**
+ * Returns whether the snapshot contains @key.
+ *
+ * @param key the key to look up
+ * @return whether @key exists
+ */
+- (bool)hasKey:(OFString*)key;
+
+/**
+ * Gets the value of @key.
+ *
+ * @param key the key to get the value for
+ * @return the value, owned by the snapshot
+ */
+- (GVariant*)valueWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the boolean @key.
+ *
+ * @param key the key to get the value for
+ * @return a boolean
+ */
+- (bool)booleanWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the 32-bit integer @key.
+ *
+ * @param key the key to get the value for
+ * @return an integer
+ */
+- (gint)intWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the 64-bit integer @key.
+ *
+ * @param key the key to get the value for
+ * @return a 64-bit integer
+ */
+- (gint64)int64WithKey:(OFString*)key;
+
+/**
+ * Gets the value of the 32-bit unsigned integer @key.
+ *
+ * @param key the key to get the value for
+ * @return an unsigned integer
+ */
+- (guint)uintWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the 64-bit unsigned integer @key.
+ *
+ * @param key the key to get the value for
+ * @return a 64-bit unsigned integer
+ */
+- (guint64)uint64WithKey:(OFString*)key;
+
+/**
+ * Gets the value of the double @key.
+ *
+ * @param key the key to get the value for
+ * @return a double
+ */
+- (gdouble)doubleWithKey:(OFString*)key;
+
+/**
+ * Gets the enum value of @key, which must have an enumerated type in the
+ * schema.
+ *
+ * @param key the key to get the value for
+ * @return the enum value
+ */
+- (gint)enumWithKey:(OFString*)key;
+
+/**
+ * Gets the flags value of @key, which must have a flags type in the
+ * schema.
+ *
+ * @param key the key to get the value for
+ * @return the flags value
+ */
+- (guint)flagsWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the string @key.
+ *
+ * @param key the key to get the value for
+ * @return a newly created string
+ */
+- (OFString*)stringWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the string @key without copying it.
+ *
+ * @param key the key to get the value for
+ * @return the string, owned by the snapshot
+ */
+- (const gchar*)cStringWithKey:(OFString*)key;
+
+/**
+ * Gets the value of the string array @key without copying it.
+ *
+ * @param key the key to get the value for
+ * @return a %NULL-terminated array, owned by the snapshot
+ */
+- (const gchar* const*)strvWithKey:(OFString*)key;
+
+@end
@@ -0,0 +1,423 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsSnapshot.h"
+
+#import "OGSettings.h"
+
+#include <string.h>
+
+typedef struct {
+	GVariant* value;
+	/* The first character of the type string of @value. */
+	gchar type;
+	gboolean isEnum;
+	gboolean isFlags;
+	union {
+		gboolean boolean;
+		gint64 integer;
+		guint64 unsignedInteger;
+		gdouble number;
+	} scalar;
+	gint enumValue;
+	guint flagsValue;
+	const gchar* string;
+	const gchar** strv;
+} Entry;
+
+struct _OGioSettingsSnapshot {
+	guint64 serial;
+	GHashTable* entries;
+};
+
+static void entryFree(gpointer data)
+{
+	Entry* entry = data;
+
+	g_variant_unref(entry->value);
+	g_free(entry->strv);
+	g_free(entry);
+}
+
+static Entry* readEntry(GSettings* settings, GSettingsSchema* schema, const gchar* key)
+{
+	Entry* entry = g_new0(Entry, 1);
+	GSettingsSchemaKey* schemaKey = g_settings_schema_get_key(schema, key);
+	GVariant* range = g_settings_schema_key_get_range(schemaKey);
+	const gchar* rangeType;
+
+	entry->value = g_settings_get_value(settings, key);
+	entry->type = g_variant_get_type_string(entry->value)[0];
+
+	g_variant_get_child(range, 0, "&s", &rangeType);
+
+	if (strcmp(rangeType, "enum") == 0) {
+		entry->isEnum = TRUE;
+		entry->enumValue = g_settings_get_enum(settings, key);
+	} else if (strcmp(rangeType, "flags") == 0) {
+		entry->isFlags = TRUE;
+		entry->flagsValue = g_settings_get_flags(settings, key);
+	}
+
+	g_variant_unref(range);
+	g_settings_schema_key_unref(schemaKey);
+
+	switch (entry->type) {
+	case 'b':
+		entry->scalar.boolean = g_variant_get_boolean(entry->value);
+		break;
+	case 'n':
+		entry->scalar.integer = g_variant_get_int16(entry->value);
+		break;
+	case 'i':
+		entry->scalar.integer = g_variant_get_int32(entry->value);
+		break;
+	case 'x':
+		entry->scalar.integer = g_variant_get_int64(entry->value);
+		break;
+	case 'y':
+		entry->scalar.unsignedInteger = g_variant_get_byte(entry->value);
+		break;
+	case 'q':
+		entry->scalar.unsignedInteger = g_variant_get_uint16(entry->value);
+		break;
+	case 'u':
+		entry->scalar.unsignedInteger = g_variant_get_uint32(entry->value);
+		break;
+	case 't':
+		entry->scalar.unsignedInteger = g_variant_get_uint64(entry->value);
+		break;
+	case 'd':
+		entry->scalar.number = g_variant_get_double(entry->value);
+		break;
+	case 's':
+	case 'o':
+	case 'g':
+		entry->string = g_variant_get_string(entry->value, NULL);
+		break;
+	case 'a':
+		if (g_variant_is_of_type(entry->value, G_VARIANT_TYPE_STRING_ARRAY))
+			entry->strv = g_variant_get_strv(entry->value, NULL);
+		break;
+	}
+
+	return entry;
+}
+
+OGioSettingsSnapshot* ogio_settings_snapshot_new(GSettings* settings, guint64 serial)
+{
+	g_return_val_if_fail(G_IS_SETTINGS(settings), NULL);
+
+	OGioSettingsSnapshot* snapshot = g_atomic_rc_box_new0(OGioSettingsSnapshot);
+	GSettingsSchema* schema = NULL;
+	gchar** keys;
+
+	g_object_get(settings, "settings-schema", &schema, NULL);
+	keys = g_settings_schema_list_keys(schema);
+
+	snapshot->serial = serial;
+	snapshot->entries = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, entryFree);
+
+	for (gchar** key = keys; *key != NULL; key++)
+		g_hash_table_insert(snapshot->entries, g_strdup(*key), readEntry(settings, schema, *key));
+
+	g_strfreev(keys);
+	g_settings_schema_unref(schema);
+
+	return snapshot;
+}
+
+static void snapshotClear(gpointer data)
+{
+	OGioSettingsSnapshot* snapshot = data;
+
+	g_hash_table_unref(snapshot->entries);
+}
+
+OGioSettingsSnapshot* ogio_settings_snapshot_ref(OGioSettingsSnapshot* snapshot)
+{
+	g_return_val_if_fail(snapshot != NULL, NULL);
+
+	return g_atomic_rc_box_acquire(snapshot);
+}
+
+void ogio_settings_snapshot_unref(OGioSettingsSnapshot* snapshot)
+{
+	g_return_if_fail(snapshot != NULL);
+
+	g_atomic_rc_box_release_full(snapshot, snapshotClear);
+}
+
+guint64 ogio_settings_snapshot_get_serial(OGioSettingsSnapshot* snapshot)
+{
+	g_return_val_if_fail(snapshot != NULL, 0);
+
+	return snapshot->serial;
+}
+
+gboolean ogio_settings_snapshot_has_key(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	g_return_val_if_fail(snapshot != NULL, FALSE);
+
+	return g_hash_table_contains(snapshot->entries, key);
+}
+
+GVariant* ogio_settings_snapshot_get_value(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL, NULL);
+
+	return entry->value;
+}
+
+gboolean ogio_settings_snapshot_get_boolean(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 'b', FALSE);
+
+	return entry->scalar.boolean;
+}
+
+gint ogio_settings_snapshot_get_int(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 'i', 0);
+
+	return (gint)entry->scalar.integer;
+}
+
+gint64 ogio_settings_snapshot_get_int64(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 'x', 0);
+
+	return entry->scalar.integer;
+}
+
+guint ogio_settings_snapshot_get_uint(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 'u', 0);
+
+	return (guint)entry->scalar.unsignedInteger;
+}
+
+guint64 ogio_settings_snapshot_get_uint64(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 't', 0);
+
+	return entry->scalar.unsignedInteger;
+}
+
+gdouble ogio_settings_snapshot_get_double(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 'd', 0);
+
+	return entry->scalar.number;
+}
+
+gint ogio_settings_snapshot_get_enum(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->isEnum, 0);
+
+	return entry->enumValue;
+}
+
+guint ogio_settings_snapshot_get_flags(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->isFlags, 0);
+
+	return entry->flagsValue;
+}
+
+const gchar* ogio_settings_snapshot_get_string(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->type == 's', NULL);
+
+	return entry->string;
+}
+
+const gchar* const* ogio_settings_snapshot_get_strv(OGioSettingsSnapshot* snapshot, const gchar* key)
+{
+	Entry* entry = g_hash_table_lookup(snapshot->entries, key);
+
+	g_return_val_if_fail(entry != NULL && entry->strv != NULL, NULL);
+
+	return entry->strv;
+}
+
+@implementation OGSettingsSnapshot
+
++ (instancetype)snapshotWithSettings:(OGSettings*)settings
+{
+	return [[[self alloc] initWithSettings:settings] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithSettings:(OGSettings*)settings
+{
+	self = [super init];
+
+	@try {
+		if (settings == nil)
+			@throw [OFInvalidArgumentException exception];
+
+		_snapshot = ogio_settings_snapshot_new([settings castedGObject], 0);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (instancetype)initWithSnapshot:(OGioSettingsSnapshot*)snapshot
+{
+	self = [super init];
+
+	@try {
+		if (snapshot == NULL)
+			@throw [OFInvalidArgumentException exception];
+
+		_snapshot = ogio_settings_snapshot_ref(snapshot);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_snapshot != NULL)
+		ogio_settings_snapshot_unref(_snapshot);
+
+	[super dealloc];
+}
+
+- (OGioSettingsSnapshot*)snapshot
+{
+	return _snapshot;
+}
+
+- (guint64)serial
+{
+	return ogio_settings_snapshot_get_serial(_snapshot);
+}
+
+- (bool)hasKey:(OFString*)key
+{
+	bool returnValue = (bool)ogio_settings_snapshot_has_key(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (GVariant*)valueWithKey:(OFString*)key
+{
+	GVariant* returnValue = (GVariant*)ogio_settings_snapshot_get_value(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (bool)booleanWithKey:(OFString*)key
+{
+	bool returnValue = (bool)ogio_settings_snapshot_get_boolean(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (gint)intWithKey:(OFString*)key
+{
+	gint returnValue = (gint)ogio_settings_snapshot_get_int(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (gint64)int64WithKey:(OFString*)key
+{
+	gint64 returnValue = (gint64)ogio_settings_snapshot_get_int64(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (guint)uintWithKey:(OFString*)key
+{
+	guint returnValue = (guint)ogio_settings_snapshot_get_uint(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (guint64)uint64WithKey:(OFString*)key
+{
+	guint64 returnValue = (guint64)ogio_settings_snapshot_get_uint64(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (gdouble)doubleWithKey:(OFString*)key
+{
+	gdouble returnValue = (gdouble)ogio_settings_snapshot_get_double(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (gint)enumWithKey:(OFString*)key
+{
+	gint returnValue = (gint)ogio_settings_snapshot_get_enum(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (guint)flagsWithKey:(OFString*)key
+{
+	guint returnValue = (guint)ogio_settings_snapshot_get_flags(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (OFString*)stringWithKey:(OFString*)key
+{
+	const gchar* gobjectValue = ogio_settings_snapshot_get_string(_snapshot, [key UTF8String]);
+
+	OFString* returnValue = ((gobjectValue != NULL) ? [OFString stringWithUTF8String:gobjectValue] : nil);
+	return returnValue;
+}
+
+- (const gchar*)cStringWithKey:(OFString*)key
+{
+	const gchar* returnValue = ogio_settings_snapshot_get_string(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+- (const gchar* const*)strvWithKey:(OFString*)key
+{
+	const gchar* const* returnValue = ogio_settings_snapshot_get_strv(_snapshot, [key UTF8String]);
+
+	return returnValue;
+}
+
+@end
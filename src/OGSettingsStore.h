@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+/**
+ * `OGSettingsStore` is the base class for settings storage implemented in
+ * Objective-C. An #OGStoreSettingsBackend turns a store into a
+ * [class@Gio.SettingsBackend] that #OGSettings objects can be created
+ * with, taking care of change notifications.
+ *
+ * Subclasses must implement -readValueWithKey: and -writeValue:key:. The
+ * default -writeTree: writes the entries of the tree one by one; stores
+ * able to write several keys atomically should override it. Keys are full
+ * paths such as `/org/example/app/volume`.
+ *
+ * The methods are called from whichever thread uses the settings, so
+ * implementations must be thread-safe. Keys are passed as C strings and
+ * values as #GVariant so that no Objective-C objects need to be created on
+ * the read path; exceptions are caught by the backend and reported as
+ * failed writes or missing values.
+ *
+ */
+@interface OGSettingsStore : OFObject
+{
+
+}
+
+/**
+ * Methods
+ */
+
+/**
+ * Reads the value stored for @key.
+ *
+ * @param key the full path of a key
+ * @return (transfer full): the stored value, or %NULL if @key has no value
+ */
+- (GVariant*)readValueWithKey:(const gchar*)key;
+
+/**
+ * Stores @value for @key, or removes the stored value if @value is %NULL.
+ *
+ * @param value the value to store, or %NULL to reset @key
+ * @param key the full path of a key
+ * @return whether the value was stored
+ */
+- (bool)writeValue:(GVariant*)value key:(const gchar*)key;
+
+/**
+ * Stores all entries of @tree, a #GTree mapping keys to values or to
+ * %NULL for keys to reset. Either all or none of the entries should be
+ * stored.
+ *
+ * @param tree the entries to store
+ * @return whether the entries were stored
+ */
+- (bool)writeTree:(GTree*)tree;
+
+/**
+ * Returns whether @key can be written. The default implementation
+ * returns true for all keys.
+ *
+ * @param key the full path of a key
+ * @return whether @key is writable
+ */
+- (bool)isWritableWithKey:(const gchar*)key;
+
+/**
+ * Makes all stored values durable. The default implementation does
+ * nothing.
+ */
+- (void)sync;
+
+@end
@@ -0,0 +1,53 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsStore.h"
+
+typedef struct {
+	OGSettingsStore* store;
+	bool success;
+} WriteTreeData;
+
+static gboolean writeTreeEntry(gpointer key, gpointer value, gpointer userData)
+{
+	WriteTreeData* data = userData;
+
+	data->success = [data->store writeValue:value key:key];
+
+	return !data->success;
+}
+
+@implementation OGSettingsStore
+
+- (GVariant*)readValueWithKey:(const gchar*)key
+{
+	@throw [OFNotImplementedException exceptionWithSelector:_cmd object:self];
+}
+
+- (bool)writeValue:(GVariant*)value key:(const gchar*)key
+{
+	@throw [OFNotImplementedException exceptionWithSelector:_cmd object:self];
+}
+
+- (bool)writeTree:(GTree*)tree
+{
+	WriteTreeData data = { self, true };
+
+	g_tree_foreach(tree, writeTreeEntry, &data);
+
+	return data.success;
+}
+
+- (bool)isWritableWithKey:(const gchar*)key
+{
+	return true;
+}
+
+- (void)sync
+{
+}
+
+@end
@@ -0,0 +1,189 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGSettings;
+
+/**
+ * `OGSettingsWriteBatch` collects writes to the keys of one or more
+ * #OGSettings objects and commits them together.
+ *
+ * Writes are staged per schema, path and backend; writing the same key
+ * again replaces the staged value, so only the last value of every key
+ * reaches the backend. On commit, keys whose stored value already equals
+ * the staged one and keys that are not writable are skipped, and the
+ * remaining writes of every schema and path are applied to the backend as
+ * a single tree write. Listeners therefore see one
+ * #GSettings::change-event per schema and path instead of one per key.
+ * GSettings offers no public way to write several paths atomically, so
+ * the trees of different schemas and paths are applied one after the
+ * other.
+ *
+ * With a window, the first staged write arms a timer in the thread-default
+ * main context of the thread that created the batch, and everything
+ * staged until it fires is committed at once. -commit can be called at
+ * any time to flush early.
+ *
+ * Writes are validated against the schema when they are staged. All
+ * methods may be called from any thread.
+ *
+ */
+@interface OGSettingsWriteBatch : OFObject
+{
+	GMutex _mutex;
+	GMutex _commitMutex;
+	GHashTable* _targets;
+	GHashTable* _clones;
+	guint _windowMsecs;
+	GMainContext* _context;
+	GSource* _windowSource;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)writeBatch;
++ (instancetype)writeBatchWithWindowMsecs:(guint)windowMsecs;
+
+/**
+ * Initializes a batch that is committed only by -commit.
+ *
+ * @return an initialized write batch
+ */
+- (instancetype)init;
+
+/**
+ * Initializes a batch that commits itself @windowMsecs milliseconds after
+ * the first staged write.
+ *
+ * @param windowMsecs the coalescing window, 0 to commit only by -commit
+ * @return an initialized write batch
+ */
+- (instancetype)initWithWindowMsecs:(guint)windowMsecs;
+
+/**
+ * Methods
+ */
+
+/**
+ * Stages writing @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value a #GVariant of the correct type, floating references are
+ * sunk
+ */
+- (void)setValueWithSettings:(OGSettings*)settings key:(OFString*)key value:(GVariant*)value;
+
+/**
+ * Stages writing the boolean @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setBooleanWithSettings:(OGSettings*)settings key:(OFString*)key value:(bool)value;
+
+/**
+ * Stages writing the 32-bit integer @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setIntWithSettings:(OGSettings*)settings key:(OFString*)key value:(gint)value;
+
+/**
+ * Stages writing the 64-bit integer @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setInt64WithSettings:(OGSettings*)settings key:(OFString*)key value:(gint64)value;
+
+/**
+ * Stages writing the 32-bit unsigned integer @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setUintWithSettings:(OGSettings*)settings key:(OFString*)key value:(guint)value;
+
+/**
+ * Stages writing the 64-bit unsigned integer @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setUint64WithSettings:(OGSettings*)settings key:(OFString*)key value:(guint64)value;
+
+/**
+ * Stages writing the double @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setDoubleWithSettings:(OGSettings*)settings key:(OFString*)key value:(gdouble)value;
+
+/**
+ * Stages writing the string @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to
+ */
+- (void)setStringWithSettings:(OGSettings*)settings key:(OFString*)key value:(OFString*)value;
+
+/**
+ * Stages writing the string array @value to @key.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of the key to set
+ * @param value the value to set it to, or %NULL
+ */
+- (void)setStrvWithSettings:(OGSettings*)settings key:(OFString*)key value:(const gchar* const*)value;
+
+/**
+ * Stages resetting @key to its default value.
+ *
+ * @param settings the settings the key belongs to
+ * @param key the name of a key
+ */
+- (void)resetWithSettings:(OGSettings*)settings key:(OFString*)key;
+
+/**
+ * The number of staged writes.
+ *
+ * @return the number of keys with a staged write
+ */
+- (guint)pendingCount;
+
+/**
+ * Drops all staged writes.
+ */
+- (void)discard;
+
+/**
+ * Writes all staged values to their backends.
+ *
+ * @return the number of keys that were changed
+ */
+- (guint)commit;
+
+@end
@@ -0,0 +1,362 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsWriteBatch.h"
+
+#import "OGSettings.h"
+
+/*
+ * The staged writes of one schema at one path of one backend. A %NULL
+ * value stands for a reset.
+ */
+typedef struct {
+	GSettingsSchema* schema;
+	GSettingsBackend* backend;
+	gchar* path;
+	GHashTable* writes;
+} Target;
+
+static void targetFree(gpointer data)
+{
+	Target* target = data;
+
+	g_settings_schema_unref(target->schema);
+	g_object_unref(target->backend);
+	g_free(target->path);
+	g_hash_table_unref(target->writes);
+	g_free(target);
+}
+
+static void variantUnref(gpointer value)
+{
+	if (value != NULL)
+		g_variant_unref(value);
+}
+
+static GHashTable* targetsNew(void)
+{
+	return g_hash_table_new_full(g_str_hash, g_str_equal, g_free, targetFree);
+}
+
+static void releaseBatch(gpointer data)
+{
+	[(OGSettingsWriteBatch*)data release];
+}
+
+@interface OGSettingsWriteBatch ()
+
+- (void)stageWithSettings:(OGSettings*)settings key:(OFString*)key value:(GVariant*)value;
+
+- (void)windowExpired:(GSource*)source;
+
+@end
+
+static gboolean windowExpired(gpointer userData)
+{
+	OGSettingsWriteBatch* batch = userData;
+
+	[batch windowExpired:g_main_current_source()];
+
+	return G_SOURCE_REMOVE;
+}
+
+@implementation OGSettingsWriteBatch
+
++ (instancetype)writeBatch
+{
+	return [[[self alloc] init] autorelease];
+}
+
++ (instancetype)writeBatchWithWindowMsecs:(guint)windowMsecs
+{
+	return [[[self alloc] initWithWindowMsecs:windowMsecs] autorelease];
+}
+
+- (instancetype)init
+{
+	return [self initWithWindowMsecs:0];
+}
+
+- (instancetype)initWithWindowMsecs:(guint)windowMsecs
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+	g_mutex_init(&_commitMutex);
+
+	_targets = targetsNew();
+	_clones = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, g_object_unref);
+	_windowMsecs = windowMsecs;
+	_context = g_main_context_ref_thread_default();
+
+	return self;
+}
+
+- (void)dealloc
+{
+	/* A pending window holds a reference, so there is none left here. */
+	g_hash_table_unref(_targets);
+	g_hash_table_unref(_clones);
+	g_main_context_unref(_context);
+
+	g_mutex_clear(&_commitMutex);
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (void)stageWithSettings:(OGSettings*)settings key:(OFString*)key value:(GVariant*)value
+{
+	GSettingsSchema* schema = NULL;
+	GSettingsBackend* backend = NULL;
+	gchar* path = NULL;
+	const gchar* keyName;
+
+	if (value != NULL)
+		g_variant_ref_sink(value);
+
+	if (settings == nil || key == nil) {
+		if (value != NULL)
+			g_variant_unref(value);
+
+		@throw [OFInvalidArgumentException exception];
+	}
+
+	keyName = [key UTF8String];
+
+	g_object_get([settings castedGObject], "settings-schema", &schema, "backend", &backend, "path", &path, NULL);
+
+	@try {
+		if (!g_settings_schema_has_key(schema, keyName))
+			@throw [OFInvalidArgumentException exception];
+
+		if (value != NULL) {
+			GSettingsSchemaKey* schemaKey = g_settings_schema_get_key(schema, keyName);
+			gboolean valid = g_variant_is_of_type(value, g_settings_schema_key_get_value_type(schemaKey)) && g_settings_schema_key_range_check(schemaKey, value);
+
+			g_settings_schema_key_unref(schemaKey);
+
+			if (!valid)
+				@throw [OFInvalidArgumentException exception];
+		}
+	} @catch (id e) {
+		if (value != NULL)
+			g_variant_unref(value);
+
+		g_settings_schema_unref(schema);
+		g_object_unref(backend);
+		g_free(path);
+		@throw e;
+	}
+
+	gchar* targetId = g_strdup_printf("%p|%s|%s", (void*)backend, g_settings_schema_get_id(schema), path);
+
+	g_mutex_lock(&_mutex);
+
+	Target* target = g_hash_table_lookup(_targets, targetId);
+
+	if (target == NULL) {
+		target = g_new(Target, 1);
+		target->schema = schema;
+		target->backend = backend;
+		target->path = path;
+		target->writes = g_hash_table_new_full(g_str_hash, g_str_equal, g_free, variantUnref);
+
+		g_hash_table_insert(_targets, targetId, target);
+	} else {
+		g_settings_schema_unref(schema);
+		g_object_unref(backend);
+		g_free(path);
+		g_free(targetId);
+	}
+
+	/* Replacing the staged value is what coalesces repeated writes. */
+	g_hash_table_insert(target->writes, g_strdup(keyName), value);
+
+	if (_windowMsecs > 0 && _windowSource == NULL) {
+		_windowSource = g_timeout_source_new(_windowMsecs);
+		g_source_set_callback(_windowSource, windowExpired, [self retain], releaseBatch);
+		g_source_attach(_windowSource, _context);
+	}
+
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)windowExpired:(GSource*)source
+{
+	g_mutex_lock(&_mutex);
+
+	if (_windowSource == source) {
+		g_source_unref(_windowSource);
+		_windowSource = NULL;
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	[self commit];
+}
+
+- (void)setValueWithSettings:(OGSettings*)settings key:(OFString*)key value:(GVariant*)value
+{
+	if (value == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	[self stageWithSettings:settings key:key value:value];
+}
+
+- (void)setBooleanWithSettings:(OGSettings*)settings key:(OFString*)key value:(bool)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_boolean(value)];
+}
+
+- (void)setIntWithSettings:(OGSettings*)settings key:(OFString*)key value:(gint)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_int32(value)];
+}
+
+- (void)setInt64WithSettings:(OGSettings*)settings key:(OFString*)key value:(gint64)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_int64(value)];
+}
+
+- (void)setUintWithSettings:(OGSettings*)settings key:(OFString*)key value:(guint)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_uint32(value)];
+}
+
+- (void)setUint64WithSettings:(OGSettings*)settings key:(OFString*)key value:(guint64)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_uint64(value)];
+}
+
+- (void)setDoubleWithSettings:(OGSettings*)settings key:(OFString*)key value:(gdouble)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_double(value)];
+}
+
+- (void)setStringWithSettings:(OGSettings*)settings key:(OFString*)key value:(OFString*)value
+{
+	if (value == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	[self stageWithSettings:settings key:key value:g_variant_new_string([value UTF8String])];
+}
+
+- (void)setStrvWithSettings:(OGSettings*)settings key:(OFString*)key value:(const gchar* const*)value
+{
+	[self stageWithSettings:settings key:key value:g_variant_new_strv(value, -1)];
+}
+
+- (void)resetWithSettings:(OGSettings*)settings key:(OFString*)key
+{
+	[self stageWithSettings:settings key:key value:NULL];
+}
+
+- (guint)pendingCount
+{
+	GHashTableIter iter;
+	gpointer target;
+	guint count = 0;
+
+	g_mutex_lock(&_mutex);
+
+	g_hash_table_iter_init(&iter, _targets);
+	while (g_hash_table_iter_next(&iter, NULL, &target))
+		count += g_hash_table_size(((Target*)target)->writes);
+
+	g_mutex_unlock(&_mutex);
+
+	return count;
+}
+
+- (void)discard
+{
+	g_mutex_lock(&_mutex);
+	g_hash_table_remove_all(_targets);
+	g_mutex_unlock(&_mutex);
+}
+
+- (guint)commit
+{
+	GHashTable* targets;
+	GSource* windowSource;
+	GHashTableIter targetIter;
+	gpointer targetId, targetData;
+	guint written = 0;
+
+	g_mutex_lock(&_mutex);
+
+	targets = _targets;
+	_targets = targetsNew();
+
+	windowSource = _windowSource;
+	_windowSource = NULL;
+
+	g_mutex_unlock(&_mutex);
+
+	g_mutex_lock(&_commitMutex);
+
+	g_hash_table_iter_init(&targetIter, targets);
+	while (g_hash_table_iter_next(&targetIter, &targetId, &targetData)) {
+		Target* target = targetData;
+		GSettings* clone = g_hash_table_lookup(_clones, targetId);
+		GHashTableIter writeIter;
+		gpointer key, value;
+		guint changed = 0;
+
+		/* A private delayed instance turns the writes into one tree
+		 * write on apply, without touching the caller's instances. */
+		if (clone == NULL) {
+			clone = g_settings_new_full(target->schema, target->backend, target->path);
+			g_settings_delay(clone);
+			g_hash_table_insert(_clones, g_strdup(targetId), clone);
+		}
+
+		g_hash_table_iter_init(&writeIter, target->writes);
+		while (g_hash_table_iter_next(&writeIter, &key, &value)) {
+			GVariant* current;
+			gboolean unchanged;
+
+			if (!g_settings_is_writable(clone, key))
+				continue;
+
+			current = g_settings_get_user_value(clone, key);
+			unchanged = (value == NULL ? current == NULL : current != NULL && g_variant_equal(current, value));
+
+			if (current != NULL)
+				g_variant_unref(current);
+
+			if (unchanged)
+				continue;
+
+			if (value == NULL)
+				g_settings_reset(clone, key);
+			else
+				g_settings_set_value(clone, key, value);
+
+			changed++;
+		}
+
+		if (changed > 0)
+			g_settings_apply(clone);
+
+		written += changed;
+	}
+
+	g_mutex_unlock(&_commitMutex);
+
+	g_hash_table_unref(targets);
+
+	/* Destroying the source drops its reference to us, so do it last. */
+	if (windowSource != NULL) {
+		g_source_destroy(windowSource);
+		g_source_unref(windowSource);
+	}
+
+	return written;
+}
+
+@end
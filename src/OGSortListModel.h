@@ -0,0 +1,86 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_SORT_LIST_MODEL (ogio_sort_list_model_get_type())
+G_DECLARE_FINAL_TYPE(OGioSortListModel, ogio_sort_list_model, OGIO, SORT_LIST_MODEL, GObject)
+
+OGioSortListModel* ogio_sort_list_model_new(GListModel* model, GCompareDataFunc compareFunc, gpointer userData, GDestroyNotify userDataDestroy);
+GListModel* ogio_sort_list_model_get_model(OGioSortListModel* self);
+void ogio_sort_list_model_set_compare_func(OGioSortListModel* self, GCompareDataFunc compareFunc, gpointer userData, GDestroyNotify userDataDestroy);
+void ogio_sort_list_model_resort(OGioSortListModel* self);
+
+G_END_DECLS
+
+/**
+ * `OGSortListModel` is a [iface@Gio.ListModel] presenting the items of a
+ * source model sorted by a comparison function. Items comparing equal keep
+ * their source order.
+ *
+ * Small changes of the source are applied item by item: removed items are
+ * taken out and added items are placed with a binary search, each with
+ * its own #GListModel::items-changed emission for just that position.
+ * Changes of more than 64 items sort the whole model again and emit one
+ * change spanning the first to the last position that moved.
+ *
+ */
+@interface OGSortListModel : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)sortListModelWithModel:(GListModel*)model compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+/**
+ * Methods
+ */
+
+- (OGioSortListModel*)castedGObject;
+
+/**
+ * The source model.
+ *
+ * @return the #GListModel being sorted
+ */
+- (GListModel*)model;
+
+/**
+ * Replaces the comparison function and sorts the model again.
+ *
+ * @param compareFunc the new comparison function
+ * @param userData user data for @compareFunc
+ * @param userDataDestroy function to release @userData, or %NULL
+ */
+- (void)setCompareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy;
+
+/**
+ * Sorts the model again, after the data the comparison function looks at
+ * has changed.
+ */
+- (void)resort;
+
+@end
@@ -0,0 +1,298 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSortListModel.h"
+
+/* Larger source changes are cheaper to apply with a full sort. */
+#define INCREMENTAL_LIMIT 64
+
+typedef struct {
+	gpointer item;
+	guint source;
+} SortEntry;
+
+struct _OGioSortListModel {
+	GObject parent_instance;
+
+	GListModel* model;
+	gulong itemsChangedHandler;
+
+	GCompareDataFunc compareFunc;
+	gpointer userData;
+	GDestroyNotify userDataDestroy;
+
+	/* The items in sorted order, with their source positions. */
+	GArray* entries;
+};
+
+static void ogio_sort_list_model_list_model_init(GListModelInterface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioSortListModel, ogio_sort_list_model, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_LIST_MODEL, ogio_sort_list_model_list_model_init))
+
+/* Ties are broken by source position, which keeps the order stable and
+ * makes every entry unique for the binary search. */
+static gint compareEntries(gconstpointer a, gconstpointer b, gpointer userData)
+{
+	OGioSortListModel* self = userData;
+	const SortEntry* entryA = a;
+	const SortEntry* entryB = b;
+	gint result = self->compareFunc(entryA->item, entryB->item, self->userData);
+
+	if (result != 0)
+		return result;
+
+	return (entryA->source > entryB->source) - (entryA->source < entryB->source);
+}
+
+static void freeEntries(GArray* entries)
+{
+	for (guint i = 0; i < entries->len; i++)
+		g_object_unref(g_array_index(entries, SortEntry, i).item);
+
+	g_array_unref(entries);
+}
+
+static void rebuild(OGioSortListModel* self)
+{
+	guint count = g_list_model_get_n_items(self->model);
+	GArray* entries = g_array_sized_new(FALSE, FALSE, sizeof(SortEntry), count);
+	GArray* old = self->entries;
+	guint oldLen = old->len;
+	guint common = MIN(oldLen, count);
+	guint prefix = 0, suffix = 0;
+
+	for (guint i = 0; i < count; i++) {
+		SortEntry entry = { g_list_model_get_item(self->model, i), i };
+		g_array_append_val(entries, entry);
+	}
+
+	g_array_sort_with_data(entries, compareEntries, self);
+
+	while (prefix < common && g_array_index(old, SortEntry, prefix).item == g_array_index(entries, SortEntry, prefix).item)
+		prefix++;
+
+	while (suffix < common - prefix && g_array_index(old, SortEntry, oldLen - 1 - suffix).item == g_array_index(entries, SortEntry, count - 1 - suffix).item)
+		suffix++;
+
+	self->entries = entries;
+	freeEntries(old);
+
+	if (oldLen - prefix - suffix > 0 || count - prefix - suffix > 0)
+		g_list_model_items_changed(G_LIST_MODEL(self), prefix, oldLen - prefix - suffix, count - prefix - suffix);
+}
+
+static void itemsChanged(GListModel* model, guint position, guint removed, guint added, gpointer userData)
+{
+	OGioSortListModel* self = userData;
+	GArray* entries = self->entries;
+
+	if (removed + added > INCREMENTAL_LIMIT) {
+		rebuild(self);
+		return;
+	}
+
+	/* Walk backwards so that removing an entry does not move the ones
+	 * still to be visited. */
+	for (guint i = entries->len; i-- > 0;) {
+		SortEntry* entry = &g_array_index(entries, SortEntry, i);
+
+		if (entry->source >= position + removed) {
+			entry->source = entry->source - removed + added;
+		} else if (entry->source >= position) {
+			g_object_unref(entry->item);
+			g_array_remove_index(entries, i);
+			g_list_model_items_changed(G_LIST_MODEL(self), i, 1, 0);
+		}
+	}
+
+	for (guint i = position; i < position + added; i++) {
+		SortEntry entry = { g_list_model_get_item(model, i), i };
+		guint low = 0, high = entries->len;
+
+		while (low < high) {
+			guint middle = low + (high - low) / 2;
+
+			if (compareEntries(&g_array_index(entries, SortEntry, middle), &entry, self) < 0)
+				low = middle + 1;
+			else
+				high = middle;
+		}
+
+		g_array_insert_val(entries, low, entry);
+		g_list_model_items_changed(G_LIST_MODEL(self), low, 0, 1);
+	}
+}
+
+static GType ogio_sort_list_model_get_item_type(GListModel* model)
+{
+	return g_list_model_get_item_type(OGIO_SORT_LIST_MODEL(model)->model);
+}
+
+static guint ogio_sort_list_model_get_n_items(GListModel* model)
+{
+	return OGIO_SORT_LIST_MODEL(model)->entries->len;
+}
+
+static gpointer ogio_sort_list_model_get_item(GListModel* model, guint position)
+{
+	OGioSortListModel* self = OGIO_SORT_LIST_MODEL(model);
+
+	if (position >= self->entries->len)
+		return NULL;
+
+	return g_object_ref(g_array_index(self->entries, SortEntry, position).item);
+}
+
+static void ogio_sort_list_model_list_model_init(GListModelInterface* iface)
+{
+	iface->get_item_type = ogio_sort_list_model_get_item_type;
+	iface->get_n_items = ogio_sort_list_model_get_n_items;
+	iface->get_item = ogio_sort_list_model_get_item;
+}
+
+static void ogio_sort_list_model_init(OGioSortListModel* self)
+{
+	self->entries = g_array_new(FALSE, FALSE, sizeof(SortEntry));
+}
+
+static void ogio_sort_list_model_finalize(GObject* object)
+{
+	OGioSortListModel* self = OGIO_SORT_LIST_MODEL(object);
+
+	g_clear_signal_handler(&self->itemsChangedHandler, self->model);
+	g_clear_object(&self->model);
+	freeEntries(self->entries);
+
+	if (self->userDataDestroy != NULL)
+		self->userDataDestroy(self->userData);
+
+	G_OBJECT_CLASS(ogio_sort_list_model_parent_class)->finalize(object);
+}
+
+static void ogio_sort_list_model_class_init(OGioSortListModelClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_sort_list_model_finalize;
+}
+
+OGioSortListModel* ogio_sort_list_model_new(GListModel* model, GCompareDataFunc compareFunc, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_val_if_fail(G_IS_LIST_MODEL(model), NULL);
+	g_return_val_if_fail(compareFunc != NULL, NULL);
+
+	OGioSortListModel* self = g_object_new(OGIO_TYPE_SORT_LIST_MODEL, NULL);
+
+	self->model = g_object_ref(model);
+	self->itemsChangedHandler = g_signal_connect(model, "items-changed", G_CALLBACK(itemsChanged), self);
+
+	ogio_sort_list_model_set_compare_func(self, compareFunc, userData, userDataDestroy);
+
+	return self;
+}
+
+GListModel* ogio_sort_list_model_get_model(OGioSortListModel* self)
+{
+	g_return_val_if_fail(OGIO_IS_SORT_LIST_MODEL(self), NULL);
+
+	return self->model;
+}
+
+void ogio_sort_list_model_set_compare_func(OGioSortListModel* self, GCompareDataFunc compareFunc, gpointer userData, GDestroyNotify userDataDestroy)
+{
+	g_return_if_fail(OGIO_IS_SORT_LIST_MODEL(self));
+	g_return_if_fail(compareFunc != NULL);
+
+	if (self->userDataDestroy != NULL)
+		self->userDataDestroy(self->userData);
+
+	self->compareFunc = compareFunc;
+	self->userData = userData;
+	self->userDataDestroy = userDataDestroy;
+
+	rebuild(self);
+}
+
+void ogio_sort_list_model_resort(OGioSortListModel* self)
+{
+	g_return_if_fail(OGIO_IS_SORT_LIST_MODEL(self));
+
+	rebuild(self);
+}
+
+@implementation OGSortListModel
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_SORT_LIST_MODEL;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_SORT_LIST_MODEL);
+	return gObjectClass;
+}
+
++ (instancetype)sortListModelWithModel:(GListModel*)model compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (!G_IS_LIST_MODEL(model) || compareFunc == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioSortListModel* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_sort_list_model_new(model, compareFunc, userData, userDataDestroy), OGIO_TYPE_SORT_LIST_MODEL, OGioSortListModel);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGSortListModel* wrapperObject;
+	@try {
+		wrapperObject = [[OGSortListModel alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioSortListModel*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_SORT_LIST_MODEL, OGioSortListModel);
+}
+
+- (GListModel*)model
+{
+	GListModel* returnValue = (GListModel*)ogio_sort_list_model_get_model((OGioSortListModel*)[self castedGObject]);
+
+	return returnValue;
+}
+
+- (void)setCompareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData userDataDestroy:(GDestroyNotify)userDataDestroy
+{
+	if (compareFunc == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_sort_list_model_set_compare_func((OGioSortListModel*)[self castedGObject], compareFunc, userData, userDataDestroy);
+}
+
+- (void)resort
+{
+	ogio_sort_list_model_resort((OGioSortListModel*)[self castedGObject]);
+}
+
+@end
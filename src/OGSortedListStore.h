@@ -0,0 +1,107 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGListStore;
+
+/**
+ * `OGSortedListStore` keeps an #OGListStore sorted by a fixed comparison
+ * function, so that lookups can use a binary search.
+ *
+ * Items are added with -insertSortedWithItem:, which finds the insert
+ * position in the store's balanced sequence in logarithmic time, and
+ * -findWithItem:position: locates an item with O(log n) comparisons where
+ * -[OGListStore findWithItem:position:] scans the whole list. The store
+ * itself is exposed through -listStore so it can be handed to views, but
+ * it must not be reordered other than through this object.
+ *
+ * -resort reorders the store with the parallel merge sort of
+ * #OGListStoreSorting, for instance after the data the comparison function
+ * looks at has changed.
+ *
+ */
+@interface OGSortedListStore : OFObject
+{
+	OGListStore* _listStore;
+	GCompareDataFunc _compareFunc;
+	gpointer _userData;
+	guint _threads;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)sortedListStoreWithItemType:(GType)itemType compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData;
+
+/**
+ * Initializes a sorted view of @listStore, sorting the items it already
+ * contains.
+ *
+ * @param listStore the store to keep sorted
+ * @param compareFunc thread-safe pairwise comparison function for sorting
+ * @param userData user data for @compareFunc
+ * @return an initialized sorted list store
+ */
+- (instancetype)initWithListStore:(OGListStore*)listStore compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData;
+
+/**
+ * Methods
+ */
+
+/**
+ * The underlying store.
+ *
+ * @return the sorted store
+ */
+- (OGListStore*)listStore;
+
+/**
+ * The number of threads used by -resort, 0 for one per processor.
+ *
+ * @return the number of sort threads
+ */
+- (guint)threads;
+
+/**
+ * Sets the number of threads used by -resort.
+ *
+ * @param threads the number of threads, 0 for one per processor
+ */
+- (void)setThreads:(guint)threads;
+
+/**
+ * Inserts @item at its sorted position. This takes a ref on @item.
+ *
+ * @param item the new item
+ * @return the position at which @item was inserted
+ */
+- (guint)insertSortedWithItem:(gpointer)item;
+
+/**
+ * Looks up @item with a binary search.
+ *
+ * @param item an item
+ * @param position the position of @item, if it was found.
+ * @return Whether the store contains @item.
+ */
+- (bool)findWithItem:(gpointer)item position:(guint*)position;
+
+/**
+ * Sorts the store again, emitting a single change for the whole list.
+ *
+ */
+- (void)resort;
+
+@end
@@ -0,0 +1,84 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSortedListStore.h"
+
+#import "OGListStore.h"
+#import "OGListStoreSorting.h"
+
+@implementation OGSortedListStore
+
++ (instancetype)sortedListStoreWithItemType:(GType)itemType compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData
+{
+	return [[[self alloc] initWithListStore:[OGListStore listStoreWithItemType:itemType] compareFunc:compareFunc userData:userData] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithListStore:(OGListStore*)listStore compareFunc:(GCompareDataFunc)compareFunc userData:(gpointer)userData
+{
+	self = [super init];
+
+	@try {
+		if (listStore == nil || compareFunc == NULL)
+			@throw [OFInvalidArgumentException exception];
+
+		_listStore = [listStore retain];
+		_compareFunc = compareFunc;
+		_userData = userData;
+
+		ogio_list_store_sort_parallel([_listStore castedGObject], _compareFunc, _userData, _threads);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[_listStore release];
+
+	[super dealloc];
+}
+
+- (OGListStore*)listStore
+{
+	return _listStore;
+}
+
+- (guint)threads
+{
+	return _threads;
+}
+
+- (void)setThreads:(guint)threads
+{
+	_threads = threads;
+}
+
+- (guint)insertSortedWithItem:(gpointer)item
+{
+	return [_listStore insertSortedWithItem:item compareFunc:_compareFunc userData:_userData];
+}
+
+- (bool)findWithItem:(gpointer)item position:(guint*)position
+{
+	bool returnValue = (bool)ogio_list_store_find_sorted([_listStore castedGObject], item, _compareFunc, _userData, position);
+
+	return returnValue;
+}
+
+- (void)resort
+{
+	ogio_list_store_sort_parallel([_listStore castedGObject], _compareFunc, _userData, _threads);
+}
+
+@end
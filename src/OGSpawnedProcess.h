@@ -0,0 +1,188 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#include <sys/resource.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGInputStream;
+@class OGOutputStream;
+
+/**
+ * `OGSpawnedProcess` is a child process started by an
+ * #OGPosixSpawnLauncher. It offers the waiting, signalling and status
+ * inspection methods of #OGSubprocess, and additionally reports the
+ * resource usage of the child once it has exited.
+ *
+ * On Linux the process is tracked through a pidfd, so signals are never
+ * delivered to a recycled process ID and waiting can be cancelled. The child
+ * is reaped by the first call that notices its exit; if the object is
+ * deallocated before that, the child is reaped in the background.
+ *
+ */
+@interface OGSpawnedProcess : OFObject
+{
+	GPid _pid;
+	int _pidfd;
+	GOutputStream* _stdinPipe;
+	GInputStream* _stdoutPipe;
+	GInputStream* _stderrPipe;
+	bool _reaped;
+	int _status;
+	struct rusage _resourceUsage;
+	GMutex _mutex;
+}
+
+/**
+ * Initializes a process object for the child @pid of the calling process,
+ * taking ownership of the given pipe file descriptors.
+ *
+ * @param pid the process ID of the child
+ * @param stdinFd the write end of the stdin pipe of the child, or -1
+ * @param stdoutFd the read end of the stdout pipe of the child, or -1
+ * @param stderrFd the read end of the stderr pipe of the child, or -1
+ * @return an initialized process
+ */
+- (instancetype)initWithPid:(GPid)pid stdinFd:(int)stdinFd stdoutFd:(int)stdoutFd stderrFd:(int)stderrFd;
+
+/**
+ * Methods
+ */
+
+/**
+ * The process ID of the child. It must not be used once the child has been
+ * reaped.
+ *
+ * @return the process ID
+ */
+- (GPid)pid;
+
+/**
+ * A pidfd referring to the child, which becomes readable when the child
+ * exits, or -1 where pidfds are not supported. It stays valid for the
+ * lifetime of the object.
+ *
+ * @return the pidfd, or -1
+ */
+- (int)pidfd;
+
+/**
+ * The pipe connected to the stdin of the child, if it was spawned with
+ * %G_SUBPROCESS_FLAGS_STDIN_PIPE.
+ *
+ * @return the stdin pipe, or %nil
+ */
+- (OGOutputStream*)stdinPipe;
+
+/**
+ * The pipe connected to the stdout of the child, if it was spawned with
+ * %G_SUBPROCESS_FLAGS_STDOUT_PIPE.
+ *
+ * @return the stdout pipe, or %nil
+ */
+- (OGInputStream*)stdoutPipe;
+
+/**
+ * The pipe connected to the stderr of the child, if it was spawned with
+ * %G_SUBPROCESS_FLAGS_STDERR_PIPE.
+ *
+ * @return the stderr pipe, or %nil
+ */
+- (OGInputStream*)stderrPipe;
+
+/**
+ * Sends the UNIX signal @signalNum to the child, unless it has already
+ * exited.
+ *
+ * @param signalNum the signal number to send
+ */
+- (void)sendSignal:(int)signalNum;
+
+/**
+ * Kills the child with SIGKILL, unless it has already exited.
+ */
+- (void)forceExit;
+
+/**
+ * Reaps the child if it has exited, without blocking.
+ *
+ * @return whether the child has exited
+ */
+- (bool)hasExited;
+
+/**
+ * Waits for the child to exit and reaps it.
+ *
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ */
+- (void)waitWithCancellable:(OGCancellable*)cancellable;
+
+/**
+ * Waits for the child to exit and throws if it did not exit successfully.
+ *
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ */
+- (void)waitCheckWithCancellable:(OGCancellable*)cancellable;
+
+/**
+ * The raw wait status of the exited child.
+ *
+ * @return the wait status
+ */
+- (int)status;
+
+/**
+ * Whether the child exited normally.
+ *
+ * @return %TRUE if the child exited by way of exit()
+ */
+- (bool)ifExited;
+
+/**
+ * The exit status of the child, if it exited normally.
+ *
+ * @return the exit status
+ */
+- (int)exitStatus;
+
+/**
+ * Whether the child was terminated by a signal.
+ *
+ * @return %TRUE if the child was killed by a signal
+ */
+- (bool)ifSignaled;
+
+/**
+ * The signal that terminated the child, if it was terminated by a signal.
+ *
+ * @return the signal causing termination
+ */
+- (int)termSig;
+
+/**
+ * Whether the child exited normally with an exit status of 0.
+ *
+ * @return %TRUE if the child was successful
+ */
+- (bool)successful;
+
+/**
+ * The resources used by the child, as reported by wait4().
+ *
+ * @return the resource usage, or %NULL while the child has not been reaped
+ */
+- (const struct rusage*)resourceUsage;
+
+@end
@@ -0,0 +1,314 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSpawnedProcess.h"
+
+#import "OGCancellable.h"
+#import "OGInputStream.h"
+#import "OGOutputStream.h"
+
+#include <errno.h>
+#include <signal.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+static int openPidfd(GPid pid)
+{
+#ifdef SYS_pidfd_open
+	return (int)syscall(SYS_pidfd_open, pid, 0);
+#else
+	return -1;
+#endif
+}
+
+static int signalPidfd(int pidfd, int signalNum)
+{
+#ifdef SYS_pidfd_send_signal
+	return (int)syscall(SYS_pidfd_send_signal, pidfd, signalNum, NULL, 0);
+#else
+	errno = ENOSYS;
+	return -1;
+#endif
+}
+
+static gpointer reaperThread(gpointer data)
+{
+	for (;;)
+		g_main_context_iteration(data, TRUE);
+
+	return NULL;
+}
+
+static void discardStatus(GPid pid, gint status, gpointer userData)
+{
+}
+
+/* Children whose process object went away unreaped are handed to a child
+ * watch on a context of its own, so they do not linger as zombies. */
+static void reapInBackground(GPid pid)
+{
+	static gsize once = 0;
+	static GMainContext* context;
+
+	if (g_once_init_enter(&once)) {
+		context = g_main_context_new();
+		g_thread_unref(g_thread_new("ogio-reaper", reaperThread, context));
+		g_once_init_leave(&once, 1);
+	}
+
+	GSource* source = g_child_watch_source_new(pid);
+
+	g_source_set_callback(source, G_SOURCE_FUNC(discardStatus), NULL, NULL);
+	g_source_attach(source, context);
+	g_source_unref(source);
+}
+
+@interface OGSpawnedProcess ()
+- (bool)reapWithOptions:(int)options;
+- (void)checkReaped;
+@end
+
+@implementation OGSpawnedProcess
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithPid:(GPid)pid stdinFd:(int)stdinFd stdoutFd:(int)stdoutFd stderrFd:(int)stderrFd
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+
+	_pid = pid;
+	_pidfd = openPidfd(pid);
+
+	if (stdinFd >= 0)
+		_stdinPipe = g_unix_output_stream_new(stdinFd, TRUE);
+
+	if (stdoutFd >= 0)
+		_stdoutPipe = g_unix_input_stream_new(stdoutFd, TRUE);
+
+	if (stderrFd >= 0)
+		_stderrPipe = g_unix_input_stream_new(stderrFd, TRUE);
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (!_reaped && ![self reapWithOptions:WNOHANG])
+		reapInBackground(_pid);
+
+	if (_pidfd >= 0)
+		close(_pidfd);
+
+	if (_stdinPipe != NULL)
+		g_object_unref(_stdinPipe);
+
+	if (_stdoutPipe != NULL)
+		g_object_unref(_stdoutPipe);
+
+	if (_stderrPipe != NULL)
+		g_object_unref(_stderrPipe);
+
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (bool)reapWithOptions:(int)options
+{
+	bool reaped;
+
+	g_mutex_lock(&_mutex);
+
+	if (!_reaped) {
+		struct rusage usage;
+		int status;
+		pid_t result;
+
+		do {
+			result = wait4(_pid, &status, options, &usage);
+		} while (result < 0 && errno == EINTR);
+
+		if (result == _pid) {
+			_reaped = true;
+			_status = status;
+			_resourceUsage = usage;
+		} else if (result < 0 && errno == ECHILD) {
+			/* Reaped behind our back, e.g. by SIG_IGN on SIGCHLD. */
+			_reaped = true;
+		}
+	}
+
+	reaped = _reaped;
+
+	g_mutex_unlock(&_mutex);
+
+	return reaped;
+}
+
+- (void)checkReaped
+{
+	if (![self reapWithOptions:WNOHANG])
+		@throw [OFInvalidArgumentException exception];
+}
+
+- (GPid)pid
+{
+	return _pid;
+}
+
+- (int)pidfd
+{
+	return _pidfd;
+}
+
+- (OGOutputStream*)stdinPipe
+{
+	if (_stdinPipe == NULL)
+		return nil;
+
+	OGOutputStream* returnValue = OGWrapperClassAndObjectForGObject(_stdinPipe);
+	return returnValue;
+}
+
+- (OGInputStream*)stdoutPipe
+{
+	if (_stdoutPipe == NULL)
+		return nil;
+
+	OGInputStream* returnValue = OGWrapperClassAndObjectForGObject(_stdoutPipe);
+	return returnValue;
+}
+
+- (OGInputStream*)stderrPipe
+{
+	if (_stderrPipe == NULL)
+		return nil;
+
+	OGInputStream* returnValue = OGWrapperClassAndObjectForGObject(_stderrPipe);
+	return returnValue;
+}
+
+- (void)sendSignal:(int)signalNum
+{
+	g_mutex_lock(&_mutex);
+
+	/* Holding the mutex keeps the child from being reaped, so its process
+	 * ID cannot have been recycled yet. */
+	if (!_reaped) {
+		if (_pidfd < 0 || signalPidfd(_pidfd, signalNum) < 0)
+			kill(_pid, signalNum);
+	}
+
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)forceExit
+{
+	[self sendSignal:SIGKILL];
+}
+
+- (bool)hasExited
+{
+	return [self reapWithOptions:WNOHANG];
+}
+
+- (void)waitWithCancellable:(OGCancellable*)cancellable
+{
+	GCancellable* gcancellable = [cancellable castedGObject];
+	GError* err = NULL;
+
+	while (![self reapWithOptions:WNOHANG]) {
+		if (g_cancellable_set_error_if_cancelled(gcancellable, &err))
+			break;
+
+		if (_pidfd >= 0) {
+			GPollFD fds[2] = {
+				{ _pidfd, G_IO_IN, 0 }
+			};
+			guint nFds = 1;
+
+			if (g_cancellable_make_pollfd(gcancellable, &fds[1]))
+				nFds++;
+
+			g_poll(fds, nFds, -1);
+
+			if (nFds > 1)
+				g_cancellable_release_fd(gcancellable);
+		} else
+			g_usleep(10000);
+	}
+
+	[OGErrorException throwForError:err];
+}
+
+- (void)waitCheckWithCancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	[self waitWithCancellable:cancellable];
+
+	g_spawn_check_wait_status(_status, &err);
+
+	[OGErrorException throwForError:err];
+}
+
+- (int)status
+{
+	[self checkReaped];
+
+	return _status;
+}
+
+- (bool)ifExited
+{
+	[self checkReaped];
+
+	return WIFEXITED(_status);
+}
+
+- (int)exitStatus
+{
+	[self checkReaped];
+
+	return WEXITSTATUS(_status);
+}
+
+- (bool)ifSignaled
+{
+	[self checkReaped];
+
+	return WIFSIGNALED(_status);
+}
+
+- (int)termSig
+{
+	[self checkReaped];
+
+	return WTERMSIG(_status);
+}
+
+- (bool)successful
+{
+	[self checkReaped];
+
+	return (WIFEXITED(_status) && WEXITSTATUS(_status) == 0);
+}
+
+- (const struct rusage*)resourceUsage
+{
+	if (![self reapWithOptions:WNOHANG])
+		return NULL;
+
+	return &_resourceUsage;
+}
+
+@end
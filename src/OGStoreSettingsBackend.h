@@ -0,0 +1,64 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSettingsBackend.h"
+
+#import "OGSettingsStore.h"
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_STORE_SETTINGS_BACKEND (ogio_store_settings_backend_get_type())
+G_DECLARE_FINAL_TYPE(OGioStoreSettingsBackend, ogio_store_settings_backend, OGIO, STORE_SETTINGS_BACKEND, GSettingsBackend)
+
+GSettingsBackend* ogio_store_settings_backend_new(OGSettingsStore* store);
+
+G_END_DECLS
+
+/**
+ * `OGStoreSettingsBackend` is a [class@Gio.SettingsBackend] keeping its
+ * values in an #OGSettingsStore.
+ *
+ * Reads go straight to the store. After a successful write, reset or tree
+ * write the backend emits the matching change notification, so all
+ * #OGSettings objects using the backend see the change; a tree write is
+ * announced with a single notification. Default values are left to the
+ * schemas, and every key the store considers writable is writable.
+ *
+ * Pass the backend to +[OGSettings settingsWithBackendWithSchemaId:backend:]
+ * to use it.
+ *
+ */
+@interface OGStoreSettingsBackend : OGSettingsBackend
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)storeSettingsBackendWithStore:(OGSettingsStore*)store;
+
+/**
+ * Methods
+ */
+
+- (OGioStoreSettingsBackend*)castedGObject;
+
+/**
+ * The store keeping the values.
+ *
+ * @return the store
+ */
+- (OGSettingsStore*)store;
+
+@end
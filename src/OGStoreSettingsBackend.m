@@ -0,0 +1,216 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGStoreSettingsBackend.h"
+
+struct _OGioStoreSettingsBackend {
+	GSettingsBackend parent_instance;
+
+	OGSettingsStore* store;
+};
+
+G_DEFINE_FINAL_TYPE(OGioStoreSettingsBackend, ogio_store_settings_backend, G_TYPE_SETTINGS_BACKEND)
+
+/*
+ * The store is Objective-C code called from C; an exception must not
+ * unwind through GSettings, so it is logged and turned into a failure.
+ */
+static void warnException(const gchar* what, id exception)
+{
+	g_warning("OGStoreSettingsBackend: %s failed: %s", what, [[exception description] UTF8String]);
+}
+
+static GVariant* ogio_store_settings_backend_read(GSettingsBackend* backend, const gchar* key, const GVariantType* expectedType, gboolean defaultValue)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+
+	/* Defaults come from the schemas. */
+	if (defaultValue)
+		return NULL;
+
+	@try {
+		return [self->store readValueWithKey:key];
+	} @catch (id e) {
+		warnException("reading", e);
+		return NULL;
+	}
+}
+
+static gboolean ogio_store_settings_backend_write(GSettingsBackend* backend, const gchar* key, GVariant* value, gpointer originTag)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+	gboolean success;
+
+	g_variant_ref_sink(value);
+
+	@try {
+		success = [self->store writeValue:value key:key];
+	} @catch (id e) {
+		warnException("writing", e);
+		success = FALSE;
+	}
+
+	g_variant_unref(value);
+
+	if (success)
+		g_settings_backend_changed(backend, key, originTag);
+
+	return success;
+}
+
+static gboolean ogio_store_settings_backend_write_tree(GSettingsBackend* backend, GTree* tree, gpointer originTag)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+	gboolean success;
+
+	@try {
+		success = [self->store writeTree:tree];
+	} @catch (id e) {
+		warnException("writing", e);
+		success = FALSE;
+	}
+
+	if (success)
+		g_settings_backend_changed_tree(backend, tree, originTag);
+
+	return success;
+}
+
+static void ogio_store_settings_backend_reset(GSettingsBackend* backend, const gchar* key, gpointer originTag)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+	gboolean success;
+
+	@try {
+		success = [self->store writeValue:NULL key:key];
+	} @catch (id e) {
+		warnException("resetting", e);
+		success = FALSE;
+	}
+
+	if (success)
+		g_settings_backend_changed(backend, key, originTag);
+}
+
+static gboolean ogio_store_settings_backend_get_writable(GSettingsBackend* backend, const gchar* key)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+
+	@try {
+		return [self->store isWritableWithKey:key];
+	} @catch (id e) {
+		warnException("checking writability", e);
+		return FALSE;
+	}
+}
+
+static void ogio_store_settings_backend_sync(GSettingsBackend* backend)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(backend);
+
+	@try {
+		[self->store sync];
+	} @catch (id e) {
+		warnException("syncing", e);
+	}
+}
+
+static void ogio_store_settings_backend_init(OGioStoreSettingsBackend* self)
+{
+}
+
+static void ogio_store_settings_backend_finalize(GObject* object)
+{
+	OGioStoreSettingsBackend* self = OGIO_STORE_SETTINGS_BACKEND(object);
+
+	[self->store release];
+
+	G_OBJECT_CLASS(ogio_store_settings_backend_parent_class)->finalize(object);
+}
+
+static void ogio_store_settings_backend_class_init(OGioStoreSettingsBackendClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+	GSettingsBackendClass* backendClass = G_SETTINGS_BACKEND_CLASS(klass);
+
+	objectClass->finalize = ogio_store_settings_backend_finalize;
+
+	backendClass->read = ogio_store_settings_backend_read;
+	backendClass->write = ogio_store_settings_backend_write;
+	backendClass->write_tree = ogio_store_settings_backend_write_tree;
+	backendClass->reset = ogio_store_settings_backend_reset;
+	backendClass->get_writable = ogio_store_settings_backend_get_writable;
+	backendClass->sync = ogio_store_settings_backend_sync;
+}
+
+GSettingsBackend* ogio_store_settings_backend_new(OGSettingsStore* store)
+{
+	g_return_val_if_fail(store != nil, NULL);
+
+	OGioStoreSettingsBackend* self = g_object_new(OGIO_TYPE_STORE_SETTINGS_BACKEND, NULL);
+
+	self->store = [store retain];
+
+	return G_SETTINGS_BACKEND(self);
+}
+
+@implementation OGStoreSettingsBackend
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_STORE_SETTINGS_BACKEND;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_STORE_SETTINGS_BACKEND);
+	return gObjectClass;
+}
+
++ (instancetype)storeSettingsBackendWithStore:(OGSettingsStore*)store
+{
+	if (store == nil)
+		@throw [OFInvalidArgumentException exception];
+
+	OGioStoreSettingsBackend* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_store_settings_backend_new(store), OGIO_TYPE_STORE_SETTINGS_BACKEND, OGioStoreSettingsBackend);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGStoreSettingsBackend* wrapperObject;
+	@try {
+		wrapperObject = [[OGStoreSettingsBackend alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioStoreSettingsBackend*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_STORE_SETTINGS_BACKEND, OGioStoreSettingsBackend);
+}
+
+- (OGSettingsStore*)store
+{
+	return [self castedGObject]->store;
+}
+
+@end
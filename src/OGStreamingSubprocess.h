@@ -0,0 +1,94 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGInputStream;
+@class OGOutputStream;
+@class OGSubprocess;
+
+G_BEGIN_DECLS
+
+/**
+ * Called by ogio_subprocess_communicate_streaming() for every chunk read
+ * from the stdout or stderr pipe of a subprocess. The data is only valid
+ * during the call.
+ *
+ * Returning %FALSE stops the communication; if @error is not set, the
+ * communication fails with %G_IO_ERROR_CANCELLED.
+ */
+typedef gboolean (*OGioSubprocessOutputFunc)(GSubprocess* subprocess, gboolean isStderr, gconstpointer data, gsize size, gpointer userData, GError** error);
+
+gboolean ogio_subprocess_communicate_streaming(GSubprocess* subprocess, GInputStream* stdinStream, gsize chunkSize, OGioSubprocessOutputFunc func, gpointer userData, GCancellable* cancellable, GError** error);
+
+G_END_DECLS
+
+/**
+ * `OGStreamingSubprocess` communicates with a subprocess like
+ * -[OGSubprocess communicateWithStdinBuf:cancellable:stdoutBuf:stderrBuf:],
+ * but hands the output over while it is produced instead of collecting it,
+ * so the memory used does not depend on the amount of output.
+ *
+ * Standard input is read from a stream one chunk at a time as the
+ * subprocess consumes it, and stdout and stderr are read into a single
+ * buffer of the chunk size, which is passed to a callback or written to
+ * an output stream before the next chunk is read. A slow consumer thus
+ * throttles the subprocess through its pipes.
+ *
+ * The pipes are serviced from a private main context on the calling thread.
+ * As with the buffering communicate functions, the pipes of the subprocess
+ * must not be used otherwise while the communication is in progress, and
+ * the subprocess is not terminated when the communication fails or is
+ * cancelled.
+ *
+ */
+@interface OGStreamingSubprocess : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Feeds @stdinStream to the stdin of @subprocess while passing its output to
+ * @func, and waits for the subprocess to exit.
+ *
+ * @param subprocess a subprocess
+ * @param stdinStream the data to send to stdin, or %nil to close stdin
+ * right away
+ * @param chunkSize the size of the buffers used, 0 for 64 KiB
+ * @param func the function receiving the output
+ * @param userData user data for @func
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ */
++ (void)communicateWithSubprocess:(OGSubprocess*)subprocess stdinStream:(OGInputStream*)stdinStream chunkSize:(gsize)chunkSize func:(OGioSubprocessOutputFunc)func userData:(gpointer)userData cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Feeds @stdinStream to the stdin of @subprocess while copying its stdout
+ * and stderr to the given streams, and waits for the subprocess to exit.
+ * Output of a pipe without a stream is discarded.
+ *
+ * @param subprocess a subprocess
+ * @param stdinStream the data to send to stdin, or %nil to close stdin
+ * right away
+ * @param stdoutStream the stream receiving stdout, or %nil
+ * @param stderrStream the stream receiving stderr, or %nil
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ */
++ (void)communicateWithSubprocess:(OGSubprocess*)subprocess stdinStream:(OGInputStream*)stdinStream stdoutStream:(OGOutputStream*)stdoutStream stderrStream:(OGOutputStream*)stderrStream cancellable:(OGCancellable*)cancellable;
+
+@end
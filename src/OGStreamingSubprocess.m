@@ -0,0 +1,285 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGStreamingSubprocess.h"
+
+#import "OGBufferPool.h"
+#import "OGCancellable.h"
+#import "OGInputStream.h"
+#import "OGOutputStream.h"
+#import "OGSubprocess.h"
+
+#define DEFAULT_CHUNK_SIZE (64 * 1024)
+
+typedef struct {
+	GSubprocess* subprocess;
+	GInputStream* source;
+	GOutputStream* stdinPipe;
+	GInputStream* stderrPipe;
+	guint8* inBuffer;
+	gsize inOffset;
+	gsize inLength;
+	guint8* outBuffer;
+	gsize chunkSize;
+	OGioSubprocessOutputFunc func;
+	gpointer userData;
+	GCancellable* cancellable;
+	GError* error;
+	guint active;
+} StreamingState;
+
+typedef struct {
+	GOutputStream* streams[2];
+	GCancellable* cancellable;
+} CopyTargets;
+
+static void finishStdin(StreamingState* state)
+{
+	g_output_stream_close(state->stdinPipe, NULL, NULL);
+	state->active--;
+}
+
+static gboolean stdinReady(GObject* stream, gpointer userData)
+{
+	StreamingState* state = userData;
+	GError* error = NULL;
+
+	if (state->error != NULL)
+		return G_SOURCE_REMOVE;
+
+	if (state->inOffset == state->inLength) {
+		gssize read = g_input_stream_read(state->source, state->inBuffer, state->chunkSize, state->cancellable, &state->error);
+
+		if (read < 0)
+			return G_SOURCE_REMOVE;
+
+		if (read == 0) {
+			finishStdin(state);
+			return G_SOURCE_REMOVE;
+		}
+
+		state->inOffset = 0;
+		state->inLength = (gsize)read;
+	}
+
+	gssize written = g_pollable_output_stream_write_nonblocking(G_POLLABLE_OUTPUT_STREAM(stream), state->inBuffer + state->inOffset, state->inLength - state->inOffset, state->cancellable, &error);
+
+	if (written < 0) {
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+			g_error_free(error);
+			return G_SOURCE_CONTINUE;
+		}
+
+		/* The subprocess stopped reading its input; its exit status tells
+		 * whether that is a failure. */
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE)) {
+			g_error_free(error);
+			finishStdin(state);
+			return G_SOURCE_REMOVE;
+		}
+
+		g_propagate_error(&state->error, error);
+		return G_SOURCE_REMOVE;
+	}
+
+	state->inOffset += (gsize)written;
+
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean outputReady(GObject* stream, gpointer userData)
+{
+	StreamingState* state = userData;
+	GError* error = NULL;
+
+	if (state->error != NULL)
+		return G_SOURCE_REMOVE;
+
+	gssize read = g_pollable_input_stream_read_nonblocking(G_POLLABLE_INPUT_STREAM(stream), state->outBuffer, state->chunkSize, state->cancellable, &error);
+
+	if (read < 0) {
+		if (g_error_matches(error, G_IO_ERROR, G_IO_ERROR_WOULD_BLOCK)) {
+			g_error_free(error);
+			return G_SOURCE_CONTINUE;
+		}
+
+		g_propagate_error(&state->error, error);
+		return G_SOURCE_REMOVE;
+	}
+
+	if (read == 0) {
+		state->active--;
+		return G_SOURCE_REMOVE;
+	}
+
+	gboolean isStderr = ((GInputStream*)stream == state->stderrPipe);
+
+	if (!state->func(state->subprocess, isStderr, state->outBuffer, (gsize)read, state->userData, &state->error)) {
+		if (state->error == NULL)
+			g_set_error_literal(&state->error, G_IO_ERROR, G_IO_ERROR_CANCELLED, "Output handler stopped the communication");
+
+		return G_SOURCE_REMOVE;
+	}
+
+	return G_SOURCE_CONTINUE;
+}
+
+static gboolean cancelled(GCancellable* cancellable, gpointer userData)
+{
+	StreamingState* state = userData;
+
+	if (state->error == NULL)
+		g_cancellable_set_error_if_cancelled(cancellable, &state->error);
+
+	return G_SOURCE_REMOVE;
+}
+
+static bool canPollInput(GInputStream* stream)
+{
+	return (stream == NULL || (G_IS_POLLABLE_INPUT_STREAM(stream) && g_pollable_input_stream_can_poll(G_POLLABLE_INPUT_STREAM(stream))));
+}
+
+static bool canPollOutput(GOutputStream* stream)
+{
+	return (stream == NULL || (G_IS_POLLABLE_OUTPUT_STREAM(stream) && g_pollable_output_stream_can_poll(G_POLLABLE_OUTPUT_STREAM(stream))));
+}
+
+static void attachSource(GSource* source, GMainContext* context, GPtrArray* sources)
+{
+	g_source_attach(source, context);
+	g_ptr_array_add(sources, source);
+}
+
+gboolean ogio_subprocess_communicate_streaming(GSubprocess* subprocess, GInputStream* stdinStream, gsize chunkSize, OGioSubprocessOutputFunc func, gpointer userData, GCancellable* cancellable, GError** error)
+{
+	g_return_val_if_fail(G_IS_SUBPROCESS(subprocess), FALSE);
+	g_return_val_if_fail(stdinStream == NULL || G_IS_INPUT_STREAM(stdinStream), FALSE);
+	g_return_val_if_fail(func != NULL, FALSE);
+
+	GOutputStream* stdinPipe = g_subprocess_get_stdin_pipe(subprocess);
+	GInputStream* outputPipes[2] = {
+		g_subprocess_get_stdout_pipe(subprocess),
+		g_subprocess_get_stderr_pipe(subprocess)
+	};
+
+	if (stdinStream != NULL && stdinPipe == NULL) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Subprocess has no stdin pipe");
+		return FALSE;
+	}
+
+	if (!canPollOutput(stdinPipe) || !canPollInput(outputPipes[0]) || !canPollInput(outputPipes[1])) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NOT_SUPPORTED, "Subprocess pipes cannot be polled");
+		return FALSE;
+	}
+
+	if (chunkSize == 0)
+		chunkSize = DEFAULT_CHUNK_SIZE;
+
+	StreamingState state = {
+		.subprocess = subprocess,
+		.source = stdinStream,
+		.stdinPipe = stdinPipe,
+		.stderrPipe = outputPipes[1],
+		.chunkSize = chunkSize,
+		.func = func,
+		.userData = userData,
+		.cancellable = cancellable
+	};
+	GMainContext* context = g_main_context_new();
+	GPtrArray* sources = g_ptr_array_new_with_free_func((GDestroyNotify)g_source_unref);
+
+	if (stdinPipe != NULL) {
+		if (stdinStream != NULL) {
+			GSource* source = g_pollable_output_stream_create_source(G_POLLABLE_OUTPUT_STREAM(stdinPipe), NULL);
+
+			state.inBuffer = ogio_buffer_pool_alloc(chunkSize);
+			g_source_set_callback(source, G_SOURCE_FUNC(stdinReady), &state, NULL);
+			attachSource(source, context, sources);
+			state.active++;
+		} else
+			g_output_stream_close(stdinPipe, NULL, NULL);
+	}
+
+	for (int i = 0; i < 2; i++) {
+		if (outputPipes[i] == NULL)
+			continue;
+
+		GSource* source = g_pollable_input_stream_create_source(G_POLLABLE_INPUT_STREAM(outputPipes[i]), NULL);
+
+		g_source_set_callback(source, G_SOURCE_FUNC(outputReady), &state, NULL);
+		attachSource(source, context, sources);
+		state.active++;
+	}
+
+	if (state.active > 0)
+		state.outBuffer = ogio_buffer_pool_alloc(chunkSize);
+
+	if (cancellable != NULL) {
+		GSource* source = g_cancellable_source_new(cancellable);
+
+		g_source_set_callback(source, G_SOURCE_FUNC(cancelled), &state, NULL);
+		attachSource(source, context, sources);
+	}
+
+	while (state.active > 0 && state.error == NULL)
+		g_main_context_iteration(context, TRUE);
+
+	for (guint i = 0; i < sources->len; i++)
+		g_source_destroy(g_ptr_array_index(sources, i));
+
+	g_ptr_array_unref(sources);
+	g_main_context_unref(context);
+
+	if (state.inBuffer != NULL)
+		ogio_buffer_pool_free(state.inBuffer);
+
+	if (state.outBuffer != NULL)
+		ogio_buffer_pool_free(state.outBuffer);
+
+	if (state.error != NULL) {
+		g_propagate_error(error, state.error);
+		return FALSE;
+	}
+
+	return g_subprocess_wait(subprocess, cancellable, error);
+}
+
+static gboolean copyOutput(GSubprocess* subprocess, gboolean isStderr, gconstpointer data, gsize size, gpointer userData, GError** error)
+{
+	CopyTargets* targets = userData;
+	GOutputStream* target = targets->streams[isStderr ? 1 : 0];
+
+	if (target == NULL)
+		return TRUE;
+
+	return g_output_stream_write_all(target, data, size, NULL, targets->cancellable, error);
+}
+
+@implementation OGStreamingSubprocess
+
++ (void)communicateWithSubprocess:(OGSubprocess*)subprocess stdinStream:(OGInputStream*)stdinStream chunkSize:(gsize)chunkSize func:(OGioSubprocessOutputFunc)func userData:(gpointer)userData cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+
+	if (subprocess == nil || func == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	ogio_subprocess_communicate_streaming([subprocess castedGObject], [stdinStream castedGObject], chunkSize, func, userData, [cancellable castedGObject], &err);
+
+	[OGErrorException throwForError:err];
+}
+
++ (void)communicateWithSubprocess:(OGSubprocess*)subprocess stdinStream:(OGInputStream*)stdinStream stdoutStream:(OGOutputStream*)stdoutStream stderrStream:(OGOutputStream*)stderrStream cancellable:(OGCancellable*)cancellable
+{
+	CopyTargets targets = {
+		{ [stdoutStream castedGObject], [stderrStream castedGObject] },
+		[cancellable castedGObject]
+	};
+
+	[self communicateWithSubprocess:subprocess stdinStream:stdinStream chunkSize:0 func:copyOutput userData:&targets cancellable:cancellable];
+}
+
+@end
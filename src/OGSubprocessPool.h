@@ -0,0 +1,143 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGSubprocessLauncher;
+
+/**
+ * How requests and responses are delimited on the pipes of the workers of
+ * an #OGSubprocessPool.
+ */
+typedef enum {
+	/** Every request and response is a single line ending in a newline */
+	OG_SUBPROCESS_POOL_FRAMING_LINE,
+	/** Every request and response is preceded by its length as a big
+	 * endian 32 bit integer */
+	OG_SUBPROCESS_POOL_FRAMING_LENGTH_PREFIXED
+} OGSubprocessPoolFraming;
+
+/**
+ * `OGSubprocessPool` keeps a fixed number of long-lived helper processes
+ * running and hands requests to whichever of them is idle, instead of
+ * spawning a process per request.
+ *
+ * Every worker is started with its stdin and stdout connected to pipes and
+ * is expected to answer each request written to its stdin with exactly one
+ * response on its stdout, framed as given by #OGSubprocessPoolFraming.
+ * Workers are started when the pool is created. A worker whose pipes fail,
+ * or whose request is cancelled halfway, is killed and replaced by a fresh
+ * process on the next request, as is a worker that reached
+ * -maxRequestsPerWorker.
+ *
+ * The pool is thread-safe: each call to -sendRequest:cancellable: occupies
+ * one worker, so up to -size requests run at the same time and further
+ * callers wait for a worker to become idle.
+ *
+ */
+@interface OGSubprocessPool : OFObject
+{
+	GSubprocessLauncher* _launcher;
+	gchar** _argv;
+	guint _size;
+	OGSubprocessPoolFraming _framing;
+	guint64 _maxRequestsPerWorker;
+	GQueue _idle;
+	guint _spawned;
+	bool _closed;
+	GMutex _mutex;
+	GCond _cond;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)subprocessPoolWithArgv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing;
+
++ (instancetype)subprocessPoolWithLauncher:(OGSubprocessLauncher*)launcher argv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing;
+
+/**
+ * Initializes a pool and starts @size workers running @argv.
+ *
+ * If @launcher is given, it must have been created with
+ * %G_SUBPROCESS_FLAGS_STDIN_PIPE and %G_SUBPROCESS_FLAGS_STDOUT_PIPE;
+ * otherwise the workers inherit stderr and the environment of the calling
+ * process.
+ *
+ * @param launcher the launcher used to start workers, or %nil
+ * @param argv the command line of a worker
+ * @param size the number of workers
+ * @param framing how requests and responses are delimited
+ * @return an initialized pool
+ */
+- (instancetype)initWithLauncher:(OGSubprocessLauncher*)launcher argv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing;
+
+/**
+ * Methods
+ */
+
+/**
+ * Sends @request to an idle worker and waits for its response.
+ *
+ * With %OG_SUBPROCESS_POOL_FRAMING_LINE a newline is appended to @request
+ * unless it already ends in one, and the returned response does not
+ * include the newline.
+ *
+ * @param request the request
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ * @return the response, to be freed with g_bytes_unref()
+ */
+- (GBytes*)sendRequest:(GBytes*)request cancellable:(OGCancellable*)cancellable;
+
+/**
+ * The number of workers the pool keeps running.
+ *
+ * @return the size of the pool
+ */
+- (guint)size;
+
+/**
+ * The number of workers currently waiting for a request.
+ *
+ * @return the number of idle workers
+ */
+- (guint)idleCount;
+
+/**
+ * The number of requests after which a worker is replaced by a fresh
+ * process, 0 if workers are never replaced for this reason.
+ *
+ * @return the maximum number of requests per worker
+ */
+- (guint64)maxRequestsPerWorker;
+
+/**
+ * Sets the number of requests after which a worker is replaced by a fresh
+ * process, which bounds the damage done by helpers that leak.
+ *
+ * @param maxRequestsPerWorker the maximum number of requests per worker,
+ * or 0 for no limit
+ */
+- (void)setMaxRequestsPerWorker:(guint64)maxRequestsPerWorker;
+
+/**
+ * Closes the stdin of all idle workers, which makes them exit. Busy
+ * workers are retired once their current request completes, and further
+ * requests fail with
+ * %G_IO_ERROR_CLOSED. This is called when the pool is deallocated.
+ */
+- (void)close;
+
+@end
@@ -0,0 +1,373 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGSubprocessPool.h"
+
+#import "OGCancellable.h"
+#import "OGSubprocessLauncher.h"
+
+typedef struct {
+	GSubprocess* process;
+	GOutputStream* input;
+	GDataInputStream* output;
+	guint64 requests;
+} PoolWorker;
+
+static void retireWorker(PoolWorker* worker, bool kill)
+{
+	/* Workers are expected to exit at the end of their input; GSubprocess
+	 * reaps them in the background. */
+	g_output_stream_close(worker->input, NULL, NULL);
+
+	if (kill)
+		g_subprocess_force_exit(worker->process);
+
+	g_object_unref(worker->output);
+	g_object_unref(worker->process);
+	g_free(worker);
+}
+
+static PoolWorker* spawnWorker(GSubprocessLauncher* launcher, const gchar* const* argv, GError** error)
+{
+	GSubprocess* process = g_subprocess_launcher_spawnv(launcher, argv, error);
+
+	if (process == NULL)
+		return NULL;
+
+	GOutputStream* input = g_subprocess_get_stdin_pipe(process);
+	GInputStream* output = g_subprocess_get_stdout_pipe(process);
+
+	if (input == NULL || output == NULL) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Subprocess pool workers need stdin and stdout pipes");
+		g_subprocess_force_exit(process);
+		g_object_unref(process);
+		return NULL;
+	}
+
+	PoolWorker* worker = g_new0(PoolWorker, 1);
+	worker->process = process;
+	worker->input = input;
+	worker->output = g_data_input_stream_new(output);
+	g_filter_input_stream_set_close_base_stream(G_FILTER_INPUT_STREAM(worker->output), FALSE);
+	g_data_input_stream_set_byte_order(worker->output, G_DATA_STREAM_BYTE_ORDER_BIG_ENDIAN);
+
+	return worker;
+}
+
+static GBytes* exchangeLine(PoolWorker* worker, GBytes* request, GCancellable* cancellable, GError** error)
+{
+	gsize size;
+	const guint8* data = g_bytes_get_data(request, &size);
+	GOutputVector vectors[2] = {
+		{ data, size },
+		{ "\n", 1 }
+	};
+	gsize nVectors = (size > 0 && data[size - 1] == '\n' ? 1 : 2);
+
+	if (!g_output_stream_writev_all(worker->input, vectors, nVectors, NULL, cancellable, error))
+		return NULL;
+
+	gsize length;
+	GError* readError = NULL;
+	char* line = g_data_input_stream_read_line(worker->output, &length, cancellable, &readError);
+
+	if (line == NULL) {
+		if (readError != NULL)
+			g_propagate_error(error, readError);
+		else
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE, "Subprocess pool worker exited");
+
+		return NULL;
+	}
+
+	return g_bytes_new_take(line, length);
+}
+
+static GBytes* exchangeFrame(PoolWorker* worker, GBytes* request, GCancellable* cancellable, GError** error)
+{
+	gsize size;
+	gconstpointer data = g_bytes_get_data(request, &size);
+
+	if (size > G_MAXUINT32) {
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_INVALID_ARGUMENT, "Request is too large");
+		return NULL;
+	}
+
+	guint32 header = GUINT32_TO_BE((guint32)size);
+	GOutputVector vectors[2] = {
+		{ &header, sizeof(header) },
+		{ data, size }
+	};
+
+	if (!g_output_stream_writev_all(worker->input, vectors, 2, NULL, cancellable, error))
+		return NULL;
+
+	GError* readError = NULL;
+	guint32 length = g_data_input_stream_read_uint32(worker->output, cancellable, &readError);
+
+	if (readError != NULL) {
+		g_propagate_error(error, readError);
+		return NULL;
+	}
+
+	guint8* response = g_malloc(length);
+	gsize read = 0;
+
+	if (!g_input_stream_read_all(G_INPUT_STREAM(worker->output), response, length, &read, cancellable, error)) {
+		g_free(response);
+		return NULL;
+	}
+
+	if (read < length) {
+		g_free(response);
+		g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_BROKEN_PIPE, "Subprocess pool worker exited");
+		return NULL;
+	}
+
+	return g_bytes_new_take(response, length);
+}
+
+@interface OGSubprocessPool ()
+- (PoolWorker*)acquireWorkerWithCancellable:(GCancellable*)cancellable error:(GError**)error;
+- (void)releaseWorker:(PoolWorker*)worker broken:(bool)broken;
+- (void)wakeWaiters;
+@end
+
+static void cancelledCallback(GCancellable* cancellable, gpointer userData)
+{
+	[(OGSubprocessPool*)userData wakeWaiters];
+}
+
+@implementation OGSubprocessPool
+
++ (instancetype)subprocessPoolWithArgv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing
+{
+	return [[[self alloc] initWithLauncher:nil argv:argv size:size framing:framing] autorelease];
+}
+
++ (instancetype)subprocessPoolWithLauncher:(OGSubprocessLauncher*)launcher argv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing
+{
+	return [[[self alloc] initWithLauncher:launcher argv:argv size:size framing:framing] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithLauncher:(OGSubprocessLauncher*)launcher argv:(const gchar* const*)argv size:(guint)size framing:(OGSubprocessPoolFraming)framing
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+	g_cond_init(&_cond);
+	g_queue_init(&_idle);
+
+	@try {
+		if (argv == NULL || argv[0] == NULL || size == 0)
+			@throw [OFInvalidArgumentException exception];
+
+		if (launcher != nil)
+			_launcher = g_object_ref([launcher castedGObject]);
+		else
+			_launcher = g_subprocess_launcher_new(G_SUBPROCESS_FLAGS_STDIN_PIPE | G_SUBPROCESS_FLAGS_STDOUT_PIPE);
+
+		_argv = g_strdupv((gchar**)argv);
+		_size = size;
+		_framing = framing;
+
+		for (guint i = 0; i < size; i++) {
+			GError* err = NULL;
+			PoolWorker* worker = spawnWorker(_launcher, (const gchar* const*)_argv, &err);
+
+			[OGErrorException throwForError:err];
+
+			g_queue_push_tail(&_idle, worker);
+			_spawned++;
+		}
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[self close];
+
+	if (_launcher != NULL)
+		g_object_unref(_launcher);
+
+	g_strfreev(_argv);
+	g_cond_clear(&_cond);
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (PoolWorker*)acquireWorkerWithCancellable:(GCancellable*)cancellable error:(GError**)error
+{
+	PoolWorker* worker = NULL;
+	bool spawn = false;
+	gulong handler = 0;
+
+	if (cancellable != NULL)
+		handler = g_cancellable_connect(cancellable, G_CALLBACK(cancelledCallback), self, NULL);
+
+	g_mutex_lock(&_mutex);
+
+	for (;;) {
+		if (_closed) {
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_CLOSED, "Subprocess pool is closed");
+			break;
+		}
+
+		if (g_cancellable_set_error_if_cancelled(cancellable, error))
+			break;
+
+		worker = g_queue_pop_head(&_idle);
+		if (worker != NULL)
+			break;
+
+		if (_spawned < _size) {
+			_spawned++;
+			spawn = true;
+			break;
+		}
+
+		g_cond_wait(&_cond, &_mutex);
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	if (handler != 0)
+		g_cancellable_disconnect(cancellable, handler);
+
+	if (spawn) {
+		worker = spawnWorker(_launcher, (const gchar* const*)_argv, error);
+
+		if (worker == NULL) {
+			g_mutex_lock(&_mutex);
+			_spawned--;
+			g_cond_signal(&_cond);
+			g_mutex_unlock(&_mutex);
+		}
+	}
+
+	return worker;
+}
+
+- (void)releaseWorker:(PoolWorker*)worker broken:(bool)broken
+{
+	bool retire;
+
+	g_mutex_lock(&_mutex);
+
+	retire = (broken || _closed || (_maxRequestsPerWorker > 0 && worker->requests >= _maxRequestsPerWorker));
+
+	if (retire)
+		_spawned--;
+	else
+		g_queue_push_tail(&_idle, worker);
+
+	g_cond_signal(&_cond);
+	g_mutex_unlock(&_mutex);
+
+	if (retire)
+		retireWorker(worker, broken);
+}
+
+- (void)wakeWaiters
+{
+	g_mutex_lock(&_mutex);
+	g_cond_broadcast(&_cond);
+	g_mutex_unlock(&_mutex);
+}
+
+- (GBytes*)sendRequest:(GBytes*)request cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+	GCancellable* gcancellable = [cancellable castedGObject];
+
+	if (request == NULL)
+		@throw [OFInvalidArgumentException exception];
+
+	PoolWorker* worker = [self acquireWorkerWithCancellable:gcancellable error:&err];
+
+	[OGErrorException throwForError:err];
+
+	GBytes* returnValue;
+
+	if (_framing == OG_SUBPROCESS_POOL_FRAMING_LINE)
+		returnValue = exchangeLine(worker, request, gcancellable, &err);
+	else
+		returnValue = exchangeFrame(worker, request, gcancellable, &err);
+
+	worker->requests++;
+
+	/* After a failed or cancelled exchange the worker may be halfway through
+	 * a request, so it cannot be reused. */
+	[self releaseWorker:worker broken:(returnValue == NULL)];
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+- (guint)size
+{
+	return _size;
+}
+
+- (guint)idleCount
+{
+	guint returnValue;
+
+	g_mutex_lock(&_mutex);
+	returnValue = _idle.length;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (guint64)maxRequestsPerWorker
+{
+	guint64 returnValue;
+
+	g_mutex_lock(&_mutex);
+	returnValue = _maxRequestsPerWorker;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (void)setMaxRequestsPerWorker:(guint64)maxRequestsPerWorker
+{
+	g_mutex_lock(&_mutex);
+	_maxRequestsPerWorker = maxRequestsPerWorker;
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)close
+{
+	GQueue idle = G_QUEUE_INIT;
+	PoolWorker* worker;
+
+	g_mutex_lock(&_mutex);
+	_closed = true;
+	idle = _idle;
+	g_queue_init(&_idle);
+	_spawned -= idle.length;
+	g_cond_broadcast(&_cond);
+	g_mutex_unlock(&_mutex);
+
+	while ((worker = g_queue_pop_head(&idle)) != NULL)
+		retireWorker(worker, false);
+}
+
+@end
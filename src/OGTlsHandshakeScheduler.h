@@ -0,0 +1,170 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGTlsConnection.h"
+
+@class OGCancellable;
+
+/**
+ * The number of buckets in the latency histograms of
+ * #OGTlsHandshakeSchedulerStatistics.
+ */
+#define OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS 12
+
+/**
+ * Counters collected by an #OGTlsHandshakeScheduler.
+ */
+typedef struct {
+	/** Number of handshakes currently waiting for a slot */
+	guint queueDepth;
+	/** Number of handshakes currently running */
+	guint inFlight;
+	/** Number of handshakes that have been started */
+	guint64 started;
+	/** Number of handshakes that completed successfully */
+	guint64 succeeded;
+	/** Number of handshakes that failed or were cancelled */
+	guint64 failed;
+	/** Number of handshakes that were rejected after waiting too long */
+	guint64 timedOut;
+	/** Histogram of the time spent waiting for a slot */
+	guint64 queueLatency[OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS];
+	/** Histogram of the time spent in the handshake itself */
+	guint64 handshakeLatency[OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS];
+} OGTlsHandshakeSchedulerStatistics;
+
+/**
+ * `OGTlsHandshakeScheduler` puts admission control in front of
+ * -[OGTlsConnection handshakeAsyncWithIoPriority:cancellable:callback:userData:].
+ *
+ * At most a configurable number of handshakes run at the same time. Further
+ * handshakes wait in a queue ordered by their I/O priority (lower values
+ * first, like everywhere in GIO) and by arrival within the same priority. A
+ * handshake that waits longer than the queue deadline is failed with
+ * %G_IO_ERROR_TIMED_OUT without ever being started, so an overloaded
+ * process sheds load instead of letting every handshake time out.
+ *
+ * Queued handshakes are started in the thread-default main context that was
+ * current when they were submitted, and the callback is invoked there as
+ * well. All methods are thread-safe.
+ *
+ */
+@interface OGTlsHandshakeScheduler : OFObject
+{
+	GMutex _mutex;
+	GQueue _queue;
+	guint _maxConcurrentHandshakes;
+	gint64 _queueDeadline;
+	guint64 _sequence;
+	OGTlsHandshakeSchedulerStatistics _statistics;
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Returns the process-wide scheduler. It allows twice as many concurrent
+ * handshakes as there are processors and has no queue deadline.
+ *
+ * @return the shared scheduler
+ */
++ (instancetype)sharedScheduler;
+
+/**
+ * Returns the upper bound of a bucket of the latency histograms.
+ *
+ * @param bucket a bucket index below %OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS
+ * @return the upper bound in microseconds, or %G_MAXINT64 for the last
+ *     bucket
+ */
++ (gint64)upperBoundOfBucket:(size_t)bucket;
+
+/**
+ * Constructors
+ */
++ (instancetype)handshakeSchedulerWithMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes queueDeadline:(gint64)queueDeadline;
+
+/**
+ * Initializes a scheduler.
+ *
+ * @param maxConcurrentHandshakes the number of handshakes allowed to run at
+ *     the same time, must not be 0
+ * @param queueDeadline the time in microseconds a handshake may wait for a
+ *     slot, or 0 to wait indefinitely
+ * @return an initialized scheduler
+ */
+- (instancetype)initWithMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes queueDeadline:(gint64)queueDeadline;
+
+/**
+ * Methods
+ */
+
+/**
+ * The number of handshakes allowed to run at the same time.
+ *
+ * @return the concurrency limit
+ */
+- (guint)maxConcurrentHandshakes;
+
+/**
+ * Changes the number of handshakes allowed to run at the same time. Raising
+ * the limit starts waiting handshakes right away.
+ *
+ * @param maxConcurrentHandshakes the new concurrency limit, must not be 0
+ */
+- (void)setMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes;
+
+/**
+ * The time in microseconds a handshake may wait for a slot.
+ *
+ * @return the queue deadline, or 0 if handshakes wait indefinitely
+ */
+- (gint64)queueDeadline;
+
+/**
+ * Changes the queue deadline for handshakes submitted from now on.
+ *
+ * @param queueDeadline the time in microseconds a handshake may wait for a
+ *     slot, or 0 to wait indefinitely
+ */
+- (void)setQueueDeadline:(gint64)queueDeadline;
+
+/**
+ * Returns a snapshot of the counters collected by the scheduler.
+ *
+ * @return the current statistics
+ */
+- (OGTlsHandshakeSchedulerStatistics)statistics;
+
+/**
+ * Asynchronously performs a TLS handshake on @connection as soon as a slot
+ * is available. See -[OGTlsConnection handshakeWithCancellable:] for more
+ * information about handshakes.
+ *
+ * The source object passed to @callback is the #GTlsConnection of
+ * @connection.
+ *
+ * @param connection the connection to handshake
+ * @param ioPriority the [I/O priority][io-priority] of the request, also
+ *     used to order waiting handshakes
+ * @param cancellable a #GCancellable, or %NULL
+ * @param callback callback to call when the handshake is complete
+ * @param userData the data to pass to the callback function
+ */
+- (void)handshakeAsyncWithConnection:(OGTlsConnection*)connection ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData;
+
+/**
+ * Finishes a handshake started with
+ * -handshakeAsyncWithConnection:ioPriority:cancellable:callback:userData:.
+ *
+ * @param result a #GAsyncResult.
+ * @return %TRUE on success, %FALSE on failure, in which
+ * case an exception is thrown.
+ */
+- (bool)handshakeFinishWithResult:(GAsyncResult*)result;
+
+@end
@@ -0,0 +1,432 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGTlsHandshakeScheduler.h"
+
+#import "OGCancellable.h"
+
+typedef struct {
+	OGTlsHandshakeScheduler* scheduler;
+	GTask* task;
+	int ioPriority;
+	guint64 sequence;
+	gint64 enqueuedAt;
+	gint64 startedAt;
+	GSource* deadlineSource;
+	GSource* cancelSource;
+	GList* link;
+} OGTlsHandshakeRequest;
+
+static const gint64 bucketUpperBounds[OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS] = {
+	1000, 2000, 5000, 10000, 25000, 50000, 100000, 250000, 500000,
+	1000000, 2500000, G_MAXINT64
+};
+
+@interface OGTlsHandshakeScheduler ()
+- (void)startRequest:(OGTlsHandshakeRequest*)request;
+- (void)finishRequest:(OGTlsHandshakeRequest*)request succeeded:(bool)succeeded;
+- (void)abandonRequest:(OGTlsHandshakeRequest*)request;
+- (bool)dequeueRequest:(OGTlsHandshakeRequest*)request expired:(bool)expired;
+@end
+
+static void requestFree(OGTlsHandshakeRequest* request)
+{
+	g_object_unref(request->task);
+	if (request->deadlineSource != NULL)
+		g_source_unref(request->deadlineSource);
+	if (request->cancelSource != NULL)
+		g_source_unref(request->cancelSource);
+	[request->scheduler release];
+}
+
+static void requestUnref(gpointer request)
+{
+	g_rc_box_release_full(request, (GDestroyNotify)requestFree);
+}
+
+static gint compareRequests(const OGTlsHandshakeRequest* a, const OGTlsHandshakeRequest* b)
+{
+	if (a->ioPriority != b->ioPriority)
+		return (a->ioPriority < b->ioPriority) ? -1 : 1;
+
+	return (a->sequence < b->sequence) ? -1 : (a->sequence > b->sequence);
+}
+
+static size_t latencyBucket(gint64 latency)
+{
+	size_t bucket = 0;
+
+	while (latency > bucketUpperBounds[bucket])
+		bucket++;
+
+	return bucket;
+}
+
+static void recordLatency(guint64* histogram, gint64 latency)
+{
+	histogram[latencyBucket(latency)]++;
+}
+
+/* Stops waiting for the deadline or cancellation of a request leaving the queue. */
+static void detachQueueSources(OGTlsHandshakeRequest* request)
+{
+	if (request->deadlineSource != NULL)
+		g_source_destroy(request->deadlineSource);
+
+	if (request->cancelSource != NULL)
+		g_source_destroy(request->cancelSource);
+}
+
+static gboolean deadlineExpired(gpointer userData)
+{
+	OGTlsHandshakeRequest* request = userData;
+
+	if ([request->scheduler dequeueRequest:request expired:true]) {
+		g_task_return_new_error(request->task, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "TLS handshake waited too long for a free slot");
+		requestUnref(request);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean queuedRequestCancelled(GCancellable* cancellable, gpointer userData)
+{
+	OGTlsHandshakeRequest* request = userData;
+
+	if ([request->scheduler dequeueRequest:request expired:false]) {
+		g_task_return_error_if_cancelled(request->task);
+		requestUnref(request);
+	}
+
+	return G_SOURCE_REMOVE;
+}
+
+static void handshakeDone(GObject* source, GAsyncResult* result, gpointer userData)
+{
+	OGTlsHandshakeRequest* request = userData;
+	GError* err = NULL;
+
+	bool succeeded = (bool)g_tls_connection_handshake_finish(G_TLS_CONNECTION(source), result, &err);
+
+	[request->scheduler finishRequest:request succeeded:succeeded];
+
+	if (succeeded)
+		g_task_return_boolean(request->task, TRUE);
+	else
+		g_task_return_error(request->task, err);
+
+	requestUnref(request);
+}
+
+static gboolean startRequestInContext(gpointer userData)
+{
+	OGTlsHandshakeRequest* request = userData;
+
+	/* Cancelled before the handshake began, so it never counts as one. */
+	if (g_task_return_error_if_cancelled(request->task)) {
+		[request->scheduler abandonRequest:request];
+		requestUnref(request);
+		return G_SOURCE_REMOVE;
+	}
+
+	g_tls_connection_handshake_async(G_TLS_CONNECTION(g_task_get_source_object(request->task)), request->ioPriority, g_task_get_cancellable(request->task), handshakeDone, request);
+
+	return G_SOURCE_REMOVE;
+}
+
+@implementation OGTlsHandshakeScheduler
+
++ (instancetype)sharedScheduler
+{
+	static OGTlsHandshakeScheduler* sharedScheduler = nil;
+	static gsize initialized = 0;
+
+	if (g_once_init_enter(&initialized)) {
+		sharedScheduler = [[OGTlsHandshakeScheduler alloc] initWithMaxConcurrentHandshakes:2 * g_get_num_processors() queueDeadline:0];
+		g_once_init_leave(&initialized, 1);
+	}
+
+	return sharedScheduler;
+}
+
++ (gint64)upperBoundOfBucket:(size_t)bucket
+{
+	if (bucket >= OG_TLS_HANDSHAKE_SCHEDULER_BUCKETS)
+		@throw [OFOutOfRangeException exception];
+
+	return bucketUpperBounds[bucket];
+}
+
++ (instancetype)handshakeSchedulerWithMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes queueDeadline:(gint64)queueDeadline
+{
+	return [[[self alloc] initWithMaxConcurrentHandshakes:maxConcurrentHandshakes queueDeadline:queueDeadline] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes queueDeadline:(gint64)queueDeadline
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+	g_queue_init(&_queue);
+
+	@try {
+		if (maxConcurrentHandshakes == 0 || queueDeadline < 0)
+			@throw [OFInvalidArgumentException exception];
+
+		_maxConcurrentHandshakes = maxConcurrentHandshakes;
+		_queueDeadline = queueDeadline;
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	/* Every queued request retains the scheduler, so the queue is empty. */
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (guint)maxConcurrentHandshakes
+{
+	g_mutex_lock(&_mutex);
+	guint returnValue = _maxConcurrentHandshakes;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (void)setMaxConcurrentHandshakes:(guint)maxConcurrentHandshakes
+{
+	if (maxConcurrentHandshakes == 0)
+		@throw [OFInvalidArgumentException exception];
+
+	g_mutex_lock(&_mutex);
+	_maxConcurrentHandshakes = maxConcurrentHandshakes;
+	g_mutex_unlock(&_mutex);
+
+	[self startRequest:NULL];
+}
+
+- (gint64)queueDeadline
+{
+	g_mutex_lock(&_mutex);
+	gint64 returnValue = _queueDeadline;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (void)setQueueDeadline:(gint64)queueDeadline
+{
+	if (queueDeadline < 0)
+		@throw [OFInvalidArgumentException exception];
+
+	g_mutex_lock(&_mutex);
+	_queueDeadline = queueDeadline;
+	g_mutex_unlock(&_mutex);
+}
+
+- (OGTlsHandshakeSchedulerStatistics)statistics
+{
+	g_mutex_lock(&_mutex);
+	OGTlsHandshakeSchedulerStatistics returnValue = _statistics;
+	returnValue.queueDepth = _queue.length;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (void)handshakeAsyncWithConnection:(OGTlsConnection*)connection ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData
+{
+	OGTlsHandshakeRequest* request = g_rc_box_new0(OGTlsHandshakeRequest);
+	request->scheduler = [self retain];
+	request->task = g_task_new([connection castedGObject], [cancellable castedGObject], callback, userData);
+	request->ioPriority = ioPriority;
+	request->enqueuedAt = g_get_monotonic_time();
+	g_task_set_source_tag(request->task, handshakeDone);
+
+	[self startRequest:request];
+}
+
+- (bool)handshakeFinishWithResult:(GAsyncResult*)result
+{
+	GError* err = NULL;
+
+	bool returnValue = (bool)g_task_propagate_boolean(G_TASK(result), &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+/*
+ * Queues @request, if any, and then starts as many queued requests as there
+ * are free slots. Requests found past their deadline are failed instead.
+ */
+- (void)startRequest:(OGTlsHandshakeRequest*)request
+{
+	GSList* toStart = NULL;
+	GSList* toExpire = NULL;
+	GSList* toCancel = NULL;
+	gint64 now = g_get_monotonic_time();
+
+	g_mutex_lock(&_mutex);
+
+	if (request != NULL) {
+		request->sequence = _sequence++;
+
+		GList* sibling = _queue.tail;
+		while (sibling != NULL && compareRequests(sibling->data, request) > 0)
+			sibling = sibling->prev;
+
+		if (sibling == NULL) {
+			g_queue_push_head(&_queue, request);
+			request->link = _queue.head;
+		} else {
+			g_queue_insert_after(&_queue, sibling, request);
+			request->link = sibling->next;
+		}
+
+		if (_statistics.inFlight >= _maxConcurrentHandshakes) {
+			if (_queueDeadline > 0) {
+				/* Round up, a zero timeout would fire continuously. */
+				gint64 milliseconds = MAX((_queueDeadline + 999) / 1000, 1);
+
+				request->deadlineSource = g_timeout_source_new((guint)MIN(milliseconds, (gint64)G_MAXUINT));
+				g_source_set_callback(request->deadlineSource, deadlineExpired, g_rc_box_acquire(request), requestUnref);
+				g_source_attach(request->deadlineSource, g_task_get_context(request->task));
+			}
+
+			GCancellable* cancellable = g_task_get_cancellable(request->task);
+			if (cancellable != NULL) {
+				request->cancelSource = g_cancellable_source_new(cancellable);
+				g_source_set_callback(request->cancelSource, G_SOURCE_FUNC(queuedRequestCancelled), g_rc_box_acquire(request), requestUnref);
+				g_source_attach(request->cancelSource, g_task_get_context(request->task));
+			}
+		}
+	}
+
+	while (_queue.length > 0 && _statistics.inFlight < _maxConcurrentHandshakes) {
+		OGTlsHandshakeRequest* next = g_queue_pop_head(&_queue);
+		next->link = NULL;
+
+		detachQueueSources(next);
+
+		if (g_cancellable_is_cancelled(g_task_get_cancellable(next->task))) {
+			toCancel = g_slist_prepend(toCancel, next);
+			continue;
+		}
+
+		if (_queueDeadline > 0 && now - next->enqueuedAt > _queueDeadline) {
+			_statistics.timedOut++;
+			toExpire = g_slist_prepend(toExpire, next);
+			continue;
+		}
+
+		_statistics.inFlight++;
+		_statistics.started++;
+		next->startedAt = now;
+		recordLatency(_statistics.queueLatency, now - next->enqueuedAt);
+		toStart = g_slist_prepend(toStart, next);
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	for (GSList* iter = toExpire; iter != NULL; iter = iter->next) {
+		OGTlsHandshakeRequest* expired = iter->data;
+
+		g_task_return_new_error(expired->task, G_IO_ERROR, G_IO_ERROR_TIMED_OUT, "TLS handshake waited too long for a free slot");
+		requestUnref(expired);
+	}
+
+	for (GSList* iter = toCancel; iter != NULL; iter = iter->next) {
+		OGTlsHandshakeRequest* cancelled = iter->data;
+
+		g_task_return_error_if_cancelled(cancelled->task);
+		requestUnref(cancelled);
+	}
+
+	toStart = g_slist_reverse(toStart);
+	for (GSList* iter = toStart; iter != NULL; iter = iter->next) {
+		OGTlsHandshakeRequest* started = iter->data;
+
+		g_main_context_invoke(g_task_get_context(started->task), startRequestInContext, started);
+	}
+
+	g_slist_free(toExpire);
+	g_slist_free(toCancel);
+	g_slist_free(toStart);
+}
+
+- (void)finishRequest:(OGTlsHandshakeRequest*)request succeeded:(bool)succeeded
+{
+	g_mutex_lock(&_mutex);
+
+	_statistics.inFlight--;
+
+	if (succeeded)
+		_statistics.succeeded++;
+	else
+		_statistics.failed++;
+
+	recordLatency(_statistics.handshakeLatency, g_get_monotonic_time() - request->startedAt);
+
+	g_mutex_unlock(&_mutex);
+
+	[self startRequest:NULL];
+}
+
+/* Gives back the slot of a started request whose handshake never began. */
+- (void)abandonRequest:(OGTlsHandshakeRequest*)request
+{
+	g_mutex_lock(&_mutex);
+
+	_statistics.inFlight--;
+	_statistics.started--;
+	_statistics.queueLatency[latencyBucket(request->startedAt - request->enqueuedAt)]--;
+
+	g_mutex_unlock(&_mutex);
+
+	[self startRequest:NULL];
+}
+
+/*
+ * Removes @request from the queue if it is still waiting there. Only
+ * requests that @expired count in the statistics.
+ */
+- (bool)dequeueRequest:(OGTlsHandshakeRequest*)request expired:(bool)expired
+{
+	bool returnValue = false;
+
+	g_mutex_lock(&_mutex);
+
+	if (request->link != NULL) {
+		g_queue_delete_link(&_queue, request->link);
+		request->link = NULL;
+		detachQueueSources(request);
+
+		if (expired)
+			_statistics.timedOut++;
+
+		returnValue = true;
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+@end
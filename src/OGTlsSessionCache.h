@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGTlsConnection.h"
+
+@class OGSocketClient;
+
+/**
+ * Counters collected by an #OGTlsSessionCache.
+ */
+typedef struct {
+	/** Number of client connections a cached session was looked up for */
+	guint64 lookups;
+	/** Number of lookups that found a cached session */
+	guint64 hits;
+	/** Number of sessions stored after a successful handshake */
+	guint64 stores;
+	/** Number of sessions dropped because of the capacity or lifetime */
+	guint64 evictions;
+	/** Number of recorded handshakes the backend reported as full */
+	guint64 fullHandshakes;
+	/** Number of recorded handshakes the backend reported as resumed */
+	guint64 resumedHandshakes;
+	/** Number of recorded handshakes the backend did not report on */
+	guint64 unknownHandshakes;
+} OGTlsSessionCacheStatistics;
+
+/**
+ * `OGTlsSessionCache` is a size-bounded, least-recently-used store of TLS
+ * client sessions keyed by server identity.
+ *
+ * Sessions are kept by copying the session state of a handshaked
+ * #GTlsClientConnection into a detached placeholder connection with
+ * g_tls_client_connection_copy_session_state(), so a cached session holds
+ * no socket. A later connection to the same identity gets the state copied
+ * back before its handshake, which lets the TLS backend resume the session
+ * instead of performing a full handshake.
+ *
+ * A cache can be attached to any number of #OGSocketClient instances that
+ * have TLS enabled with -[OGSocketClient setTls:]; it then hooks into the
+ * client's #GSocketClient::event signal. For server-side connections the TLS
+ * backend resumes sessions from its own tickets, and the cache only records
+ * the outcome of each handshake with -recordHandshakeOfConnection:.
+ *
+ * Whether a handshake was resumed is read from the backend's
+ * `session-reused` property when it provides one. All methods are
+ * thread-safe.
+ *
+ */
+@interface OGTlsSessionCache : OFObject
+{
+	GMutex _mutex;
+	GHashTable* _entries;
+	GQueue _lru;
+	unsigned int _capacity;
+	gint64 _lifetime;
+	OGTlsSessionCacheStatistics _statistics;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)sessionCacheWithCapacity:(unsigned int)capacity;
++ (instancetype)sessionCacheWithCapacity:(unsigned int)capacity lifetime:(gint64)lifetime;
+
+/**
+ * Initializes a session cache that keeps at most @capacity sessions.
+ *
+ * @param capacity the maximum number of cached sessions, must not be 0
+ * @param lifetime the time in microseconds after which a cached session is
+ *     no longer offered, or 0 to keep sessions until evicted
+ * @return an initialized session cache
+ */
+- (instancetype)initWithCapacity:(unsigned int)capacity lifetime:(gint64)lifetime;
+
+/**
+ * Methods
+ */
+
+/**
+ * The maximum number of sessions kept by the cache.
+ *
+ * @return the capacity of the cache
+ */
+- (unsigned int)capacity;
+
+/**
+ * The number of sessions currently kept by the cache.
+ *
+ * @return the number of cached sessions
+ */
+- (unsigned int)count;
+
+/**
+ * Returns a snapshot of the counters collected by the cache.
+ *
+ * @return the current statistics
+ */
+- (OGTlsSessionCacheStatistics)statistics;
+
+/**
+ * Returns the fraction of recorded handshakes the backend reported as
+ * resumed, ignoring handshakes it did not report on.
+ *
+ * @return the resumed-handshake rate between 0 and 1
+ */
+- (double)resumptionRate;
+
+/**
+ * Resets all counters to zero without touching the cached sessions.
+ *
+ */
+- (void)resetStatistics;
+
+/**
+ * Makes @client use the cache for all TLS connections it creates. The
+ * cache is kept alive for as long as it is attached to @client.
+ *
+ * @param client a socket client, usually with TLS enabled
+ */
+- (void)attachToSocketClient:(OGSocketClient*)client;
+
+/**
+ * Stops @client from using the cache.
+ *
+ * @param client a socket client previously passed to
+ *     -attachToSocketClient:
+ */
+- (void)detachFromSocketClient:(OGSocketClient*)client;
+
+/**
+ * Copies a cached session for the server identity of @connection into
+ * @connection, which must be a client connection that has not handshaked
+ * yet.
+ *
+ * @param connection a TLS client connection
+ * @return whether a cached session was found and copied
+ */
+- (bool)prepareClientConnection:(OGTlsConnection*)connection;
+
+/**
+ * Stores the session of @connection, which must be a client connection that
+ * has completed its handshake, under its server identity. This replaces any
+ * session previously cached for that identity.
+ *
+ * @param connection a handshaked TLS client connection
+ */
+- (void)storeClientConnection:(OGTlsConnection*)connection;
+
+/**
+ * Records whether the completed handshake of @connection was resumed. Works
+ * for both client and server connections.
+ *
+ * @param connection a handshaked TLS connection
+ */
+- (void)recordHandshakeOfConnection:(OGTlsConnection*)connection;
+
+/**
+ * Drops the session cached for @identity, if any.
+ *
+ * @param identity the server identity, as returned by
+ *     g_socket_connectable_to_string()
+ */
+- (void)removeSessionForIdentity:(OFString*)identity;
+
+/**
+ * Drops all cached sessions.
+ *
+ */
+- (void)removeAllSessions;
+
+@end
@@ -0,0 +1,331 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGTlsSessionCache.h"
+
+#import "OGSocketClient.h"
+
+typedef struct {
+	gchar* identity;
+	GTlsClientConnection* holder;
+	gint64 storedAt;
+} OGTlsSessionCacheEntry;
+
+@interface OGTlsSessionCache ()
+- (bool)prepareGClientConnection:(GTlsClientConnection*)connection;
+- (void)storeGClientConnection:(GTlsClientConnection*)connection;
+- (void)recordGConnection:(GTlsConnection*)connection;
+- (void)removeLink:(GList*)link;
+@end
+
+static void entryFree(OGTlsSessionCacheEntry* entry)
+{
+	g_free(entry->identity);
+	g_object_unref(entry->holder);
+	g_free(entry);
+}
+
+/*
+ * Creates a client connection on top of an in-memory stream that only serves
+ * as a carrier for the session state of @source, so that caching a session
+ * does not keep the socket of @source open.
+ */
+static GTlsClientConnection* newSessionHolder(GTlsClientConnection* source, GSocketConnectable* identity)
+{
+	GInputStream* input = g_memory_input_stream_new();
+	GOutputStream* output = g_memory_output_stream_new_resizable();
+	GIOStream* stream = g_simple_io_stream_new(input, output);
+	g_object_unref(input);
+	g_object_unref(output);
+
+	GIOStream* holder = g_tls_client_connection_new(stream, identity, NULL);
+	g_object_unref(stream);
+
+	if (holder == NULL)
+		return NULL;
+
+	g_tls_client_connection_copy_session_state(G_TLS_CLIENT_CONNECTION(holder), source);
+	return G_TLS_CLIENT_CONNECTION(holder);
+}
+
+static void socketClientEvent(GSocketClient* client, GSocketClientEvent event, GSocketConnectable* connectable, GIOStream* connection, gpointer userData)
+{
+	OGTlsSessionCache* cache = (OGTlsSessionCache*)userData;
+
+	if (connection == NULL || !G_IS_TLS_CLIENT_CONNECTION(connection))
+		return;
+
+	switch (event) {
+	case G_SOCKET_CLIENT_TLS_HANDSHAKING:
+		[cache prepareGClientConnection:G_TLS_CLIENT_CONNECTION(connection)];
+		break;
+	case G_SOCKET_CLIENT_TLS_HANDSHAKED:
+		[cache recordGConnection:G_TLS_CONNECTION(connection)];
+		[cache storeGClientConnection:G_TLS_CLIENT_CONNECTION(connection)];
+		break;
+	default:
+		break;
+	}
+}
+
+static void releaseCache(gpointer data, GClosure* closure)
+{
+	[(OGTlsSessionCache*)data release];
+}
+
+@implementation OGTlsSessionCache
+
++ (instancetype)sessionCacheWithCapacity:(unsigned int)capacity
+{
+	return [[[self alloc] initWithCapacity:capacity lifetime:0] autorelease];
+}
+
++ (instancetype)sessionCacheWithCapacity:(unsigned int)capacity lifetime:(gint64)lifetime
+{
+	return [[[self alloc] initWithCapacity:capacity lifetime:lifetime] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithCapacity:(unsigned int)capacity lifetime:(gint64)lifetime
+{
+	self = [super init];
+
+	g_mutex_init(&_mutex);
+	g_queue_init(&_lru);
+
+	@try {
+		if (capacity == 0 || lifetime < 0)
+			@throw [OFInvalidArgumentException exception];
+
+		_capacity = capacity;
+		_lifetime = lifetime;
+		_entries = g_hash_table_new(g_str_hash, g_str_equal);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	if (_entries != NULL)
+		g_hash_table_destroy(_entries);
+
+	g_queue_clear_full(&_lru, (GDestroyNotify)entryFree);
+	g_mutex_clear(&_mutex);
+
+	[super dealloc];
+}
+
+- (unsigned int)capacity
+{
+	return _capacity;
+}
+
+- (unsigned int)count
+{
+	g_mutex_lock(&_mutex);
+	unsigned int returnValue = _lru.length;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (OGTlsSessionCacheStatistics)statistics
+{
+	g_mutex_lock(&_mutex);
+	OGTlsSessionCacheStatistics returnValue = _statistics;
+	g_mutex_unlock(&_mutex);
+
+	return returnValue;
+}
+
+- (double)resumptionRate
+{
+	OGTlsSessionCacheStatistics statistics = [self statistics];
+	guint64 reported = statistics.fullHandshakes + statistics.resumedHandshakes;
+
+	if (reported == 0)
+		return 0;
+
+	return (double)statistics.resumedHandshakes / (double)reported;
+}
+
+- (void)resetStatistics
+{
+	g_mutex_lock(&_mutex);
+	memset(&_statistics, 0, sizeof(_statistics));
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)attachToSocketClient:(OGSocketClient*)client
+{
+	g_signal_connect_data([client castedGObject], "event", G_CALLBACK(socketClientEvent), [self retain], releaseCache, 0);
+}
+
+- (void)detachFromSocketClient:(OGSocketClient*)client
+{
+	g_signal_handlers_disconnect_by_func([client castedGObject], G_CALLBACK(socketClientEvent), self);
+}
+
+- (bool)prepareClientConnection:(OGTlsConnection*)connection
+{
+	GTlsConnection* gobjectValue = [connection castedGObject];
+
+	if (!G_IS_TLS_CLIENT_CONNECTION(gobjectValue))
+		@throw [OFInvalidArgumentException exception];
+
+	return [self prepareGClientConnection:G_TLS_CLIENT_CONNECTION(gobjectValue)];
+}
+
+- (void)storeClientConnection:(OGTlsConnection*)connection
+{
+	GTlsConnection* gobjectValue = [connection castedGObject];
+
+	if (!G_IS_TLS_CLIENT_CONNECTION(gobjectValue))
+		@throw [OFInvalidArgumentException exception];
+
+	[self storeGClientConnection:G_TLS_CLIENT_CONNECTION(gobjectValue)];
+}
+
+- (void)recordHandshakeOfConnection:(OGTlsConnection*)connection
+{
+	[self recordGConnection:[connection castedGObject]];
+}
+
+- (void)removeSessionForIdentity:(OFString*)identity
+{
+	g_mutex_lock(&_mutex);
+
+	GList* link = g_hash_table_lookup(_entries, [identity UTF8String]);
+	if (link != NULL)
+		[self removeLink:link];
+
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)removeAllSessions
+{
+	g_mutex_lock(&_mutex);
+
+	g_hash_table_remove_all(_entries);
+	g_queue_clear_full(&_lru, (GDestroyNotify)entryFree);
+	g_queue_init(&_lru);
+
+	g_mutex_unlock(&_mutex);
+}
+
+- (bool)prepareGClientConnection:(GTlsClientConnection*)connection
+{
+	GSocketConnectable* identity = g_tls_client_connection_get_server_identity(connection);
+
+	if (identity == NULL)
+		return false;
+
+	gchar* key = g_socket_connectable_to_string(identity);
+	bool found = false;
+
+	g_mutex_lock(&_mutex);
+
+	_statistics.lookups++;
+
+	GList* link = g_hash_table_lookup(_entries, key);
+	if (link != NULL) {
+		OGTlsSessionCacheEntry* entry = link->data;
+
+		if (_lifetime > 0 && g_get_monotonic_time() - entry->storedAt > _lifetime) {
+			[self removeLink:link];
+			_statistics.evictions++;
+		} else {
+			g_queue_unlink(&_lru, link);
+			g_queue_push_head_link(&_lru, link);
+
+			g_tls_client_connection_copy_session_state(connection, entry->holder);
+
+			_statistics.hits++;
+			found = true;
+		}
+	}
+
+	g_mutex_unlock(&_mutex);
+
+	g_free(key);
+	return found;
+}
+
+- (void)storeGClientConnection:(GTlsClientConnection*)connection
+{
+	GSocketConnectable* identity = g_tls_client_connection_get_server_identity(connection);
+
+	if (identity == NULL)
+		return;
+
+	GTlsClientConnection* holder = newSessionHolder(connection, identity);
+	if (holder == NULL)
+		return;
+
+	OGTlsSessionCacheEntry* entry = g_new0(OGTlsSessionCacheEntry, 1);
+	entry->identity = g_socket_connectable_to_string(identity);
+	entry->holder = holder;
+	entry->storedAt = g_get_monotonic_time();
+
+	g_mutex_lock(&_mutex);
+
+	GList* existing = g_hash_table_lookup(_entries, entry->identity);
+	if (existing != NULL)
+		[self removeLink:existing];
+
+	g_queue_push_head(&_lru, entry);
+	g_hash_table_insert(_entries, entry->identity, _lru.head);
+	_statistics.stores++;
+
+	while (_lru.length > _capacity) {
+		[self removeLink:_lru.tail];
+		_statistics.evictions++;
+	}
+
+	g_mutex_unlock(&_mutex);
+}
+
+- (void)recordGConnection:(GTlsConnection*)connection
+{
+	GParamSpec* pspec = g_object_class_find_property(G_OBJECT_GET_CLASS(connection), "session-reused");
+	gboolean reused = FALSE;
+
+	if (pspec != NULL && pspec->value_type == G_TYPE_BOOLEAN)
+		g_object_get(connection, "session-reused", &reused, NULL);
+	else
+		pspec = NULL;
+
+	g_mutex_lock(&_mutex);
+
+	if (pspec == NULL)
+		_statistics.unknownHandshakes++;
+	else if (reused)
+		_statistics.resumedHandshakes++;
+	else
+		_statistics.fullHandshakes++;
+
+	g_mutex_unlock(&_mutex);
+}
+
+/* Must be called with _mutex held. */
+- (void)removeLink:(GList*)link
+{
+	OGTlsSessionCacheEntry* entry = link->data;
+
+	g_hash_table_remove(_entries, entry->identity);
+	g_queue_delete_link(&_lru, link);
+	entryFree(entry);
+}
+
+@end
@@ -0,0 +1,114 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGUnixConnection;
+
+/**
+ * The largest number of file descriptors Linux accepts in one SCM_RIGHTS
+ * control message.
+ */
+#define OG_UNIX_FD_CHANNEL_MAX_FDS_PER_MESSAGE 253
+
+/**
+ * `OGUnixFdChannel` passes batches of file descriptors together with a
+ * payload over an #OGUnixConnection.
+ *
+ * -[OGUnixConnection sendFd:cancellable:] sends one descriptor per message
+ * and allocates an #OGUnixFDList and an #OGUnixFDMessage for each. A
+ * channel instead packs up to -maxFdsPerMessage descriptors into the
+ * SCM_RIGHTS control message of a single sendmsg() call, using control
+ * buffers allocated once per channel, and splits larger batches into as
+ * many messages as needed. The receiving side reassembles the batch, so
+ * handing over tens of thousands of descriptors takes a few hundred system
+ * calls.
+ *
+ * Both ends of the connection have to use an `OGUnixFdChannel`, since every
+ * message carries a small header. Sending and receiving may happen on
+ * different threads at the same time; concurrent sends, like concurrent
+ * receives, are serialized.
+ *
+ */
+@interface OGUnixFdChannel : OFObject
+{
+	OGUnixConnection* _connection;
+	GSocket* _socket;
+	guint _maxFdsPerMessage;
+	guint8* _sendControl;
+	guint8* _receiveControl;
+	gsize _controlSize;
+	GMutex _sendMutex;
+	GMutex _receiveMutex;
+}
+
+/**
+ * Constructors
+ */
++ (instancetype)unixFdChannelWithConnection:(OGUnixConnection*)connection;
+
+/**
+ * Initializes a channel.
+ *
+ * @param connection the connection to pass descriptors over
+ * @param maxFdsPerMessage the number of descriptors sent per message, at
+ * most %OG_UNIX_FD_CHANNEL_MAX_FDS_PER_MESSAGE, or 0 for that maximum
+ * @return an initialized channel
+ */
+- (instancetype)initWithConnection:(OGUnixConnection*)connection maxFdsPerMessage:(guint)maxFdsPerMessage;
+
+/**
+ * Methods
+ */
+
+/**
+ * The connection the channel uses.
+ *
+ * @return the connection
+ */
+- (OGUnixConnection*)connection;
+
+/**
+ * The number of descriptors sent per message.
+ *
+ * @return the maximum number of descriptors per message
+ */
+- (guint)maxFdsPerMessage;
+
+/**
+ * Sends @count file descriptors and @size bytes of @data as one batch. The
+ * descriptors stay open in the calling process.
+ *
+ * @param fds the file descriptors to send
+ * @param count the number of descriptors, may be 0
+ * @param data the payload, may be %NULL if @size is 0
+ * @param size the size of the payload
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ */
+- (void)sendFds:(const gint*)fds count:(gsize)count data:(gconstpointer)data size:(gsize)size cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Receives one batch sent with -sendFds:count:data:size:cancellable:,
+ * appending its descriptors to @fds. The received descriptors have the
+ * close-on-exec flag set and are owned by the caller. On error, no
+ * descriptor is appended.
+ *
+ * @param fds an array of #gint receiving the descriptors
+ * @param cancellable optional #GCancellable object, %NULL to ignore
+ * @return the payload, to be freed with g_bytes_unref()
+ */
+- (GBytes*)receiveFdsIntoArray:(GArray*)fds cancellable:(OGCancellable*)cancellable;
+
+@end
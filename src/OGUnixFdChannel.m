@@ -0,0 +1,335 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGUnixFdChannel.h"
+
+#import "OGCancellable.h"
+#import "OGUnixConnection.h"
+
+#include <errno.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <unistd.h>
+
+/* Precedes the payload of every message; the control message is attached
+ * to its first byte. */
+typedef struct {
+	guint32 fdCount;
+	guint32 payloadSize;
+	guint32 more;
+} BatchHeader;
+
+static void setSocketError(GError** error, int errsv, const char* what)
+{
+	g_set_error(error, G_IO_ERROR, g_io_error_from_errno(errsv), "%s: %s", what, g_strerror(errsv));
+}
+
+static gboolean sendMessage(GSocket* socket, struct iovec* iov, int iovCount, const gint* fds, guint fdCount, guint8* control, GCancellable* cancellable, GError** error)
+{
+	struct msghdr msg = { 0 };
+	int fd = g_socket_get_fd(socket);
+
+	msg.msg_iov = iov;
+	msg.msg_iovlen = iovCount;
+
+	if (fdCount > 0) {
+		struct cmsghdr* cmsg;
+
+		msg.msg_control = control;
+		msg.msg_controllen = CMSG_SPACE(fdCount * sizeof(gint));
+		memset(control, 0, msg.msg_controllen);
+
+		cmsg = CMSG_FIRSTHDR(&msg);
+		cmsg->cmsg_level = SOL_SOCKET;
+		cmsg->cmsg_type = SCM_RIGHTS;
+		cmsg->cmsg_len = CMSG_LEN(fdCount * sizeof(gint));
+		memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(gint));
+	}
+
+	for (;;) {
+		ssize_t sent;
+
+		if (g_cancellable_set_error_if_cancelled(cancellable, error))
+			return FALSE;
+
+		sent = sendmsg(fd, &msg, MSG_NOSIGNAL);
+
+		if (sent < 0) {
+			int errsv = errno;
+
+			if (errsv == EINTR)
+				continue;
+
+			if (errsv == EAGAIN || errsv == EWOULDBLOCK) {
+				if (!g_socket_condition_wait(socket, G_IO_OUT, cancellable, error))
+					return FALSE;
+
+				continue;
+			}
+
+			setSocketError(error, errsv, "Error sending message");
+			return FALSE;
+		}
+
+		/* The descriptors went out with the first byte; only the rest of
+		 * the data is left to send after a short write. */
+		msg.msg_control = NULL;
+		msg.msg_controllen = 0;
+
+		while (msg.msg_iovlen > 0 && (gsize)sent >= msg.msg_iov->iov_len) {
+			sent -= msg.msg_iov->iov_len;
+			msg.msg_iov++;
+			msg.msg_iovlen--;
+		}
+
+		if (msg.msg_iovlen == 0)
+			return TRUE;
+
+		msg.msg_iov->iov_base = (guint8*)msg.msg_iov->iov_base + sent;
+		msg.msg_iov->iov_len -= sent;
+	}
+}
+
+static gboolean receiveHeader(GSocket* socket, BatchHeader* header, guint8* control, gsize controlSize, GArray* fds, gboolean* truncated, GCancellable* cancellable, GError** error)
+{
+	int fd = g_socket_get_fd(socket);
+	gsize received = 0;
+
+	while (received < sizeof(*header)) {
+		struct iovec iov = { (guint8*)header + received, sizeof(*header) - received };
+		struct msghdr msg = { 0 };
+		ssize_t result;
+
+		if (g_cancellable_set_error_if_cancelled(cancellable, error))
+			return FALSE;
+
+		msg.msg_iov = &iov;
+		msg.msg_iovlen = 1;
+		msg.msg_control = control;
+		msg.msg_controllen = controlSize;
+
+		result = recvmsg(fd, &msg, MSG_CMSG_CLOEXEC);
+
+		if (result < 0) {
+			int errsv = errno;
+
+			if (errsv == EINTR)
+				continue;
+
+			if (errsv == EAGAIN || errsv == EWOULDBLOCK) {
+				if (!g_socket_condition_wait(socket, G_IO_IN, cancellable, error))
+					return FALSE;
+
+				continue;
+			}
+
+			setSocketError(error, errsv, "Error receiving message");
+			return FALSE;
+		}
+
+		if (result == 0) {
+			if (received == 0)
+				g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_CONNECTION_CLOSED, "Connection closed by peer");
+			else
+				g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Unexpected early end-of-stream");
+
+			return FALSE;
+		}
+
+		for (struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != NULL; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+			if (cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS)
+				continue;
+
+			g_array_append_vals(fds, CMSG_DATA(cmsg), (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(gint));
+		}
+
+		if (msg.msg_flags & MSG_CTRUNC)
+			*truncated = TRUE;
+
+		received += (gsize)result;
+	}
+
+	return TRUE;
+}
+
+static gboolean receiveAll(GSocket* socket, guint8* buffer, gsize size, GCancellable* cancellable, GError** error)
+{
+	while (size > 0) {
+		gssize result = g_socket_receive(socket, (gchar*)buffer, size, cancellable, error);
+
+		if (result < 0)
+			return FALSE;
+
+		if (result == 0) {
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Unexpected early end-of-stream");
+			return FALSE;
+		}
+
+		buffer += result;
+		size -= (gsize)result;
+	}
+
+	return TRUE;
+}
+
+@implementation OGUnixFdChannel
+
++ (instancetype)unixFdChannelWithConnection:(OGUnixConnection*)connection
+{
+	return [[[self alloc] initWithConnection:connection maxFdsPerMessage:0] autorelease];
+}
+
+- (instancetype)init
+{
+	OF_INVALID_INIT_METHOD
+}
+
+- (instancetype)initWithConnection:(OGUnixConnection*)connection maxFdsPerMessage:(guint)maxFdsPerMessage
+{
+	self = [super init];
+
+	g_mutex_init(&_sendMutex);
+	g_mutex_init(&_receiveMutex);
+
+	@try {
+		if (connection == nil || maxFdsPerMessage > OG_UNIX_FD_CHANNEL_MAX_FDS_PER_MESSAGE)
+			@throw [OFInvalidArgumentException exception];
+
+		if (maxFdsPerMessage == 0)
+			maxFdsPerMessage = OG_UNIX_FD_CHANNEL_MAX_FDS_PER_MESSAGE;
+
+		_connection = [connection retain];
+		_socket = g_socket_connection_get_socket(G_SOCKET_CONNECTION([connection castedGObject]));
+		_maxFdsPerMessage = maxFdsPerMessage;
+		_controlSize = CMSG_SPACE(maxFdsPerMessage * sizeof(gint));
+		_sendControl = g_malloc(_controlSize);
+		_receiveControl = g_malloc(_controlSize);
+	} @catch (id e) {
+		[self release];
+		@throw e;
+	}
+
+	return self;
+}
+
+- (void)dealloc
+{
+	[_connection release];
+	g_free(_sendControl);
+	g_free(_receiveControl);
+	g_mutex_clear(&_sendMutex);
+	g_mutex_clear(&_receiveMutex);
+
+	[super dealloc];
+}
+
+- (OGUnixConnection*)connection
+{
+	return _connection;
+}
+
+- (guint)maxFdsPerMessage
+{
+	return _maxFdsPerMessage;
+}
+
+- (void)sendFds:(const gint*)fds count:(gsize)count data:(gconstpointer)data size:(gsize)size cancellable:(OGCancellable*)cancellable
+{
+	GError* err = NULL;
+	gsize sent = 0;
+
+	if ((fds == NULL && count > 0) || (data == NULL && size > 0) || size > G_MAXUINT32)
+		@throw [OFInvalidArgumentException exception];
+
+	g_mutex_lock(&_sendMutex);
+
+	do {
+		guint fdCount = (guint)MIN(count - sent, _maxFdsPerMessage);
+		gsize payloadSize = (sent == 0 ? size : 0);
+		BatchHeader header = { fdCount, (guint32)payloadSize, (sent + fdCount < count) };
+		struct iovec iov[2] = {
+			{ &header, sizeof(header) },
+			{ (gpointer)data, payloadSize }
+		};
+
+		if (!sendMessage(_socket, iov, (payloadSize > 0 ? 2 : 1), fds + sent, fdCount, _sendControl, [cancellable castedGObject], &err))
+			break;
+
+		sent += fdCount;
+	} while (sent < count);
+
+	g_mutex_unlock(&_sendMutex);
+
+	[OGErrorException throwForError:err];
+}
+
+- (GBytes*)receiveFdsIntoArray:(GArray*)fds cancellable:(OGCancellable*)cancellable
+{
+	GCancellable* gcancellable = [cancellable castedGObject];
+	GError* err = NULL;
+	GBytes* payload = NULL;
+	guint start;
+	bool more = true;
+
+	if (fds == NULL || g_array_get_element_size(fds) != sizeof(gint))
+		@throw [OFInvalidArgumentException exception];
+
+	start = fds->len;
+
+	g_mutex_lock(&_receiveMutex);
+
+	while (more) {
+		BatchHeader header;
+		gboolean truncated = FALSE;
+		guint before = fds->len;
+
+		if (!receiveHeader(_socket, &header, _receiveControl, _controlSize, fds, &truncated, gcancellable, &err))
+			break;
+
+		if (truncated || fds->len - before != header.fdCount) {
+			g_set_error_literal(&err, G_IO_ERROR, G_IO_ERROR_FAILED, "File descriptors were lost in transfer");
+			break;
+		}
+
+		if (header.payloadSize > 0) {
+			guint8* buffer = g_malloc(header.payloadSize);
+
+			if (!receiveAll(_socket, buffer, header.payloadSize, gcancellable, &err)) {
+				g_free(buffer);
+				break;
+			}
+
+			if (payload != NULL)
+				g_bytes_unref(payload);
+
+			payload = g_bytes_new_take(buffer, header.payloadSize);
+		}
+
+		more = (header.more != 0);
+	}
+
+	g_mutex_unlock(&_receiveMutex);
+
+	if (err != NULL) {
+		for (guint i = start; i < fds->len; i++)
+			close(g_array_index(fds, gint, i));
+
+		g_array_set_size(fds, start);
+
+		if (payload != NULL)
+			g_bytes_unref(payload);
+
+		[OGErrorException throwForError:err];
+	}
+
+	if (payload == NULL)
+		payload = g_bytes_new(NULL, 0);
+
+	return payload;
+}
+
+@end
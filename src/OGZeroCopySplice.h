@@ -0,0 +1,128 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+@class OGCancellable;
+@class OGIOStream;
+@class OGInputStream;
+@class OGOutputStream;
+
+/**
+ * `OGZeroCopySplice` provides drop-in replacements for
+ * -[OGOutputStream spliceWithSource:flags:cancellable:] and
+ * -[OGIOStream spliceAsyncWithStream2:flags:ioPriority:cancellable:callback:userData:]
+ * that move data between file descriptors inside the kernel.
+ *
+ * When both ends implement #GFileDescriptorBased, which is the case for
+ * #GUnixInputStream, #GUnixOutputStream, local file streams and the streams
+ * of a #GSocketConnection, data is moved with copy_file_range() between
+ * regular files, with sendfile() from a regular file and with splice()
+ * through a pooled pipe otherwise. If the kernel refuses one method, the next
+ * one is tried, down to a plain read()/write() loop. Streams that are not
+ * file descriptor based, such as buffered, converter or TLS streams, are
+ * passed on to the regular GIO implementation.
+ *
+ * Asynchronous splices between pipes, sockets and other non-file
+ * descriptors are driven by file descriptor sources in the thread-default
+ * main context of the caller and only touch a descriptor once it reported
+ * readiness. When either end is a regular file, the transfer is blocking
+ * disk I/O and runs in a worker thread instead; splices of two
+ * #GIOStream<!-- -->s with such an end are passed on to GIO.
+ *
+ */
+@interface OGZeroCopySplice : OFObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
+
+/**
+ * Checks whether data can be moved from @source to @target without copying
+ * it through user space.
+ *
+ * @param source a #GInputStream
+ * @param target a #GOutputStream
+ * @return whether both streams are file descriptor based
+ */
++ (bool)canSpliceFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target;
+
+/**
+ * Splices @source into @target. See
+ * -[OGOutputStream spliceWithSource:flags:cancellable:].
+ *
+ * @param source a #GInputStream.
+ * @param target a #GOutputStream.
+ * @param flags a set of #GOutputStreamSpliceFlags.
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @return a #gssize containing the size of the data spliced, clamped to
+ *     %G_MAXSSIZE
+ */
++ (gssize)spliceFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target flags:(GOutputStreamSpliceFlags)flags cancellable:(OGCancellable*)cancellable;
+
+/**
+ * Splices @source into @target asynchronously. See
+ * -[OGOutputStream spliceAsyncWithSource:flags:ioPriority:cancellable:callback:userData:].
+ *
+ * @param source a #GInputStream.
+ * @param target a #GOutputStream.
+ * @param flags a set of #GOutputStreamSpliceFlags.
+ * @param ioPriority the io priority of the request.
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @param callback a #GAsyncReadyCallback
+ *   to call when the request is satisfied
+ * @param userData the data to pass to callback function
+ */
++ (void)spliceAsyncFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target flags:(GOutputStreamSpliceFlags)flags ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData;
+
+/**
+ * Finishes an asynchronous splice started with
+ * +spliceAsyncFromStream:toStream:flags:ioPriority:cancellable:callback:userData:.
+ *
+ * @param result a #GAsyncResult.
+ * @return a #gssize of the number of bytes spliced, clamped to
+ *     %G_MAXSSIZE
+ */
++ (gssize)spliceFinishWithResult:(GAsyncResult*)result;
+
+/**
+ * Asynchronously splices the input stream of @stream1 into the output
+ * stream of @stream2 and the input stream of @stream2 into the output stream
+ * of @stream1. See
+ * -[OGIOStream spliceAsyncWithStream2:flags:ioPriority:cancellable:callback:userData:].
+ *
+ * @param stream1 a #GIOStream.
+ * @param stream2 a #GIOStream.
+ * @param flags a set of #GIOStreamSpliceFlags.
+ * @param ioPriority the io priority of the request.
+ * @param cancellable optional #GCancellable object, %NULL to ignore.
+ * @param callback a #GAsyncReadyCallback
+ *   to call when the request is satisfied
+ * @param userData the data to pass to callback function
+ */
++ (void)spliceAsyncWithStream1:(OGIOStream*)stream1 stream2:(OGIOStream*)stream2 flags:(GIOStreamSpliceFlags)flags ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData;
+
+/**
+ * Finishes an asynchronous splice started with
+ * +spliceAsyncWithStream1:stream2:flags:ioPriority:cancellable:callback:userData:.
+ *
+ * @param result a #GAsyncResult.
+ * @return %TRUE on success, %FALSE otherwise.
+ */
++ (bool)spliceStreamsFinishWithResult:(GAsyncResult*)result;
+
+@end
@@ -0,0 +1,831 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#ifndef _GNU_SOURCE
+# define _GNU_SOURCE
+#endif
+
+#import "OGZeroCopySplice.h"
+
+#import "OGCancellable.h"
+#import "OGIOStream.h"
+#import "OGInputStream.h"
+#import "OGOutputStream.h"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <glib-unix.h>
+
+#ifdef __linux__
+# include <sys/sendfile.h>
+#endif
+
+#define CHUNK_SIZE (1024 * 1024)
+#define COPY_BUFFER_SIZE (64 * 1024)
+#define PIPE_POOL_SIZE 32
+#define STEPS_PER_DISPATCH 8
+
+typedef enum {
+	MODE_COPY_FILE_RANGE,
+	MODE_SENDFILE,
+	MODE_SPLICE,
+	MODE_COPY
+} SpliceMode;
+
+typedef enum {
+	STEP_PROGRESS,
+	STEP_WAIT_IN,
+	STEP_WAIT_OUT,
+	STEP_EOF,
+	STEP_ERROR
+} SpliceStep;
+
+typedef struct {
+	int in;
+	int out;
+	SpliceMode mode;
+	bool nonblocking;
+	int pipe[2];
+	gsize pipeFill;
+	guint8* buffer;
+	gsize bufferSize;
+	gsize bufferStart;
+	gsize bufferEnd;
+	guint64 transferred;
+} SpliceChannel;
+
+typedef struct _AsyncChannel AsyncChannel;
+typedef void (*AsyncChannelDone)(AsyncChannel* channel, GError* error);
+
+struct _AsyncChannel {
+	SpliceChannel channel;
+	GMainContext* context;
+	GCancellable* cancellable;
+	int priority;
+	GSource* source;
+	AsyncChannelDone done;
+	gpointer owner;
+};
+
+typedef struct {
+	GInputStream* source;
+	GOutputStream* target;
+	GOutputStreamSpliceFlags flags;
+	AsyncChannel channel;
+} SpliceData;
+
+typedef struct {
+	GIOStream* stream1;
+	GIOStream* stream2;
+	GIOStreamSpliceFlags flags;
+	AsyncChannel forward;
+	AsyncChannel backward;
+	int remaining;
+	GError* error;
+} StreamSpliceData;
+
+static GMutex pipePoolMutex;
+static GQueue pipePool = G_QUEUE_INIT;
+
+static bool pipeAcquire(int fds[2])
+{
+	g_mutex_lock(&pipePoolMutex);
+	int* pooled = g_queue_pop_head(&pipePool);
+	g_mutex_unlock(&pipePoolMutex);
+
+	if (pooled != NULL) {
+		fds[0] = pooled[0];
+		fds[1] = pooled[1];
+		g_free(pooled);
+		return true;
+	}
+
+#ifdef __linux__
+	if (pipe2(fds, O_CLOEXEC | O_NONBLOCK) != 0)
+		return false;
+
+	/* Larger pipes mean fewer round trips; the limit may forbid it. */
+	fcntl(fds[1], F_SETPIPE_SZ, CHUNK_SIZE);
+
+	return true;
+#else
+	return false;
+#endif
+}
+
+static void pipeRelease(int fds[2], bool empty)
+{
+	if (empty) {
+		g_mutex_lock(&pipePoolMutex);
+
+		if (pipePool.length < PIPE_POOL_SIZE) {
+			int* pooled = g_new(int, 2);
+			pooled[0] = fds[0];
+			pooled[1] = fds[1];
+			g_queue_push_head(&pipePool, pooled);
+			fds = NULL;
+		}
+
+		g_mutex_unlock(&pipePoolMutex);
+	}
+
+	if (fds != NULL) {
+		close(fds[0]);
+		close(fds[1]);
+	}
+}
+
+static int inputStreamFd(GInputStream* stream)
+{
+	if (!G_IS_FILE_DESCRIPTOR_BASED(stream))
+		return -1;
+
+	return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(stream));
+}
+
+static int outputStreamFd(GOutputStream* stream)
+{
+	if (!G_IS_FILE_DESCRIPTOR_BASED(stream))
+		return -1;
+
+	return g_file_descriptor_based_get_fd(G_FILE_DESCRIPTOR_BASED(stream));
+}
+
+static bool isRegularFile(int fd)
+{
+	struct stat st;
+
+	return (fstat(fd, &st) == 0 && S_ISREG(st.st_mode));
+}
+
+static bool isNonBlocking(int fd)
+{
+	int flags = fcntl(fd, F_GETFL);
+
+	return (flags >= 0 && (flags & O_NONBLOCK));
+}
+
+/* Whether moving data between @in and @out is disk I/O that may block. */
+static bool isFileTransfer(int in, int out)
+{
+	return (isRegularFile(in) || isRegularFile(out));
+}
+
+static void channelInit(SpliceChannel* channel, int in, int out)
+{
+	memset(channel, 0, sizeof(*channel));
+	channel->in = in;
+	channel->out = out;
+	channel->nonblocking = (isNonBlocking(in) && isNonBlocking(out));
+	channel->pipe[0] = channel->pipe[1] = -1;
+
+#ifdef __linux__
+	bool inRegular = isRegularFile(in);
+	bool outRegular = isRegularFile(out);
+
+	if (inRegular && outRegular)
+		channel->mode = MODE_COPY_FILE_RANGE;
+	else if (inRegular)
+		channel->mode = MODE_SENDFILE;
+	else
+		channel->mode = MODE_SPLICE;
+#else
+	channel->mode = MODE_COPY;
+#endif
+}
+
+static void channelClear(SpliceChannel* channel)
+{
+	if (channel->pipe[0] >= 0)
+		pipeRelease(channel->pipe, channel->pipeFill == 0);
+
+	g_free(channel->buffer);
+
+	channel->pipe[0] = channel->pipe[1] = -1;
+	channel->buffer = NULL;
+}
+
+static bool isUnsupported(int error)
+{
+	return (error == EINVAL || error == ENOSYS || error == EXDEV || error == EOPNOTSUPP || error == EBADF);
+}
+
+static bool wouldBlock(int error)
+{
+	return (error == EAGAIN || error == EWOULDBLOCK);
+}
+
+/*
+ * Moves whatever is left in the pipe into the copy buffer, so a channel
+ * whose target refuses splice() can continue in copy mode.
+ */
+static bool channelDrainPipe(SpliceChannel* channel)
+{
+	channel->bufferSize = MAX(COPY_BUFFER_SIZE, channel->pipeFill);
+	channel->buffer = g_malloc(channel->bufferSize);
+	channel->bufferStart = channel->bufferEnd = 0;
+
+	while (channel->pipeFill > 0) {
+		ssize_t n = read(channel->pipe[0], channel->buffer + channel->bufferEnd, channel->pipeFill);
+
+		if (n < 0 && errno == EINTR)
+			continue;
+		if (n <= 0)
+			return false;
+
+		channel->bufferEnd += n;
+		channel->pipeFill -= n;
+	}
+
+	return true;
+}
+
+/* Performs one non-blocking transfer step. */
+static SpliceStep channelStep(SpliceChannel* channel, GError** error)
+{
+	ssize_t n;
+
+	switch (channel->mode) {
+#ifdef __linux__
+	case MODE_COPY_FILE_RANGE:
+		n = copy_file_range(channel->in, NULL, channel->out, NULL, CHUNK_SIZE, 0);
+
+		if (n > 0) {
+			channel->transferred += n;
+			return STEP_PROGRESS;
+		}
+		if (n == 0)
+			return STEP_EOF;
+		if (errno == EINTR)
+			return STEP_PROGRESS;
+		if (isUnsupported(errno)) {
+			channel->mode = MODE_SENDFILE;
+			return STEP_PROGRESS;
+		}
+		break;
+
+	case MODE_SENDFILE:
+		n = sendfile(channel->out, channel->in, NULL, CHUNK_SIZE);
+
+		if (n > 0) {
+			channel->transferred += n;
+			return STEP_PROGRESS;
+		}
+		if (n == 0)
+			return STEP_EOF;
+		if (errno == EINTR)
+			return STEP_PROGRESS;
+		if (wouldBlock(errno))
+			return STEP_WAIT_OUT;
+		if (isUnsupported(errno)) {
+			channel->mode = MODE_SPLICE;
+			return STEP_PROGRESS;
+		}
+		break;
+
+	case MODE_SPLICE:
+		if (channel->pipe[0] < 0 && !pipeAcquire(channel->pipe)) {
+			channel->mode = MODE_COPY;
+			return STEP_PROGRESS;
+		}
+
+		if (channel->pipeFill == 0) {
+			n = splice(channel->in, NULL, channel->pipe[1], NULL, CHUNK_SIZE, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+			if (n > 0) {
+				channel->pipeFill = n;
+				return STEP_PROGRESS;
+			}
+			if (n == 0)
+				return STEP_EOF;
+			if (errno == EINTR)
+				return STEP_PROGRESS;
+			if (wouldBlock(errno))
+				return STEP_WAIT_IN;
+			if (isUnsupported(errno)) {
+				channel->mode = MODE_COPY;
+				return STEP_PROGRESS;
+			}
+		} else {
+			n = splice(channel->pipe[0], NULL, channel->out, NULL, channel->pipeFill, SPLICE_F_MOVE | SPLICE_F_NONBLOCK);
+
+			if (n > 0) {
+				channel->pipeFill -= n;
+				channel->transferred += n;
+				return STEP_PROGRESS;
+			}
+			if (n < 0 && errno == EINTR)
+				return STEP_PROGRESS;
+			if (n < 0 && wouldBlock(errno))
+				return STEP_WAIT_OUT;
+			if (n < 0 && isUnsupported(errno) && channelDrainPipe(channel)) {
+				channel->mode = MODE_COPY;
+				return STEP_PROGRESS;
+			}
+		}
+		break;
+#endif
+
+	case MODE_COPY:
+		if (channel->buffer == NULL) {
+			channel->bufferSize = COPY_BUFFER_SIZE;
+			channel->buffer = g_malloc(channel->bufferSize);
+		}
+
+		if (channel->bufferStart == channel->bufferEnd) {
+			channel->bufferStart = channel->bufferEnd = 0;
+			n = read(channel->in, channel->buffer, channel->bufferSize);
+
+			if (n > 0) {
+				channel->bufferEnd = n;
+				return STEP_PROGRESS;
+			}
+			if (n == 0)
+				return STEP_EOF;
+			if (errno == EINTR)
+				return STEP_PROGRESS;
+			if (wouldBlock(errno))
+				return STEP_WAIT_IN;
+		} else {
+			n = write(channel->out, channel->buffer + channel->bufferStart, channel->bufferEnd - channel->bufferStart);
+
+			if (n > 0) {
+				channel->bufferStart += n;
+				channel->transferred += n;
+				return STEP_PROGRESS;
+			}
+			if (n < 0 && errno == EINTR)
+				return STEP_PROGRESS;
+			if (n < 0 && wouldBlock(errno))
+				return STEP_WAIT_OUT;
+		}
+		break;
+
+	default:
+		break;
+	}
+
+	int savedErrno = (errno != 0) ? errno : EIO;
+	g_set_error(error, G_IO_ERROR, g_io_error_from_errno(savedErrno), "Error splicing: %s", g_strerror(savedErrno));
+
+	return STEP_ERROR;
+}
+
+static bool waitForFd(int fd, GIOCondition condition, GCancellable* cancellable, GError** error)
+{
+	GPollFD fds[2] = { { fd, (gushort)condition, 0 } };
+	guint nfds = 1;
+	int result;
+
+	if (cancellable != NULL && g_cancellable_make_pollfd(cancellable, &fds[1]))
+		nfds = 2;
+
+	do {
+		result = g_poll(fds, nfds, -1);
+	} while (result < 0 && errno == EINTR);
+
+	if (nfds == 2)
+		g_cancellable_release_fd(cancellable);
+
+	return !g_cancellable_set_error_if_cancelled(cancellable, error);
+}
+
+static gssize channelRunSync(SpliceChannel* channel, GCancellable* cancellable, GError** error)
+{
+	for (;;) {
+		if (g_cancellable_set_error_if_cancelled(cancellable, error))
+			return -1;
+
+		switch (channelStep(channel, error)) {
+		case STEP_PROGRESS:
+			break;
+		case STEP_WAIT_IN:
+			if (!waitForFd(channel->in, G_IO_IN, cancellable, error))
+				return -1;
+			break;
+		case STEP_WAIT_OUT:
+			if (!waitForFd(channel->out, G_IO_OUT, cancellable, error))
+				return -1;
+			break;
+		case STEP_EOF:
+			return (gssize)MIN(channel->transferred, (guint64)G_MAXSSIZE);
+		case STEP_ERROR:
+			return -1;
+		}
+	}
+}
+
+static bool setPending(GInputStream* source, GOutputStream* target, GError** error)
+{
+	if (!g_input_stream_set_pending(source, error))
+		return false;
+
+	if (!g_output_stream_set_pending(target, error)) {
+		g_input_stream_clear_pending(source);
+		return false;
+	}
+
+	return true;
+}
+
+static void clearPending(GInputStream* source, GOutputStream* target)
+{
+	g_input_stream_clear_pending(source);
+	g_output_stream_clear_pending(target);
+}
+
+/* Closes the streams requested by @flags, keeping the first error. */
+static void closeStreams(GInputStream* source, GOutputStream* target, GOutputStreamSpliceFlags flags, GError** error)
+{
+	if (flags & G_OUTPUT_STREAM_SPLICE_CLOSE_SOURCE)
+		g_input_stream_close(source, NULL, (error != NULL && *error == NULL) ? error : NULL);
+
+	if (flags & G_OUTPUT_STREAM_SPLICE_CLOSE_TARGET)
+		g_output_stream_close(target, NULL, (error != NULL && *error == NULL) ? error : NULL);
+}
+
+static void asyncChannelRun(AsyncChannel* channel);
+
+static void asyncChannelStop(AsyncChannel* channel)
+{
+	if (channel->source == NULL)
+		return;
+
+	g_source_destroy(channel->source);
+	g_source_unref(channel->source);
+	channel->source = NULL;
+}
+
+static gboolean asyncChannelFdReady(gint fd, GIOCondition condition, gpointer userData)
+{
+	AsyncChannel* channel = userData;
+
+	asyncChannelStop(channel);
+	asyncChannelRun(channel);
+
+	return G_SOURCE_REMOVE;
+}
+
+static gboolean asyncChannelIdle(gpointer userData)
+{
+	AsyncChannel* channel = userData;
+
+	asyncChannelStop(channel);
+	asyncChannelRun(channel);
+
+	return G_SOURCE_REMOVE;
+}
+
+static void asyncChannelWait(AsyncChannel* channel, int fd, GIOCondition condition)
+{
+	GSource* source;
+
+	if (fd >= 0) {
+		source = g_unix_fd_source_new(fd, condition | G_IO_ERR | G_IO_HUP);
+		g_source_set_callback(source, G_SOURCE_FUNC(asyncChannelFdReady), channel, NULL);
+	} else {
+		source = g_idle_source_new();
+		g_source_set_callback(source, asyncChannelIdle, channel, NULL);
+	}
+
+	if (channel->cancellable != NULL) {
+		GSource* cancellableSource = g_cancellable_source_new(channel->cancellable);
+		g_source_set_dummy_callback(cancellableSource);
+		g_source_add_child_source(source, cancellableSource);
+		g_source_unref(cancellableSource);
+	}
+
+	g_source_set_priority(source, channel->priority);
+	g_source_attach(source, channel->context);
+	channel->source = source;
+}
+
+/* Waits for the descriptor the next step of the channel will use. */
+static void asyncChannelWaitNext(AsyncChannel* channel)
+{
+	SpliceChannel* spliceChannel = &channel->channel;
+	bool output;
+
+	switch (spliceChannel->mode) {
+	case MODE_SPLICE:
+		output = (spliceChannel->pipeFill > 0);
+		break;
+	case MODE_COPY:
+		output = (spliceChannel->bufferStart != spliceChannel->bufferEnd);
+		break;
+	default:
+		output = false;
+		break;
+	}
+
+	if (output)
+		asyncChannelWait(channel, spliceChannel->out, G_IO_OUT);
+	else
+		asyncChannelWait(channel, spliceChannel->in, G_IO_IN);
+}
+
+static void asyncChannelRun(AsyncChannel* channel)
+{
+	for (int i = 0; i < STEPS_PER_DISPATCH; i++) {
+		GError* error = NULL;
+
+		if (g_cancellable_set_error_if_cancelled(channel->cancellable, &error)) {
+			channel->done(channel, error);
+			return;
+		}
+
+		switch (channelStep(&channel->channel, &error)) {
+		case STEP_PROGRESS:
+			/* A blocking descriptor is only touched after it reported
+			 * readiness, or the step would stall the main context. */
+			if (!channel->channel.nonblocking) {
+				asyncChannelWaitNext(channel);
+				return;
+			}
+			break;
+		case STEP_WAIT_IN:
+			asyncChannelWait(channel, channel->channel.in, G_IO_IN);
+			return;
+		case STEP_WAIT_OUT:
+			asyncChannelWait(channel, channel->channel.out, G_IO_OUT);
+			return;
+		case STEP_EOF:
+			channel->done(channel, NULL);
+			return;
+		case STEP_ERROR:
+			channel->done(channel, error);
+			return;
+		}
+	}
+
+	/* Let other sources run before continuing a long transfer. */
+	asyncChannelWait(channel, -1, 0);
+}
+
+static void asyncChannelInit(AsyncChannel* channel, int in, int out, GTask* task, int priority, AsyncChannelDone done)
+{
+	channelInit(&channel->channel, in, out);
+	channel->context = g_task_get_context(task);
+	channel->cancellable = g_task_get_cancellable(task);
+	channel->priority = priority;
+	channel->done = done;
+	channel->owner = task;
+}
+
+static void asyncChannelClear(AsyncChannel* channel)
+{
+	asyncChannelStop(channel);
+	channelClear(&channel->channel);
+}
+
+static void spliceDataFree(SpliceData* data)
+{
+	asyncChannelClear(&data->channel);
+	g_object_unref(data->source);
+	g_object_unref(data->target);
+	g_free(data);
+}
+
+static void streamSpliceDataFree(StreamSpliceData* data)
+{
+	asyncChannelClear(&data->forward);
+	asyncChannelClear(&data->backward);
+	g_object_unref(data->stream1);
+	g_object_unref(data->stream2);
+	g_clear_error(&data->error);
+	g_free(data);
+}
+
+static void spliceDone(AsyncChannel* channel, GError* error)
+{
+	GTask* task = channel->owner;
+	SpliceData* data = g_task_get_task_data(task);
+
+	clearPending(data->source, data->target);
+	closeStreams(data->source, data->target, data->flags, &error);
+
+	if (error != NULL)
+		g_task_return_error(task, error);
+	else
+		g_task_return_int(task, (gssize)MIN(channel->channel.transferred, (guint64)G_MAXSSIZE));
+
+	g_object_unref(task);
+}
+
+/* Runs a splice from or to a regular file, which is blocking disk I/O. */
+static void spliceThread(GTask* task, gpointer sourceObject, gpointer taskData, GCancellable* cancellable)
+{
+	SpliceData* data = taskData;
+	GError* error = NULL;
+	gssize transferred = channelRunSync(&data->channel.channel, cancellable, &error);
+
+	clearPending(data->source, data->target);
+	closeStreams(data->source, data->target, data->flags, &error);
+
+	if (error != NULL)
+		g_task_return_error(task, error);
+	else
+		g_task_return_int(task, transferred);
+}
+
+static void streamSpliceDone(AsyncChannel* channel, GError* error)
+{
+	GTask* task = channel->owner;
+	StreamSpliceData* data = g_task_get_task_data(task);
+
+	if (error != NULL) {
+		if (data->error == NULL)
+			data->error = error;
+		else
+			g_error_free(error);
+	}
+
+	data->remaining--;
+
+	if (data->remaining > 0 && data->error == NULL && (data->flags & G_IO_STREAM_SPLICE_WAIT_FOR_BOTH))
+		return;
+
+	/* Stop whichever direction is still running. */
+	asyncChannelStop(&data->forward);
+	asyncChannelStop(&data->backward);
+
+	clearPending(g_io_stream_get_input_stream(data->stream1), g_io_stream_get_output_stream(data->stream2));
+	clearPending(g_io_stream_get_input_stream(data->stream2), g_io_stream_get_output_stream(data->stream1));
+
+	if (data->flags & G_IO_STREAM_SPLICE_CLOSE_STREAM1)
+		g_io_stream_close(data->stream1, NULL, (data->error == NULL) ? &data->error : NULL);
+
+	if (data->flags & G_IO_STREAM_SPLICE_CLOSE_STREAM2)
+		g_io_stream_close(data->stream2, NULL, (data->error == NULL) ? &data->error : NULL);
+
+	if (data->error != NULL)
+		g_task_return_error(task, g_steal_pointer(&data->error));
+	else
+		g_task_return_boolean(task, TRUE);
+
+	g_object_unref(task);
+}
+
+@implementation OGZeroCopySplice
+
++ (bool)canSpliceFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target
+{
+	return (inputStreamFd([source castedGObject]) >= 0 && outputStreamFd([target castedGObject]) >= 0);
+}
+
++ (gssize)spliceFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target flags:(GOutputStreamSpliceFlags)flags cancellable:(OGCancellable*)cancellable
+{
+	GInputStream* gsource = [source castedGObject];
+	GOutputStream* gtarget = [target castedGObject];
+	int in = inputStreamFd(gsource);
+	int out = outputStreamFd(gtarget);
+	GError* err = NULL;
+
+	if (in < 0 || out < 0)
+		return [target spliceWithSource:source flags:flags cancellable:cancellable];
+
+	if (!setPending(gsource, gtarget, &err))
+		[OGErrorException throwForError:err];
+
+	SpliceChannel channel;
+	channelInit(&channel, in, out);
+
+	gssize returnValue = channelRunSync(&channel, [cancellable castedGObject], &err);
+
+	channelClear(&channel);
+	clearPending(gsource, gtarget);
+	closeStreams(gsource, gtarget, flags, &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
++ (void)spliceAsyncFromStream:(OGInputStream*)source toStream:(OGOutputStream*)target flags:(GOutputStreamSpliceFlags)flags ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData
+{
+	GInputStream* gsource = [source castedGObject];
+	GOutputStream* gtarget = [target castedGObject];
+	int in = inputStreamFd(gsource);
+	int out = outputStreamFd(gtarget);
+
+	if (in < 0 || out < 0) {
+		[target spliceAsyncWithSource:source flags:flags ioPriority:ioPriority cancellable:cancellable callback:callback userData:userData];
+		return;
+	}
+
+	GTask* task = g_task_new(gtarget, [cancellable castedGObject], callback, userData);
+	g_task_set_source_tag(task, spliceDone);
+	g_task_set_priority(task, ioPriority);
+
+	GError* err = NULL;
+	if (!setPending(gsource, gtarget, &err)) {
+		g_task_return_error(task, err);
+		g_object_unref(task);
+		return;
+	}
+
+	SpliceData* data = g_new0(SpliceData, 1);
+	data->source = g_object_ref(gsource);
+	data->target = g_object_ref(gtarget);
+	data->flags = flags;
+	asyncChannelInit(&data->channel, in, out, task, ioPriority, spliceDone);
+	g_task_set_task_data(task, data, (GDestroyNotify)spliceDataFree);
+
+	if (isFileTransfer(in, out)) {
+		g_task_run_in_thread(task, spliceThread);
+		g_object_unref(task);
+		return;
+	}
+
+	asyncChannelWaitNext(&data->channel);
+}
+
++ (gssize)spliceFinishWithResult:(GAsyncResult*)result
+{
+	GError* err = NULL;
+	gssize returnValue;
+
+	if (g_async_result_is_tagged(result, spliceDone))
+		returnValue = g_task_propagate_int(G_TASK(result), &err);
+	else {
+		GObject* target = g_async_result_get_source_object(result);
+		returnValue = g_output_stream_splice_finish(G_OUTPUT_STREAM(target), result, &err);
+		g_object_unref(target);
+	}
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
++ (void)spliceAsyncWithStream1:(OGIOStream*)stream1 stream2:(OGIOStream*)stream2 flags:(GIOStreamSpliceFlags)flags ioPriority:(int)ioPriority cancellable:(OGCancellable*)cancellable callback:(GAsyncReadyCallback)callback userData:(gpointer)userData
+{
+	GIOStream* gstream1 = [stream1 castedGObject];
+	GIOStream* gstream2 = [stream2 castedGObject];
+	GInputStream* input1 = g_io_stream_get_input_stream(gstream1);
+	GOutputStream* output1 = g_io_stream_get_output_stream(gstream1);
+	GInputStream* input2 = g_io_stream_get_input_stream(gstream2);
+	GOutputStream* output2 = g_io_stream_get_output_stream(gstream2);
+
+	int in1 = inputStreamFd(input1);
+	int out1 = outputStreamFd(output1);
+	int in2 = inputStreamFd(input2);
+	int out2 = outputStreamFd(output2);
+
+	if (in1 < 0 || out1 < 0 || in2 < 0 || out2 < 0 || isFileTransfer(in1, out2) || isFileTransfer(in2, out1)) {
+		[stream1 spliceAsyncWithStream2:stream2 flags:flags ioPriority:ioPriority cancellable:cancellable callback:callback userData:userData];
+		return;
+	}
+
+	GTask* task = g_task_new(NULL, [cancellable castedGObject], callback, userData);
+	g_task_set_source_tag(task, streamSpliceDone);
+	g_task_set_priority(task, ioPriority);
+
+	GError* err = NULL;
+	if (!setPending(input1, output2, &err)) {
+		g_task_return_error(task, err);
+		g_object_unref(task);
+		return;
+	}
+	if (!setPending(input2, output1, &err)) {
+		clearPending(input1, output2);
+		g_task_return_error(task, err);
+		g_object_unref(task);
+		return;
+	}
+
+	StreamSpliceData* data = g_new0(StreamSpliceData, 1);
+	data->stream1 = g_object_ref(gstream1);
+	data->stream2 = g_object_ref(gstream2);
+	data->flags = flags;
+	data->remaining = 2;
+	asyncChannelInit(&data->forward, in1, out2, task, ioPriority, streamSpliceDone);
+	asyncChannelInit(&data->backward, in2, out1, task, ioPriority, streamSpliceDone);
+	g_task_set_task_data(task, data, (GDestroyNotify)streamSpliceDataFree);
+
+	asyncChannelWaitNext(&data->forward);
+	asyncChannelWaitNext(&data->backward);
+}
+
++ (bool)spliceStreamsFinishWithResult:(GAsyncResult*)result
+{
+	GError* err = NULL;
+	bool returnValue;
+
+	if (g_async_result_is_tagged(result, streamSpliceDone))
+		returnValue = (bool)g_task_propagate_boolean(G_TASK(result), &err);
+	else
+		returnValue = (bool)g_io_stream_splice_finish(result, &err);
+
+	[OGErrorException throwForError:err];
+
+	return returnValue;
+}
+
+@end
@@ -0,0 +1,74 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_ZSTD_COMPRESSOR (ogio_zstd_compressor_get_type())
+G_DECLARE_FINAL_TYPE(OGioZstdCompressor, ogio_zstd_compressor, OGIO, ZSTD_COMPRESSOR, GObject)
+
+OGioZstdCompressor* ogio_zstd_compressor_new(int level, GBytes* dictionary);
+int ogio_zstd_compressor_get_level(OGioZstdCompressor* compressor);
+
+G_END_DECLS
+
+/**
+ * `OGZstdCompressor` is an implementation of [iface@Gio.Converter] that
+ * compresses data into Zstandard frames.
+ *
+ * Each conversion until g_converter_reset() produces one frame carrying a
+ * content checksum. %G_CONVERTER_FLUSH ends the current block so that
+ * everything written so far can be decompressed by the peer, which makes
+ * the compressor usable for framed protocols.
+ *
+ * Levels range from negative "fast" levels up to 22; level 0 selects the
+ * library default (3). An optional dictionary trained with `zstd --train`
+ * improves the ratio on small, similar payloads; the decompressor has to be
+ * given the same dictionary.
+ *
+ */
+@interface OGZstdCompressor : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)zstdCompressorWithLevel:(int)level;
+
++ (instancetype)zstdCompressorWithLevel:(int)level dictionary:(GBytes*)dictionary;
+
+/**
+ * Methods
+ */
+
+- (OGioZstdCompressor*)castedGObject;
+
+/**
+ * Returns the compression level the compressor was created with.
+ *
+ * @return the compression level
+ */
+- (int)level;
+
+@end
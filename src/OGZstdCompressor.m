@@ -0,0 +1,192 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGZstdCompressor.h"
+
+#include <zstd.h>
+
+struct _OGioZstdCompressor {
+	GObject parent_instance;
+
+	ZSTD_CCtx* context;
+	int level;
+};
+
+static void ogio_zstd_compressor_converter_init(GConverterIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioZstdCompressor, ogio_zstd_compressor, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, ogio_zstd_compressor_converter_init))
+
+static GConverterResult ogio_zstd_compressor_convert(GConverter* converter, const void* inbuf, gsize inbufSize, void* outbuf, gsize outbufSize, GConverterFlags flags, gsize* bytesRead, gsize* bytesWritten, GError** error)
+{
+	OGioZstdCompressor* self = OGIO_ZSTD_COMPRESSOR(converter);
+	ZSTD_inBuffer input = { inbuf, inbufSize, 0 };
+	ZSTD_outBuffer output = { outbuf, outbufSize, 0 };
+	ZSTD_EndDirective directive = ZSTD_e_continue;
+
+	if (flags & G_CONVERTER_INPUT_AT_END)
+		directive = ZSTD_e_end;
+	else if (flags & G_CONVERTER_FLUSH)
+		directive = ZSTD_e_flush;
+
+	size_t remaining = ZSTD_compressStream2(self->context, &output, &input, directive);
+	if (ZSTD_isError(remaining)) {
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_FAILED, "Zstandard compression failed: %s", ZSTD_getErrorName(remaining));
+		return G_CONVERTER_ERROR;
+	}
+
+	*bytesRead = input.pos;
+	*bytesWritten = output.pos;
+
+	if (directive == ZSTD_e_end && remaining == 0 && input.pos == inbufSize)
+		return G_CONVERTER_FINISHED;
+
+	if (directive == ZSTD_e_flush && remaining == 0 && input.pos == inbufSize)
+		return G_CONVERTER_FLUSHED;
+
+	if (input.pos == 0 && output.pos == 0) {
+		if (directive == ZSTD_e_continue && inbufSize == 0)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Need more input");
+		else
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Not enough space in output buffer");
+
+		return G_CONVERTER_ERROR;
+	}
+
+	return G_CONVERTER_CONVERTED;
+}
+
+static void ogio_zstd_compressor_reset(GConverter* converter)
+{
+	OGioZstdCompressor* self = OGIO_ZSTD_COMPRESSOR(converter);
+
+	/* Keeps the level and the dictionary. */
+	ZSTD_CCtx_reset(self->context, ZSTD_reset_session_only);
+}
+
+static void ogio_zstd_compressor_converter_init(GConverterIface* iface)
+{
+	iface->convert = ogio_zstd_compressor_convert;
+	iface->reset = ogio_zstd_compressor_reset;
+}
+
+static void ogio_zstd_compressor_finalize(GObject* object)
+{
+	OGioZstdCompressor* self = OGIO_ZSTD_COMPRESSOR(object);
+
+	ZSTD_freeCCtx(self->context);
+
+	G_OBJECT_CLASS(ogio_zstd_compressor_parent_class)->finalize(object);
+}
+
+static void ogio_zstd_compressor_init(OGioZstdCompressor* self)
+{
+	self->context = ZSTD_createCCtx();
+}
+
+static void ogio_zstd_compressor_class_init(OGioZstdCompressorClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_zstd_compressor_finalize;
+}
+
+OGioZstdCompressor* ogio_zstd_compressor_new(int level, GBytes* dictionary)
+{
+	g_return_val_if_fail(level >= ZSTD_minCLevel() && level <= ZSTD_maxCLevel(), NULL);
+
+	OGioZstdCompressor* self = g_object_new(OGIO_TYPE_ZSTD_COMPRESSOR, NULL);
+	self->level = level;
+
+	if (self->context == NULL || ZSTD_isError(ZSTD_CCtx_setParameter(self->context, ZSTD_c_compressionLevel, level)) || ZSTD_isError(ZSTD_CCtx_setParameter(self->context, ZSTD_c_checksumFlag, 1))) {
+		g_object_unref(self);
+		return NULL;
+	}
+
+	if (dictionary != NULL) {
+		gsize size;
+		const void* data = g_bytes_get_data(dictionary, &size);
+
+		if (ZSTD_isError(ZSTD_CCtx_loadDictionary(self->context, data, size))) {
+			g_object_unref(self);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+int ogio_zstd_compressor_get_level(OGioZstdCompressor* compressor)
+{
+	g_return_val_if_fail(OGIO_IS_ZSTD_COMPRESSOR(compressor), 0);
+
+	return compressor->level;
+}
+
+@implementation OGZstdCompressor
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_ZSTD_COMPRESSOR;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_ZSTD_COMPRESSOR);
+	return gObjectClass;
+}
+
++ (instancetype)zstdCompressorWithLevel:(int)level
+{
+	return [self zstdCompressorWithLevel:level dictionary:NULL];
+}
+
++ (instancetype)zstdCompressorWithLevel:(int)level dictionary:(GBytes*)dictionary
+{
+	if (level < ZSTD_minCLevel() || level > ZSTD_maxCLevel())
+		@throw [OFInvalidArgumentException exception];
+
+	OGioZstdCompressor* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_zstd_compressor_new(level, dictionary), OGIO_TYPE_ZSTD_COMPRESSOR, OGioZstdCompressor);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGZstdCompressor* wrapperObject;
+	@try {
+		wrapperObject = [[OGZstdCompressor alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioZstdCompressor*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_ZSTD_COMPRESSOR, OGioZstdCompressor);
+}
+
+- (int)level
+{
+	int returnValue = (int)ogio_zstd_compressor_get_level((OGioZstdCompressor*)[self castedGObject]);
+
+	return returnValue;
+}
+
+@end
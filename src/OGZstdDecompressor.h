@@ -0,0 +1,61 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#include <gio/gdesktopappinfo.h>
+#include <gio/gfiledescriptorbased.h>
+#include <gio/gio.h>
+#include <gio/gunixfdmessage.h>
+#include <gio/gunixinputstream.h>
+#include <gio/gunixmounts.h>
+#include <gio/gunixoutputstream.h>
+
+#import <OGObject/OGObject.h>
+
+G_BEGIN_DECLS
+
+#define OGIO_TYPE_ZSTD_DECOMPRESSOR (ogio_zstd_decompressor_get_type())
+G_DECLARE_FINAL_TYPE(OGioZstdDecompressor, ogio_zstd_decompressor, OGIO, ZSTD_DECOMPRESSOR, GObject)
+
+OGioZstdDecompressor* ogio_zstd_decompressor_new(GBytes* dictionary);
+
+G_END_DECLS
+
+/**
+ * `OGZstdDecompressor` is an implementation of [iface@Gio.Converter] that
+ * decompresses Zstandard frames.
+ *
+ * Concatenated frames are decompressed one after the other. The input must
+ * end on a frame boundary, otherwise the conversion fails with
+ * %G_IO_ERROR_PARTIAL_INPUT. Frames compressed with a dictionary can only be
+ * decompressed if the same dictionary is passed to the constructor.
+ *
+ */
+@interface OGZstdDecompressor : OGObject
+{
+
+}
+
+/**
+ * Functions and class methods
+ */
++ (void)load;
+
++ (GTypeClass*)gObjectClass;
+
+/**
+ * Constructors
+ */
++ (instancetype)zstdDecompressor;
+
++ (instancetype)zstdDecompressorWithDictionary:(GBytes*)dictionary;
+
+/**
+ * Methods
+ */
+
+- (OGioZstdDecompressor*)castedGObject;
+
+@end
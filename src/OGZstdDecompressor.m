@@ -0,0 +1,175 @@
+/*
+ * SPDX-FileCopyrightText: 2015-2017 Tyler Burton <software@tylerburton.ca>
+ * SPDX-FileCopyrightText: 2015-2025 The ObjGTK authors, see AUTHORS file
+ * SPDX-License-Identifier: LGPL-2.1-or-later
+ */
+
+#import "OGZstdDecompressor.h"
+
+#include <zstd.h>
+
+struct _OGioZstdDecompressor {
+	GObject parent_instance;
+
+	ZSTD_DCtx* context;
+	gboolean inFrame;
+};
+
+static void ogio_zstd_decompressor_converter_init(GConverterIface* iface);
+
+G_DEFINE_FINAL_TYPE_WITH_CODE(OGioZstdDecompressor, ogio_zstd_decompressor, G_TYPE_OBJECT,
+	G_IMPLEMENT_INTERFACE(G_TYPE_CONVERTER, ogio_zstd_decompressor_converter_init))
+
+static GConverterResult ogio_zstd_decompressor_convert(GConverter* converter, const void* inbuf, gsize inbufSize, void* outbuf, gsize outbufSize, GConverterFlags flags, gsize* bytesRead, gsize* bytesWritten, GError** error)
+{
+	OGioZstdDecompressor* self = OGIO_ZSTD_DECOMPRESSOR(converter);
+	ZSTD_inBuffer input = { inbuf, inbufSize, 0 };
+	ZSTD_outBuffer output = { outbuf, outbufSize, 0 };
+
+	size_t hint = ZSTD_decompressStream(self->context, &output, &input);
+	if (ZSTD_isError(hint)) {
+		g_set_error(error, G_IO_ERROR, G_IO_ERROR_INVALID_DATA, "Invalid Zstandard data: %s", ZSTD_getErrorName(hint));
+		return G_CONVERTER_ERROR;
+	}
+
+	/* A hint of 0 means the frame has been decoded and fully flushed. */
+	if (input.pos > 0 || output.pos > 0)
+		self->inFrame = (hint != 0);
+
+	*bytesRead = input.pos;
+	*bytesWritten = output.pos;
+
+	if ((flags & G_CONVERTER_INPUT_AT_END) && input.pos == inbufSize && !self->inFrame)
+		return G_CONVERTER_FINISHED;
+
+	if (input.pos == 0 && output.pos == 0) {
+		if (outbufSize == 0)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_NO_SPACE, "Not enough space in output buffer");
+		else if (flags & G_CONVERTER_INPUT_AT_END)
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Truncated Zstandard frame");
+		else if (flags & G_CONVERTER_FLUSH)
+			return G_CONVERTER_FLUSHED;
+		else
+			g_set_error_literal(error, G_IO_ERROR, G_IO_ERROR_PARTIAL_INPUT, "Need more input");
+
+		return G_CONVERTER_ERROR;
+	}
+
+	if ((flags & G_CONVERTER_FLUSH) && input.pos == inbufSize && output.pos < outbufSize)
+		return G_CONVERTER_FLUSHED;
+
+	return G_CONVERTER_CONVERTED;
+}
+
+static void ogio_zstd_decompressor_reset(GConverter* converter)
+{
+	OGioZstdDecompressor* self = OGIO_ZSTD_DECOMPRESSOR(converter);
+
+	/* Keeps the dictionary. */
+	ZSTD_DCtx_reset(self->context, ZSTD_reset_session_only);
+	self->inFrame = FALSE;
+}
+
+static void ogio_zstd_decompressor_converter_init(GConverterIface* iface)
+{
+	iface->convert = ogio_zstd_decompressor_convert;
+	iface->reset = ogio_zstd_decompressor_reset;
+}
+
+static void ogio_zstd_decompressor_finalize(GObject* object)
+{
+	OGioZstdDecompressor* self = OGIO_ZSTD_DECOMPRESSOR(object);
+
+	ZSTD_freeDCtx(self->context);
+
+	G_OBJECT_CLASS(ogio_zstd_decompressor_parent_class)->finalize(object);
+}
+
+static void ogio_zstd_decompressor_init(OGioZstdDecompressor* self)
+{
+	self->context = ZSTD_createDCtx();
+}
+
+static void ogio_zstd_decompressor_class_init(OGioZstdDecompressorClass* klass)
+{
+	GObjectClass* objectClass = G_OBJECT_CLASS(klass);
+
+	objectClass->finalize = ogio_zstd_decompressor_finalize;
+}
+
+OGioZstdDecompressor* ogio_zstd_decompressor_new(GBytes* dictionary)
+{
+	OGioZstdDecompressor* self = g_object_new(OGIO_TYPE_ZSTD_DECOMPRESSOR, NULL);
+
+	if (self->context == NULL) {
+		g_object_unref(self);
+		return NULL;
+	}
+
+	if (dictionary != NULL) {
+		gsize size;
+		const void* data = g_bytes_get_data(dictionary, &size);
+
+		if (ZSTD_isError(ZSTD_DCtx_loadDictionary(self->context, data, size))) {
+			g_object_unref(self);
+			return NULL;
+		}
+	}
+
+	return self;
+}
+
+@implementation OGZstdDecompressor
+
+static GTypeClass *gObjectClass = NULL;
+
++ (void)load
+{
+	GType gtypeToAssociate = OGIO_TYPE_ZSTD_DECOMPRESSOR;
+
+	if (gtypeToAssociate == 0)
+		return;
+
+	g_type_set_qdata(gtypeToAssociate, [super wrapperQuark], [self class]);
+}
+
++ (GTypeClass*)gObjectClass
+{
+	if(gObjectClass != NULL)
+		return gObjectClass;
+
+	gObjectClass = g_type_class_ref(OGIO_TYPE_ZSTD_DECOMPRESSOR);
+	return gObjectClass;
+}
+
++ (instancetype)zstdDecompressor
+{
+	return [self zstdDecompressorWithDictionary:NULL];
+}
+
++ (instancetype)zstdDecompressorWithDictionary:(GBytes*)dictionary
+{
+	OGioZstdDecompressor* gobjectValue = G_TYPE_CHECK_INSTANCE_CAST(ogio_zstd_decompressor_new(dictionary), OGIO_TYPE_ZSTD_DECOMPRESSOR, OGioZstdDecompressor);
+
+	if OF_UNLIKELY(!gobjectValue)
+		@throw [OGObjectGObjectToWrapCreationFailedException exception];
+
+	OGZstdDecompressor* wrapperObject;
+	@try {
+		wrapperObject = [[OGZstdDecompressor alloc] initWithGObject:gobjectValue];
+	} @catch (id e) {
+		g_object_unref(gobjectValue);
+		[wrapperObject release];
+		@throw e;
+	}
+
+	g_object_unref(gobjectValue);
+	return [wrapperObject autorelease];
+}
+
+- (OGioZstdDecompressor*)castedGObject
+{
+	return G_TYPE_CHECK_INSTANCE_CAST([self gObject], OGIO_TYPE_ZSTD_DECOMPRESSOR, OGioZstdDecompressor);
+}
+
+@end
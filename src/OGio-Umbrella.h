@@ -8,17 +8,24 @@
 
 
 // Generated classes
+#import "OGAdaptiveBufferedInputStream.h"
+#import "OGAdaptiveBufferedOutputStream.h"
+#import "OGAdaptiveBuffering.h"
 #import "OGAppInfoMonitor.h"
 #import "OGAppLaunchContext.h"
 #import "OGApplication.h"
 #import "OGApplicationCommandLine.h"
+#import "OGBufferPool.h"
 #import "OGBufferedInputStream.h"
 #import "OGBufferedOutputStream.h"
 #import "OGBytesIcon.h"
+#import "OGCachingTlsDatabase.h"
 #import "OGCancellable.h"
 #import "OGCharsetConverter.h"
+#import "OGChunkedListStore.h"
 #import "OGConverterInputStream.h"
 #import "OGConverterOutputStream.h"
+#import "OGCorkedOutputStream.h"
 #import "OGCredentials.h"
 #import "OGDBusActionGroup.h"
 #import "OGDBusAuthObserver.h"
@@ -33,8 +40,10 @@
 #import "OGDBusObjectSkeleton.h"
 #import "OGDBusProxy.h"
 #import "OGDBusServer.h"
+#import "OGDataArrays.h"
 #import "OGDataInputStream.h"
 #import "OGDataOutputStream.h"
+#import "OGDataRecordSchema.h"
 #import "OGDebugControllerDBus.h"
 #import "OGDesktopAppInfo.h"
 #import "OGEmblem.h"
@@ -45,16 +54,27 @@
 #import "OGFileInfo.h"
 #import "OGFileInputStream.h"
 #import "OGFileMonitor.h"
+#import "OGFileMonitorHub.h"
 #import "OGFileOutputStream.h"
 #import "OGFilenameCompleter.h"
 #import "OGFilterInputStream.h"
+#import "OGFilterListModel.h"
 #import "OGFilterOutputStream.h"
 #import "OGIOStream.h"
+#import "OGIndexedGzipInputStream.h"
 #import "OGInetAddress.h"
 #import "OGInetAddressMask.h"
 #import "OGInetSocketAddress.h"
 #import "OGInputStream.h"
 #import "OGListStore.h"
+#import "OGListStoreSorting.h"
+#if __has_include("OGLz4Compressor.h")
+# import "OGLz4Compressor.h"
+# import "OGLz4Decompressor.h"
+#endif
+#import "OGMapListModel.h"
+#import "OGMappedFileInputStream.h"
+#import "OGMappedSettingsStore.h"
 #import "OGMemoryInputStream.h"
 #import "OGMemoryOutputStream.h"
 #import "OGMenu.h"
@@ -69,12 +89,23 @@
 #import "OGNetworkService.h"
 #import "OGNotification.h"
 #import "OGOutputStream.h"
+#import "OGParallelGzipInputStream.h"
+#import "OGParallelGzipOutputStream.h"
 #import "OGPermission.h"
+#import "OGPosixSpawnLauncher.h"
+#import "OGProcessExit.h"
+#import "OGProcessSupervisor.h"
 #import "OGPropertyAction.h"
 #import "OGProxyAddress.h"
 #import "OGProxyAddressEnumerator.h"
+#import "OGReadAheadInputStream.h"
 #import "OGResolver.h"
+#import "OGSeekable.h"
 #import "OGSettings.h"
+#import "OGSettingsCache.h"
+#import "OGSettingsSnapshot.h"
+#import "OGSettingsStore.h"
+#import "OGSettingsWriteBatch.h"
 #import "OGSimpleAction.h"
 #import "OGSimpleActionGroup.h"
 #import "OGSimpleAsyncResult.h"
@@ -89,8 +120,14 @@
 #import "OGSocketControlMessage.h"
 #import "OGSocketListener.h"
 #import "OGSocketService.h"
+#import "OGSortListModel.h"
+#import "OGSortedListStore.h"
+#import "OGSpawnedProcess.h"
+#import "OGStoreSettingsBackend.h"
+#import "OGStreamingSubprocess.h"
 #import "OGSubprocess.h"
 #import "OGSubprocessLauncher.h"
+#import "OGSubprocessPool.h"
 #import "OGTask.h"
 #import "OGTcpConnection.h"
 #import "OGTcpWrapperConnection.h"
@@ -100,17 +137,25 @@
 #import "OGTlsCertificate.h"
 #import "OGTlsConnection.h"
 #import "OGTlsDatabase.h"
+#import "OGTlsHandshakeScheduler.h"
 #import "OGTlsInteraction.h"
 #import "OGTlsPassword.h"
+#import "OGTlsSessionCache.h"
 #import "OGUnixConnection.h"
 #import "OGUnixCredentialsMessage.h"
 #import "OGUnixFDList.h"
 #import "OGUnixFDMessage.h"
+#import "OGUnixFdChannel.h"
 #import "OGUnixInputStream.h"
 #import "OGUnixMountMonitor.h"
 #import "OGUnixOutputStream.h"
 #import "OGUnixSocketAddress.h"
 #import "OGVfs.h"
 #import "OGVolumeMonitor.h"
+#import "OGZeroCopySplice.h"
 #import "OGZlibCompressor.h"
 #import "OGZlibDecompressor.h"
+#if __has_include("OGZstdCompressor.h")
+# import "OGZstdCompressor.h"
+# import "OGZstdDecompressor.h"
+#endif